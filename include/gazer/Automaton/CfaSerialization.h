@@ -0,0 +1,151 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file This file declares a serialized format for automata systems, which
+/// may be used to store translated systems on disk.
+///
+/// The format is a sequence of records, each starting with a tag and holding
+/// space-separated fields, terminated by a newline. A field is either an
+/// unsigned number or a length-prefixed string in the form of `len:bytes`.
+/// Types, expressions, variables, automata and locations are numbered in the
+/// order of their definition, and later records refer to them by number.
+/// The records of the system are followed by an 'end' record, after which
+/// clients may append records of their own.
+///
+//===----------------------------------------------------------------------===//
+#ifndef GAZER_AUTOMATON_CFASERIALIZATION_H
+#define GAZER_AUTOMATON_CFASERIALIZATION_H
+
+#include "gazer/Automaton/Cfa.h"
+
+#include <llvm/ADT/DenseMap.h>
+
+namespace gazer
+{
+
+class AutomataSystemWriter
+{
+public:
+    explicit AutomataSystemWriter(llvm::raw_ostream& os)
+        : mOS(os)
+    {}
+
+    AutomataSystemWriter(const AutomataSystemWriter&) = delete;
+    AutomataSystemWriter& operator=(const AutomataSystemWriter&) = delete;
+
+    /// Writes all automata of \p system, followed by an 'end' record.
+    void write(AutomataSystem& system);
+
+    /// Writes the records needed to define \p expr (if it was not written
+    /// already), and returns its number.
+    unsigned writeExpr(const ExprPtr& expr);
+
+    /// Returns the number of an already written automaton or location.
+    unsigned getAutomatonNumber(Cfa* cfa) const;
+    unsigned getLocationNumber(Location* loc) const;
+
+    bool hasLocation(Location* loc) const { return mLocations.count(loc) != 0; }
+
+    //------------------------- Record construction -------------------------//
+    void beginRecord(llvm::StringRef tag);
+    void writeField(uint64_t value);
+    void writeField(llvm::StringRef value);
+    void endRecord();
+
+private:
+    unsigned writeType(Type& type);
+    unsigned writeVariable(Variable* variable, llvm::StringRef tag, Cfa* cfa);
+    unsigned writeLiteral(const ExprRef<LiteralExpr>& expr, unsigned typeNum);
+    void writeAssignments(llvm::ArrayRef<VariableAssignment> assignments);
+
+private:
+    llvm::raw_ostream& mOS;
+
+    llvm::DenseMap<Type*, unsigned> mTypes;
+    llvm::DenseMap<Expr*, unsigned> mExprs;
+    llvm::DenseMap<Variable*, unsigned> mVariables;
+    llvm::DenseMap<Cfa*, unsigned> mAutomata;
+    llvm::DenseMap<Location*, unsigned> mLocations;
+};
+
+class AutomataSystemReader
+{
+public:
+    AutomataSystemReader(GazerContext& context, llvm::StringRef buffer)
+        : mContext(context), mBuffer(buffer)
+    {}
+
+    AutomataSystemReader(const AutomataSystemReader&) = delete;
+    AutomataSystemReader& operator=(const AutomataSystemReader&) = delete;
+
+    /// Reads an automata system up to and including its 'end' record.
+    /// \return The loaded system, or nullptr if the input was malformed.
+    std::unique_ptr<AutomataSystem> read();
+
+    /// Returns the expression, automaton or location defined with the
+    /// given number, or nullptr if there is no such definition.
+    ExprPtr getExpr(uint64_t num) const;
+    Cfa* getAutomaton(uint64_t num) const;
+    Location* getLocation(uint64_t num) const;
+
+    //---------------------------- Record parsing ---------------------------//
+
+    /// Reads the tag of the next client record into \p tag. Type and
+    /// expression definitions found on the way are processed transparently.
+    /// \return False if the input is exhausted or malformed.
+    bool nextRecord(llvm::StringRef& tag);
+
+    bool readField(uint64_t& value);
+    bool readField(llvm::StringRef& value);
+    bool endRecord();
+
+    bool hasError() const { return mError; }
+
+private:
+    bool readTag(llvm::StringRef& tag);
+    bool readDefinition(llvm::StringRef tag);
+    bool readType();
+    bool readVariable(llvm::StringRef tag);
+    bool readLiteral();
+    bool readNonNullary();
+    bool readAssignments(std::vector<VariableAssignment>& assignments);
+
+    template<class T>
+    bool readRef(const std::vector<T>& vec, T& result);
+
+    bool fail() {
+        mError = true;
+        return false;
+    }
+
+private:
+    GazerContext& mContext;
+    llvm::StringRef mBuffer;
+    bool mError = false;
+
+    AutomataSystem* mSystem = nullptr;
+    std::vector<Type*> mTypes;
+    std::vector<ExprPtr> mExprs;
+    std::vector<Variable*> mVariables;
+    std::vector<Cfa*> mAutomata;
+    std::vector<Location*> mLocations;
+};
+
+} // end namespace gazer
+
+#endif
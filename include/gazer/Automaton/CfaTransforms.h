@@ -52,6 +52,23 @@ struct RecursiveToCyclicResult
 /// transformed into the input format of a different verifier.
 RecursiveToCyclicResult TransformRecursiveToCyclic(Cfa* cfa);
 
+//===----------------------------------------------------------------------===//
+/// Merges the sequential and diamond-shaped loop-free regions of the given
+/// CFA into single transitions (large-block encoding). A location with
+/// a single incoming and a single outgoing assign transition is removed by
+/// joining its transitions, and parallel assign transitions between two
+/// locations are merged into one, selecting the assigned values by the
+/// guards of the original transitions.
+///
+/// The transformation relies on the CFA being in SSA form (each variable is
+/// assigned at most once along any path) and on transitions leaving the
+/// same location having mutually exclusive guards. Both properties hold
+/// for the automata translated from LLVM IR using the recursive loop
+/// representation, but not for cyclic automata.
+///
+/// \return The number of removed locations.
+unsigned TransformLargeBlockEncoding(Cfa* cfa);
+
 //===----------------------------------------------------------------------===//
 struct InlineResult
 {
@@ -0,0 +1,54 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#ifndef GAZER_BITBLASTSOLVER_BITBLASTSOLVER_H
+#define GAZER_BITBLASTSOLVER_BITBLASTSOLVER_H
+
+#include "gazer/Core/Solver/Solver.h"
+
+namespace gazer
+{
+
+/// Creates solvers which decide boolean and bit-vector formulas (with arrays
+/// over these sorts) by bit-blasting them into an embedded SAT solver.
+///
+/// Formulas containing other theories are not rejected, but the solver
+/// will answer UNKNOWN instead of SAT for them.
+class BitBlastSolverFactory : public SolverFactory
+{
+public:
+    BitBlastSolverFactory() = default;
+
+    std::unique_ptr<Solver> createSolver(GazerContext& context) override;
+};
+
+/// Creates interpolating solvers over the bit-blasted encoding.
+///
+/// Interpolants are computed from resolution refutations, they are built
+/// from the bits of the variables and base array reads shared by the two
+/// sides of the interpolation query.
+class BitBlastItpSolverFactory : public ItpSolverFactory
+{
+public:
+    BitBlastItpSolverFactory() = default;
+
+    std::unique_ptr<ItpSolver> createItpSolver(GazerContext& context) override;
+};
+
+} // end namespace gazer
+
+#endif
@@ -32,6 +32,7 @@
 
 #include <boost/intrusive_ptr.hpp>
 
+#include <atomic>
 #include <memory>
 #include <string>
 
@@ -176,13 +177,14 @@ public:
 private:
     static void DeleteExpr(Expr* expr);
 
+    // Expressions may be shared between threads, thus reference counting is atomic.
     friend void intrusive_ptr_add_ref(Expr* expr) {
-        expr->mRefCount++;
+        expr->mRefCount.fetch_add(1, std::memory_order_relaxed);
     }
 
     friend void intrusive_ptr_release(Expr* expr) {
         assert(expr->mRefCount > 0 && "Attempting to decrease a zero ref counter!");
-        if (--expr->mRefCount == 0) {
+        if (expr->mRefCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
             Expr::DeleteExpr(expr);
         }
     }
@@ -192,7 +194,7 @@ protected:
     Type& mType;
 
 private:
-    mutable unsigned mRefCount;
+    mutable std::atomic<unsigned> mRefCount;
     Expr* mNextPtr = nullptr;
     mutable size_t mHashCode = 0;
 };
@@ -25,6 +25,12 @@ namespace gazer
 
 unsigned ExprDepth(const ExprPtr& expr);
 
+/// Returns true if the DAG of \p expr has at most \p maxSize distinct nodes
+/// and its depth is at most \p maxDepth. The traversal stops as soon as any
+/// of the bounds is exceeded, thus its cost does not depend on the size of
+/// large expressions.
+bool IsExprWithinBounds(const ExprPtr& expr, unsigned maxSize, unsigned maxDepth);
+
 void FormatPrintExpr(const ExprPtr& expr, llvm::raw_ostream& os);
 
 void InfixPrintExpr(const ExprPtr& expr, llvm::raw_ostream& os, unsigned bvRadix = 10);
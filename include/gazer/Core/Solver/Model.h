@@ -20,6 +20,8 @@
 
 #include "gazer/Core/Expr/ExprEvaluator.h"
 
+#include <llvm/ADT/ArrayRef.h>
+
 namespace gazer
 {
 
@@ -31,6 +33,17 @@ public:
     // Inherited from ExprEvaluator:
     virtual ExprRef<AtomicExpr> evaluate(const ExprPtr& expr) = 0;
 
+    /// Evaluates each expression of \p exprs and appends the results to
+    /// \p results in the same order. Implementations may override this
+    /// method to share work between the evaluated expressions.
+    virtual void evaluateAll(llvm::ArrayRef<ExprPtr> exprs, std::vector<ExprRef<AtomicExpr>>& results)
+    {
+        results.reserve(results.size() + exprs.size());
+        for (const ExprPtr& expr : exprs) {
+            results.push_back(this->evaluate(expr));
+        }
+    }
+
     virtual ~Model() = default;
 
     virtual void dump(llvm::raw_ostream& os) = 0;
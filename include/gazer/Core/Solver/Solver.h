@@ -20,6 +20,9 @@
 
 #include "gazer/Core/Expr.h"
 
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/Support/ErrorHandling.h>
+
 namespace gazer
 {
 
@@ -61,6 +64,25 @@ public:
     virtual SolverStatus run() = 0;
     virtual std::unique_ptr<Model> getModel() = 0;
 
+    /// Returns true if this solver supports checking satisfiability under
+    /// assumptions and extracting unsatisfiable cores.
+    virtual bool supportsAssumptions() const { return false; }
+
+    /// Checks the satisfiability of the current assertions under a set of
+    /// assumptions. Assumptions must be boolean variable references or their
+    /// negations. They are only valid for this particular call.
+    virtual SolverStatus runWithAssumptions(llvm::ArrayRef<ExprPtr> assumptions)
+    {
+        llvm_unreachable("This solver does not support assumptions!");
+    }
+
+    /// Returns the subset of the assumptions passed to the last call of
+    /// runWithAssumptions() which was sufficient to prove unsatisfiability.
+    virtual void getUnsatCore(std::vector<ExprPtr>& core)
+    {
+        llvm_unreachable("This solver does not support unsatisfiable cores!");
+    }
+
     virtual void reset() = 0;
 
     virtual void push() = 0;
@@ -85,6 +107,7 @@ class ItpSolver : public Solver
     using ItpGroupMapTy = std::unordered_map<ItpGroup, llvm::SmallVector<ExprPtr, 1>>;
 public:
     using Solver::Solver;
+    using Solver::add;
 
     void add(ItpGroup group, const ExprPtr& expr)
     {
@@ -125,6 +148,14 @@ public:
     virtual std::unique_ptr<Solver> createSolver(GazerContext& symbols) = 0;
 };
 
+/// Base factory class for interpolating solvers.
+class ItpSolverFactory
+{
+public:
+    /// Creates a new interpolating solver instance with a given symbol table.
+    virtual std::unique_ptr<ItpSolver> createItpSolver(GazerContext& symbols) = 0;
+};
+
 }
 
 #endif
@@ -0,0 +1,91 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file This file declares an on-disk cache for translated automata systems.
+///
+//===----------------------------------------------------------------------===//
+#ifndef GAZER_LLVM_AUTOMATON_AUTOMATACACHE_H
+#define GAZER_LLVM_AUTOMATON_AUTOMATACACHE_H
+
+#include "gazer/LLVM/Automaton/ModuleToAutomata.h"
+
+namespace llvm
+{
+    class LLVMContext;
+} // end namespace llvm
+
+namespace gazer
+{
+
+/// Stores the results of the verification pipeline on disk, so repeated
+/// runs on the same input can skip the LLVM transformations and the
+/// module-to-automata translation.
+///
+/// Entries are keyed by the input module (before running any passes) and
+/// the frontend settings. An entry holds the final module, the automata
+/// system, the CFA-to-LLVM trace information and the messages of the
+/// instrumented error codes. Traces of memory objects are not cached.
+class AutomataCache
+{
+public:
+    using ErrorMessages = std::vector<std::pair<unsigned, std::string>>;
+
+    struct Entry
+    {
+        std::unique_ptr<llvm::Module> module;
+        std::unique_ptr<AutomataSystem> system;
+        CfaToLLVMTrace trace;
+        ErrorMessages messages;
+    };
+
+    /// Creates a cache in \p directory for the given input module.
+    /// Options which are not part of \p settings but change the result
+    /// of the pipeline should be passed in \p extraOptions.
+    AutomataCache(
+        llvm::StringRef directory,
+        const llvm::Module& module,
+        const LLVMFrontendSettings& settings,
+        llvm::StringRef extraOptions = ""
+    );
+
+    /// Loads the cached entry of the input module into \p entry.
+    /// \return False if there is no (valid) entry in the cache.
+    bool lookup(GazerContext& context, llvm::LLVMContext& llvmContext, Entry& entry) const;
+
+    /// Stores the results of the pipeline for the input module.
+    void store(
+        llvm::Module& module,
+        AutomataSystem& system,
+        const CfaToLLVMTrace& trace,
+        const ErrorMessages& messages
+    ) const;
+
+    llvm::StringRef getKey() const { return mKey; }
+
+private:
+    std::string getPath(llvm::StringRef extension) const;
+    bool writeAtomically(llvm::StringRef extension, llvm::function_ref<void(llvm::raw_ostream&)> writer) const;
+
+private:
+    std::string mDirectory;
+    std::string mKey;
+};
+
+} // end namespace gazer
+
+#endif
@@ -101,6 +101,7 @@ private:
 
     ExprPtr operandValue(const llvm::Value* value);
     ExprPtr operandMemoryObject(const MemoryObjectDef* def);
+    ExprPtr integerLiteral(const llvm::APInt& value);
 
     ExprPtr handleOverflowPredicate(const llvm::CallInst& call);
 
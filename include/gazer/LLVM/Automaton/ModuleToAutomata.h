@@ -142,6 +142,10 @@ public:
     /// Attempts to inline and eliminate a given variable from the CFA.
     virtual bool tryToEliminate(ValueOrMemoryObject val, Variable* variable, const ExprPtr& expr) = 0;
 
+    /// Inlines a given variable regardless of the variable elimination settings.
+    /// Returns false if the variable must be kept, e.g. because it is an output.
+    virtual bool tryToInline(ValueOrMemoryObject val, Variable* variable, const ExprPtr& expr) = 0;
+
     virtual void insertAssignment(Variable* variable, const ExprPtr& value) = 0;
 
     virtual void splitCurrentTransition(const ExprPtr& guard) = 0;
@@ -156,6 +160,7 @@ public:
 class CfaToLLVMTrace
 {
     friend class llvm2cfa::GenerationContext;
+    friend class AutomataCache;
 public:
     enum LocationKind { Location_Unknown, Location_Entry, Location_Exit };
 
@@ -195,6 +200,15 @@ public:
         : ModulePass(ID), mContext(context), mSettings(settings)
     {}
 
+    /// Creates a pass which provides an already translated system (e.g. one
+    /// loaded from a cache) instead of translating the module.
+    ModuleToAutomataPass(
+        GazerContext& context, LLVMFrontendSettings& settings,
+        std::unique_ptr<AutomataSystem> system, CfaToLLVMTrace traceInfo
+    ) : ModulePass(ID), mSystem(std::move(system)), mTraceInfo(std::move(traceInfo)),
+        mContext(context), mSettings(settings), mPreloaded(true)
+    {}
+
     void getAnalysisUsage(llvm::AnalysisUsage& au) const override;
 
     bool runOnModule(llvm::Module& module) override;
@@ -213,6 +227,7 @@ private:
     CfaToLLVMTrace mTraceInfo;
     GazerContext& mContext;
     LLVMFrontendSettings& mSettings;
+    bool mPreloaded = false;
 };
 
 class SpecialFunctions;
@@ -44,8 +44,14 @@ private:
     std::set<std::string> mSanitizerFlags;
 };
 
-/// Compiles a set of C and/or LLVM bitcode files using clang, links them
-/// together with llvm-link and parses the resulting module.
+/// Compiles a set of C and/or LLVM bitcode files using clang and links them
+/// together into a single module within \p llvmContext. Up to -j translation
+/// units are compiled in parallel.
+///
+/// Translation units are linked in-process. If gazer was built with
+/// GAZER_ENABLE_CLANG_LIBS, sequential uncached builds also compile the
+/// translation units in-process using the clang libraries. Otherwise each
+/// translation unit is compiled by a separate clang process.
 std::unique_ptr<llvm::Module> ClangCompileAndLink(
     llvm::ArrayRef<std::string> files,
     llvm::LLVMContext& llvmContext,
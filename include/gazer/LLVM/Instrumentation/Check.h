@@ -125,10 +125,20 @@ public:
 
     std::string messageForCode(unsigned ec) const;
 
+    /// Returns the messages of all error codes created so far.
+    std::vector<std::pair<unsigned, std::string>> getMessages() const;
+
+    /// Sets the message of an error code which was not created by this
+    /// registry, e.g. because the instrumented module was loaded from a cache.
+    void restoreMessage(unsigned ec, std::string message) {
+        mRestoredMessages[ec] = std::move(message);
+    }
+
     ~CheckRegistry();
 private:
     llvm::LLVMContext& mLlvmContext;
     llvm::DenseMap<unsigned, CheckViolation> mCheckMap;
+    llvm::DenseMap<unsigned, std::string> mRestoredMessages;
     std::vector<Check*> mChecks;
     bool mRegisterPassesCalled = false;
 
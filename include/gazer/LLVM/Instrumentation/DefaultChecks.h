@@ -31,4 +31,8 @@ namespace gazer::checks
     /// in an over- or underflow.
     std::unique_ptr<Check> createSignedIntegerOverflowCheck(ClangOptions& options);
 
+    /// This check fails if a load or store accesses memory outside of
+    /// its target object, through a null pointer, or after deallocation.
+    std::unique_ptr<Check> createMemorySafetyCheck(ClangOptions& options);
+
 } // end namespace gazer::checks
\ No newline at end of file
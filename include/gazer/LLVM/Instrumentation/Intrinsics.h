@@ -48,6 +48,8 @@ public:
     static constexpr char USubNoOverflowPrefix[] = "gazer.no_overflow.usub.";
     static constexpr char UMulNoOverflowPrefix[] = "gazer.no_overflow.umul.";
 
+    static constexpr char ValidAccessName[] = "gazer.memory.valid_access";
+
     enum class Overflow
     {
         SAdd, UAdd, SSub, USub, SMul, UMul, SDiv, Shl
@@ -77,6 +79,12 @@ public:
     /// Returns a 'gazer.KIND.no_overflow.T(T left, T right)' intrinsic.
     static llvm::FunctionCallee GetOrInsertOverflowCheck(llvm::Module& module, Overflow kind, llvm::Type* type);
 
+    /// Returns a 'gazer.memory.valid_access(i8* ptr, i64 size, i8* base, i64 base_size)'
+    /// predicate, which holds if the 'size' bytes starting at 'ptr' lie within the live
+    /// object occupying [base, base + base_size). A null base stands for an unknown
+    /// object, in which case the pointer is only required to be non-null.
+    static llvm::FunctionCallee GetOrInsertValidAccess(llvm::Module& module);
+
     static bool isPredicate(llvm::Function& function);
 };
 
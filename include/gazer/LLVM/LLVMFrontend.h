@@ -21,6 +21,7 @@
 #include "gazer/LLVM/ClangFrontend.h"
 #include "gazer/LLVM/Instrumentation/Check.h"
 #include "gazer/LLVM/LLVMFrontendSettings.h"
+#include "gazer/LLVM/PipelineReport.h"
 #include "gazer/Verifier/VerificationAlgorithm.h"
 
 #include <llvm/Pass.h>
@@ -32,6 +33,7 @@ namespace gazer
 
 class GazerContext;
 class LLVMFrontend;
+class AutomataCache;
 
 /// Builder class for LLVM frontends.
 class FrontendConfig
@@ -110,6 +112,8 @@ public:
     LLVMFrontend(const LLVMFrontend&) = delete;
     LLVMFrontend& operator=(const LLVMFrontend&) = delete;
 
+    ~LLVMFrontend();
+
     static std::unique_ptr<LLVMFrontend> FromInputFile(
         llvm::StringRef input,
         GazerContext& context,
@@ -144,12 +148,22 @@ public:
 
     GazerContext& getContext() const { return mContext; }
     llvm::Module& getModule() const { return *mModule; }
+
+    /// Returns the resource usage report of the pipeline,
+    /// or nullptr if reporting was not requested.
+    PipelineReport* getPipelineReport() const { return mPipelineReport.get(); }
 private:
     //---------------------- Individual pipeline steps ---------------------//
     void registerEnabledChecks();
     void registerEarlyOptimizations();
     void registerLateOptimizations();
     void registerInlining();
+    bool registerCachedAutomata();
+
+    /// Adds \p pass to the pass manager, followed by a checkpoint if reporting is enabled.
+    void addPass(llvm::Pass* pass);
+    void addCheckpoint(llvm::StringRef stepName);
+    void printPipelineReport();
 
 private:
     GazerContext& mContext;
@@ -162,6 +176,10 @@ private:
     std::unique_ptr<VerificationAlgorithm> mBackendAlgorithm = nullptr; 
 
     std::unique_ptr<llvm::ToolOutputFile> mModuleOutput = nullptr;
+    std::unique_ptr<AutomataCache> mAutomataCache = nullptr;
+
+    std::unique_ptr<PipelineReport> mPipelineReport = nullptr;
+    PipelineSnapshot mLastSnapshot;
 };
 
 }
@@ -62,13 +62,16 @@ enum class ElimVarsLevel
 {
     Off,       ///< Do not try to eliminate variables
     Normal,    ///< Inline variables which have only one use
-    Aggressive ///< Inline all suitable variables
+    Aggressive,///< Inline all suitable variables
+    Bounded    ///< Inline variables while the resulting expressions stay within a size and depth limit
 };
 
 enum class MemoryModelSetting
 {
     Havoc,
-    Flat
+    Flat,
+    Regions,
+    AliasSets
 };
 
 class LLVMFrontendSettings
@@ -93,23 +96,32 @@ public:
     bool optimize = true;
     bool liftAsserts = true;
     bool slicing = true;
+    bool accelerateLoops = false;
+    unsigned accelerateLoopsMaxStores = 1024;
 
     // Checks
     std::string checks = "";
 
     // IR translation
     ElimVarsLevel elimVars = ElimVarsLevel::Off;
+    unsigned elimVarsMaxSize = 64;
+    unsigned elimVarsMaxDepth = 16;
     LoopRepresentation loops = LoopRepresentation::Recursion;
     IntRepresentation ints = IntRepresentation::BitVectors;
     FloatRepresentation floats = FloatRepresentation::Fpa;
     bool simplifyExpr = true;
+    bool largeBlockEncoding = false;
     bool strict = false;
+    unsigned cfaThreads = 1;
 
     std::string function = "main";
 
     // Memory models
     bool debugDumpMemorySSA = false;
     MemoryModelSetting memoryModel = MemoryModelSetting::Flat;
+    bool memoryWordCells = false;
+    bool promoteMemory = true;
+    unsigned memoryFlattenReads = 0;
 
 public:
     /// Returns true if the current settings can be applied to the given module.
@@ -120,6 +132,7 @@ public:
     bool isElimVarsOff() const { return elimVars == ElimVarsLevel::Off; }
     bool isElimVarsNormal() const { return elimVars == ElimVarsLevel::Normal; }
     bool isElimVarsAggressive() const { return elimVars == ElimVarsLevel::Aggressive; }
+    bool isElimVarsBounded() const { return elimVars == ElimVarsLevel::Bounded; }
 
 public:
     static LLVMFrontendSettings initFromCommandLine();
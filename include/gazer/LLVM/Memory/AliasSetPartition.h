@@ -0,0 +1,97 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file This file declares a partitioning of memory into disjoint regions,
+/// based on the alias sets computed by LLVM's alias analyses.
+///
+//===----------------------------------------------------------------------===//
+#ifndef GAZER_LLVM_MEMORY_ALIASSETPARTITION_H
+#define GAZER_LLVM_MEMORY_ALIASSETPARTITION_H
+
+#include <llvm/ADT/StringRef.h>
+
+#include <functional>
+#include <memory>
+
+namespace llvm
+{
+    class Module;
+    class Function;
+    class Value;
+    class AAResults;
+    class raw_ostream;
+} // end namespace llvm
+
+namespace gazer::memory
+{
+
+/// Partitions the memory of a module into regions using the alias sets of
+/// each function, as a cheaper alternative to PointsToAnalysis.
+///
+/// The alias sets of a function are only meaningful within that function,
+/// thus they are stitched together by the objects their pointers are derived
+/// from: globals, allocas, heap allocations, the formal parameters of a
+/// function (merged with the actual arguments of its calls) and the results
+/// of calls to defined functions (merged with the returned values).
+/// Pointers of unknown origin and objects whose address escapes into memory
+/// or unknown code belong to a single unknown region.
+///
+/// The alias sets of a function are never split, and distinct regions are
+/// guaranteed not to alias.
+class AliasSetPartition
+{
+    class Impl;
+public:
+    using RegionID = unsigned;
+    using AliasAnalysisFuncTy = std::function<llvm::AAResults&(llvm::Function&)>;
+
+    /// The region of all memory which may be accessed through pointers
+    /// of unknown origin.
+    static constexpr RegionID UnknownRegion = 0;
+
+    /// Partitions \p module, querying the alias analysis results of each
+    /// function through \p aliasAnalysis. The arguments of \p entry (if present)
+    /// are assumed to point into unknown memory.
+    AliasSetPartition(
+        llvm::Module& module, AliasAnalysisFuncTy aliasAnalysis,
+        const llvm::Function* entry = nullptr);
+
+    AliasSetPartition(const AliasSetPartition&) = delete;
+    AliasSetPartition& operator=(const AliasSetPartition&) = delete;
+
+    ~AliasSetPartition();
+
+    /// Returns the region the pointer \p ptr points into. Pointers not known
+    /// to the partition are assumed to point into the unknown region.
+    RegionID getRegionFor(const llvm::Value* ptr) const;
+
+    /// Returns the number of regions, including the unknown region.
+    unsigned getNumRegions() const;
+
+    /// Returns a human-readable name for a region.
+    llvm::StringRef getRegionName(RegionID region) const;
+
+    void print(llvm::raw_ostream& os) const;
+
+private:
+    std::unique_ptr<Impl> pImpl;
+};
+
+} // end namespace gazer::memory
+
+#endif
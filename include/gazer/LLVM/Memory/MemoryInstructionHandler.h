@@ -135,20 +135,21 @@ public:
         llvm::SmallVectorImpl<VariableAssignment>& outputAssignments) = 0;
 
     /// If the memory model wishes to handle external calls to unknown functions, it
-    /// may do so through this method. Note that known memory-related functions such
-    /// as malloc, memset, memcpy, etc. have their own overridable methods, therefore
-    /// they should not be handled here. Furthermore, if the call is to a non-void
-    /// function, the translation process already generates a havoc assignment for
-    /// it _before_ calling this function.
-    virtual void handleExternalCall(
-        llvm::CallSite call, llvm2cfa::GenerationStepExtensionPoint& ep) {}
+    /// may do so through this method. This includes known library functions, such
+    /// as malloc, memset, memcpy, etc., which the memory model may encode precisely.
+    /// Returns true if the handler has assigned the return value of the call.
+    /// Otherwise, if the call is to a non-void function, the translation process
+    /// generates a havoc assignment for it _after_ calling this function.
+    virtual bool handleExternalCall(
+        llvm::CallSite call, llvm2cfa::GenerationStepExtensionPoint& ep) { return false; }
 
     // Memory safety predicates
     //==--------------------------------------------------------------------==//
     
-    /// Returns a boolean expression which evaluates to true if a memory access
-    /// through \p ptr (represented by the expression in \p expr) is valid.
-    virtual ExprPtr isValidAccess(llvm::Value* ptr, const ExprPtr& expr) = 0;
+    /// Returns a boolean expression which evaluates to true if the memory access
+    /// described by the 'gazer.memory.valid_access' call \p check is valid.
+    virtual ExprPtr isValidAccess(
+        llvm::CallSite check, llvm2cfa::GenerationStepExtensionPoint& ep) = 0;
 
     virtual ~MemoryInstructionHandler() = default;
 };
@@ -24,6 +24,7 @@
 namespace llvm
 {
     class Loop;
+    class AAResults;
 } // end namespace llvm
 
 namespace gazer
@@ -58,11 +59,16 @@ std::unique_ptr<MemoryModel> CreateHavocMemoryModel(GazerContext& context);
 //==-----------------------------------------------------------------------==//
 // FlatMemoryModel - a memory model which represents all memory as a single
 // array, where loads and stores are reads and writes in said array.
+// If the memory model setting is 'Regions', the memory is partitioned by a
+// points-to analysis, and each disjoint region is represented by its own array.
+// The 'AliasSets' setting partitions the memory by the alias sets of the alias
+// analysis results returned by \p aliasAnalysis instead.
 std::unique_ptr<MemoryModel> CreateFlatMemoryModel(
     GazerContext& context,
     const LLVMFrontendSettings& settings,
     llvm::Module& module,
-    std::function<llvm::DominatorTree&(llvm::Function&)> dominators
+    std::function<llvm::DominatorTree&(llvm::Function&)> dominators,
+    std::function<llvm::AAResults&(llvm::Function&)> aliasAnalysis = nullptr
 );
 
 class MemoryModelWrapperPass : public llvm::ModulePass
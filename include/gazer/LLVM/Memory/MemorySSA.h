@@ -20,6 +20,8 @@
 
 #include "gazer/LLVM/Memory/MemoryObject.h"
 
+#include <llvm/ADT/PointerUnion.h>
+
 #include <boost/iterator/indirect_iterator.hpp>
 
 #include <unordered_map>
@@ -108,12 +110,19 @@ private:
 };
 
 /// Helper class for building memory SSA form.
+///
+/// Memory phi nodes are only placed where the object is live, i.e. where its
+/// value may be read before being overwritten. For liveness purposes, call
+/// definitions and definitions of scalar objects (other than phis) are
+/// assumed to overwrite the whole object without reading its previous value,
+/// while all other definitions are treated as partial updates.
 class MemorySSABuilder
 {
     struct MemoryObjectInfo
     {
         MemoryObject* object;
         llvm::SmallPtrSet<llvm::BasicBlock*, 32> defBlocks;
+        llvm::SmallPtrSet<llvm::BasicBlock*, 32> liveInBlocks;
         llvm::SmallVector<MemoryObjectDef*, 8> renameStack;
 
         MemoryObjectDef* getCurrentTopDefinition() {
@@ -121,6 +130,15 @@ class MemorySSABuilder
             return nullptr;
         }
     };
+
+    using AccessPtr = llvm::PointerUnion<MemoryObjectDef*, MemoryObjectUse*>;
+
+    /// Memory accesses annotated on a single basic block.
+    struct BlockAccessInfo
+    {
+        llvm::SmallVector<MemoryObjectDef*, 4> blockDefs;
+        llvm::SmallVector<std::pair<llvm::Instruction*, AccessPtr>, 8> accesses;
+    };
 public:
     MemorySSABuilder(
         llvm::Function& function,
@@ -153,6 +171,11 @@ public:
     std::unique_ptr<MemorySSA> build();
 
 private:
+    void addBlockDef(MemoryObjectDef* def, llvm::BasicBlock* block);
+    void addInstructionAccess(llvm::Instruction* inst, AccessPtr access);
+
+    void sortBlockAccesses();
+    void calculateLiveInBlocks();
     void calculatePHINodes();
     void renamePass();
     void renameBlock(llvm::BasicBlock* block);
@@ -164,8 +187,11 @@ private:
 
     std::vector<std::unique_ptr<MemoryObject>> mObjectStorage;
     llvm::DenseMap<MemoryObject*, MemoryObjectInfo> mObjectInfo;
-    MemorySSA::ValueToDefSetMap mValueDefs;
-    MemorySSA::ValueToUseSetMap mValueUses;
+    llvm::DenseMap<llvm::BasicBlock*, BlockAccessInfo> mBlockAccesses;
+
+    // The objects whose rename stacks were pushed, in order, used to unwind
+    // the stacks when leaving a dominator tree node.
+    llvm::SmallVector<MemoryObjectInfo*, 32> mRenameTrail;
 
     unsigned mVersionNumber = 0;
 };
@@ -18,8 +18,15 @@
 #ifndef GAZER_LLVM_MEMORY_MEMORYUTILS_H
 #define GAZER_LLVM_MEMORY_MEMORYUTILS_H
 
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/SmallVector.h>
+
 namespace llvm {
     class GlobalVariable;
+    class Value;
+    class Type;
+    class Instruction;
+    class DataLayout;
 }
 
 namespace gazer::memory
@@ -28,6 +35,32 @@ namespace gazer::memory
 /// Returns true if the given global variable is used as a pointer.
 bool isGlobalUsedAsPointer(llvm::GlobalVariable& gv);
 
+/// A scalar field of a memory object at a given byte offset.
+struct ScalarField
+{
+    uint64_t offset;
+    llvm::Type* type;
+};
+
+/// Describes how the memory of an object can be split into independent scalars.
+struct PromotableObject
+{
+    /// The fields of the object, ordered by their offsets.
+    llvm::SmallVector<ScalarField, 4> fields;
+
+    /// Maps each load and store accessing the object to the index of its field.
+    llvm::DenseMap<const llvm::Instruction*, unsigned> accesses;
+};
+
+/// Returns true if the address of \p object (a global variable or an alloca)
+/// does not escape and its memory is only accessed by simple loads and stores
+/// at constant, in-bounds offsets which do not partially overlap. In this case,
+/// each accessed field is collected into \p result, so that the object may be
+/// represented by at most \p maxFields scalar variables.
+bool findPromotableFields(
+    const llvm::Value* object, const llvm::DataLayout& dl,
+    PromotableObject& result, unsigned maxFields);
+
 }
 
 #endif
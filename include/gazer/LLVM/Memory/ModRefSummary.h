@@ -0,0 +1,94 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file This file declares a bottom-up interprocedural analysis which
+/// summarizes the memory locations read or written by each function.
+///
+//===----------------------------------------------------------------------===//
+#ifndef GAZER_LLVM_MEMORY_MODREFSUMMARY_H
+#define GAZER_LLVM_MEMORY_MODREFSUMMARY_H
+
+#include <llvm/ADT/BitVector.h>
+
+#include <functional>
+#include <unordered_map>
+
+namespace llvm
+{
+    class Module;
+    class Function;
+    class Instruction;
+    class raw_ostream;
+} // end namespace llvm
+
+namespace gazer::memory
+{
+
+/// Computes the set of abstract memory locations each function may modify
+/// or reference, including the effects of its transitive callees.
+///
+/// Locations are identified by an index in [0, numLocations), their meaning
+/// is up to the client. The local effects of each instruction are queried
+/// through a callback, except for direct calls to defined functions, whose
+/// effects are taken from the summary of the callee. Functions are visited
+/// in a bottom-up order of the call graph; the members of a strongly connected
+/// component (i.e. mutually recursive functions) share the same summary.
+class ModRefSummary
+{
+public:
+    /// Adds the locations modified and referenced by an instruction to
+    /// \p mod and \p ref, respectively.
+    using LocalEffectsFn = std::function<void(
+        const llvm::Instruction& inst, llvm::BitVector& mod, llvm::BitVector& ref)>;
+
+    ModRefSummary(llvm::Module& module, unsigned numLocations, LocalEffectsFn localEffects);
+
+    ModRefSummary(const ModRefSummary&) = delete;
+    ModRefSummary& operator=(const ModRefSummary&) = delete;
+
+    /// Returns true if \p function or any of its callees may write \p location.
+    bool mayModify(const llvm::Function* function, unsigned location) const;
+
+    /// Returns true if \p function or any of its callees may read \p location.
+    bool mayReference(const llvm::Function* function, unsigned location) const;
+
+    bool mayAccess(const llvm::Function* function, unsigned location) const {
+        return mayModify(function, location) || mayReference(function, location);
+    }
+
+    unsigned getNumLocations() const { return mNumLocations; }
+
+    void print(llvm::raw_ostream& os) const;
+
+private:
+    struct Summary
+    {
+        llvm::BitVector mod;
+        llvm::BitVector ref;
+    };
+
+    const Summary* lookup(const llvm::Function* function) const;
+
+private:
+    unsigned mNumLocations;
+    std::unordered_map<const llvm::Function*, Summary> mSummaries;
+};
+
+} // end namespace gazer::memory
+
+#endif
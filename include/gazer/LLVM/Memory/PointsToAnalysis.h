@@ -0,0 +1,106 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file This file declares a unification-based, field-sensitive points-to
+/// analysis which partitions the memory of a module into disjoint regions.
+///
+//===----------------------------------------------------------------------===//
+#ifndef GAZER_LLVM_MEMORY_POINTSTOANALYSIS_H
+#define GAZER_LLVM_MEMORY_POINTSTOANALYSIS_H
+
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/StringRef.h>
+
+#include <cstdint>
+#include <memory>
+
+namespace llvm
+{
+    class Module;
+    class Function;
+    class Value;
+    class raw_ostream;
+} // end namespace llvm
+
+namespace gazer::memory
+{
+
+/// A Steensgaard-style points-to analysis with field sensitivity, similar to
+/// the local phase of Data Structure Analysis.
+///
+/// Allocation sites (globals, allocas and heap allocations) are represented
+/// by abstract nodes, and each pointer points to a cell: a node and a byte
+/// offset within it. Pointers stored at different offsets of a node may point
+/// to different nodes. If a node is accessed in a way that makes its offsets
+/// indistinguishable (e.g. by a non-constant index), it is collapsed into a
+/// single field. Pointers which escape into unknown code, or which are forged
+/// from integers, are merged into a single unknown node.
+///
+/// Each equivalence class of nodes which is accessed by a memory instruction
+/// forms a region. Distinct regions are guaranteed not to alias.
+class PointsToAnalysis
+{
+    class Impl;
+public:
+    using RegionID = unsigned;
+
+    /// The region of all memory which may be accessed through pointers
+    /// of unknown origin.
+    static constexpr RegionID UnknownRegion = 0;
+
+    /// Runs the analysis on \p module. The arguments of \p entry (if present)
+    /// are assumed to point into unknown memory.
+    explicit PointsToAnalysis(llvm::Module& module, const llvm::Function* entry = nullptr);
+
+    PointsToAnalysis(const PointsToAnalysis&) = delete;
+    PointsToAnalysis& operator=(const PointsToAnalysis&) = delete;
+
+    ~PointsToAnalysis();
+
+    /// Returns the region the pointer \p ptr points into. Pointers not known
+    /// to the analysis are assumed to point into the unknown region.
+    RegionID getRegionFor(const llvm::Value* ptr) const;
+
+    /// Returns the number of regions, including the unknown region.
+    unsigned getNumRegions() const;
+
+    /// Returns the allocation sites (globals, allocas and allocating calls)
+    /// belonging to a given region.
+    llvm::ArrayRef<const llvm::Value*> getRegionObjects(RegionID region) const;
+
+    /// Returns a human-readable name for a region.
+    llvm::StringRef getRegionName(RegionID region) const;
+
+    /// Returns true if distinct offsets of the region may not be told apart.
+    bool isCollapsed(RegionID region) const;
+
+    /// If all accesses of a region have the same size S, and their offsets are
+    /// multiples of S from the beginning of their allocation site, returns S.
+    /// Such accesses never partially overlap. Returns zero for regions with
+    /// mixed, unaligned or unknown accesses.
+    uint64_t getUniformAccessSize(RegionID region) const;
+
+    void print(llvm::raw_ostream& os) const;
+
+private:
+    std::unique_ptr<Impl> pImpl;
+};
+
+} // end namespace gazer::memory
+
+#endif
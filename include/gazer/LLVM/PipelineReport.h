@@ -0,0 +1,96 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file This file declares utilities for measuring the resource usage of
+/// the individual steps of the verification pipeline.
+///
+//===----------------------------------------------------------------------===//
+#ifndef GAZER_LLVM_PIPELINEREPORT_H
+#define GAZER_LLVM_PIPELINEREPORT_H
+
+#include <llvm/ADT/StringRef.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace llvm
+{
+    class Module;
+    class raw_ostream;
+} // end namespace llvm
+
+namespace gazer
+{
+
+class AutomataSystem;
+
+/// The state of the verification process at a given point of the pipeline.
+struct PipelineSnapshot
+{
+    std::chrono::steady_clock::time_point time;
+
+    /// Peak resident set size of the process in kilobytes,
+    /// or zero if it is not available on this platform.
+    uint64_t peakRss = 0;
+
+    /// Number of LLVM instructions in the module.
+    uint64_t instructions = 0;
+
+    /// Size of the automata system, all zero if it is not built yet.
+    uint64_t automata = 0;
+    uint64_t locations = 0;
+    uint64_t transitions = 0;
+    uint64_t locals = 0;
+
+    /// Measures the current state. Both \p module and \p system may be null.
+    static PipelineSnapshot take(const llvm::Module* module, const AutomataSystem* system);
+};
+
+/// Collects the wall time, memory usage and program size changes of each
+/// executed pipeline step.
+class PipelineReport
+{
+public:
+    struct Step
+    {
+        std::string name;
+        PipelineSnapshot before;
+        PipelineSnapshot after;
+    };
+
+public:
+    void addStep(llvm::StringRef name, const PipelineSnapshot& before, const PipelineSnapshot& after) {
+        mSteps.push_back({name.str(), before, after});
+    }
+
+    const std::vector<Step>& getSteps() const { return mSteps; }
+
+    /// Prints a human-readable table of the measurements, similarly to LLVM's -time-passes.
+    void print(llvm::raw_ostream& os) const;
+
+    /// Prints the measurements in JSON, intended for processing by other tools.
+    void printJson(llvm::raw_ostream& os) const;
+
+private:
+    std::vector<Step> mSteps;
+};
+
+} // end namespace gazer
+
+#endif
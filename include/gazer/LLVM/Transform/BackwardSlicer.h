@@ -27,6 +27,11 @@
 namespace gazer
 {
 
+/// Removes the instructions of a function which the slicing criterion does
+/// not depend on. Branches outside of the slice are redirected to their
+/// immediate post-dominator, thus the slicer assumes that the skipped
+/// regions terminate. The criterion must therefore match every instruction
+/// which may restrict the executions of the function (e.g. assumptions).
 class BackwardSlicer
 {
 public:
@@ -41,20 +46,24 @@ public:
 private:
 
     bool collectRequiredNodes(llvm::DenseSet<llvm::Instruction*>& visited);
-    void sliceBlocks(
-        const llvm::DenseSet<llvm::Instruction*>& required,
-        llvm::SmallVectorImpl<llvm::BasicBlock*>& preservedBlocks
-    );
+    void sliceBlocks(const llvm::DenseSet<llvm::Instruction*>& required);
     void sliceInstructions(llvm::BasicBlock& bb, const llvm::DenseSet<llvm::Instruction*>& required);
 
 private:
     llvm::Function& mFunction;
     std::function<bool(llvm::Instruction*)> mCriterion;
+    llvm::PostDominatorTree mPDT;
     std::unique_ptr<ProgramDependenceGraph> mPDG;
 };
 
 llvm::Pass* createBackwardSlicerPass(std::function<bool(llvm::Instruction*)> criteria);
 
+/// Slices the entry function with respect to its error calls. Other
+/// functions are sliced with respect to their return values and side
+/// effects, and calls which are irrelevant for reaching an error are
+/// removed. Must be run after assertion lifting.
+llvm::Pass* createInterproceduralSlicerPass(llvm::Function& entry);
+
 } // end namespace gazer
 
 #endif
\ No newline at end of file
@@ -39,6 +39,11 @@ llvm::Pass* createNormalizeVerifierCallsPass();
 /// A simpler (and more restricted) inlining pass.
 llvm::Pass* createSimpleInlinerPass(llvm::Function& entry, InlineLevel level);
 
+/// This pass replaces loops with a closed-form effect (counters, simple array
+/// fills) by straight-line code. At most \p maxStores stores are emitted for
+/// the iterations of a single loop.
+llvm::Pass* createLoopAccelerationPass(unsigned maxStores);
+
 }
 
 #endif
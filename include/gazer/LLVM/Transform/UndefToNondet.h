@@ -37,6 +37,10 @@ public:
     {}
 
     bool runOnModule(llvm::Module& module) override;
+
+    llvm::StringRef getPassName() const override {
+        return "Promote undefined values to nondetermistic calls";
+    }
 };
 
 llvm::Pass* createPromoteUndefsPass();
@@ -20,6 +20,9 @@
 
 #include "gazer/Core/Solver/Solver.h"
 
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/StringRef.h>
+
 namespace z3 {
     class context;
     class model;
@@ -29,12 +32,34 @@ namespace z3 {
 namespace gazer
 {
 
+/// Named configurations of the Z3 solver.
+enum class Z3SolverProfile
+{
+    Default,        ///< Z3's default (combined) solver.
+    Incremental,    ///< The incremental SMT core, without any pre-processing.
+    QF_ABV,         ///< Simplification and equation solving, followed by bit-blasting for pure bit-vector queries.
+    ArrayElim       ///< Rewrites reads over array writes into if-then-else terms before solving.
+};
+
+/// Returns the command-line name of \p profile.
+llvm::StringRef getZ3SolverProfileName(Z3SolverProfile profile);
+
+/// Returns all available solver profiles.
+llvm::ArrayRef<Z3SolverProfile> getAllZ3SolverProfiles();
+
 class Z3SolverFactory : public SolverFactory
 {
 public:
-    Z3SolverFactory() = default;
+    explicit Z3SolverFactory(Z3SolverProfile profile = Z3SolverProfile::Default)
+        : mProfile(profile)
+    {}
 
     std::unique_ptr<Solver> createSolver(GazerContext& context) override;
+
+    Z3SolverProfile getProfile() const { return mProfile; }
+
+private:
+    Z3SolverProfile mProfile;
 };
 
 /// Utility function which transforms an arbitrary Z3 bitvector into LLVM's APInt.
@@ -0,0 +1,1048 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "gazer/Automaton/CfaSerialization.h"
+#include "gazer/Core/ExprTypes.h"
+#include "gazer/Core/LiteralExpr.h"
+
+#include <llvm/ADT/SmallString.h>
+#include <llvm/ADT/STLExtras.h>
+#include <llvm/ADT/StringSwitch.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <optional>
+
+using namespace gazer;
+
+// Writer
+//===----------------------------------------------------------------------===//
+
+void AutomataSystemWriter::beginRecord(llvm::StringRef tag)
+{
+    mOS << tag;
+}
+
+void AutomataSystemWriter::writeField(uint64_t value)
+{
+    mOS << ' ' << value;
+}
+
+void AutomataSystemWriter::writeField(llvm::StringRef value)
+{
+    mOS << ' ' << value.size() << ':' << value;
+}
+
+void AutomataSystemWriter::endRecord()
+{
+    mOS << '\n';
+}
+
+unsigned AutomataSystemWriter::getAutomatonNumber(Cfa* cfa) const
+{
+    auto it = mAutomata.find(cfa);
+    assert(it != mAutomata.end() && "Automaton was not written yet!");
+    return it->second;
+}
+
+unsigned AutomataSystemWriter::getLocationNumber(Location* loc) const
+{
+    auto it = mLocations.find(loc);
+    assert(it != mLocations.end() && "Location was not written yet!");
+    return it->second;
+}
+
+unsigned AutomataSystemWriter::writeType(Type& type)
+{
+    auto it = mTypes.find(&type);
+    if (it != mTypes.end()) {
+        return it->second;
+    }
+
+    // Subtypes must be defined before the composite type.
+    llvm::SmallVector<unsigned, 2> subtypes;
+    if (auto arrTy = llvm::dyn_cast<ArrayType>(&type)) {
+        subtypes.push_back(writeType(arrTy->getIndexType()));
+        subtypes.push_back(writeType(arrTy->getElementType()));
+    } else if (auto tupTy = llvm::dyn_cast<TupleType>(&type)) {
+        for (Type& subtype : llvm::make_range(tupTy->subtype_begin(), tupTy->subtype_end())) {
+            subtypes.push_back(writeType(subtype));
+        }
+    }
+
+    unsigned num = mTypes.size();
+    beginRecord("type");
+    writeField(num);
+
+    switch (type.getTypeID()) {
+        case Type::BoolTypeID: writeField("bool"); break;
+        case Type::IntTypeID: writeField("int"); break;
+        case Type::RealTypeID: writeField("real"); break;
+        case Type::BvTypeID:
+            writeField("bv");
+            writeField(llvm::cast<BvType>(type).getWidth());
+            break;
+        case Type::FloatTypeID:
+            writeField("float");
+            writeField(llvm::cast<FloatType>(type).getPrecision());
+            break;
+        case Type::ArrayTypeID:
+            writeField("array");
+            break;
+        case Type::TupleTypeID:
+            writeField("tuple");
+            writeField(subtypes.size());
+            break;
+        default:
+            llvm_unreachable("Unsupported type in an automata system!");
+    }
+
+    for (unsigned subtype : subtypes) {
+        writeField(subtype);
+    }
+    endRecord();
+
+    mTypes[&type] = num;
+    return num;
+}
+
+unsigned AutomataSystemWriter::writeVariable(Variable* variable, llvm::StringRef tag, Cfa* cfa)
+{
+    assert(mVariables.count(variable) == 0 && "Variables must be written only once!");
+
+    unsigned typeNum = writeType(variable->getType());
+    unsigned num = mVariables.size();
+
+    beginRecord(tag);
+    writeField(num);
+
+    std::string name = variable->getName();
+    if (cfa != nullptr) {
+        // Member variables are re-created by the automaton, which adds the prefix again.
+        writeField(getAutomatonNumber(cfa));
+        llvm::StringRef symbol = name;
+        symbol.consume_front(cfa->getName().str() + "/");
+        writeField(symbol);
+    } else {
+        writeField(name);
+    }
+
+    writeField(typeNum);
+    endRecord();
+
+    mVariables[variable] = num;
+    return num;
+}
+
+unsigned AutomataSystemWriter::writeLiteral(const ExprRef<LiteralExpr>& expr, unsigned typeNum)
+{
+    unsigned num = mExprs.size();
+    beginRecord("lit");
+    writeField(num);
+    writeField(typeNum);
+
+    if (auto boolLit = llvm::dyn_cast<BoolLiteralExpr>(expr)) {
+        writeField(boolLit->getValue() ? 1 : 0);
+    } else if (auto intLit = llvm::dyn_cast<IntLiteralExpr>(expr)) {
+        writeField(std::to_string(intLit->getValue()));
+    } else if (auto realLit = llvm::dyn_cast<RealLiteralExpr>(expr)) {
+        writeField(std::to_string(realLit->getValue().numerator()));
+        writeField(std::to_string(realLit->getValue().denominator()));
+    } else if (auto bvLit = llvm::dyn_cast<BvLiteralExpr>(expr)) {
+        llvm::SmallString<32> buffer;
+        bvLit->getValue().toString(buffer, 16, /*Signed=*/false);
+        writeField(buffer);
+    } else if (auto fltLit = llvm::dyn_cast<FloatLiteralExpr>(expr)) {
+        llvm::SmallString<32> buffer;
+        fltLit->getValue().bitcastToAPInt().toString(buffer, 16, /*Signed=*/false);
+        writeField(buffer);
+    } else if (auto arrLit = llvm::dyn_cast<ArrayLiteralExpr>(expr)) {
+        writeField(arrLit->getMap().size());
+        for (auto& [index, value] : arrLit->getMap()) {
+            writeField(mExprs.lookup(index.get()));
+            writeField(mExprs.lookup(value.get()));
+        }
+        writeField(arrLit->hasDefault() ? 1 : 0);
+        if (arrLit->hasDefault()) {
+            writeField(mExprs.lookup(arrLit->getDefault().get()));
+        }
+    } else {
+        llvm_unreachable("Unsupported literal in an automata system!");
+    }
+
+    endRecord();
+    return num;
+}
+
+static std::optional<llvm::APFloat::roundingMode> getRoundingMode(const NonNullaryExpr* expr)
+{
+    switch (expr->getKind()) {
+        case Expr::FCast: return llvm::cast<FCastExpr>(expr)->getRoundingMode();
+        case Expr::SignedToFp: return llvm::cast<SignedToFpExpr>(expr)->getRoundingMode();
+        case Expr::UnsignedToFp: return llvm::cast<UnsignedToFpExpr>(expr)->getRoundingMode();
+        case Expr::FpToSigned: return llvm::cast<FpToSignedExpr>(expr)->getRoundingMode();
+        case Expr::FpToUnsigned: return llvm::cast<FpToUnsignedExpr>(expr)->getRoundingMode();
+        case Expr::FAdd: return llvm::cast<FAddExpr>(expr)->getRoundingMode();
+        case Expr::FSub: return llvm::cast<FSubExpr>(expr)->getRoundingMode();
+        case Expr::FMul: return llvm::cast<FMulExpr>(expr)->getRoundingMode();
+        case Expr::FDiv: return llvm::cast<FDivExpr>(expr)->getRoundingMode();
+        default:
+            return std::nullopt;
+    }
+}
+
+unsigned AutomataSystemWriter::writeExpr(const ExprPtr& expr)
+{
+    assert(expr != nullptr);
+
+    // Expressions may be very deep, thus operands are written in an
+    // explicit post-order traversal instead of a recursive one.
+    llvm::SmallVector<std::pair<Expr*, bool>, 16> stack;
+    stack.push_back({expr.get(), false});
+
+    while (!stack.empty()) {
+        auto [current, expanded] = stack.pop_back_val();
+        if (mExprs.count(current) != 0) {
+            continue;
+        }
+
+        if (!expanded) {
+            stack.push_back({current, true});
+            if (auto nn = llvm::dyn_cast<NonNullaryExpr>(current)) {
+                for (const ExprPtr& op : nn->operands()) {
+                    stack.push_back({op.get(), false});
+                }
+            } else if (auto arrLit = llvm::dyn_cast<ArrayLiteralExpr>(current)) {
+                for (auto& [index, value] : arrLit->getMap()) {
+                    stack.push_back({index.get(), false});
+                    stack.push_back({value.get(), false});
+                }
+                if (arrLit->hasDefault()) {
+                    stack.push_back({arrLit->getDefault().get(), false});
+                }
+            }
+            continue;
+        }
+
+        unsigned typeNum = writeType(current->getType());
+        unsigned num = mExprs.size();
+
+        if (auto varRef = llvm::dyn_cast<VarRefExpr>(current)) {
+            Variable* variable = &varRef->getVariable();
+            auto it = mVariables.find(variable);
+            unsigned varNum = it != mVariables.end()
+                ? it->second : writeVariable(variable, "var", nullptr);
+
+            beginRecord("varref");
+            writeField(num);
+            writeField(varNum);
+            endRecord();
+        } else if (current->getKind() == Expr::Undef) {
+            beginRecord("undef");
+            writeField(num);
+            writeField(typeNum);
+            endRecord();
+        } else if (auto lit = llvm::dyn_cast<LiteralExpr>(current)) {
+            writeLiteral(ExprRef<LiteralExpr>(lit), typeNum);
+        } else {
+            auto nn = llvm::cast<NonNullaryExpr>(current);
+            beginRecord("expr");
+            writeField(num);
+            writeField(Expr::getKindName(nn->getKind()));
+            writeField(typeNum);
+            writeField(nn->getNumOperands());
+            for (const ExprPtr& op : nn->operands()) {
+                writeField(mExprs.lookup(op.get()));
+            }
+
+            // Some expressions carry information beside their type and operands.
+            if (auto extract = llvm::dyn_cast<ExtractExpr>(nn)) {
+                writeField(extract->getOffset());
+                writeField(extract->getExtractedWidth());
+            } else if (auto rm = getRoundingMode(nn)) {
+                writeField(static_cast<unsigned>(*rm));
+            } else if (auto tupleSel = llvm::dyn_cast<TupleSelectExpr>(nn)) {
+                writeField(tupleSel->getIndex());
+            }
+            endRecord();
+        }
+
+        mExprs[current] = num;
+    }
+
+    return mExprs.lookup(expr.get());
+}
+
+void AutomataSystemWriter::writeAssignments(llvm::ArrayRef<VariableAssignment> assignments)
+{
+    writeField(assignments.size());
+    for (const VariableAssignment& assign : assignments) {
+        writeField(mVariables.lookup(assign.getVariable()));
+        writeField(mExprs.lookup(assign.getValue().get()));
+    }
+}
+
+void AutomataSystemWriter::write(AutomataSystem& system)
+{
+    for (Cfa& cfa : system) {
+        unsigned num = mAutomata.size();
+        beginRecord("cfa");
+        writeField(num);
+        writeField(cfa.getName());
+        endRecord();
+        mAutomata[&cfa] = num;
+    }
+
+    if (system.getMainAutomaton() != nullptr) {
+        beginRecord("main");
+        writeField(getAutomatonNumber(system.getMainAutomaton()));
+        endRecord();
+    }
+
+    // Call transitions refer to the variables of their callee, thus all
+    // variables must be defined before the first transition.
+    for (Cfa& cfa : system) {
+        for (Variable& input : cfa.inputs()) {
+            writeVariable(&input, "input", &cfa);
+        }
+        for (Variable& local : cfa.locals()) {
+            writeVariable(&local, "local", &cfa);
+        }
+        for (Variable& output : cfa.outputs()) {
+            beginRecord("output");
+            writeField(getAutomatonNumber(&cfa));
+            writeField(mVariables.lookup(&output));
+            endRecord();
+        }
+    }
+
+    for (Cfa& cfa : system) {
+        for (Location* loc : cfa.nodes()) {
+            unsigned num = mLocations.size();
+            beginRecord("loc");
+            writeField(num);
+            writeField(getAutomatonNumber(&cfa));
+            if (loc == cfa.getEntry()) {
+                writeField("entry");
+            } else if (loc == cfa.getExit()) {
+                writeField("exit");
+            } else if (loc->isError()) {
+                writeField("error");
+            } else {
+                writeField("state");
+            }
+            endRecord();
+            mLocations[loc] = num;
+        }
+    }
+
+    for (Cfa& cfa : system) {
+        for (Transition* edge : cfa.edges()) {
+            // Define all referenced expressions before the transition record.
+            std::vector<VariableAssignment> inputs;
+            std::vector<VariableAssignment> outputs;
+            if (auto assign = llvm::dyn_cast<AssignTransition>(edge)) {
+                inputs.assign(assign->begin(), assign->end());
+            } else {
+                auto call = llvm::cast<CallTransition>(edge);
+                inputs.assign(call->input_begin(), call->input_end());
+                outputs.assign(call->output_begin(), call->output_end());
+            }
+
+            unsigned guard = writeExpr(edge->getGuard());
+            for (auto& assign : llvm::concat<VariableAssignment>(inputs, outputs)) {
+                writeExpr(assign.getVariable()->getRefExpr());
+                writeExpr(assign.getValue());
+            }
+
+            beginRecord(edge->isAssign() ? "assign" : "call");
+            writeField(getLocationNumber(edge->getSource()));
+            writeField(getLocationNumber(edge->getTarget()));
+            writeField(guard);
+            if (auto call = llvm::dyn_cast<CallTransition>(edge)) {
+                writeField(getAutomatonNumber(call->getCalledAutomaton()));
+                writeAssignments(inputs);
+                writeAssignments(outputs);
+            } else {
+                writeAssignments(inputs);
+            }
+            endRecord();
+        }
+
+        for (auto& [loc, errorExpr] : cfa.errors()) {
+            unsigned exprNum = writeExpr(errorExpr);
+            beginRecord("errorcode");
+            writeField(getLocationNumber(loc));
+            writeField(exprNum);
+            endRecord();
+        }
+    }
+
+    beginRecord("end");
+    endRecord();
+}
+
+// Reader
+//===----------------------------------------------------------------------===//
+
+bool AutomataSystemReader::readTag(llvm::StringRef& tag)
+{
+    size_t end = mBuffer.find_first_of(" \n");
+    if (end == 0 || end == llvm::StringRef::npos) {
+        return false;
+    }
+
+    tag = mBuffer.take_front(end);
+    mBuffer = mBuffer.drop_front(end);
+    return true;
+}
+
+bool AutomataSystemReader::readField(uint64_t& value)
+{
+    if (!mBuffer.consume_front(" ")) {
+        return fail();
+    }
+
+    size_t end = mBuffer.find_first_not_of("0123456789");
+    if (end == 0 || end == llvm::StringRef::npos
+        || mBuffer.take_front(end).getAsInteger(10, value)
+    ) {
+        return fail();
+    }
+
+    mBuffer = mBuffer.drop_front(end);
+    return true;
+}
+
+bool AutomataSystemReader::readField(llvm::StringRef& value)
+{
+    if (!mBuffer.consume_front(" ")) {
+        return fail();
+    }
+
+    size_t length;
+    if (mBuffer.consumeInteger(10, length) || !mBuffer.consume_front(":")
+        || mBuffer.size() < length
+    ) {
+        return fail();
+    }
+
+    value = mBuffer.take_front(length);
+    mBuffer = mBuffer.drop_front(length);
+    return true;
+}
+
+bool AutomataSystemReader::endRecord()
+{
+    if (!mBuffer.consume_front("\n")) {
+        return fail();
+    }
+
+    return true;
+}
+
+template<class T>
+bool AutomataSystemReader::readRef(const std::vector<T>& vec, T& result)
+{
+    uint64_t num;
+    if (!readField(num) || num >= vec.size()) {
+        return fail();
+    }
+
+    result = vec[num];
+    return true;
+}
+
+ExprPtr AutomataSystemReader::getExpr(uint64_t num) const
+{
+    return num < mExprs.size() ? mExprs[num] : nullptr;
+}
+
+Cfa* AutomataSystemReader::getAutomaton(uint64_t num) const
+{
+    return num < mAutomata.size() ? mAutomata[num] : nullptr;
+}
+
+Location* AutomataSystemReader::getLocation(uint64_t num) const
+{
+    return num < mLocations.size() ? mLocations[num] : nullptr;
+}
+
+bool AutomataSystemReader::nextRecord(llvm::StringRef& tag)
+{
+    while (!mError && readTag(tag)) {
+        if (!readDefinition(tag)) {
+            return !mError;
+        }
+    }
+
+    return false;
+}
+
+bool AutomataSystemReader::readDefinition(llvm::StringRef tag)
+{
+    bool success;
+    if (tag == "type") {
+        success = readType();
+    } else if (tag == "var") {
+        success = readVariable(tag);
+    } else if (tag == "lit") {
+        success = readLiteral();
+    } else if (tag == "expr") {
+        success = readNonNullary();
+    } else if (tag == "undef" || tag == "varref") {
+        uint64_t num;
+        if (!readField(num) || num != mExprs.size()) {
+            return fail();
+        }
+
+        if (tag == "undef") {
+            Type* type;
+            success = readRef(mTypes, type);
+            if (success) {
+                mExprs.push_back(UndefExpr::Get(*type));
+            }
+        } else {
+            Variable* variable;
+            success = readRef(mVariables, variable);
+            if (success) {
+                mExprs.push_back(variable->getRefExpr());
+            }
+        }
+    } else {
+        // Not a definition, let the caller handle it.
+        return false;
+    }
+
+    if (!success || !endRecord()) {
+        return fail();
+    }
+
+    return true;
+}
+
+bool AutomataSystemReader::readType()
+{
+    uint64_t num;
+    llvm::StringRef kind;
+    if (!readField(num) || num != mTypes.size() || !readField(kind)) {
+        return fail();
+    }
+
+    Type* type = nullptr;
+    if (kind == "bool") {
+        type = &BoolType::Get(mContext);
+    } else if (kind == "int") {
+        type = &IntType::Get(mContext);
+    } else if (kind == "real") {
+        type = &RealType::Get(mContext);
+    } else if (kind == "bv") {
+        uint64_t width;
+        if (!readField(width) || width == 0) {
+            return fail();
+        }
+        type = &BvType::Get(mContext, width);
+    } else if (kind == "float") {
+        uint64_t precision;
+        if (!readField(precision)) {
+            return fail();
+        }
+
+        switch (precision) {
+            case FloatType::Half:
+            case FloatType::Single:
+            case FloatType::Double:
+            case FloatType::Quad:
+                type = &FloatType::Get(mContext, static_cast<FloatType::FloatPrecision>(precision));
+                break;
+            default:
+                return fail();
+        }
+    } else if (kind == "array") {
+        Type* index;
+        Type* element;
+        if (!readRef(mTypes, index) || !readRef(mTypes, element)) {
+            return fail();
+        }
+        type = &ArrayType::Get(*index, *element);
+    } else {
+        // Tuple types cannot be constructed from an arbitrary list of
+        // subtypes. As the LLVM frontend never creates them, they are
+        // rejected here.
+        return fail();
+    }
+
+    mTypes.push_back(type);
+    return true;
+}
+
+bool AutomataSystemReader::readVariable(llvm::StringRef tag)
+{
+    uint64_t num;
+    if (!readField(num) || num != mVariables.size()) {
+        return fail();
+    }
+
+    Cfa* cfa = nullptr;
+    if (tag != "var" && !readRef(mAutomata, cfa)) {
+        return fail();
+    }
+
+    llvm::StringRef name;
+    Type* type;
+    if (!readField(name) || !readRef(mTypes, type)) {
+        return fail();
+    }
+
+    Variable* variable;
+    if (tag == "input") {
+        variable = cfa->createInput(name.str(), *type);
+    } else if (tag == "local") {
+        variable = cfa->createLocal(name.str(), *type);
+    } else {
+        variable = mContext.getVariable(name);
+        if (variable == nullptr) {
+            variable = mContext.createVariable(name.str(), *type);
+        } else if (&variable->getType() != type) {
+            return fail();
+        }
+    }
+
+    mVariables.push_back(variable);
+    return true;
+}
+
+bool AutomataSystemReader::readLiteral()
+{
+    uint64_t num;
+    Type* type;
+    if (!readField(num) || num != mExprs.size() || !readRef(mTypes, type)) {
+        return fail();
+    }
+
+    ExprRef<LiteralExpr> lit;
+    switch (type->getTypeID()) {
+        case Type::BoolTypeID: {
+            uint64_t value;
+            if (!readField(value)) {
+                return fail();
+            }
+            lit = BoolLiteralExpr::Get(mContext, value != 0);
+            break;
+        }
+        case Type::IntTypeID: {
+            llvm::StringRef str;
+            long long value;
+            if (!readField(str) || str.getAsInteger(10, value)) {
+                return fail();
+            }
+            lit = IntLiteralExpr::Get(llvm::cast<IntType>(*type), value);
+            break;
+        }
+        case Type::RealTypeID: {
+            llvm::StringRef numStr, denStr;
+            long long numerator, denominator;
+            if (!readField(numStr) || numStr.getAsInteger(10, numerator)
+                || !readField(denStr) || denStr.getAsInteger(10, denominator)
+                || denominator == 0
+            ) {
+                return fail();
+            }
+            lit = RealLiteralExpr::Get(llvm::cast<RealType>(*type), numerator, denominator);
+            break;
+        }
+        case Type::BvTypeID: {
+            auto& bvTy = llvm::cast<BvType>(*type);
+            llvm::StringRef str;
+            llvm::APInt value;
+            if (!readField(str) || str.getAsInteger(16, value) || value.getActiveBits() > bvTy.getWidth()) {
+                return fail();
+            }
+            lit = BvLiteralExpr::Get(bvTy, value.zextOrTrunc(bvTy.getWidth()));
+            break;
+        }
+        case Type::FloatTypeID: {
+            auto& fltTy = llvm::cast<FloatType>(*type);
+            llvm::StringRef str;
+            llvm::APInt bits;
+            if (!readField(str) || str.getAsInteger(16, bits) || bits.getActiveBits() > fltTy.getWidth()) {
+                return fail();
+            }
+            llvm::APFloat value(fltTy.getLLVMSemantics(), bits.zextOrTrunc(fltTy.getWidth()));
+            lit = FloatLiteralExpr::Get(fltTy, value);
+            break;
+        }
+        case Type::ArrayTypeID: {
+            ArrayLiteralExpr::Builder builder(llvm::cast<ArrayType>(*type));
+            uint64_t numElements;
+            if (!readField(numElements)) {
+                return fail();
+            }
+
+            auto readLiteralRef = [this](ExprRef<LiteralExpr>& result) {
+                ExprPtr expr;
+                if (!readRef(mExprs, expr) || !llvm::isa<LiteralExpr>(expr)) {
+                    return fail();
+                }
+                result = llvm::cast<LiteralExpr>(expr);
+                return true;
+            };
+
+            for (uint64_t i = 0; i < numElements; ++i) {
+                ExprRef<LiteralExpr> index, value;
+                if (!readLiteralRef(index) || !readLiteralRef(value)) {
+                    return false;
+                }
+                builder.addValue(index, value);
+            }
+
+            uint64_t hasDefault;
+            if (!readField(hasDefault)) {
+                return fail();
+            }
+
+            if (hasDefault != 0) {
+                ExprRef<LiteralExpr> elze;
+                if (!readLiteralRef(elze)) {
+                    return false;
+                }
+                builder.setDefault(elze);
+            }
+
+            lit = builder.build();
+            break;
+        }
+        default:
+            return fail();
+    }
+
+    mExprs.push_back(lit);
+    return true;
+}
+
+static std::optional<Expr::ExprKind> parseExprKind(llvm::StringRef name)
+{
+    return llvm::StringSwitch<std::optional<Expr::ExprKind>>(name)
+        #define GAZER_EXPR_KIND(KIND) .Case(#KIND, Expr::KIND)
+        #include "gazer/Core/Expr/ExprKind.def"
+        #undef GAZER_EXPR_KIND
+        .Default(std::nullopt);
+}
+
+static size_t getExpectedNumOperands(Expr::ExprKind kind)
+{
+    switch (kind) {
+        case Expr::Select:
+        case Expr::ArrayWrite:
+            return 3;
+        case Expr::And:
+        case Expr::Or:
+        case Expr::TupleConstruct:
+            return 0;
+        default:
+            break;
+    }
+
+    if ((kind >= Expr::FirstUnary && kind <= Expr::LastUnary)
+        || kind == Expr::FIsNan || kind == Expr::FIsInf
+        || (kind >= Expr::FCast && kind <= Expr::FpToUnsigned)
+        || kind == Expr::TupleSelect
+    ) {
+        return 1;
+    }
+
+    return 2;
+}
+
+bool AutomataSystemReader::readNonNullary()
+{
+    uint64_t num;
+    llvm::StringRef kindName;
+    Type* type;
+    uint64_t numOps;
+
+    if (!readField(num) || num != mExprs.size() || !readField(kindName)
+        || !readRef(mTypes, type) || !readField(numOps)
+    ) {
+        return fail();
+    }
+
+    auto kind = parseExprKind(kindName);
+    if (!kind || *kind == Expr::Undef || *kind == Expr::Literal || *kind == Expr::VarRef
+        || *kind == Expr::TupleConstruct
+    ) {
+        return fail();
+    }
+
+    // Multiary expressions (with an expected count of 0) need at least two operands.
+    size_t expected = getExpectedNumOperands(*kind);
+    if ((expected != 0 && numOps != expected) || (expected == 0 && numOps < 2)) {
+        return fail();
+    }
+
+    ExprVector ops(numOps, nullptr);
+    for (uint64_t i = 0; i < numOps; ++i) {
+        if (!readRef(mExprs, ops[i])) {
+            return fail();
+        }
+    }
+
+    auto readRoundingMode = [this](llvm::APFloat::roundingMode& rm) {
+        uint64_t value;
+        if (!readField(value)) {
+            return fail();
+        }
+        rm = static_cast<llvm::APFloat::roundingMode>(value);
+        return true;
+    };
+
+    ExprPtr expr;
+    llvm::APFloat::roundingMode rm;
+
+    switch (*kind) {
+        case Expr::Not: expr = NotExpr::Create(ops[0]); break;
+        case Expr::ZExt: expr = ZExtExpr::Create(ops[0], *type); break;
+        case Expr::SExt: expr = SExtExpr::Create(ops[0], *type); break;
+        case Expr::Extract: {
+            uint64_t offset, width;
+            if (!readField(offset) || !readField(width)) {
+                return fail();
+            }
+            expr = ExtractExpr::Create(ops[0], offset, width);
+            break;
+        }
+        case Expr::Add: expr = AddExpr::Create(ops[0], ops[1]); break;
+        case Expr::Sub: expr = SubExpr::Create(ops[0], ops[1]); break;
+        case Expr::Mul: expr = MulExpr::Create(ops[0], ops[1]); break;
+        case Expr::Div: expr = DivExpr::Create(ops[0], ops[1]); break;
+        case Expr::Mod: expr = ModExpr::Create(ops[0], ops[1]); break;
+        case Expr::Rem: expr = RemExpr::Create(ops[0], ops[1]); break;
+        case Expr::BvSDiv: expr = BvSDivExpr::Create(ops[0], ops[1]); break;
+        case Expr::BvUDiv: expr = BvUDivExpr::Create(ops[0], ops[1]); break;
+        case Expr::BvSRem: expr = BvSRemExpr::Create(ops[0], ops[1]); break;
+        case Expr::BvURem: expr = BvURemExpr::Create(ops[0], ops[1]); break;
+        case Expr::Shl: expr = ShlExpr::Create(ops[0], ops[1]); break;
+        case Expr::LShr: expr = LShrExpr::Create(ops[0], ops[1]); break;
+        case Expr::AShr: expr = AShrExpr::Create(ops[0], ops[1]); break;
+        case Expr::BvAnd: expr = BvAndExpr::Create(ops[0], ops[1]); break;
+        case Expr::BvOr: expr = BvOrExpr::Create(ops[0], ops[1]); break;
+        case Expr::BvXor: expr = BvXorExpr::Create(ops[0], ops[1]); break;
+        case Expr::BvConcat: expr = BvConcatExpr::Create(ops[0], ops[1]); break;
+        case Expr::And: expr = AndExpr::Create(ops); break;
+        case Expr::Or: expr = OrExpr::Create(ops); break;
+        case Expr::Imply: expr = ImplyExpr::Create(ops[0], ops[1]); break;
+        case Expr::Eq: expr = EqExpr::Create(ops[0], ops[1]); break;
+        case Expr::NotEq: expr = NotEqExpr::Create(ops[0], ops[1]); break;
+        case Expr::Lt: expr = LtExpr::Create(ops[0], ops[1]); break;
+        case Expr::LtEq: expr = LtEqExpr::Create(ops[0], ops[1]); break;
+        case Expr::Gt: expr = GtExpr::Create(ops[0], ops[1]); break;
+        case Expr::GtEq: expr = GtEqExpr::Create(ops[0], ops[1]); break;
+        case Expr::BvSLt: expr = BvSLtExpr::Create(ops[0], ops[1]); break;
+        case Expr::BvSLtEq: expr = BvSLtEqExpr::Create(ops[0], ops[1]); break;
+        case Expr::BvSGt: expr = BvSGtExpr::Create(ops[0], ops[1]); break;
+        case Expr::BvSGtEq: expr = BvSGtEqExpr::Create(ops[0], ops[1]); break;
+        case Expr::BvULt: expr = BvULtExpr::Create(ops[0], ops[1]); break;
+        case Expr::BvULtEq: expr = BvULtEqExpr::Create(ops[0], ops[1]); break;
+        case Expr::BvUGt: expr = BvUGtExpr::Create(ops[0], ops[1]); break;
+        case Expr::BvUGtEq: expr = BvUGtEqExpr::Create(ops[0], ops[1]); break;
+        case Expr::FIsNan: expr = FIsNanExpr::Create(ops[0]); break;
+        case Expr::FIsInf: expr = FIsInfExpr::Create(ops[0]); break;
+        case Expr::FCast:
+            if (!readRoundingMode(rm)) { return false; }
+            expr = FCastExpr::Create(ops[0], *type, rm);
+            break;
+        case Expr::SignedToFp:
+            if (!readRoundingMode(rm)) { return false; }
+            expr = SignedToFpExpr::Create(ops[0], *type, rm);
+            break;
+        case Expr::UnsignedToFp:
+            if (!readRoundingMode(rm)) { return false; }
+            expr = UnsignedToFpExpr::Create(ops[0], *type, rm);
+            break;
+        case Expr::FpToSigned:
+            if (!readRoundingMode(rm)) { return false; }
+            expr = FpToSignedExpr::Create(ops[0], *type, rm);
+            break;
+        case Expr::FpToUnsigned:
+            if (!readRoundingMode(rm)) { return false; }
+            expr = FpToUnsignedExpr::Create(ops[0], *type, rm);
+            break;
+        case Expr::FAdd:
+            if (!readRoundingMode(rm)) { return false; }
+            expr = FAddExpr::Create(ops[0], ops[1], rm);
+            break;
+        case Expr::FSub:
+            if (!readRoundingMode(rm)) { return false; }
+            expr = FSubExpr::Create(ops[0], ops[1], rm);
+            break;
+        case Expr::FMul:
+            if (!readRoundingMode(rm)) { return false; }
+            expr = FMulExpr::Create(ops[0], ops[1], rm);
+            break;
+        case Expr::FDiv:
+            if (!readRoundingMode(rm)) { return false; }
+            expr = FDivExpr::Create(ops[0], ops[1], rm);
+            break;
+        case Expr::FEq: expr = FEqExpr::Create(ops[0], ops[1]); break;
+        case Expr::FGt: expr = FGtExpr::Create(ops[0], ops[1]); break;
+        case Expr::FGtEq: expr = FGtEqExpr::Create(ops[0], ops[1]); break;
+        case Expr::FLt: expr = FLtExpr::Create(ops[0], ops[1]); break;
+        case Expr::FLtEq: expr = FLtEqExpr::Create(ops[0], ops[1]); break;
+        case Expr::Select: expr = SelectExpr::Create(ops[0], ops[1], ops[2]); break;
+        case Expr::ArrayRead: expr = ArrayReadExpr::Create(ops[0], ops[1]); break;
+        case Expr::ArrayWrite: expr = ArrayWriteExpr::Create(ops[0], ops[1], ops[2]); break;
+        case Expr::TupleSelect: {
+            uint64_t index;
+            if (!readField(index)) {
+                return fail();
+            }
+            expr = TupleSelectExpr::Create(ops[0], index);
+            break;
+        }
+        case Expr::Undef:
+        case Expr::Literal:
+        case Expr::VarRef:
+        case Expr::TupleConstruct:
+            llvm_unreachable("Invalid kinds should have been rejected earlier!");
+    }
+
+    mExprs.push_back(expr);
+    return true;
+}
+
+bool AutomataSystemReader::readAssignments(std::vector<VariableAssignment>& assignments)
+{
+    uint64_t count;
+    if (!readField(count)) {
+        return fail();
+    }
+
+    for (uint64_t i = 0; i < count; ++i) {
+        Variable* variable;
+        ExprPtr value;
+        if (!readRef(mVariables, variable) || !readRef(mExprs, value)) {
+            return fail();
+        }
+        assignments.emplace_back(variable, value);
+    }
+
+    return true;
+}
+
+std::unique_ptr<AutomataSystem> AutomataSystemReader::read()
+{
+    auto system = std::make_unique<AutomataSystem>(mContext);
+    mSystem = system.get();
+
+    llvm::StringRef tag;
+    while (nextRecord(tag)) {
+        bool success = true;
+        if (tag == "end") {
+            if (!endRecord()) {
+                return nullptr;
+            }
+            return system;
+        }
+
+        if (tag == "cfa") {
+            uint64_t num;
+            llvm::StringRef name;
+            success = readField(num) && num == mAutomata.size() && readField(name);
+            if (success) {
+                mAutomata.push_back(mSystem->createCfa(name.str()));
+            }
+        } else if (tag == "main") {
+            Cfa* main;
+            success = readRef(mAutomata, main);
+            if (success) {
+                mSystem->setMainAutomaton(main);
+            }
+        } else if (tag == "input" || tag == "local") {
+            success = readVariable(tag);
+        } else if (tag == "output") {
+            Cfa* cfa;
+            Variable* variable;
+            success = readRef(mAutomata, cfa) && readRef(mVariables, variable);
+            if (success) {
+                cfa->addOutput(variable);
+            }
+        } else if (tag == "loc") {
+            uint64_t num;
+            Cfa* cfa;
+            llvm::StringRef kind;
+            success = readField(num) && num == mLocations.size()
+                && readRef(mAutomata, cfa) && readField(kind);
+
+            if (success) {
+                Location* loc = nullptr;
+                if (kind == "entry") {
+                    loc = cfa->getEntry();
+                } else if (kind == "exit") {
+                    loc = cfa->getExit();
+                } else if (kind == "state") {
+                    loc = cfa->createLocation();
+                } else if (kind == "error") {
+                    loc = cfa->createErrorLocation();
+                }
+
+                success = loc != nullptr;
+                mLocations.push_back(loc);
+            }
+        } else if (tag == "assign" || tag == "call") {
+            Location* source;
+            Location* target;
+            ExprPtr guard;
+            Cfa* callee = nullptr;
+            std::vector<VariableAssignment> inputs;
+            std::vector<VariableAssignment> outputs;
+
+            success = readRef(mLocations, source) && readRef(mLocations, target)
+                && readRef(mExprs, guard)
+                && source->getAutomaton() == target->getAutomaton();
+
+            if (success && tag == "call") {
+                success = readRef(mAutomata, callee)
+                    && readAssignments(inputs) && readAssignments(outputs);
+            } else if (success) {
+                success = readAssignments(inputs);
+            }
+
+            if (success) {
+                Cfa* cfa = source->getAutomaton();
+                if (callee != nullptr) {
+                    cfa->createCallTransition(source, target, guard, callee, inputs, outputs);
+                } else {
+                    cfa->createAssignTransition(source, target, guard, inputs);
+                }
+            }
+        } else if (tag == "errorcode") {
+            Location* loc;
+            ExprPtr errorCode;
+            success = readRef(mLocations, loc) && readRef(mExprs, errorCode);
+            if (success) {
+                loc->getAutomaton()->addErrorCode(loc, errorCode);
+            }
+        } else {
+            success = false;
+        }
+
+        if (!success || !endRecord()) {
+            return nullptr;
+        }
+    }
+
+    return nullptr;
+}
@@ -0,0 +1,192 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "gazer/Automaton/Cfa.h"
+#include "gazer/Automaton/CfaTransforms.h"
+#include "gazer/Core/Expr/ExprBuilder.h"
+
+#include <llvm/ADT/MapVector.h>
+#include <llvm/ADT/SmallPtrSet.h>
+
+using namespace gazer;
+
+namespace
+{
+
+class LargeBlockEncoder
+{
+public:
+    explicit LargeBlockEncoder(Cfa* cfa)
+        : mCfa(cfa), mExprBuilder(CreateFoldingExprBuilder(cfa->getParent().getContext()))
+    {}
+
+    unsigned transform();
+
+private:
+    bool mergeSequential(Location* loc);
+    bool mergeParallel(Location* loc);
+    bool mergeParallelGroup(llvm::ArrayRef<AssignTransition*> group);
+
+private:
+    Cfa* mCfa;
+    std::unique_ptr<ExprBuilder> mExprBuilder;
+    unsigned mNumRemoved = 0;
+};
+
+} // end anonymous namespace
+
+unsigned LargeBlockEncoder::transform()
+{
+    // Merging parallel transitions may turn their source or target into
+    // candidates for sequential merging and vice versa, so iterate until
+    // a fixpoint is reached.
+    bool changed;
+    do {
+        changed = false;
+        std::vector<Location*> locations(mCfa->node_begin(), mCfa->node_end());
+
+        for (Location* loc : locations) {
+            changed |= this->mergeSequential(loc);
+        }
+
+        for (Location* loc : locations) {
+            changed |= this->mergeParallel(loc);
+        }
+    } while (changed);
+
+    mCfa->clearDisconnectedElements();
+
+    return mNumRemoved;
+}
+
+bool LargeBlockEncoder::mergeSequential(Location* loc)
+{
+    if (loc == mCfa->getEntry() || loc == mCfa->getExit() || loc->isError()) {
+        return false;
+    }
+
+    if (loc->getNumIncoming() != 1 || loc->getNumOutgoing() != 1) {
+        return false;
+    }
+
+    auto first = llvm::dyn_cast<AssignTransition>(*loc->incoming_begin());
+    auto second = llvm::dyn_cast<AssignTransition>(*loc->outgoing_begin());
+    if (first == nullptr || second == nullptr || first->getSource() == second->getTarget()) {
+        return false;
+    }
+
+    std::vector<VariableAssignment> assignments(first->begin(), first->end());
+    llvm::SmallPtrSet<Variable*, 8> assigned;
+    for (const VariableAssignment& assign : assignments) {
+        assigned.insert(assign.getVariable());
+    }
+
+    for (const VariableAssignment& assign : *second) {
+        // This cannot happen in SSA form, but we should not break other automata either.
+        if (!assigned.insert(assign.getVariable()).second) {
+            return false;
+        }
+        assignments.push_back(assign);
+    }
+
+    // As the automaton is in SSA form, the second guard may freely refer to
+    // the variables assigned by the first transition.
+    mCfa->createAssignTransition(
+        first->getSource(), second->getTarget(),
+        mExprBuilder->And(first->getGuard(), second->getGuard()),
+        assignments
+    );
+
+    mCfa->disconnectNode(loc);
+    ++mNumRemoved;
+
+    return true;
+}
+
+bool LargeBlockEncoder::mergeParallel(Location* loc)
+{
+    llvm::MapVector<Location*, llvm::SmallVector<AssignTransition*, 2>> groups;
+    for (Transition* edge : loc->outgoing()) {
+        if (auto assign = llvm::dyn_cast<AssignTransition>(edge)) {
+            groups[assign->getTarget()].push_back(assign);
+        }
+    }
+
+    bool changed = false;
+    for (auto& [target, group] : groups) {
+        if (group.size() > 1) {
+            changed |= this->mergeParallelGroup(group);
+        }
+    }
+
+    return changed;
+}
+
+bool LargeBlockEncoder::mergeParallelGroup(llvm::ArrayRef<AssignTransition*> group)
+{
+    ExprVector guards;
+    llvm::MapVector<Variable*, llvm::SmallVector<std::pair<ExprPtr, ExprPtr>, 2>> choices;
+
+    for (AssignTransition* edge : group) {
+        guards.push_back(edge->getGuard());
+        for (const VariableAssignment& assign : *edge) {
+            choices[assign.getVariable()].emplace_back(edge->getGuard(), assign.getValue());
+        }
+    }
+
+    std::vector<VariableAssignment> assignments;
+    for (auto& [variable, values] : choices) {
+        auto isUndef = [](auto& pair) { return pair.second->getKind() == Expr::Undef; };
+        if (std::all_of(values.begin(), values.end(), isUndef)) {
+            assignments.emplace_back(variable, values.front().second);
+            continue;
+        }
+
+        // Undefined values cannot be part of a select expression.
+        if (std::any_of(values.begin(), values.end(), isUndef)) {
+            return false;
+        }
+
+        // Select the value of the transition whose guard holds. Transitions which
+        // do not assign the variable need no choice: in SSA form, the variable is
+        // not read on their paths.
+        ExprPtr value = values.back().second;
+        for (auto it = std::next(values.rbegin()); it != values.rend(); ++it) {
+            if (it->second != value) {
+                value = mExprBuilder->Select(it->first, it->second, value);
+            }
+        }
+
+        assignments.emplace_back(variable, value);
+    }
+
+    mCfa->createAssignTransition(
+        group.front()->getSource(), group.front()->getTarget(), mExprBuilder->Or(guards), assignments
+    );
+
+    for (AssignTransition* edge : group) {
+        mCfa->disconnectEdge(edge);
+    }
+
+    return true;
+}
+
+unsigned gazer::TransformLargeBlockEncoding(Cfa* cfa)
+{
+    LargeBlockEncoder encoder(cfa);
+    return encoder.transform();
+}
@@ -17,6 +17,8 @@
 //===----------------------------------------------------------------------===//
 #include "gazer/Core/Expr/ExprUtils.h"
 
+#include <llvm/ADT/DenseMap.h>
+
 #include <numeric>
 
 using namespace gazer;
@@ -41,3 +43,37 @@ unsigned gazer::ExprDepth(const ExprPtr& expr)
 
     llvm_unreachable("An expression cannot be nullary and non-nullary at the same time!");
 }
+
+bool gazer::IsExprWithinBounds(const ExprPtr& expr, unsigned maxSize, unsigned maxDepth)
+{
+    // Maps each visited node to the greatest depth it was reached at. Nodes
+    // reached again on a longer path must be re-expanded to get the depth right.
+    llvm::DenseMap<const Expr*, unsigned> visited;
+    llvm::SmallVector<std::pair<const Expr*, unsigned>, 16> worklist;
+    worklist.emplace_back(expr.get(), 1);
+
+    while (!worklist.empty()) {
+        auto [current, depth] = worklist.pop_back_val();
+        if (depth > maxDepth) {
+            return false;
+        }
+
+        auto [it, inserted] = visited.try_emplace(current, depth);
+        if (!inserted) {
+            if (it->second >= depth) {
+                continue;
+            }
+            it->second = depth;
+        } else if (visited.size() > maxSize) {
+            return false;
+        }
+
+        if (auto nn = llvm::dyn_cast<NonNullaryExpr>(current)) {
+            for (auto& op : nn->operands()) {
+                worklist.emplace_back(op.get(), depth + 1);
+            }
+        }
+    }
+
+    return true;
+}
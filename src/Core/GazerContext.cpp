@@ -65,6 +65,7 @@ GazerContext::~GazerContext() = default;
 Variable* GazerContext::createVariable(const std::string& name, Type &type)
 {
     LLVM_DEBUG(llvm::dbgs() << "Adding variable with name " << name << " and type " << type << "\n");
+    std::lock_guard<std::mutex> lock(pImpl->VariableMutex);
     GAZER_DEBUG_ASSERT(pImpl->VariableTable.count(name) == 0);
     auto ptr = new Variable(name, type);
     pImpl->VariableTable[name] = std::unique_ptr<Variable>(ptr);
@@ -81,6 +82,7 @@ Variable* GazerContext::createVariable(const std::string& name, Type &type)
 
 Variable* GazerContext::getVariable(llvm::StringRef name)
 {
+    std::lock_guard<std::mutex> lock(pImpl->VariableMutex);
     auto result = pImpl->VariableTable.find(name);
     if (result == pImpl->VariableTable.end()) {
         return nullptr;
@@ -91,6 +93,7 @@ Variable* GazerContext::getVariable(llvm::StringRef name)
 
 void GazerContext::removeVariable(Variable* variable)
 {
+    std::lock_guard<std::mutex> lock(pImpl->VariableMutex);
     auto result = pImpl->VariableTable.find(variable->getName());
     assert(result != pImpl->VariableTable.end() && "Attempting to delete a non-existant variable!");
 
@@ -125,6 +128,8 @@ void ExprStorage::removeFromList(Expr* expr)
 
 void ExprStorage::destroy(Expr *expr)
 {
+    std::lock_guard<std::recursive_mutex> lock(mMutex);
+
     GAZER_DEBUG(llvm::errs()
         << "[ExprStorage] Removing "
         << Expr::getKindName(expr->getKind())
@@ -155,8 +160,8 @@ void ExprStorage::destroy(Expr *expr)
     while (last != nullptr) {
         for (size_t i = 0; i < last->mOperands.size(); ++i) {
             Expr* child = last->getOperand(i).get();
-            if (child->mRefCount == 1) {
-                // If this is the only pointer pointing at the expression, remove it.
+            if (child->mRefCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                // If this was the only pointer pointing at the expression, remove it.
                 this->removeFromList(child);
                 --mEntryCount;
 
@@ -175,8 +180,6 @@ void ExprStorage::destroy(Expr *expr)
                     // If it is a leaf node, just delete it.
                     delete child;
                 }
-            } else {
-                last->mOperands[i]->mRefCount--;
             }
 
             last->mOperands[i].detach();
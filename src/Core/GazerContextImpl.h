@@ -33,6 +33,7 @@
 
 #include <boost/container_hash/hash.hpp>
 
+#include <mutex>
 #include <unordered_set>
 #include <unordered_map>
 
@@ -287,7 +288,8 @@ template<> struct expr_hasher<TupleSelectExpr>
 /// created by a given context.
 ///
 /// Construction is done by calling the (private) constructors of the
-/// befriended expression classes.
+/// befriended expression classes. The storage may be accessed from multiple
+/// threads: lookups, insertions and removals are serialized by a mutex.
 class ExprStorage
 {
     static constexpr size_t DefaultBucketCount = 64;
@@ -356,12 +358,14 @@ private:
     ExprRef<ExprTy> createIfNotExists(ConstructorArgs&&... args)
     {
         auto hash = expr_hasher<ExprTy>::hash_value(args...);
+
+        std::lock_guard<std::recursive_mutex> lock(mMutex);
         Bucket* bucket = &getBucketForHash(hash);
 
         Expr* current = bucket->Ptr;
         while (current != nullptr) {
-            if (expr_hasher<ExprTy>::equals(current, args...)) {
-                return ExprRef<ExprTy>(llvm::cast<ExprTy>(current));
+            if (expr_hasher<ExprTy>::equals(current, args...) && tryRetain(current)) {
+                return ExprRef<ExprTy>(llvm::cast<ExprTy>(current), false);
             }
 
             current = current->mNextPtr;
@@ -401,12 +405,30 @@ private:
         return entries * 4 >= mBucketCount * 3;
     }
 
+    /// Increments the reference counter of \p expr, unless it has already
+    /// dropped to zero and \p expr is waiting to be destroyed by another thread.
+    static bool tryRetain(Expr* expr)
+    {
+        unsigned count = expr->mRefCount.load(std::memory_order_relaxed);
+        while (count != 0) {
+            if (expr->mRefCount.compare_exchange_weak(count, count + 1, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
     void removeFromList(Expr* expr);
 
 private:
     Bucket* mStorage;
     size_t  mBucketCount;
     size_t  mEntryCount = 0;
+
+    // Destroying an expression may release other expressions, which
+    // re-enters the storage on the same thread.
+    std::recursive_mutex mMutex;
 };
 
 class GazerContextImpl
@@ -446,6 +468,10 @@ public:
     ExprRef<BoolLiteralExpr> TrueLit, FalseLit;
     llvm::StringMap<std::unique_ptr<Variable>> VariableTable;
 
+    //------------------ Synchronization ------------------//
+    std::mutex TypeMutex;
+    std::mutex VariableMutex;
+
 private:
 };
 
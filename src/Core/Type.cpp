@@ -141,6 +141,7 @@ auto BvType::Get(GazerContext& context, unsigned width) -> BvType&
             break;
     }
 
+    std::lock_guard<std::mutex> lock(pImpl->TypeMutex);
     auto result = pImpl->BvTypes.find(width);
     if (result == pImpl->BvTypes.end()) {
         auto ptr = new BvType(context, width);
@@ -223,6 +224,7 @@ ArrayType& ArrayType::Get(Type& indexType, Type& elementType)
 
     std::vector<Type*> subtypes = { &indexType, &elementType };
 
+    std::lock_guard<std::mutex> lock(pImpl->TypeMutex);
     auto result = pImpl->ArrayTypes.find(subtypes);
     if (result == pImpl->ArrayTypes.end()) {
         auto ptr = new ArrayType(ctx, subtypes);
@@ -245,6 +247,7 @@ TupleType& TupleType::Get(std::vector<Type*> subtypes)
     auto& ctx = subtypes[0]->getContext();
     auto& pImpl = ctx.pImpl;
 
+    std::lock_guard<std::mutex> lock(pImpl->TypeMutex);
     auto result = pImpl->TupleTypes.find(subtypes);
     if (result == pImpl->TupleTypes.end()) {
         auto ptr = new TupleType(ctx, subtypes);
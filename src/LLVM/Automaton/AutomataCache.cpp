@@ -0,0 +1,353 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "gazer/LLVM/Automaton/AutomataCache.h"
+#include "gazer/Automaton/CfaSerialization.h"
+
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/ADT/StringMap.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IRReader/IRReader.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/SHA1.h>
+#include <llvm/Support/SourceMgr.h>
+#include <llvm/Support/raw_ostream.h>
+
+using namespace gazer;
+
+/// Must be changed whenever the format of cache entries changes.
+static constexpr char CacheFormatVersion[] = "gazer-cfa-cache-1";
+
+static void printSettings(const LLVMFrontendSettings& settings, llvm::raw_ostream& os)
+{
+    os
+        << "trace=" << settings.trace << ";"
+        << "inline=" << static_cast<int>(settings.inlineLevel) << ";"
+        << "inline_globals=" << settings.inlineGlobals << ";"
+        << "optimize=" << settings.optimize << ";"
+        << "lift_asserts=" << settings.liftAsserts << ";"
+        << "slicing=" << settings.slicing << ";"
+        << "accelerate_loops=" << settings.accelerateLoops << ";"
+        << "accelerate_loops_max_stores=" << settings.accelerateLoopsMaxStores << ";"
+        << "checks=" << settings.checks << ";"
+        << "elim_vars=" << static_cast<int>(settings.elimVars) << ";"
+        << "elim_vars_max_size=" << settings.elimVarsMaxSize << ";"
+        << "elim_vars_max_depth=" << settings.elimVarsMaxDepth << ";"
+        << "loops=" << static_cast<int>(settings.loops) << ";"
+        << "ints=" << static_cast<int>(settings.ints) << ";"
+        << "floats=" << static_cast<int>(settings.floats) << ";"
+        << "simplify_expr=" << settings.simplifyExpr << ";"
+        << "large_block_encoding=" << settings.largeBlockEncoding << ";"
+        << "strict=" << settings.strict << ";"
+        << "function=" << settings.function << ";"
+        << "memory=" << static_cast<int>(settings.memoryModel) << ";"
+        << "memory_word_cells=" << settings.memoryWordCells << ";"
+        << "promote_memory=" << settings.promoteMemory << ";"
+        << "memory_flatten_reads=" << settings.memoryFlattenReads << ";";
+}
+
+AutomataCache::AutomataCache(
+    llvm::StringRef directory,
+    const llvm::Module& module,
+    const LLVMFrontendSettings& settings,
+    llvm::StringRef extraOptions
+) : mDirectory(directory)
+{
+    llvm::SmallVector<char, 0> bitcode;
+    llvm::raw_svector_ostream bitcodeOS(bitcode);
+    llvm::WriteBitcodeToFile(module, bitcodeOS);
+
+    std::string settingsStr;
+    llvm::raw_string_ostream settingsOS(settingsStr);
+    printSettings(settings, settingsOS);
+
+    llvm::SHA1 hasher;
+    hasher.update(CacheFormatVersion);
+    hasher.update(settingsOS.str());
+    hasher.update(extraOptions);
+    hasher.update(llvm::StringRef(bitcode.data(), bitcode.size()));
+
+    mKey = llvm::toHex(hasher.final(), /*LowerCase=*/true);
+}
+
+std::string AutomataCache::getPath(llvm::StringRef extension) const
+{
+    llvm::SmallString<128> path = llvm::StringRef(mDirectory);
+    llvm::sys::path::append(path, mKey + extension);
+
+    return path.str().str();
+}
+
+namespace
+{
+
+/// Identifies the blocks and instructions of a function by their position,
+/// which is preserved by writing and reloading the module as bitcode.
+struct FunctionNumbering
+{
+    std::vector<const llvm::BasicBlock*> blocks;
+    std::vector<const llvm::Instruction*> instructions;
+};
+
+} // end anonymous namespace
+
+static FunctionNumbering& getNumbering(
+    llvm::StringMap<FunctionNumbering>& numberings, const llvm::Function& function)
+{
+    auto [it, inserted] = numberings.try_emplace(function.getName());
+    if (inserted) {
+        for (const llvm::BasicBlock& bb : function) {
+            it->second.blocks.push_back(&bb);
+            for (const llvm::Instruction& inst : bb) {
+                it->second.instructions.push_back(&inst);
+            }
+        }
+    }
+
+    return it->second;
+}
+
+bool AutomataCache::writeAtomically(
+    llvm::StringRef extension, llvm::function_ref<void(llvm::raw_ostream&)> writer) const
+{
+    // Write into a temporary file first, so that concurrent gazer runs never
+    // observe partially written entries.
+    llvm::SmallString<128> model = llvm::StringRef(mDirectory);
+    llvm::sys::path::append(model, mKey + "-%%%%%%.tmp");
+
+    int fd;
+    llvm::SmallString<128> tempFile;
+    if (llvm::sys::fs::createUniqueFile(model, fd, tempFile)) {
+        return false;
+    }
+
+    llvm::raw_fd_ostream os(fd, /*shouldClose=*/true);
+    writer(os);
+    os.close();
+
+    if (os.has_error() || llvm::sys::fs::rename(tempFile, this->getPath(extension))) {
+        os.clear_error();
+        llvm::sys::fs::remove(tempFile);
+        return false;
+    }
+
+    return true;
+}
+
+void AutomataCache::store(
+    llvm::Module& module,
+    AutomataSystem& system,
+    const CfaToLLVMTrace& trace,
+    const ErrorMessages& messages) const
+{
+    if (std::error_code ec = llvm::sys::fs::create_directories(mDirectory)) {
+        llvm::errs() << "ERROR: could not create cache directory '" << mDirectory << "': "
+            << ec.message() << "\n";
+        return;
+    }
+
+    // The automata are written last, as their presence marks a complete entry.
+    bool success = this->writeAtomically(".bc", [&module](llvm::raw_ostream& os) {
+        llvm::WriteBitcodeToFile(module, os);
+    });
+
+    if (!success) {
+        return;
+    }
+
+    this->writeAtomically(".cfa", [&](llvm::raw_ostream& os) {
+        AutomataSystemWriter writer(os);
+        writer.write(system);
+
+        llvm::StringMap<FunctionNumbering> numberings;
+        for (auto& [loc, info] : trace.mLocationsToBlocks) {
+            // Locations removed by later CFA transformations may still be present.
+            auto location = const_cast<Location*>(loc);
+            if (info.block == nullptr || !writer.hasLocation(location)) {
+                continue;
+            }
+
+            auto& numbering = getNumbering(numberings, *info.block->getParent());
+            auto bbIdx = std::find(numbering.blocks.begin(), numbering.blocks.end(), info.block)
+                - numbering.blocks.begin();
+
+            writer.beginRecord("block");
+            writer.writeField(writer.getLocationNumber(location));
+            writer.writeField(info.block->getParent()->getName());
+            writer.writeField(bbIdx);
+            writer.writeField(static_cast<unsigned>(info.kind));
+            writer.endRecord();
+        }
+
+        for (auto& [cfa, mapping] : trace.mValueMaps) {
+            for (auto& [val, expr] : mapping.values) {
+                // Only LLVM values are queried by the trace builder.
+                if (!val.isValue() || expr == nullptr) {
+                    continue;
+                }
+
+                const llvm::Value* value = val.asValue();
+                llvm::StringRef kind;
+                llvm::StringRef name;
+                size_t index = 0;
+
+                if (auto arg = llvm::dyn_cast<llvm::Argument>(value)) {
+                    kind = "arg";
+                    name = arg->getParent()->getName();
+                    index = arg->getArgNo();
+                } else if (auto inst = llvm::dyn_cast<llvm::Instruction>(value)) {
+                    auto& numbering = getNumbering(numberings, *inst->getFunction());
+                    kind = "inst";
+                    name = inst->getFunction()->getName();
+                    index = std::find(numbering.instructions.begin(), numbering.instructions.end(), inst)
+                        - numbering.instructions.begin();
+                } else if (auto gv = llvm::dyn_cast<llvm::GlobalValue>(value)) {
+                    kind = "global";
+                    name = gv->getName();
+                } else {
+                    continue;
+                }
+
+                unsigned exprNum = writer.writeExpr(expr);
+                writer.beginRecord("value");
+                writer.writeField(writer.getAutomatonNumber(const_cast<Cfa*>(cfa)));
+                writer.writeField(kind);
+                writer.writeField(name);
+                writer.writeField(index);
+                writer.writeField(exprNum);
+                writer.endRecord();
+            }
+        }
+
+        for (auto& [ec, message] : messages) {
+            writer.beginRecord("message");
+            writer.writeField(ec);
+            writer.writeField(message);
+            writer.endRecord();
+        }
+    });
+}
+
+bool AutomataCache::lookup(GazerContext& context, llvm::LLVMContext& llvmContext, Entry& entry) const
+{
+    auto buffer = llvm::MemoryBuffer::getFile(this->getPath(".cfa"));
+    if (!buffer) {
+        return false;
+    }
+
+    llvm::SMDiagnostic err;
+    std::unique_ptr<llvm::Module> module = llvm::parseIRFile(this->getPath(".bc"), err, llvmContext);
+    if (module == nullptr) {
+        return false;
+    }
+
+    AutomataSystemReader reader(context, (*buffer)->getBuffer());
+    std::unique_ptr<AutomataSystem> system = reader.read();
+    if (system == nullptr) {
+        return false;
+    }
+
+    CfaToLLVMTrace trace;
+    ErrorMessages messages;
+    llvm::StringMap<FunctionNumbering> numberings;
+
+    auto getFunctionNumbering = [&](llvm::StringRef name) -> FunctionNumbering* {
+        llvm::Function* function = module->getFunction(name);
+        if (function == nullptr) {
+            return nullptr;
+        }
+        return &getNumbering(numberings, *function);
+    };
+
+    llvm::StringRef tag;
+    while (reader.nextRecord(tag)) {
+        bool success = false;
+        if (tag == "block") {
+            uint64_t locNum, bbIdx, kind;
+            llvm::StringRef fname;
+            if (reader.readField(locNum) && reader.readField(fname)
+                && reader.readField(bbIdx) && reader.readField(kind)
+            ) {
+                Location* loc = reader.getLocation(locNum);
+                FunctionNumbering* numbering = getFunctionNumbering(fname);
+                success = loc != nullptr && numbering != nullptr
+                    && bbIdx < numbering->blocks.size()
+                    && kind <= CfaToLLVMTrace::Location_Exit;
+
+                if (success) {
+                    trace.mLocationsToBlocks[loc] = {
+                        numbering->blocks[bbIdx], static_cast<CfaToLLVMTrace::LocationKind>(kind)
+                    };
+                }
+            }
+        } else if (tag == "value") {
+            uint64_t cfaNum, index, exprNum;
+            llvm::StringRef kind, name;
+            if (reader.readField(cfaNum) && reader.readField(kind) && reader.readField(name)
+                && reader.readField(index) && reader.readField(exprNum)
+            ) {
+                const llvm::Value* value = nullptr;
+                if (kind == "global") {
+                    value = module->getNamedValue(name);
+                } else if (kind == "arg") {
+                    llvm::Function* function = module->getFunction(name);
+                    if (function != nullptr && index < function->arg_size()) {
+                        value = function->arg_begin() + index;
+                    }
+                } else if (kind == "inst") {
+                    FunctionNumbering* numbering = getFunctionNumbering(name);
+                    if (numbering != nullptr && index < numbering->instructions.size()) {
+                        value = numbering->instructions[index];
+                    }
+                }
+
+                Cfa* cfa = reader.getAutomaton(cfaNum);
+                ExprPtr expr = reader.getExpr(exprNum);
+                success = value != nullptr && cfa != nullptr && expr != nullptr;
+
+                if (success) {
+                    trace.mValueMaps[cfa].values[value] = expr;
+                }
+            }
+        } else if (tag == "message") {
+            uint64_t ec;
+            llvm::StringRef message;
+            success = reader.readField(ec) && reader.readField(message);
+            if (success) {
+                messages.emplace_back(ec, message.str());
+            }
+        }
+
+        if (!success || !reader.endRecord()) {
+            return false;
+        }
+    }
+
+    if (reader.hasError()) {
+        return false;
+    }
+
+    entry.module = std::move(module);
+    entry.system = std::move(system);
+    entry.trace = std::move(trace);
+    entry.messages = std::move(messages);
+
+    return true;
+}
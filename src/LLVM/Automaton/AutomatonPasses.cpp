@@ -56,13 +56,19 @@ char ModuleToAutomataPass::ID;
 
 void ModuleToAutomataPass::getAnalysisUsage(llvm::AnalysisUsage& au) const
 {
-    au.addRequired<llvm::DominatorTreeWrapperPass>();
-    au.addRequired<MemoryModelWrapperPass>();
+    if (!mPreloaded) {
+        au.addRequired<llvm::DominatorTreeWrapperPass>();
+        au.addRequired<MemoryModelWrapperPass>();
+    }
     au.setPreservesAll();
 }
 
 bool ModuleToAutomataPass::runOnModule(llvm::Module& module)
 {
+    if (mPreloaded) {
+        return false;
+    }
+
     // We need to save loop information here as a on-the-fly LoopInfo pass would delete
     // the acquired loop information when the lambda function exits.
     llvm::DenseMap<const llvm::Function*, std::unique_ptr<llvm::LoopInfo>> loopInfos;
@@ -96,6 +102,12 @@ bool ModuleToAutomataPass::runOnModule(llvm::Module& module)
 
         // TODO: We should translate automata other than the main in this case.
         TransformRecursiveToCyclic(mSystem->getMainAutomaton());
+    } else if (mSettings.largeBlockEncoding && !mSettings.trace) {
+        // Merged locations disappear from the automata, thus their blocks would
+        // be missing from error traces. Only do this if no trace was requested.
+        for (Cfa& cfa : *mSystem) {
+            TransformLargeBlockEncoding(&cfa);
+        }
     }
 
     return false;
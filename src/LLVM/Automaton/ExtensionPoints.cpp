@@ -176,6 +176,11 @@ bool BlocksToCfa::ExtensionPointImpl::tryToEliminate(ValueOrMemoryObject val, Va
     return mBlocksToCfa.tryToEliminate(val, variable, expr);
 }
 
+bool BlocksToCfa::ExtensionPointImpl::tryToInline(ValueOrMemoryObject val, Variable* variable, const ExprPtr& expr)
+{
+    return mBlocksToCfa.tryToInline(val, variable, expr);
+}
+
 void BlocksToCfa::ExtensionPointImpl::insertAssignment(Variable* variable, const ExprPtr& value)
 {
     mAssigns.emplace_back(variable, value);
@@ -35,6 +35,7 @@
 #include <llvm/Analysis/LoopInfo.h>
 #include <llvm/ADT/MapVector.h>
 
+#include <mutex>
 #include <variant>
 
 namespace gazer
@@ -214,6 +215,7 @@ public:
         const llvm::BasicBlock* bb, Location* loc, CfaToLLVMTrace::LocationKind kind
     ) {
         if (mSettings.trace) {
+            std::lock_guard<std::mutex> lock(mTraceMutex);
             mTraceInfo.mLocationsToBlocks[loc] = { bb, kind };
         }
     }
@@ -221,6 +223,7 @@ public:
     void addExprValueIfTraceEnabled(Cfa* cfa, ValueOrMemoryObject value, ExprPtr expr)
     {
         if (mSettings.trace) {
+            std::lock_guard<std::mutex> lock(mTraceMutex);
             mTraceInfo.mValueMaps[cfa].values[value] = std::move(expr);
         }
     }
@@ -265,6 +268,7 @@ private:
     const LLVMFrontendSettings& mSettings;
     std::unordered_map<VariantT, CfaGenInfo> mProcedures;
     CfaToLLVMTrace mTraceInfo;
+    std::mutex mTraceMutex;
     unsigned mTmp = 0;
 };
 
@@ -292,6 +296,12 @@ public:
 protected:
     void createAutomata();
 
+    /// Encodes the procedures of each function in a separate task on a pool
+    /// of \p numThreads threads.
+    void encodeParallel(unsigned numThreads);
+
+    std::unique_ptr<ExprBuilder> createExprBuilder() const;
+
     void declareLoopVariables(
         llvm::Loop* loop, CfaGenInfo& loopGenInfo,
         MemoryInstructionHandler& memoryInstHandler,
@@ -333,6 +343,7 @@ protected:
 
         ExprPtr getAsOperand(ValueOrMemoryObject val) override;
         bool tryToEliminate(ValueOrMemoryObject val, Variable* variable, const ExprPtr& expr) override;
+        bool tryToInline(ValueOrMemoryObject val, Variable* variable, const ExprPtr& expr) override;
         void insertAssignment(Variable* variable, const ExprPtr& value) override;
 
         void splitCurrentTransition(const ExprPtr& guard) override;
@@ -367,6 +378,7 @@ private:
 
 private:
     bool tryToEliminate(ValueOrMemoryObject val, Variable* variable, const ExprPtr& expr);
+    bool tryToInline(ValueOrMemoryObject val, Variable* variable, const ExprPtr& expr);
 
     void insertOutputAssignments(CfaGenInfo& callee, std::vector<VariableAssignment>& outputArgs);
     void insertPhiAssignments(const llvm::BasicBlock* source, const llvm::BasicBlock* target, std::vector<VariableAssignment>& phiAssignments);
@@ -792,25 +792,27 @@ ExprPtr InstToExpr::operand(ValueOrMemoryObject value)
     llvm_unreachable("Invalid ValueOrMemoryObject state!");
 }
 
-ExprPtr InstToExpr::operandValue(const llvm::Value* value)
+ExprPtr InstToExpr::integerLiteral(const llvm::APInt& value)
 {
-    if (auto ci = dyn_cast<ConstantInt>(value)) {
-        // Check for boolean literals
-        if (ci->getType()->isIntegerTy(1)) {
-            return ci->isZero() ? mExprBuilder.False() : mExprBuilder.True();
-        }
+    // Check for boolean literals
+    if (value.getBitWidth() == 1) {
+        return value.isNullValue() ? mExprBuilder.False() : mExprBuilder.True();
+    }
 
-        switch (mSettings.ints) {
-            case IntRepresentation::BitVectors:
-                return mExprBuilder.BvLit(
-                    ci->getValue().getLimitedValue(),
-                    ci->getType()->getIntegerBitWidth()
-                );
-            case IntRepresentation::Integers:
-                return mExprBuilder.IntLit(ci->getSExtValue());
-        }
+    switch (mSettings.ints) {
+        case IntRepresentation::BitVectors:
+            return mExprBuilder.BvLit(value.getLimitedValue(), value.getBitWidth());
+        case IntRepresentation::Integers:
+            return mExprBuilder.IntLit(value.getSExtValue());
+    }
 
-        llvm_unreachable("Invalid int representation strategy!");
+    llvm_unreachable("Invalid int representation strategy!");
+}
+
+ExprPtr InstToExpr::operandValue(const llvm::Value* value)
+{
+    if (auto ci = dyn_cast<ConstantInt>(value)) {
+        return this->integerLiteral(ci->getValue());
     }
     
     if (auto cfp = dyn_cast<llvm::ConstantFP>(value)) {
@@ -822,8 +824,16 @@ ExprPtr InstToExpr::operandValue(const llvm::Value* value)
         std::vector<ExprRef<LiteralExpr>> elements;
         elements.reserve(ca->getNumElements());
         for (unsigned i = 0; i < ca->getNumElements(); ++i) {
-            llvm::Constant* constantElem = ca->getElementAsConstant(i);
-            ExprPtr constantExpr = this->operandValue(constantElem);
+            // The elements are read directly, as creating a constant for them would
+            // modify the LLVMContext, which may be shared between translation threads.
+            ExprPtr constantExpr;
+            if (auto intTy = dyn_cast<llvm::IntegerType>(ca->getElementType())) {
+                constantExpr = this->integerLiteral(
+                    llvm::APInt(intTy->getBitWidth(), ca->getElementAsInteger(i))
+                );
+            } else {
+                constantExpr = mExprBuilder.FloatLit(ca->getElementAsAPFloat(i));
+            }
 
             assert(llvm::isa<LiteralExpr>(constantExpr)
                 && "Constants should be translated to literals!");
@@ -25,6 +25,7 @@
 
 #include "gazer/LLVM/Memory/MemoryModel.h"
 #include "gazer/LLVM/Instrumentation/Check.h"
+#include "gazer/LLVM/Instrumentation/Intrinsics.h"
 
 #include "gazer/Automaton/Cfa.h"
 #include "gazer/Core/Expr/ExprBuilder.h"
@@ -38,6 +39,9 @@
 #include <llvm/Analysis/LoopInfo.h>
 #include <llvm/IR/InstIterator.h>
 #include <llvm/ADT/StringExtras.h>
+#include <llvm/ADT/STLExtras.h>
+#include <llvm/Support/ThreadPool.h>
+#include <llvm/Support/Threading.h>
 
 #define DEBUG_TYPE "ModuleToCfa"
 
@@ -232,12 +236,17 @@ ModuleToCfa::ModuleToCfa(
     mSettings(settings),
     mSystem(new AutomataSystem(context)),
     mGenCtx(*mSystem, mMemoryModel, types, std::move(loops), specialFunctions, settings)
+{
+    mExprBuilder = this->createExprBuilder();
+}
+
+std::unique_ptr<ExprBuilder> ModuleToCfa::createExprBuilder() const
 {
     if (mSettings.simplifyExpr) {
-        mExprBuilder = CreateFoldingExprBuilder(mContext);
-    } else {
-        mExprBuilder = CreateExprBuilder(mContext);
+        return CreateFoldingExprBuilder(mContext);
     }
+
+    return CreateExprBuilder(mContext);
 }
 
 std::unique_ptr<AutomataSystem> ModuleToCfa::generate(
@@ -248,13 +257,22 @@ std::unique_ptr<AutomataSystem> ModuleToCfa::generate(
     this->createAutomata();
 
     // Encode all loops and functions
-    for (auto& [source, genInfo] : mGenCtx.procedures()) {
-        LLVM_DEBUG(llvm::dbgs() << "Encoding function CFA " << genInfo.Automaton->getName() << "\n");
+    unsigned numThreads = mSettings.cfaThreads;
+    if (numThreads == 0) {
+        numThreads = llvm::heavyweight_hardware_concurrency();
+    }
+
+    if (numThreads > 1) {
+        this->encodeParallel(numThreads);
+    } else {
+        for (auto& [source, genInfo] : mGenCtx.procedures()) {
+            LLVM_DEBUG(llvm::dbgs() << "Encoding function CFA " << genInfo.Automaton->getName() << "\n");
 
-        BlocksToCfa blocksToCfa(mGenCtx, genInfo, *mExprBuilder);
+            BlocksToCfa blocksToCfa(mGenCtx, genInfo, *mExprBuilder);
 
-        // Do the actual encoding.
-        blocksToCfa.encode();
+            // Do the actual encoding.
+            blocksToCfa.encode();
+        }
     }
 
     // CFAs must be connected graphs. Remove unreachable components now.
@@ -277,6 +295,39 @@ std::unique_ptr<AutomataSystem> ModuleToCfa::generate(
     return std::move(mSystem);
 }
 
+void ModuleToCfa::encodeParallel(unsigned numThreads)
+{
+    // Once the interfaces are set up, procedures only read each other's
+    // generation info. The procedures of a function share the memory
+    // instruction handler of that function, so they are encoded in one task.
+    llvm::MapVector<llvm::Function*, std::vector<CfaGenInfo*>> functionProcedures;
+    for (auto& [source, genInfo] : mGenCtx.procedures()) {
+        functionProcedures[genInfo.getEntryBlock()->getParent()].push_back(&genInfo);
+    }
+
+    // Schedule the largest functions first to keep the workers balanced.
+    auto tasks = functionProcedures.takeVector();
+    llvm::sort(tasks, [](auto& lhs, auto& rhs) {
+        return lhs.first->size() > rhs.first->size();
+    });
+
+    llvm::ThreadPool pool(numThreads);
+    for (auto& task : tasks) {
+        pool.async([this, &task]() {
+            // Each task uses its own expression builder.
+            auto exprBuilder = this->createExprBuilder();
+            for (CfaGenInfo* genInfo : task.second) {
+                LLVM_DEBUG(llvm::dbgs() << "Encoding function CFA " << genInfo->Automaton->getName() << "\n");
+
+                BlocksToCfa blocksToCfa(mGenCtx, *genInfo, *exprBuilder);
+                blocksToCfa.encode();
+            }
+        });
+    }
+
+    pool.wait();
+}
+
 void ModuleToCfa::createAutomata()
 {
     // Create an automaton for each function definition and set the interfaces.
@@ -627,9 +678,17 @@ bool BlocksToCfa::handleCall(const llvm::CallInst* call, Location** entry, Locat
         llvm::Value* arg = call->getArgOperand(0);
         ExprPtr errorCodeExpr = operand(arg);
         mCfa->addErrorCode(exit, errorCodeExpr);
-    } else {
-        // Try to handle this value as a special function.
-        mGenCtx.getSpecialFunctions().handle(call, callerEP);
+    } else if (callee->getName() == GazerIntrinsic::ValidAccessName) {
+        // Memory safety predicates are encoded by the memory model.
+        ExprPtr valid = mMemoryInstHandler.isValidAccess(const_cast<llvm::CallInst*>(call), callerEP);
+        callerEP.insertAssignment(getVariable(call), valid);
+        return false;
+    } else if (!mGenCtx.getSpecialFunctions().handle(call, callerEP)) {
+        // Let the memory model handle the remaining external calls, including
+        // the library functions it models.
+        bool hasResult = mMemoryInstHandler.handleExternalCall(
+            const_cast<llvm::CallInst*>(call), callerEP);
+        return !hasResult;
     }
 
     return true;
@@ -719,7 +778,7 @@ bool BlocksToCfa::tryToEliminate(ValueOrMemoryObject val, Variable* variable, co
             return llvm::isa<Instruction>(v) && mInlinedVars.count(llvm::cast<Instruction>(v)) != 0;
         });
 
-        if (!mGenCtx.getSettings().isElimVarsAggressive()
+        if (mGenCtx.getSettings().isElimVarsNormal()
             && getNumUsesInBlocks(inst) > 1
             && hasInlinedOperands
         ) {
@@ -727,6 +786,39 @@ bool BlocksToCfa::tryToEliminate(ValueOrMemoryObject val, Variable* variable, co
         }
     }
 
+    if (mGenCtx.getSettings().isElimVarsBounded()) {
+        // Values described by debug intrinsics are shown in error traces,
+        // keep them as variables so their values are read directly from the model.
+        if (mGenCtx.getSettings().trace && val.isValue() && val.asValue()->isUsedByMetadata()) {
+            return false;
+        }
+
+        // The operands of the expression are already inlined, so the
+        // budget applies to the whole formula built so far.
+        if (!IsExprWithinBounds(
+            expr, mGenCtx.getSettings().elimVarsMaxSize, mGenCtx.getSettings().elimVarsMaxDepth)
+        ) {
+            return false;
+        }
+    }
+
+    mInlinedVars[val] = expr;
+    mGenCtx.addExprValueIfTraceEnabled(mGenInfo.Automaton, val, expr);
+    mEliminatedVarsSet.insert(variable);
+    return true;
+}
+
+bool BlocksToCfa::tryToInline(ValueOrMemoryObject val, Variable* variable, const ExprPtr& expr)
+{
+    // Call results and outputs must be kept, see tryToEliminate.
+    if (llvm::isa<llvm::CallInst>(val) || llvm::isa<memory::CallDef>(val)) {
+        return false;
+    }
+
+    if (mGenInfo.LoopOutputs.count(val) != 0 || mGenInfo.Outputs.count(val) != 0) {
+        return false;
+    }
+
     mInlinedVars[val] = expr;
     mGenCtx.addExprValueIfTraceEnabled(mGenInfo.Automaton, val, expr);
     mEliminatedVarsSet.insert(variable);
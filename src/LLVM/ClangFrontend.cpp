@@ -18,14 +18,32 @@
 #include "gazer/LLVM/ClangFrontend.h"
 
 #include <llvm/Support/Path.h>
+#include <llvm/Support/Process.h>
 #include <llvm/Support/Program.h>
 #include <llvm/Support/FileSystem.h>
 #include <llvm/IR/Module.h>
+#include <llvm/Linker/Linker.h>
 
 #include <llvm/Support/SourceMgr.h>
 #include <llvm/Support/CommandLine.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/SHA1.h>
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/ADT/STLExtras.h>
 #include <llvm/IRReader/IRReader.h>
 
+#ifdef GAZER_ENABLE_CLANG_LIBS
+#include <clang/Basic/Diagnostic.h>
+#include <clang/Basic/DiagnosticOptions.h>
+#include <clang/CodeGen/CodeGenAction.h>
+#include <clang/Frontend/CompilerInstance.h>
+#include <clang/Frontend/CompilerInvocation.h>
+#include <clang/Frontend/Utils.h>
+#endif
+
+#include <chrono>
+#include <thread>
+
 using namespace llvm;
 
 namespace gazer
@@ -50,104 +68,368 @@ namespace
         cl::desc("Enable the specified warning"),
         cl::cat(gazer::ClangFrontendCategory)
     );
+    cl::opt<unsigned> Jobs("j",
+        cl::desc("Compile at most N translation units in parallel"),
+        cl::value_desc("N"),
+        cl::init(1),
+        cl::cat(gazer::ClangFrontendCategory)
+    );
+    cl::opt<std::string> CacheDirectory("clang-cache-dir",
+        cl::desc("Reuse the bitcode of unchanged translation units from the given cache directory"),
+        cl::value_desc("dir"),
+        cl::cat(gazer::ClangFrontendCategory)
+    );
+
+    /// A running clang process working on a single translation unit. If the
+    /// cache is enabled, the unit is preprocessed first to compute its cache
+    /// key, and it is only compiled on a cache miss.
+    struct ClangJob
+    {
+        enum Stage { Preprocess, Compile };
+
+        size_t index;
+        std::string input;
+        std::string inputPath;
+        std::string preprocessedPath;
+        Stage stage;
+        llvm::sys::ProcessInfo process;
+    };
+
+    enum class JobState { Running, Done, Failed };
 } // end anonymous namespace
 
-static bool executeClang(
-    llvm::StringRef clang, llvm::StringRef input,
-    llvm::StringRef output, llvm::ArrayRef<std::string> flags)
+static bool checkClangResult(int returnCode, const std::string& clangErrors)
+{
+    if (returnCode == -1) {
+        llvm::errs() << "ERROR: failed to execute clang:"
+            << (clangErrors.empty() ? "Unknown error." : clangErrors) << "\n";
+        return false;
+    }
+
+    if (returnCode != 0) {
+        llvm::errs() << "ERROR: clang exited with a non-zero exit code.\n";
+        return false;
+    }
+
+    return true;
+}
+
+/// Returns the clang arguments shared by preprocessing and compilation.
+static std::vector<std::string> createClangArguments(llvm::ArrayRef<std::string> flags)
 {
     // Build our clang configuration
-    std::vector<llvm::StringRef> clangArgs = {
-        clang,
+    std::vector<std::string> clangArgs = {
         "-g",
         // In the newer (>=5.0) versions of clang, -O0 marks functions
         // with a 'not optimizable' flag, which can break the functionality
         // of gazer. Here we request optimizations with -O1 and turn them off
         // immediately by disabling all LLVM passes.
         "-O1", "-Xclang", "-disable-llvm-passes",
-        "-c", "-emit-llvm",
     };
 
     // Add -I and -D options correctly
-    std::vector<std::string> prefixedStrings;
     for (auto& include : Includes) {
-        prefixedStrings.push_back("-I" + include);
+        clangArgs.push_back("-I" + include);
     }
     for (auto& define : Defines) {
-        prefixedStrings.push_back("-D" + define);
+        clangArgs.push_back("-D" + define);
     }
     for (auto& warning : Warnings) {
-        prefixedStrings.push_back("-W" + warning);
+        clangArgs.push_back("-W" + warning);
     }
 
-    clangArgs.insert(clangArgs.end(), prefixedStrings.begin(), prefixedStrings.end());
-
     // Add other custom args
     clangArgs.insert(clangArgs.end(), flags.begin(), flags.end());
 
+    return clangArgs;
+}
+
+/// Starts compiling \p input into \p output without waiting for clang to finish.
+static bool startClang(
+    llvm::StringRef clang, llvm::StringRef input,
+    llvm::StringRef output, llvm::ArrayRef<std::string> commonArgs,
+    llvm::sys::ProcessInfo& process)
+{
+    std::vector<llvm::StringRef> clangArgs = { clang };
+    clangArgs.insert(clangArgs.end(), commonArgs.begin(), commonArgs.end());
     clangArgs.insert(clangArgs.end(), {
-        input, "-o", output
+        "-c", "-emit-llvm", input, "-o", output
     });
 
     std::string clangErrors;
+    bool executionFailed = false;
 
-    int returnCode = llvm::sys::ExecuteAndWait(
+    process = llvm::sys::ExecuteNoWait(
         clang,
         clangArgs,
         /*env=*/llvm::None,
-        /*redirects=*/llvm::None,
-        /*secondsToWait=*/0,
+        /*redirects=*/{},
         /*memoryLimit=*/0,
-        &clangErrors
+        &clangErrors,
+        &executionFailed
     );
 
-    if (returnCode == -1) {
-        llvm::errs() << "ERROR: failed to execute clang:"
-            << (clangErrors.empty() ? "Unknown error." : clangErrors) << "\n";
-        return false;
+    if (executionFailed) {
+        return checkClangResult(-1, clangErrors);
     }
 
-    if (returnCode != 0) {
-        llvm::errs() << "ERROR: clang exited with a non-zero exit code.\n";
-        return false;
+    return true;
+}
+
+#ifdef GAZER_ENABLE_CLANG_LIBS
+
+/// Compiles \p input with the clang libraries directly into \p llvmContext.
+static std::unique_ptr<llvm::Module> compileInProcess(
+    const std::string& clang, const std::string& input,
+    llvm::ArrayRef<std::string> commonArgs, llvm::LLVMContext& llvmContext)
+{
+    // The driver derives the resource directory, and thus the location of
+    // the builtin headers, from the path of the clang executable.
+    std::vector<const char*> clangArgs = { clang.c_str() };
+    for (const std::string& arg : commonArgs) {
+        clangArgs.push_back(arg.c_str());
     }
+    clangArgs.insert(clangArgs.end(), { "-c", "-emit-llvm", input.c_str() });
 
-    return true;
+    llvm::IntrusiveRefCntPtr<clang::DiagnosticOptions> diagOpts = new clang::DiagnosticOptions();
+    llvm::IntrusiveRefCntPtr<clang::DiagnosticsEngine> diags =
+        clang::CompilerInstance::createDiagnostics(diagOpts.get());
+
+    std::shared_ptr<clang::CompilerInvocation> invocation =
+        clang::createInvocationFromCommandLine(clangArgs, diags);
+    if (invocation == nullptr) {
+        return nullptr;
+    }
+
+    clang::CompilerInstance compiler;
+    compiler.setInvocation(std::move(invocation));
+    compiler.createDiagnostics();
+
+    clang::EmitLLVMOnlyAction action(&llvmContext);
+    if (!compiler.ExecuteAction(action)) {
+        return nullptr;
+    }
+
+    return action.takeModule();
 }
 
-static bool executeLinker(llvm::StringRef linker, const std::vector<std::string>& bitcodeFiles, llvm::StringRef output)
+/// Compiles and links the input files one after another within the current
+/// process. No temporary files are written and no bitcode is parsed again.
+static std::unique_ptr<llvm::Module> compileAndLinkInProcess(
+    llvm::ArrayRef<std::string> files, const std::string& clang,
+    llvm::ArrayRef<std::string> clangArgs, llvm::LLVMContext& llvmContext)
 {
-    std::vector<llvm::StringRef> linkerArgs;
-    linkerArgs.emplace_back(linker);
-    linkerArgs.insert(linkerArgs.end(), bitcodeFiles.begin(), bitcodeFiles.end());
-    linkerArgs.emplace_back("-o");
-    linkerArgs.emplace_back(output);
+    auto result = std::make_unique<llvm::Module>("gazer_llvm_output", llvmContext);
+    llvm::Linker linker(*result);
+    llvm::SMDiagnostic err;
 
-    std::string linkerErrors;
-    int returnCode = llvm::sys::ExecuteAndWait(
-        linker,
-        linkerArgs,
-        /*env=*/llvm::None,
-        /*redirects=*/llvm::None,
-        /*secondsToWait=*/0,
-        /*memoryLimit=*/0,
-        &linkerErrors
-    );
+    for (llvm::StringRef inputFile : files) {
+        std::unique_ptr<llvm::Module> module;
+        if (inputFile.endswith_lower(".bc") || inputFile.endswith_lower(".ll")) {
+            module = llvm::parseIRFile(inputFile, err, llvmContext);
+            if (module == nullptr) {
+                err.print(nullptr, llvm::errs());
+                return nullptr;
+            }
+        } else if (inputFile.endswith_lower(".c")) {
+            llvm::SmallString<128> inputPath = inputFile;
+            llvm::sys::fs::make_absolute(inputPath);
+
+            module = compileInProcess(clang, inputPath.str().str(), clangArgs, llvmContext);
+            if (module == nullptr) {
+                llvm::errs() << "Failed to compile input file '" << inputFile << "'.\n";
+                return nullptr;
+            }
+        } else {
+            llvm::errs() << "Cannot compile source file " << inputFile << ".\n"
+            << "Supported extensions are: .c, .bc, .ll\n";
+            return nullptr;
+        }
 
-    if (returnCode == -1) {
-        llvm::errs() << "ERROR: failed to execute llvm-link:"
-            << (linkerErrors.empty() ? "Unknown error." : linkerErrors) << "\n";
+        if (linker.linkInModule(std::move(module))) {
+            llvm::errs() << "ERROR: failed to link input file '" << inputFile << "'.\n";
+            return nullptr;
+        }
+    }
+
+    return result;
+}
+
+#endif
+
+namespace
+{
+
+/// A persistent cache of compiled translation units. Entries are keyed by
+/// the hash of the clang version, the clang arguments and the preprocessed
+/// source. The preprocessed source contains the path of each included file,
+/// thus the debug locations of cached bitcode files are always accurate.
+class BitcodeCache
+{
+public:
+    BitcodeCache(llvm::StringRef directory, llvm::StringRef clang, llvm::ArrayRef<std::string> args)
+        : mDirectory(directory), mClang(clang), mArgs(args)
+    {}
+
+    /// Creates the cache directory and queries the version of clang.
+    bool init(llvm::StringRef workingDir);
+
+    /// Starts preprocessing \p input into \p output without waiting for clang to finish.
+    bool startPreprocess(llvm::StringRef input, llvm::StringRef output, llvm::sys::ProcessInfo& process);
+
+    /// Returns the key of the preprocessed source file \p preprocessed,
+    /// or an empty string if the key could not be computed.
+    std::string computeKey(llvm::StringRef preprocessed);
+
+    /// Returns the path of the cached bitcode file for \p key.
+    std::string getPath(llvm::StringRef key) const;
+
+    bool contains(llvm::StringRef key) const {
+        return llvm::sys::fs::exists(this->getPath(key));
+    }
+
+    /// Stores a copy of \p bitcodeFile under \p key.
+    void store(llvm::StringRef bitcodeFile, llvm::StringRef key);
+
+private:
+    std::string mDirectory;
+    std::string mClang;
+    llvm::ArrayRef<std::string> mArgs;
+    std::string mVersion;
+};
+
+} // end anonymous namespace
+
+bool BitcodeCache::init(llvm::StringRef workingDir)
+{
+    if (std::error_code ec = llvm::sys::fs::create_directories(mDirectory)) {
+        llvm::errs() << "ERROR: could not create cache directory '" << mDirectory << "': "
+            << ec.message() << "\n";
         return false;
     }
 
-    if (returnCode != 0) {
-        llvm::errs() << "ERROR: llvm-link exited with a non-zero exit code.\n";
+    llvm::SmallString<128> versionFile = workingDir;
+    llvm::sys::path::append(versionFile, "clang_version.txt");
+
+    llvm::Optional<llvm::StringRef> redirects[] = { llvm::None, llvm::StringRef(versionFile), llvm::None };
+    llvm::StringRef versionArgs[] = { mClang, "--version" };
+    int returnCode = llvm::sys::ExecuteAndWait(mClang, versionArgs, llvm::None, redirects);
+
+    auto buffer = llvm::MemoryBuffer::getFile(versionFile);
+    if (returnCode != 0 || !buffer) {
+        llvm::errs() << "ERROR: could not determine the version of clang.\n";
         return false;
     }
 
+    mVersion = (*buffer)->getBuffer().str();
     return true;
 }
 
+bool BitcodeCache::startPreprocess(
+    llvm::StringRef input, llvm::StringRef output, llvm::sys::ProcessInfo& process)
+{
+    std::vector<llvm::StringRef> clangArgs = { mClang };
+    clangArgs.insert(clangArgs.end(), mArgs.begin(), mArgs.end());
+    clangArgs.insert(clangArgs.end(), { "-E", input, "-o", output });
+
+    // Errors are not reported here, the compilation will report them.
+    bool executionFailed = false;
+    process = llvm::sys::ExecuteNoWait(
+        mClang, clangArgs, llvm::None, llvm::None, 0, nullptr, &executionFailed);
+
+    return !executionFailed;
+}
+
+std::string BitcodeCache::computeKey(llvm::StringRef preprocessed)
+{
+    auto buffer = llvm::MemoryBuffer::getFile(preprocessed);
+    if (!buffer) {
+        return "";
+    }
+
+    llvm::SHA1 hasher;
+    hasher.update(mVersion);
+    for (const std::string& arg : mArgs) {
+        hasher.update(arg);
+        hasher.update(llvm::StringRef("\0", 1));
+    }
+    hasher.update((*buffer)->getBuffer());
+
+    llvm::sys::fs::remove(preprocessed);
+
+    return llvm::toHex(hasher.final(), /*LowerCase=*/true);
+}
+
+std::string BitcodeCache::getPath(llvm::StringRef key) const
+{
+    llvm::SmallString<128> path = llvm::StringRef(mDirectory);
+    llvm::sys::path::append(path, key + ".bc");
+
+    return path.str().str();
+}
+
+void BitcodeCache::store(llvm::StringRef bitcodeFile, llvm::StringRef key)
+{
+    // Copy into a temporary file first, so that concurrent gazer runs never
+    // observe partially written entries.
+    llvm::SmallString<128> model = llvm::StringRef(mDirectory);
+    llvm::sys::path::append(model, key + "-%%%%%%.tmp");
+
+    int fd;
+    llvm::SmallString<128> tempFile;
+    if (llvm::sys::fs::createUniqueFile(model, fd, tempFile)) {
+        return;
+    }
+    llvm::sys::Process::SafelyCloseFileDescriptor(fd);
+
+    if (llvm::sys::fs::copy_file(bitcodeFile, tempFile)
+        || llvm::sys::fs::rename(tempFile, this->getPath(key))
+    ) {
+        llvm::sys::fs::remove(tempFile);
+    }
+}
+
+/// Waits until at most \p maxRunning jobs are running. When the process of a
+/// job finishes, \p onFinished is called with its return code and errors. It
+/// may start the next stage of the job, otherwise the job is removed from
+/// \p jobs. Returns false if any of the finished jobs failed.
+static bool waitForClangJobs(
+    std::vector<ClangJob>& jobs, size_t maxRunning,
+    llvm::function_ref<JobState(ClangJob&, int, const std::string&)> onFinished)
+{
+    bool success = true;
+    while (jobs.size() > maxRunning) {
+        bool finished = false;
+        for (auto it = jobs.begin(); it != jobs.end();) {
+            std::string clangErrors;
+            llvm::sys::ProcessInfo result = llvm::sys::Wait(
+                it->process, /*secondsToWait=*/0, /*waitUntilTerminates=*/false, &clangErrors);
+
+            if (result.Pid == 0) {
+                // The process is still running.
+                ++it;
+                continue;
+            }
+
+            finished = true;
+            JobState state = onFinished(*it, result.ReturnCode, clangErrors);
+            if (state == JobState::Running) {
+                ++it;
+                continue;
+            }
+
+            success &= state == JobState::Done;
+            it = jobs.erase(it);
+        }
+
+        if (!finished) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    return success;
+}
+
 auto gazer::ClangCompileAndLink(
     llvm::ArrayRef<std::string> files,
     llvm::LLVMContext& llvmContext,
@@ -162,72 +444,171 @@ auto gazer::ClangCompileAndLink(
     std::error_code errorCode;
     llvm::SMDiagnostic err;
 
-    // Find clang and llvm-link.
+    // Find clang.
     auto clang = llvm::sys::findProgramByName("clang");
     CHECK_ERROR(clang.getError(), "Could not find clang.");
 
-    auto llvm_link = llvm::sys::findProgramByName("llvm-link");
-    CHECK_ERROR(llvm_link.getError(), "Could not find llvm-link.");
+    // Add extra flags
+    std::vector<std::string> flags;
+    settings.createArgumentList(flags);
+    std::vector<std::string> clangArgs = createClangArguments(flags);
+    size_t maxJobs = std::max(1u, Jobs.getValue());
+
+#ifdef GAZER_ENABLE_CLANG_LIBS
+    // Modules compiled in-process must be created within llvmContext, which
+    // cannot be shared between threads. Parallel and cached compilation thus
+    // still use separate clang processes.
+    if (maxJobs == 1 && CacheDirectory.empty()) {
+        return compileAndLinkInProcess(files, *clang, clangArgs, llvmContext);
+    }
+#endif
 
     // Create a temporary working directory
     llvm::SmallString<128> workingDir;
     errorCode = llvm::sys::fs::createUniqueDirectory("gazer_workdir_", workingDir);
     CHECK_ERROR(errorCode, "Could not create temporary working directory.");
 
-    std::vector<std::string> bitcodeFiles;
+    std::unique_ptr<BitcodeCache> cache;
+    if (!CacheDirectory.empty()) {
+        cache = std::make_unique<BitcodeCache>(CacheDirectory, *clang, clangArgs);
+        if (!cache->init(workingDir)) {
+            return nullptr;
+        }
+    }
 
-    for (llvm::StringRef inputFile : files) {
+    // Translation units are compiled in parallel by separate clang processes
+    // and are linked in-process while the rest of the units are being
+    // compiled. To keep the result deterministic, they are linked in the
+    // order of the input files.
+    std::vector<std::string> bitcodeFiles(files.size());
+    std::vector<std::string> cacheKeys(files.size());
+    std::vector<bool> available(files.size(), false);
+    std::vector<ClangJob> jobs;
+    bool clangSuccess = true;
+
+    auto result = std::make_unique<llvm::Module>("gazer_llvm_output", llvmContext);
+    llvm::Linker linker(*result);
+    size_t numLinked = 0;
+    bool linkerSuccess = true;
+
+    auto linkAvailable = [&]() {
+        while (linkerSuccess && numLinked < files.size() && available[numLinked]) {
+            if (!cacheKeys[numLinked].empty()) {
+                cache->store(bitcodeFiles[numLinked], cacheKeys[numLinked]);
+            }
+
+            auto module = llvm::parseIRFile(bitcodeFiles[numLinked], err, llvmContext);
+            if (module == nullptr) {
+                err.print(nullptr, llvm::errs());
+                linkerSuccess = false;
+            } else if (linker.linkInModule(std::move(module))) {
+                llvm::errs() << "ERROR: failed to link input file '" << files[numLinked] << "'.\n";
+                linkerSuccess = false;
+            }
+            ++numLinked;
+        }
+    };
+
+    // Called when the clang process of a job finishes. With the cache enabled,
+    // a preprocessed unit is either found in the cache or compiled by the same
+    // job, thus preprocessing also runs in parallel.
+    auto finishJob = [&](ClangJob& job, int returnCode, const std::string& clangErrors) {
+        if (job.stage == ClangJob::Preprocess) {
+            // Failed preprocessing is reported by the compilation.
+            std::string key = returnCode == 0 ? cache->computeKey(job.preprocessedPath) : "";
+            if (!key.empty() && cache->contains(key)) {
+                bitcodeFiles[job.index] = cache->getPath(key);
+                available[job.index] = true;
+                return JobState::Done;
+            }
+
+            cacheKeys[job.index] = key;
+            job.stage = ClangJob::Compile;
+            if (startClang(*clang, job.inputPath, bitcodeFiles[job.index], clangArgs, job.process)) {
+                return JobState::Running;
+            }
+        } else if (checkClangResult(returnCode, clangErrors)) {
+            available[job.index] = true;
+            return JobState::Done;
+        }
+
+        llvm::errs() << "Failed to compile input file '" << job.input << "'.\n";
+        return JobState::Failed;
+    };
+
+    for (size_t i = 0; i < files.size(); ++i) {
+        llvm::StringRef inputFile = files[i];
         if (inputFile.endswith_lower(".bc") || inputFile.endswith_lower(".ll")) {
-            bitcodeFiles.push_back(inputFile);
+            bitcodeFiles[i] = inputFile;
+            available[i] = true;
             continue;
         }
 
         if (!inputFile.endswith_lower(".c")) {
             llvm::errs() << "Cannot compile source file " << inputFile << ".\n"
             << "Supported extensions are: .c, .bc, .ll\n";
-            return nullptr;
+            clangSuccess = false;
+            break;
         }
 
         llvm::SmallString<128> inputPath = inputFile;
         llvm::sys::fs::make_absolute(inputPath);
 
-        // Construct the output file path
+        // Construct the output file path. Input files with the same name
+        // in different directories must not overwrite each other's output.
         llvm::SmallString<128> outputPath = workingDir;
-        llvm::sys::path::append(outputPath, llvm::sys::path::filename(inputPath));
+        llvm::sys::path::append(
+            outputPath, std::to_string(i) + "_" + llvm::sys::path::filename(inputPath).str());
         llvm::sys::path::replace_extension(outputPath, "bc");
 
-        // Add extra flags
-        std::vector<std::string> flags;
-        settings.createArgumentList(flags);
+        if (!waitForClangJobs(jobs, maxJobs - 1, finishJob)) {
+            clangSuccess = false;
+            break;
+        }
 
-        // Call clang
-        bool clangSuccess = executeClang(*clang, inputPath, outputPath, flags);
-        if (!clangSuccess) {
-            // TODO: Clean-up the working directory?
-            llvm::errs() << "Failed to compile input file '" << inputFile << "'.\n";
-            return nullptr;
+        bitcodeFiles[i] = outputPath.str();
+
+        ClangJob& job = jobs.emplace_back();
+        job.index = i;
+        job.input = inputFile;
+        job.inputPath = inputPath.str();
+
+        llvm::SmallString<128> preprocessedPath = workingDir;
+        llvm::sys::path::append(preprocessedPath, std::to_string(i) + ".i");
+        job.preprocessedPath = preprocessedPath.str();
+
+        if (cache != nullptr && cache->startPreprocess(inputPath, preprocessedPath, job.process)) {
+            job.stage = ClangJob::Preprocess;
+        } else {
+            // Call clang
+            job.stage = ClangJob::Compile;
+            if (!startClang(*clang, inputPath, outputPath, clangArgs, job.process)) {
+                llvm::errs() << "Failed to compile input file '" << inputFile << "'.\n";
+                jobs.pop_back();
+                clangSuccess = false;
+                break;
+            }
         }
 
-        bitcodeFiles.push_back(outputPath.str());
+        // Link the finished units while the new one is being compiled.
+        linkAvailable();
     }
 
-    // Run llvm-link
-    llvm::SmallString<128> resultFile = workingDir;
-    llvm::sys::path::append(resultFile, "gazer_llvm_output.bc");
-    bool linkerSuccess = executeLinker(*llvm_link, bitcodeFiles, resultFile);
+    // Wait for the remaining compilations, even if one of them has failed.
+    clangSuccess &= waitForClangJobs(jobs, 0, finishJob);
+    if (!clangSuccess) {
+        // TODO: Clean-up the working directory?
+        return nullptr;
+    }
 
+    linkAvailable();
     if (!linkerSuccess) {
-        llvm::errs() << "ERROR: failed to execute llvm-link.\n";
         return nullptr;
     }
 
-    // Read back the result file
-    auto module = llvm::parseIRFile(resultFile, err, llvmContext);
-    if (module == nullptr) {
-        err.print(nullptr, llvm::errs());
-    }
+    assert(numLinked == files.size() && "All input files must be linked!");
 
-    return module;
+    return result;
 }
 
 using namespace gazer;
@@ -37,6 +37,7 @@ FrontendConfig::FrontendConfig()
     registerCheck("assertion-fail",     &checks::createAssertionFailCheck);
     registerCheck("div-by-zero",        &checks::createDivisionByZeroCheck);
     registerCheck("signed-overflow",    &checks::createSignedIntegerOverflowCheck);
+    registerCheck("memory-safety",      &checks::createMemorySafetyCheck);
 }
 
 void FrontendConfig::registerCheck(llvm::StringRef name, CheckFactory factory)
@@ -53,6 +54,8 @@ auto FrontendConfig::buildFrontend(
     std::vector<std::unique_ptr<Check>> checks;
     createChecks(checks);
 
+    PipelineSnapshot beforeClang = PipelineSnapshot::take(nullptr, nullptr);
+
     auto module = ClangCompileAndLink(inputs, llvmContext, mClangSettings);
     if (module == nullptr) {
         llvm::errs() << "Failed to build input module.\n";
@@ -66,6 +69,12 @@ auto FrontendConfig::buildFrontend(
 
     auto frontend = std::make_unique<LLVMFrontend>(std::move(module), context, mSettings);
 
+    if (PipelineReport* report = frontend->getPipelineReport()) {
+        // Clang runs in child processes, thus its memory usage is not included.
+        report->addStep(
+            "Clang compile and link", beforeClang, PipelineSnapshot::take(&frontend->getModule(), nullptr));
+    }
+
     for (auto& check : checks) {
         // Release the unique pointer and add it to the check registry
         frontend->getChecks().add(check.release());
@@ -142,6 +142,11 @@ std::string CheckRegistry::messageForCode(unsigned ec) const
         return "Unknown failure: a property violation was found, but I could not create an error trace.\n";
     }
 
+    auto restored = mRestoredMessages.find(ec);
+    if (restored != mRestoredMessages.end()) {
+        return restored->second;
+    }
+
     auto result = mCheckMap.find(ec);
     assert(result != mCheckMap.end() && "Error code should be present in the check map!");
 
@@ -165,6 +170,20 @@ std::string CheckRegistry::messageForCode(unsigned ec) const
     return rso.str();
 }
 
+std::vector<std::pair<unsigned, std::string>> CheckRegistry::getMessages() const
+{
+    std::vector<std::pair<unsigned, std::string>> messages;
+    for (auto& [ec, violation] : mCheckMap) {
+        messages.emplace_back(ec, this->messageForCode(ec));
+    }
+    for (auto& [ec, message] : mRestoredMessages) {
+        messages.emplace_back(ec, message);
+    }
+
+    std::sort(messages.begin(), messages.end());
+    return messages;
+}
+
 CheckRegistry::~CheckRegistry()
 {
     // If registerPasses() was not called, this object still owns all added checks.
@@ -21,6 +21,8 @@
 #include <llvm/IR/Module.h>
 #include <llvm/IR/InstIterator.h>
 #include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Intrinsics.h>
+#include <llvm/IR/Operator.h>
 #include <llvm/Transforms/Utils/BasicBlockUtils.h>
 #include <llvm/Support/Regex.h>
 
@@ -179,9 +181,56 @@ private:
     llvm::Regex mIntrinsicRegex;
 };
 
+/// Checks that loads, stores and the memory-accessing library functions only
+/// access live objects within their bounds, and that free is only called on
+/// the start of live heap objects (or null).
+///
+/// Library functions working on strings are only checked for their first
+/// byte. Objects are tracked by their allocation site within a function:
+/// pointers passed between functions or loaded from memory do not carry the
+/// liveness of their object, and freeing such a pointer is assumed to
+/// possibly free any object allocated in the current function. Such frees
+/// are only checked for the pointer being non-null.
+class MemorySafetyCheck final : public Check
+{
+    /// A memory access to be checked: the pointer and the number of bytes
+    /// accessed through it. Deallocations are represented by zero-sized
+    /// accesses, which allow null pointers.
+    struct Access
+    {
+        llvm::Instruction* inst;
+        llvm::Value* ptr;
+        llvm::Value* size;
+        bool isFree;
+    };
+
+public:
+    static char ID;
+
+    MemorySafetyCheck()
+        : Check(ID)
+    {}
+
+    bool mark(llvm::Function& function) override;
+
+    llvm::StringRef getErrorDescription() const override { return "Invalid memory access"; }
+
+private:
+    /// Returns true if the access is provably within the bounds of a stack or global object.
+    bool isSafeAccess(llvm::Value* ptr, uint64_t size, const llvm::DataLayout& dl);
+
+    /// Finds the object \p ptr points into, and returns its size in \p objSize.
+    /// Returns nullptr if the object cannot be determined.
+    llvm::Value* findBaseObject(llvm::Value* ptr, llvm::IRBuilder<>& builder, llvm::Value** objSize);
+
+    /// Collects the memory accesses of a call to a library function.
+    void collectLibraryAccesses(llvm::CallInst* call, llvm::SmallVectorImpl<Access>& accesses);
+};
+
 char DivisionByZeroCheck::ID;
 char AssertionFailCheck::ID;
 char SignedIntegerOverflowCheck::ID;
+char MemorySafetyCheck::ID;
 
 } // end anonymous namespace
 
@@ -306,6 +355,185 @@ bool SignedIntegerOverflowCheck::mark(llvm::Function& function)
     return true;
 }
 
+static llvm::Optional<uint64_t> getStaticObjectSize(const llvm::Value* object, const llvm::DataLayout& dl)
+{
+    if (auto alloca = llvm::dyn_cast<llvm::AllocaInst>(object)) {
+        auto count = llvm::dyn_cast<llvm::ConstantInt>(alloca->getArraySize());
+        if (count != nullptr) {
+            uint64_t size = dl.getTypeAllocSize(alloca->getAllocatedType());
+            return size * count->getZExtValue();
+        }
+    } else if (auto gv = llvm::dyn_cast<llvm::GlobalVariable>(object)) {
+        if (!gv->isDeclaration() && !gv->isInterposable()) {
+            uint64_t size = dl.getTypeAllocSize(gv->getValueType());
+            return size;
+        }
+    }
+
+    return llvm::None;
+}
+
+bool MemorySafetyCheck::isSafeAccess(llvm::Value* ptr, uint64_t size, const llvm::DataLayout& dl)
+{
+    llvm::APInt offset(dl.getIndexTypeSizeInBits(ptr->getType()), 0);
+    const llvm::Value* object = ptr->stripAndAccumulateInBoundsConstantOffsets(dl, offset);
+
+    auto objSize = getStaticObjectSize(object, dl);
+    if (!objSize) {
+        return false;
+    }
+
+    return !offset.isNegative() && offset.getZExtValue() + size <= *objSize;
+}
+
+llvm::Value* MemorySafetyCheck::findBaseObject(
+    llvm::Value* ptr, llvm::IRBuilder<>& builder, llvm::Value** objSize)
+{
+    const llvm::DataLayout& dl = builder.GetInsertBlock()->getModule()->getDataLayout();
+    llvm::Type* sizeTy = builder.getInt64Ty();
+
+    llvm::Value* base = ptr->stripPointerCasts();
+    while (auto gep = llvm::dyn_cast<llvm::GEPOperator>(base)) {
+        base = gep->getPointerOperand()->stripPointerCasts();
+    }
+
+    if (auto size = getStaticObjectSize(base, dl)) {
+        *objSize = llvm::ConstantInt::get(sizeTy, *size);
+        return base;
+    }
+
+    // Heap allocations are sized by their arguments, which dominate the
+    // allocation and thus all accesses derived from it.
+    auto call = llvm::dyn_cast<llvm::CallInst>(base);
+    llvm::Function* callee = call != nullptr ? call->getCalledFunction() : nullptr;
+    if (callee == nullptr) {
+        return nullptr;
+    }
+
+    if (callee->getName() == "malloc" && call->getNumArgOperands() == 1) {
+        *objSize = builder.CreateZExtOrTrunc(call->getArgOperand(0), sizeTy);
+        return base;
+    }
+
+    if (callee->getName() == "calloc" && call->getNumArgOperands() == 2) {
+        *objSize = builder.CreateMul(
+            builder.CreateZExtOrTrunc(call->getArgOperand(0), sizeTy),
+            builder.CreateZExtOrTrunc(call->getArgOperand(1), sizeTy)
+        );
+        return base;
+    }
+
+    return nullptr;
+}
+
+void MemorySafetyCheck::collectLibraryAccesses(llvm::CallInst* call, llvm::SmallVectorImpl<Access>& accesses)
+{
+    llvm::Function* callee = call->getCalledFunction();
+    if (callee == nullptr || !callee->isDeclaration()) {
+        return;
+    }
+
+    llvm::IntegerType* sizeTy = llvm::Type::getInt64Ty(call->getContext());
+    llvm::Value* oneByte = llvm::ConstantInt::get(sizeTy, 1);
+    llvm::StringRef name = callee->getName();
+    llvm::Intrinsic::ID id = callee->getIntrinsicID();
+
+    if (id == llvm::Intrinsic::memcpy || id == llvm::Intrinsic::memmove || name == "memcpy" || name == "memmove") {
+        accesses.push_back({call, call->getArgOperand(0), call->getArgOperand(2), false});
+        accesses.push_back({call, call->getArgOperand(1), call->getArgOperand(2), false});
+    } else if (id == llvm::Intrinsic::memset || name == "memset") {
+        accesses.push_back({call, call->getArgOperand(0), call->getArgOperand(2), false});
+    } else if (name == "strcpy" || name == "strcmp") {
+        accesses.push_back({call, call->getArgOperand(0), oneByte, false});
+        accesses.push_back({call, call->getArgOperand(1), oneByte, false});
+    } else if (name == "strlen") {
+        accesses.push_back({call, call->getArgOperand(0), oneByte, false});
+    } else if (name == "free" && call->getNumArgOperands() == 1) {
+        accesses.push_back({call, call->getArgOperand(0), llvm::ConstantInt::get(sizeTy, 0), true});
+    }
+}
+
+bool MemorySafetyCheck::mark(llvm::Function& function)
+{
+    llvm::Module& module = *function.getParent();
+    const llvm::DataLayout& dl = module.getDataLayout();
+    llvm::IntegerType* sizeTy = llvm::Type::getInt64Ty(module.getContext());
+
+    llvm::SmallVector<Access, 16> accesses;
+    for (Instruction& inst : instructions(function)) {
+        if (auto load = dyn_cast<LoadInst>(&inst)) {
+            uint64_t size = dl.getTypeStoreSize(load->getType());
+            accesses.push_back({&inst, load->getPointerOperand(), llvm::ConstantInt::get(sizeTy, size), false});
+        } else if (auto store = dyn_cast<StoreInst>(&inst)) {
+            uint64_t size = dl.getTypeStoreSize(store->getValueOperand()->getType());
+            accesses.push_back({&inst, store->getPointerOperand(), llvm::ConstantInt::get(sizeTy, size), false});
+        } else if (auto call = dyn_cast<CallInst>(&inst)) {
+            this->collectLibraryAccesses(call, accesses);
+        }
+    }
+
+    // Accesses proven to be safe are not instrumented, which also keeps
+    // the corresponding objects promotable by the memory model.
+    llvm::SmallVector<Access, 16> targets;
+    for (Access& access : accesses) {
+        auto constSize = llvm::dyn_cast<llvm::ConstantInt>(access.size);
+        if (access.isFree || constSize == nullptr
+            || !this->isSafeAccess(access.ptr, constSize->getZExtValue(), dl)
+        ) {
+            targets.push_back(access);
+        }
+    }
+
+    if (targets.empty()) {
+        return false;
+    }
+
+    auto validAccess = GazerIntrinsic::GetOrInsertValidAccess(module);
+    llvm::PointerType* bytePtrTy = llvm::Type::getInt8PtrTy(module.getContext());
+
+    IRBuilder<> builder(module.getContext());
+    for (auto& [inst, ptr, size, isFree] : targets) {
+        builder.SetInsertPoint(inst);
+        llvm::Value* objSize = nullptr;
+        llvm::Value* base = this->findBaseObject(ptr, builder, &objSize);
+        bool isKnownBase = base != nullptr;
+        if (!isKnownBase) {
+            base = llvm::ConstantPointerNull::get(bytePtrTy);
+            objSize = builder.getInt64(0);
+        }
+
+        llvm::Value* bytePtr = builder.CreatePointerCast(ptr, bytePtrTy);
+        llvm::Value* basePtr = builder.CreatePointerCast(base, bytePtrTy);
+        llvm::Value* check = builder.CreateCall(validAccess, {
+            bytePtr, builder.CreateZExtOrTrunc(size, sizeTy), basePtr, objSize
+        }, "mem_check");
+
+        if (isFree) {
+            // Only the start of a heap object may be freed, stack and global
+            // objects may not be freed at all.
+            if (isKnownBase) {
+                llvm::Value* isStart = llvm::isa<llvm::CallInst>(base)
+                    ? builder.CreateICmpEQ(bytePtr, basePtr) : builder.getFalse();
+                check = builder.CreateAnd(check, isStart);
+            }
+
+            check = builder.CreateOr(builder.CreateIsNull(ptr), check);
+        }
+
+        BasicBlock* bb = inst->getParent();
+        BasicBlock* errorBB = this->createErrorBlock(function, "error.memsafety", inst);
+
+        BasicBlock* newBB = bb->splitBasicBlock(inst);
+        builder.ClearInsertionPoint();
+        llvm::ReplaceInstWithInst(
+            bb->getTerminator(),
+            builder.CreateCondBr(check, newBB, errorBB)
+        );
+    }
+
+    return true;
+}
+
 std::unique_ptr<Check> gazer::checks::createDivisionByZeroCheck(ClangOptions& options)
 {
     return std::make_unique<DivisionByZeroCheck>();
@@ -321,3 +549,8 @@ std::unique_ptr<Check> gazer::checks::createSignedIntegerOverflowCheck(ClangOpti
     options.addSanitizerFlag("signed-integer-overflow");
     return std::make_unique<SignedIntegerOverflowCheck>();
 }
+
+std::unique_ptr<Check> gazer::checks::createMemorySafetyCheck(ClangOptions& options)
+{
+    return std::make_unique<MemorySafetyCheck>();
+}
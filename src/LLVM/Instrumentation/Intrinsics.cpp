@@ -123,4 +123,18 @@ llvm::FunctionCallee GazerIntrinsic::GetOrInsertOverflowCheck(llvm::Module& modu
         type,
         type
     );
-}
\ No newline at end of file
+}
+
+llvm::FunctionCallee GazerIntrinsic::GetOrInsertValidAccess(llvm::Module& module)
+{
+    auto& context = module.getContext();
+
+    return module.getOrInsertFunction(
+        ValidAccessName,
+        llvm::Type::getInt1Ty(context),
+        llvm::Type::getInt8PtrTy(context),
+        llvm::Type::getInt64Ty(context),
+        llvm::Type::getInt8PtrTy(context),
+        llvm::Type::getInt64Ty(context)
+    );
+}
@@ -20,8 +20,10 @@
 #include "gazer/LLVM/InstrumentationPasses.h"
 #include "gazer/LLVM/Transform/Passes.h"
 #include "gazer/LLVM/Automaton/ModuleToAutomata.h"
+#include "gazer/LLVM/Automaton/AutomataCache.h"
 #include "gazer/LLVM/Transform/UndefToNondet.h"
 #include "gazer/LLVM/Memory/MemoryModel.h"
+#include "gazer/LLVM/PipelineReport.h"
 #include "gazer/Trace/TraceWriter.h"
 #include "gazer/LLVM/Trace/TestHarnessGenerator.h"
 #include "gazer/LLVM/Transform/BackwardSlicer.h"
@@ -67,6 +69,21 @@ namespace
     cl::opt<bool> StructurizeCFG(
         "structurize", cl::desc("Try to remove irreducible controlf flow"), cl::cat(LLVMFrontendCategory)
     );
+    cl::opt<std::string> CfaCacheDirectory(
+        "cfa-cache-dir",
+        cl::desc("Cache the translated automata system of the input in the given directory"),
+        cl::cat(LLVMFrontendCategory)
+    );
+    cl::opt<bool> TimePipeline(
+        "time-pipeline",
+        cl::desc("Report the time, memory usage and program size changes of each pipeline step"),
+        cl::cat(LLVMFrontendCategory)
+    );
+    cl::opt<std::string> TimePipelineJson(
+        "time-pipeline-json",
+        cl::desc("Write the pipeline report in JSON format into the given file"),
+        cl::cat(LLVMFrontendCategory)
+    );
 
     class RunVerificationBackendPass : public llvm::ModulePass
     {
@@ -99,9 +116,83 @@ namespace
         std::unique_ptr<VerificationResult> mResult;
     };
 
+    class StoreAutomataCachePass : public llvm::ModulePass
+    {
+    public:
+        static char ID;
+
+        StoreAutomataCachePass(const AutomataCache& cache, const CheckRegistry& checks)
+            : ModulePass(ID), mCache(cache), mChecks(checks)
+        {}
+
+        void getAnalysisUsage(llvm::AnalysisUsage& au) const override
+        {
+            au.addRequired<ModuleToAutomataPass>();
+            au.setPreservesAll();
+        }
+
+        bool runOnModule(llvm::Module& module) override
+        {
+            auto& moduleToCfa = getAnalysis<ModuleToAutomataPass>();
+            mCache.store(module, moduleToCfa.getSystem(), moduleToCfa.getTraceInfo(), mChecks.getMessages());
+
+            return false;
+        }
+
+        llvm::StringRef getPassName() const override {
+            return "Store automata cache pass";
+        }
+
+    private:
+        const AutomataCache& mCache;
+        const CheckRegistry& mChecks;
+    };
+
+    /// Records the resource usage of the pipeline step which was executed
+    /// since the previous checkpoint.
+    class PipelineCheckpointPass : public llvm::ModulePass
+    {
+    public:
+        static char ID;
+
+        PipelineCheckpointPass(PipelineReport& report, PipelineSnapshot& last, std::string stepName)
+            : ModulePass(ID), mReport(report), mLast(last), mStepName(std::move(stepName))
+        {}
+
+        void getAnalysisUsage(llvm::AnalysisUsage& au) const override
+        {
+            au.setPreservesAll();
+        }
+
+        bool runOnModule(llvm::Module& module) override
+        {
+            const AutomataSystem* system = nullptr;
+            if (auto moduleToCfa = getAnalysisIfAvailable<ModuleToAutomataPass>()) {
+                system = &moduleToCfa->getSystem();
+            }
+
+            PipelineSnapshot current = PipelineSnapshot::take(&module, system);
+            mReport.addStep(mStepName, mLast, current);
+            mLast = current;
+
+            return false;
+        }
+
+        llvm::StringRef getPassName() const override {
+            return "Pipeline checkpoint pass";
+        }
+
+    private:
+        PipelineReport& mReport;
+        PipelineSnapshot& mLast;
+        std::string mStepName;
+    };
+
 } // end anonymous namespace
 
 char RunVerificationBackendPass::ID;
+char StoreAutomataCachePass::ID;
+char PipelineCheckpointPass::ID;
 
 LLVMFrontend::LLVMFrontend(
     std::unique_ptr<llvm::Module> module,
@@ -132,69 +223,125 @@ LLVMFrontend::LLVMFrontend(
             mModuleOutput = nullptr;
         }
     }
+
+    if (TimePipeline || !TimePipelineJson.empty()) {
+        mPipelineReport = std::make_unique<PipelineReport>();
+    }
 }
 
+LLVMFrontend::~LLVMFrontend() = default;
+
 void LLVMFrontend::registerVerificationPipeline()
 {
+    if (this->registerCachedAutomata()) {
+        return;
+    }
+
     // Do basic preprocessing: get rid of alloca's and turn undef's
     //  into nondet function calls.
-    mPassManager.add(llvm::createPromoteMemoryToRegisterPass());
-    mPassManager.add(gazer::createPromoteUndefsPass());
+    this->addPass(llvm::createPromoteMemoryToRegisterPass());
+    this->addPass(gazer::createPromoteUndefsPass());
 
     // Perform check instrumentation.
-    mPassManager.add(gazer::createNormalizeVerifierCallsPass());
+    this->addPass(gazer::createNormalizeVerifierCallsPass());
     registerEnabledChecks();
 
     // Execute early optimization passes.
     registerEarlyOptimizations();
 
     // Inline functions and global variables if requested.
-    mPassManager.add(gazer::createMarkFunctionEntriesPass());
+    this->addPass(gazer::createMarkFunctionEntriesPass());
     registerInlining();
 
     // Unify function exit nodes
-    mPassManager.add(llvm::createUnifyFunctionExitNodesPass());
+    this->addPass(llvm::createUnifyFunctionExitNodesPass());
 
     // Run assertion lifting.
     if (mSettings.liftAsserts) {
-        mPassManager.add(new llvm::CallGraphWrapperPass());
-        mPassManager.add(gazer::createLiftErrorCallsPass(*mSettings.getEntryFunction(*mModule)));
+        this->addPass(new llvm::CallGraphWrapperPass());
+        this->addPass(gazer::createLiftErrorCallsPass(*mSettings.getEntryFunction(*mModule)));
 
         // Assertion lifting creates a lot of dead code. Run a lightweight DCE pass 
         // and a subsequent CFG simplification to clean up.
-        mPassManager.add(llvm::createDeadCodeEliminationPass());
-        mPassManager.add(llvm::createCFGSimplificationPass());
-
-        // FIXME: Run program slicing here if requested.
+        this->addPass(llvm::createDeadCodeEliminationPass());
+        this->addPass(llvm::createCFGSimplificationPass());
+
+        // After lifting, all error calls are in the entry function, thus
+        // everything they do not depend on may be removed. Slicing would
+        // remove the nondeterministic calls needed to replay traces.
+        if (mSettings.slicing && !mSettings.trace) {
+            this->addPass(gazer::createInterproceduralSlicerPass(*mSettings.getEntryFunction(*mModule)));
+        }
     }
 
     // Execute late optimization passes.
     registerLateOptimizations();
 
     // Do an instruction namer pass.
-    mPassManager.add(llvm::createInstructionNamerPass());
+    this->addPass(llvm::createInstructionNamerPass());
 
     if (!PrintFinalModule.empty() && mModuleOutput != nullptr) {
-        mPassManager.add(llvm::createPrintModulePass(mModuleOutput->os()));
+        this->addPass(llvm::createPrintModulePass(mModuleOutput->os()));
         mModuleOutput->keep();
     }
 
     // Unify exit nodes again
-    mPassManager.add(llvm::createUnifyFunctionExitNodesPass());
+    this->addPass(llvm::createUnifyFunctionExitNodesPass());
     
     // Display the final LLVM CFG now.
     if (ShowFinalCFG) {
-        mPassManager.add(llvm::createCFGPrinterLegacyPassPass());
+        this->addPass(llvm::createCFGPrinterLegacyPassPass());
     }
 
     // Perform module-to-automata translation.
-    mPassManager.add(new gazer::MemoryModelWrapperPass(mContext, mSettings));
-    mPassManager.add(new gazer::ModuleToAutomataPass(mContext, mSettings));
+    this->addPass(new gazer::MemoryModelWrapperPass(mContext, mSettings));
+    this->addPass(new gazer::ModuleToAutomataPass(mContext, mSettings));
+
+    if (mAutomataCache != nullptr) {
+        this->addPass(new StoreAutomataCachePass(*mAutomataCache, mChecks));
+    }
 
     // Execute the verifier backend if there is one.
     if (mBackendAlgorithm != nullptr) {
-        mPassManager.add(new RunVerificationBackendPass(mChecks, *mBackendAlgorithm, mSettings));
+        this->addPass(new RunVerificationBackendPass(mChecks, *mBackendAlgorithm, mSettings));
+    }
+}
+
+bool LLVMFrontend::registerCachedAutomata()
+{
+    if (CfaCacheDirectory.empty()) {
+        return false;
+    }
+
+    // The key must be computed before any of the passes modify the module.
+    mAutomataCache = std::make_unique<AutomataCache>(
+        CfaCacheDirectory, *mModule, mSettings, StructurizeCFG ? "structurize" : "");
+
+    AutomataCache::Entry entry;
+    if (!mAutomataCache->lookup(mContext, mModule->getContext(), entry)) {
+        return false;
+    }
+
+    // The cached module already went through the whole pipeline,
+    // thus only the backend needs to be executed.
+    mModule = std::move(entry.module);
+    for (auto& [ec, message] : entry.messages) {
+        mChecks.restoreMessage(ec, message);
+    }
+
+    if (!PrintFinalModule.empty() && mModuleOutput != nullptr) {
+        this->addPass(llvm::createPrintModulePass(mModuleOutput->os()));
+        mModuleOutput->keep();
+    }
+
+    this->addPass(new gazer::ModuleToAutomataPass(
+        mContext, mSettings, std::move(entry.system), std::move(entry.trace)));
+
+    if (mBackendAlgorithm != nullptr) {
+        this->addPass(new RunVerificationBackendPass(mChecks, *mBackendAlgorithm, mSettings));
     }
+
+    return true;
 }
 
 bool RunVerificationBackendPass::runOnModule(llvm::Module& module)
@@ -270,43 +417,88 @@ bool RunVerificationBackendPass::runOnModule(llvm::Module& module)
 void LLVMFrontend::registerEnabledChecks()
 {
     mChecks.registerPasses(mPassManager);
+    this->addCheckpoint("Check instrumentation");
 }
 
 void LLVMFrontend::registerInlining()
 {
     if (mSettings.inlineLevel != InlineLevel::Off) {
-        mPassManager.add(llvm::createInternalizePass([this](auto& gv) {
+        this->addPass(llvm::createInternalizePass([this](auto& gv) {
             if (auto fun = llvm::dyn_cast<llvm::Function>(&gv)) {
                 return mSettings.getEntryFunction(*gv.getParent()) == fun;
             }
             return false;
         }));
-        mPassManager.add(gazer::createSimpleInlinerPass(*mSettings.getEntryFunction(*mModule), mSettings.inlineLevel));
+        this->addPass(gazer::createSimpleInlinerPass(*mSettings.getEntryFunction(*mModule), mSettings.inlineLevel));
 
         // Remove dead functions
-        mPassManager.add(llvm::createGlobalDCEPass());
+        this->addPass(llvm::createGlobalDCEPass());
 
         // Inline eligible global variables
         if (mSettings.inlineGlobals) {
-            mPassManager.add(gazer::createInlineGlobalVariablesPass());
+            this->addPass(gazer::createInlineGlobalVariablesPass());
         }
 
         // Remove dead globals
-        mPassManager.add(llvm::createGlobalDCEPass());
+        this->addPass(llvm::createGlobalDCEPass());
 
         // Transform the generated alloca instructions into registers
-        mPassManager.add(llvm::createPromoteMemoryToRegisterPass());
+        this->addPass(llvm::createPromoteMemoryToRegisterPass());
     }
 }
 
 void LLVMFrontend::registerPass(llvm::Pass* pass)
 {
+    this->addPass(pass);
+}
+
+void LLVMFrontend::addPass(llvm::Pass* pass)
+{
+    // The pass manager may delete redundant analysis passes, so the name
+    // must be queried before adding the pass.
+    std::string name = mPipelineReport != nullptr ? pass->getPassName().str() : "";
+
     mPassManager.add(pass);
+    this->addCheckpoint(name);
+}
+
+void LLVMFrontend::addCheckpoint(llvm::StringRef stepName)
+{
+    if (mPipelineReport != nullptr) {
+        mPassManager.add(new PipelineCheckpointPass(*mPipelineReport, mLastSnapshot, stepName.str()));
+    }
 }
 
 void LLVMFrontend::run()
 {
+    if (mPipelineReport != nullptr) {
+        mLastSnapshot = PipelineSnapshot::take(mModule.get(), nullptr);
+    }
+
     mPassManager.run(*mModule);
+
+    if (mPipelineReport != nullptr) {
+        this->printPipelineReport();
+    }
+}
+
+void LLVMFrontend::printPipelineReport()
+{
+    if (TimePipeline) {
+        mPipelineReport->print(llvm::errs());
+    }
+
+    if (!TimePipelineJson.empty()) {
+        std::error_code ec;
+        llvm::ToolOutputFile output(TimePipelineJson, ec, llvm::sys::fs::OF_Text);
+        if (ec) {
+            emit_error("could not open '%s': %s", TimePipelineJson.c_str(), ec.message().c_str());
+            return;
+        }
+
+        mPipelineReport->printJson(output.os());
+        output.keep();
+    }
 }
 
 void LLVMFrontend::registerEarlyOptimizations()
@@ -316,33 +508,33 @@ void LLVMFrontend::registerEarlyOptimizations()
     }
 
     // Start with some metadata-based typed AA
-    mPassManager.add(llvm::createTypeBasedAAWrapperPass());
-    mPassManager.add(llvm::createScopedNoAliasAAWrapperPass());
+    this->addPass(llvm::createTypeBasedAAWrapperPass());
+    this->addPass(llvm::createScopedNoAliasAAWrapperPass());
 
     // Split call sites under conditionals
-    mPassManager.add(llvm::createCallSiteSplittingPass());
+    this->addPass(llvm::createCallSiteSplittingPass());
 
     // Do some inter-procedural reductions
-    mPassManager.add(llvm::createIPSCCPPass());
-    mPassManager.add(llvm::createGlobalOptimizerPass());
-    mPassManager.add(llvm::createDeadArgEliminationPass());
+    this->addPass(llvm::createIPSCCPPass());
+    this->addPass(llvm::createGlobalOptimizerPass());
+    this->addPass(llvm::createDeadArgEliminationPass());
 
     // Clean up
-    mPassManager.add(llvm::createInstructionCombiningPass());
-    mPassManager.add(llvm::createCFGSimplificationPass());
+    this->addPass(llvm::createInstructionCombiningPass());
+    this->addPass(llvm::createCFGSimplificationPass());
 
     // SROA may introduce new undef values, so we run another promote undef pass after it
-    mPassManager.add(llvm::createSROAPass());
-    mPassManager.add(gazer::createPromoteUndefsPass());
+    this->addPass(llvm::createSROAPass());
+    this->addPass(gazer::createPromoteUndefsPass());
     //mPassManager.add(llvm::createEarlyCSEPass());
 
-    mPassManager.add(llvm::createCFGSimplificationPass());
-    mPassManager.add(llvm::createAggressiveInstCombinerPass());
-    mPassManager.add(llvm::createInstructionCombiningPass());
+    this->addPass(llvm::createCFGSimplificationPass());
+    this->addPass(llvm::createAggressiveInstCombinerPass());
+    this->addPass(llvm::createInstructionCombiningPass());
 
     // Try to remove irreducible control flow
     if (StructurizeCFG) {
-        mPassManager.add(llvm::createStructurizeCFGPass());
+        this->addPass(llvm::createStructurizeCFGPass());
     }
     
     // Optimize loops
@@ -353,8 +545,8 @@ void LLVMFrontend::registerEarlyOptimizations()
 
     //mPassManager.add(llvm::createCFGSimplificationPass());
     //mPassManager.add(llvm::createInstructionCombiningPass());
-    mPassManager.add(llvm::createIndVarSimplifyPass());
-    mPassManager.add(llvm::createLoopDeletionPass());
+    this->addPass(llvm::createIndVarSimplifyPass());
+    this->addPass(llvm::createLoopDeletionPass());
 
     //mPassManager.add(llvm::createNewGVNPass());
 }
@@ -362,17 +554,21 @@ void LLVMFrontend::registerEarlyOptimizations()
 void LLVMFrontend::registerLateOptimizations()
 {
     if (mSettings.optimize) {
-        mPassManager.add(llvm::createBasicAAWrapperPass());
-        mPassManager.add(llvm::createLICMPass());
+        this->addPass(llvm::createBasicAAWrapperPass());
+        this->addPass(llvm::createLICMPass());
     }
 
-    mPassManager.add(llvm::createGlobalOptimizerPass());
-    mPassManager.add(llvm::createGlobalDCEPass());
+    this->addPass(llvm::createGlobalOptimizerPass());
+    this->addPass(llvm::createGlobalDCEPass());
 
     // Currently loop simplify must be applied for ModuleToAutomata
     // to work properly as it relies on loop preheaders being available.
-    mPassManager.add(llvm::createCFGSimplificationPass());
-    mPassManager.add(llvm::createLoopSimplifyPass());
+    this->addPass(llvm::createCFGSimplificationPass());
+    this->addPass(llvm::createLoopSimplifyPass());
+
+    if (mSettings.accelerateLoops) {
+        this->addPass(gazer::createLoopAccelerationPass(mSettings.accelerateLoopsMaxStores));
+    }
 }
 
 auto LLVMFrontend::FromInputFile(
@@ -57,17 +57,38 @@ namespace
     cl::opt<bool> NoSlice(
         "no-slicing", cl::desc("Do not run program slicing pass"), cl::cat(LLVMFrontendCategory)
     );
+    cl::opt<bool> AccelerateLoops(
+        "accelerate-loops", cl::desc("Replace loops having a closed-form effect with straight-line code"),
+        cl::cat(LLVMFrontendCategory)
+    );
+    cl::opt<unsigned> AccelerateLoopsMaxStores(
+        "accelerate-loops-max-stores",
+        cl::desc("Maximum number of stores emitted for an accelerated loop (requires -accelerate-loops)"),
+        cl::value_desc("N"), cl::init(1024), cl::cat(LLVMFrontendCategory)
+    );
 
     // LLVM IR to CFA translation options
     cl::opt<ElimVarsLevel> ElimVarsLevelOpt("elim-vars", cl::desc("Level for variable elimination:"),
         cl::values(
             clEnumValN(ElimVarsLevel::Off, "off", "Do not eliminate variables"),
             clEnumValN(ElimVarsLevel::Normal, "normal", "Eliminate variables having only one use"),
-            clEnumValN(ElimVarsLevel::Aggressive, "aggressive", "Eliminate all eligible variables")
+            clEnumValN(ElimVarsLevel::Aggressive, "aggressive", "Eliminate all eligible variables"),
+            clEnumValN(ElimVarsLevel::Bounded, "bounded",
+                "Eliminate eligible variables while their expressions stay within the limits of -elim-vars-max-size and -elim-vars-max-depth")
         ),
         cl::init(ElimVarsLevel::Normal),
         cl::cat(IrToCfaCategory)
     );
+    cl::opt<unsigned> ElimVarsMaxSize(
+        "elim-vars-max-size",
+        cl::desc("Maximum number of distinct nodes in an inlined expression (requires -elim-vars=bounded)"),
+        cl::value_desc("N"), cl::init(64), cl::cat(IrToCfaCategory)
+    );
+    cl::opt<unsigned> ElimVarsMaxDepth(
+        "elim-vars-max-depth",
+        cl::desc("Maximum depth of an inlined expression (requires -elim-vars=bounded)"),
+        cl::value_desc("N"), cl::init(16), cl::cat(IrToCfaCategory)
+    );
     cl::opt<bool> ArithInts(
         "math-int", cl::desc("Use mathematical unbounded integers instead of bitvectors"),
         cl::cat(IrToCfaCategory));
@@ -77,9 +98,18 @@ namespace
     );
     cl::opt<std::string> EntryFunctionName(
         "function", cl::desc("Main function name"), cl::cat(IrToCfaCategory), cl::init("main"));
+    cl::opt<bool> LargeBlockEncoding(
+        "large-block-encoding",
+        cl::desc("Merge loop-free regions of the automata into single transitions (ignored with -trace)"),
+        cl::cat(IrToCfaCategory)
+    );
     cl::opt<bool> Strict(
         "strict", cl::desc("Use stricter transformation rules for undefined behavior"), cl::cat(IrToCfaCategory)
     );
+    cl::opt<unsigned> CfaThreads(
+        "cfa-threads", cl::desc("Number of threads used to translate functions into automata (0: one per hardware thread)"),
+        cl::value_desc("N"), cl::init(1), cl::cat(IrToCfaCategory)
+    );
 
     // Memory models
     cl::opt<bool> DebugDumpMemorySSA(
@@ -89,11 +119,32 @@ namespace
     cl::opt<MemoryModelSetting> MemoryModelOpt("memory", cl::desc("Memory model to use:"),
         cl::values(
             clEnumValN(MemoryModelSetting::Flat, "flat", "Bit-precise flat memory model"),
+            clEnumValN(MemoryModelSetting::Regions, "regions",
+                "Flat memory model partitioned into disjoint regions by a points-to analysis"),
+            clEnumValN(MemoryModelSetting::AliasSets, "alias-sets",
+                "Flat memory model partitioned into disjoint regions by the alias sets of LLVM's alias analyses"),
             clEnumValN(MemoryModelSetting::Havoc, "havoc", "Dummy havoc model")
         ),
         cl::init(MemoryModelSetting::Flat),
         cl::cat(IrToCfaCategory)
     );
+    cl::opt<bool> MemoryWordCells(
+        "memory-word-cells",
+        cl::desc("Use word-sized memory cells in regions where all accesses are uniform (requires -memory=regions)"),
+        cl::cat(IrToCfaCategory)
+    );
+    cl::opt<bool> NoPromoteMemory(
+        "no-promote-memory",
+        cl::desc("Do not promote the fields of non-escaping globals and allocas into scalar variables"),
+        cl::cat(IrToCfaCategory)
+    );
+    cl::opt<unsigned> MemoryFlattenReads(
+        "memory-flatten-reads",
+        cl::desc("Encode memory reads over at most N preceding stores as if-then-else chains instead of array reads (0: always use arrays)"),
+        cl::value_desc("N"),
+        cl::init(0),
+        cl::cat(IrToCfaCategory)
+    );
 
     // Traceability options
     cl::opt<bool> PrintTrace(
@@ -139,11 +190,20 @@ LLVMFrontendSettings LLVMFrontendSettings::initFromCommandLine()
     settings.slicing =!NoSlice;
     settings.simplifyExpr = !NoSimplifyExpr;
 
+    settings.accelerateLoops = AccelerateLoops;
+    settings.accelerateLoopsMaxStores = AccelerateLoopsMaxStores;
+    settings.largeBlockEncoding = LargeBlockEncoding;
     settings.strict = Strict;
+    settings.cfaThreads = CfaThreads;
 
     settings.inlineLevel = InlineLevelOpt;
     settings.elimVars = ElimVarsLevelOpt;
+    settings.elimVarsMaxSize = ElimVarsMaxSize;
+    settings.elimVarsMaxDepth = ElimVarsMaxDepth;
     settings.memoryModel = MemoryModelOpt;
+    settings.memoryWordCells = MemoryWordCells;
+    settings.promoteMemory = !NoPromoteMemory;
+    settings.memoryFlattenReads = MemoryFlattenReads;
 
     settings.checks = EnabledChecks;
 
@@ -173,6 +233,7 @@ std::string LLVMFrontendSettings::toString() const
         case ElimVarsLevel::Off:         str += "off"; break;
         case ElimVarsLevel::Normal:      str += "normal"; break;
         case ElimVarsLevel::Aggressive:  str += "aggressive"; break;
+        case ElimVarsLevel::Bounded:     str += "bounded"; break;
     }
     str += R"(", "loop_representation": ")";
 
@@ -0,0 +1,517 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "gazer/LLVM/Memory/AliasSetPartition.h"
+
+#include <llvm/Analysis/AliasAnalysis.h>
+#include <llvm/Analysis/AliasSetTracker.h>
+#include <llvm/IR/CallSite.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/IntrinsicInst.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Operator.h>
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/SmallPtrSet.h>
+#include <llvm/ADT/StringSet.h>
+#include <llvm/Support/Debug.h>
+#include <llvm/Support/raw_ostream.h>
+
+#define DEBUG_TYPE "AliasSetPartition"
+
+using namespace gazer;
+using namespace gazer::memory;
+
+namespace
+{
+
+bool isAllocationFunction(llvm::StringRef name)
+{
+    return name == "malloc" || name == "calloc" || name == "valloc" || name == "realloc"
+        || name == "aligned_alloc" || name == "memalign"
+        || name == "_Znwm" || name == "_Znam" || name == "_Znwj" || name == "_Znaj";
+}
+
+/// Returns true if the library function \p name returns its first argument.
+bool returnsFirstArgument(llvm::StringRef name)
+{
+    return name == "memcpy" || name == "memmove" || name == "memset"
+        || name == "strcpy" || name == "strncpy" || name == "strcat";
+}
+
+/// Returns true if the known library function \p name does not capture
+/// its pointer arguments.
+bool isNonCapturingLibraryFunction(llvm::StringRef name)
+{
+    return returnsFirstArgument(name)
+        || name == "strlen" || name == "strcmp" || name == "strncmp" || name == "free"
+        || name.startswith("gazer.") || name.startswith("verifier.")
+        || name.startswith("__VERIFIER_");
+}
+
+const llvm::Function* getCalledFunction(llvm::ImmutableCallSite call)
+{
+    return llvm::dyn_cast<llvm::Function>(call.getCalledValue()->stripPointerCasts());
+}
+
+} // end anonymous namespace
+
+class AliasSetPartition::Impl
+{
+public:
+    Impl(llvm::Module& module, AliasAnalysisFuncTy aliasAnalysis, const llvm::Function* entry)
+        : mModule(module), mAliasAnalysis(std::move(aliasAnalysis)), mEntry(entry)
+    {}
+
+    void analyze();
+
+    RegionID getRegionFor(const llvm::Value* ptr) const
+    {
+        auto it = mRegionOf.find(ptr);
+        return it == mRegionOf.end() ? UnknownRegion : it->second;
+    }
+
+private:
+    // Union-find
+    //==--------------------------------------------------------------------==//
+    unsigned getNode(const llvm::Value* value);
+    unsigned find(unsigned node);
+    void merge(unsigned lhs, unsigned rhs);
+    void merge(const llvm::Value* lhs, const llvm::Value* rhs) {
+        this->merge(this->getNode(lhs), this->getNode(rhs));
+    }
+    void escape(const llvm::Value* value) {
+        this->merge(this->getNode(value), mUnknown);
+    }
+
+    // Constraint generation
+    //==--------------------------------------------------------------------==//
+    bool isIdentifiedObject(const llvm::Value* object) const;
+    void anchor(const llvm::Value* ptr);
+    void visitInstruction(const llvm::Instruction& inst);
+    void visitCall(llvm::ImmutableCallSite call);
+    void visitAliasSets(llvm::Function& function);
+    void visitInitializer(const llvm::Constant* init);
+
+    // Regions
+    //==--------------------------------------------------------------------==//
+    void computeRegions();
+
+public:
+    struct Region
+    {
+        std::string name;
+        std::vector<const llvm::Value*> objects;
+    };
+
+    std::vector<Region> mRegions;
+
+private:
+    llvm::Module& mModule;
+    AliasAnalysisFuncTy mAliasAnalysis;
+    const llvm::Function* mEntry;
+
+    std::vector<unsigned> mParent;
+    std::vector<const llvm::Value*> mValues;
+    unsigned mUnknown;
+
+    llvm::DenseMap<const llvm::Value*, unsigned> mNodes;
+    llvm::SmallPtrSet<const llvm::Value*, 32> mAccessed;
+    std::vector<const llvm::Value*> mObjects;
+
+    llvm::DenseMap<const llvm::Value*, RegionID> mRegionOf;
+};
+
+unsigned AliasSetPartition::Impl::getNode(const llvm::Value* value)
+{
+    auto [it, inserted] = mNodes.try_emplace(value, mParent.size());
+    if (inserted) {
+        mParent.push_back(it->second);
+        mValues.push_back(value);
+    }
+
+    return it->second;
+}
+
+unsigned AliasSetPartition::Impl::find(unsigned node)
+{
+    while (mParent[node] != node) {
+        mParent[node] = mParent[mParent[node]];
+        node = mParent[node];
+    }
+
+    return node;
+}
+
+void AliasSetPartition::Impl::merge(unsigned lhs, unsigned rhs)
+{
+    lhs = this->find(lhs);
+    rhs = this->find(rhs);
+    if (lhs == rhs) {
+        return;
+    }
+
+    // Keep the unknown node as the representative of its class.
+    if (rhs == mUnknown) {
+        std::swap(lhs, rhs);
+    }
+    mParent[rhs] = lhs;
+}
+
+bool AliasSetPartition::Impl::isIdentifiedObject(const llvm::Value* object) const
+{
+    if (llvm::isa<llvm::GlobalVariable>(object) || llvm::isa<llvm::AllocaInst>(object)) {
+        return true;
+    }
+
+    if (auto arg = llvm::dyn_cast<llvm::Argument>(object)) {
+        // Parameters are merged with the actual arguments of each call.
+        const llvm::Function* function = arg->getParent();
+        return function != mEntry && !function->hasAddressTaken();
+    }
+
+    if (auto call = llvm::ImmutableCallSite(object)) {
+        // Calls to defined functions are merged with their returned values.
+        const llvm::Function* callee = getCalledFunction(call);
+        return callee != nullptr && !callee->isIntrinsic()
+            && (!callee->isDeclaration() || isAllocationFunction(callee->getName()));
+    }
+
+    return false;
+}
+
+void AliasSetPartition::Impl::anchor(const llvm::Value* ptr)
+{
+    // Merge the pointer with the objects it may be derived from.
+    llvm::SmallVector<const llvm::Value*, 4> worklist;
+    llvm::SmallPtrSet<const llvm::Value*, 4> visited;
+    worklist.push_back(ptr);
+
+    while (!worklist.empty()) {
+        const llvm::Value* current = worklist.pop_back_val()->stripPointerCasts();
+        if (!visited.insert(current).second) {
+            continue;
+        }
+
+        if (auto gep = llvm::dyn_cast<llvm::GEPOperator>(current)) {
+            worklist.push_back(gep->getPointerOperand());
+        } else if (auto phi = llvm::dyn_cast<llvm::PHINode>(current)) {
+            worklist.append(phi->value_op_begin(), phi->value_op_end());
+        } else if (auto select = llvm::dyn_cast<llvm::SelectInst>(current)) {
+            worklist.push_back(select->getTrueValue());
+            worklist.push_back(select->getFalseValue());
+        } else if (llvm::isa<llvm::ConstantPointerNull>(current) || llvm::isa<llvm::UndefValue>(current)
+            || llvm::isa<llvm::Function>(current)
+        ) {
+            // These do not point into memory.
+            continue;
+        } else if (this->isIdentifiedObject(current)) {
+            this->merge(ptr, current);
+        } else if (auto call = llvm::ImmutableCallSite(current)) {
+            const llvm::Function* callee = getCalledFunction(call);
+            if (callee != nullptr && (returnsFirstArgument(callee->getName())
+                || callee->getIntrinsicID() == llvm::Intrinsic::ssa_copy)
+            ) {
+                worklist.push_back(call.getArgument(0));
+            } else {
+                this->escape(ptr);
+            }
+        } else {
+            // Loaded pointers, pointers forged from integers and the like
+            // may point anywhere.
+            this->escape(ptr);
+        }
+    }
+}
+
+void AliasSetPartition::Impl::visitCall(llvm::ImmutableCallSite call)
+{
+    const llvm::Function* callee = getCalledFunction(call);
+    if (callee != nullptr && callee->isIntrinsic()) {
+        // Memory intrinsics do not capture their arguments, the rest of the
+        // intrinsics do not access memory at all.
+        return;
+    }
+
+    if (callee == nullptr || callee->isDeclaration()) {
+        llvm::StringRef name = callee != nullptr ? callee->getName() : "";
+        if (name == "realloc") {
+            this->merge(call.getInstruction(), call.getArgument(0));
+        } else if (callee == nullptr || !isNonCapturingLibraryFunction(name)) {
+            // Indirect calls and unknown functions may do anything with their arguments.
+            for (const llvm::Value* arg : call.args()) {
+                if (arg->getType()->isPointerTy()) {
+                    this->escape(arg);
+                }
+            }
+        }
+        return;
+    }
+
+    unsigned idx = 0;
+    for (const llvm::Value* arg : call.args()) {
+        if (arg->getType()->isPointerTy()) {
+            if (idx < callee->arg_size() && (callee->arg_begin() + idx)->getType()->isPointerTy()) {
+                this->merge(arg, callee->arg_begin() + idx);
+            } else {
+                // Variadic arguments and type punning across the call
+                this->escape(arg);
+            }
+        }
+        ++idx;
+    }
+
+    if (call.getType()->isPointerTy()) {
+        for (const llvm::BasicBlock& bb : *callee) {
+            if (auto ret = llvm::dyn_cast<llvm::ReturnInst>(bb.getTerminator())) {
+                this->merge(call.getInstruction(), ret->getReturnValue());
+            }
+        }
+    }
+}
+
+void AliasSetPartition::Impl::visitInstruction(const llvm::Instruction& inst)
+{
+    if (inst.getType()->isPointerTy()) {
+        this->anchor(&inst);
+    }
+
+    for (const llvm::Value* operand : inst.operands()) {
+        if (operand->getType()->isPointerTy() && llvm::isa<llvm::Constant>(operand)) {
+            this->anchor(operand);
+        }
+    }
+
+    if (auto load = llvm::dyn_cast<llvm::LoadInst>(&inst)) {
+        mAccessed.insert(load->getPointerOperand());
+    } else if (auto store = llvm::dyn_cast<llvm::StoreInst>(&inst)) {
+        mAccessed.insert(store->getPointerOperand());
+        if (store->getValueOperand()->getType()->isPointerTy()) {
+            // Objects whose address is stored into memory may be accessed
+            // through loaded pointers.
+            this->escape(store->getValueOperand());
+        }
+    } else if (auto ptrToInt = llvm::dyn_cast<llvm::PtrToIntInst>(&inst)) {
+        this->escape(ptrToInt->getPointerOperand());
+    } else if (auto ret = llvm::dyn_cast<llvm::ReturnInst>(&inst)) {
+        const llvm::Function* function = inst.getFunction();
+        llvm::Value* value = ret->getReturnValue();
+        if (value != nullptr && value->getType()->isPointerTy()
+            && (function == mEntry || function->hasAddressTaken())
+        ) {
+            this->escape(value);
+        }
+    } else if (llvm::isa<llvm::AtomicCmpXchgInst>(&inst) || llvm::isa<llvm::AtomicRMWInst>(&inst)) {
+        for (const llvm::Value* operand : inst.operands()) {
+            if (operand->getType()->isPointerTy()) {
+                mAccessed.insert(operand);
+                this->escape(operand);
+            }
+        }
+    } else if (auto call = llvm::ImmutableCallSite(&inst)) {
+        for (const llvm::Value* arg : call.args()) {
+            if (arg->getType()->isPointerTy()) {
+                mAccessed.insert(arg);
+            }
+        }
+        this->visitCall(call);
+    }
+}
+
+void AliasSetPartition::Impl::visitAliasSets(llvm::Function& function)
+{
+    llvm::AliasSetTracker tracker(mAliasAnalysis(function));
+
+    for (llvm::Instruction& inst : llvm::instructions(function)) {
+        if (auto load = llvm::dyn_cast<llvm::LoadInst>(&inst)) {
+            tracker.add(load);
+        } else if (auto store = llvm::dyn_cast<llvm::StoreInst>(&inst)) {
+            tracker.add(store);
+        } else if (auto call = llvm::CallSite(&inst)) {
+            // Calls may access any part of the objects pointed by their arguments.
+            for (llvm::Value* arg : call.args()) {
+                if (arg->getType()->isPointerTy()) {
+                    tracker.add(arg, llvm::MemoryLocation::UnknownSize, llvm::AAMDNodes());
+                }
+            }
+        }
+    }
+
+    for (const llvm::AliasSet& aliasSet : tracker) {
+        if (aliasSet.isForwardingAliasSet()) {
+            continue;
+        }
+
+        const llvm::Value* first = nullptr;
+        for (auto& entry : aliasSet) {
+            if (first == nullptr) {
+                first = entry.getValue();
+            } else {
+                this->merge(first, entry.getValue());
+            }
+        }
+    }
+}
+
+void AliasSetPartition::Impl::visitInitializer(const llvm::Constant* init)
+{
+    // Addresses stored in initializers escape into memory.
+    if (init->getType()->isPointerTy()) {
+        this->anchor(init);
+        this->escape(init);
+        return;
+    }
+
+    if (llvm::isa<llvm::ConstantAggregate>(init) || llvm::isa<llvm::ConstantExpr>(init)) {
+        for (const llvm::Value* operand : init->operands()) {
+            this->visitInitializer(llvm::cast<llvm::Constant>(operand));
+        }
+    }
+}
+
+void AliasSetPartition::Impl::analyze()
+{
+    mUnknown = this->getNode(nullptr);
+
+    for (llvm::GlobalVariable& gv : mModule.globals()) {
+        this->getNode(&gv);
+        mObjects.push_back(&gv);
+        if (gv.hasInitializer()) {
+            this->visitInitializer(gv.getInitializer());
+        }
+    }
+
+    for (llvm::Function& function : mModule) {
+        if (function.isDeclaration()) {
+            continue;
+        }
+
+        for (llvm::Argument& arg : function.args()) {
+            if (arg.getType()->isPointerTy()) {
+                this->anchor(&arg);
+            }
+        }
+
+        for (llvm::Instruction& inst : llvm::instructions(function)) {
+            this->visitInstruction(inst);
+            if (llvm::isa<llvm::AllocaInst>(&inst)) {
+                mObjects.push_back(&inst);
+            } else if (auto call = llvm::ImmutableCallSite(&inst)) {
+                const llvm::Function* callee = getCalledFunction(call);
+                if (callee != nullptr && callee->isDeclaration() && isAllocationFunction(callee->getName())) {
+                    mObjects.push_back(&inst);
+                }
+            }
+        }
+
+        this->visitAliasSets(function);
+    }
+
+    this->computeRegions();
+}
+
+void AliasSetPartition::Impl::computeRegions()
+{
+    llvm::DenseMap<unsigned, RegionID> regionOfNode;
+    llvm::StringSet<> names;
+
+    auto getOrCreateRegion = [&](unsigned node, const llvm::Value* object) -> RegionID {
+        unsigned root = this->find(node);
+        auto it = regionOfNode.find(root);
+        if (it != regionOfNode.end()) {
+            return it->second;
+        }
+
+        RegionID id = mRegions.size();
+        regionOfNode[root] = id;
+
+        std::string name = object != nullptr && object->hasName() ? object->getName().str() : "aliasset";
+        if (!names.insert(name).second) {
+            name += "." + std::to_string(id);
+            names.insert(name);
+        }
+        mRegions.push_back({name, {}});
+
+        return id;
+    };
+
+    RegionID unknownId = getOrCreateRegion(mUnknown, nullptr);
+    assert(unknownId == UnknownRegion);
+    (void) unknownId;
+    mRegions[UnknownRegion].name = "unknown";
+
+    for (const llvm::Value* object : mObjects) {
+        RegionID id = getOrCreateRegion(this->getNode(object), object);
+        mRegions[id].objects.push_back(object);
+    }
+
+    for (const llvm::Value* ptr : mAccessed) {
+        getOrCreateRegion(this->getNode(ptr), nullptr);
+    }
+
+    // Every pointer seen by the analysis is mapped onto the region of its class,
+    // if the class is accessed at all.
+    for (unsigned node = 0; node < mValues.size(); ++node) {
+        auto it = regionOfNode.find(this->find(node));
+        if (mValues[node] != nullptr && it != regionOfNode.end()) {
+            mRegionOf[mValues[node]] = it->second;
+        }
+    }
+
+    LLVM_DEBUG(llvm::dbgs() << "Alias set partition found " << mRegions.size() << " regions.\n");
+}
+
+// Public interface
+//==------------------------------------------------------------------------==//
+
+AliasSetPartition::AliasSetPartition(
+    llvm::Module& module, AliasAnalysisFuncTy aliasAnalysis, const llvm::Function* entry
+) : pImpl(std::make_unique<Impl>(module, std::move(aliasAnalysis), entry))
+{
+    pImpl->analyze();
+}
+
+AliasSetPartition::~AliasSetPartition() = default;
+
+auto AliasSetPartition::getRegionFor(const llvm::Value* ptr) const -> RegionID
+{
+    return pImpl->getRegionFor(ptr);
+}
+
+unsigned AliasSetPartition::getNumRegions() const
+{
+    return pImpl->mRegions.size();
+}
+
+llvm::StringRef AliasSetPartition::getRegionName(RegionID region) const
+{
+    assert(region < pImpl->mRegions.size());
+    return pImpl->mRegions[region].name;
+}
+
+void AliasSetPartition::print(llvm::raw_ostream& os) const
+{
+    for (RegionID id = 0; id < pImpl->mRegions.size(); ++id) {
+        auto& region = pImpl->mRegions[id];
+        os << "Region " << id << " (" << region.name << "):";
+        for (const llvm::Value* object : region.objects) {
+            os << " ";
+            object->printAsOperand(os, false);
+        }
+        os << "\n";
+    }
+}
@@ -17,13 +17,22 @@
 //===----------------------------------------------------------------------===//
 #include "gazer/LLVM/Memory/MemoryModel.h"
 #include "gazer/LLVM/Memory/MemoryInstructionHandler.h"
+#include "gazer/LLVM/Instrumentation/Intrinsics.h"
 #include "gazer/LLVM/Memory/MemorySSA.h"
 #include "gazer/LLVM/Memory/MemoryUtils.h"
+#include "gazer/LLVM/Memory/ModRefSummary.h"
+#include "gazer/LLVM/Memory/PointsToAnalysis.h"
+#include "gazer/LLVM/Memory/AliasSetPartition.h"
 
 #include "gazer/Core/LiteralExpr.h"
 #include "gazer/Core/Expr/ExprBuilder.h"
 
 #include <llvm/IR/InstIterator.h>
+#include <llvm/ADT/DenseSet.h>
+#include <llvm/ADT/SetVector.h>
+#include <llvm/ADT/StringSwitch.h>
+#include <llvm/IR/Intrinsics.h>
+#include <llvm/IR/Operator.h>
 #include <llvm/IR/GetElementPtrTypeIterator.h>
 #include <llvm/Transforms/Utils/UnifyFunctionExitNodes.h>
 #include <llvm/Support/Debug.h>
@@ -39,9 +48,121 @@ namespace
 {
 
 llvm::cl::opt<bool> FlatMemoryDumpMemSSA("flat-memory-dump-memssa");
+llvm::cl::opt<bool> FlatMemoryDumpRegions("flat-memory-dump-regions");
+llvm::cl::opt<bool> FlatMemoryDumpModRef("flat-memory-dump-modref");
 
 class FlatMemoryModelInstTranslator;
 
+/// Library functions with a precise encoding in the flat memory model.
+enum class LibraryFunction
+{
+    None,
+    Memcpy,     ///< memcpy, memmove and their intrinsics.
+    Memset,     ///< memset and its intrinsic.
+    Malloc,
+    Calloc,
+    Free,
+    Strlen,
+    Strcpy,
+    Strcmp
+};
+
+LibraryFunction getLibraryFunction(const llvm::Function* callee)
+{
+    if (callee == nullptr || !callee->isDeclaration()) {
+        return LibraryFunction::None;
+    }
+
+    switch (callee->getIntrinsicID()) {
+        case llvm::Intrinsic::memcpy:
+        case llvm::Intrinsic::memmove:
+            return LibraryFunction::Memcpy;
+        case llvm::Intrinsic::memset:
+            return LibraryFunction::Memset;
+        case llvm::Intrinsic::not_intrinsic:
+            break;
+        default:
+            return LibraryFunction::None;
+    }
+
+    return llvm::StringSwitch<LibraryFunction>(callee->getName())
+        .Cases("memcpy", "memmove", LibraryFunction::Memcpy)
+        .Case("memset", LibraryFunction::Memset)
+        .Case("malloc", LibraryFunction::Malloc)
+        .Case("calloc", LibraryFunction::Calloc)
+        .Case("free", LibraryFunction::Free)
+        .Case("strlen", LibraryFunction::Strlen)
+        .Case("strcpy", LibraryFunction::Strcpy)
+        .Case("strcmp", LibraryFunction::Strcmp)
+        .Default(LibraryFunction::None);
+}
+
+bool isHeapAllocation(LibraryFunction function)
+{
+    return function == LibraryFunction::Malloc || function == LibraryFunction::Calloc;
+}
+
+/// Returns the value \p ptr was derived from through casts and address arithmetic.
+const llvm::Value* getBaseObject(const llvm::Value* ptr)
+{
+    const llvm::Value* base = ptr->stripPointerCasts();
+    while (auto gep = llvm::dyn_cast<llvm::GEPOperator>(base)) {
+        base = gep->getPointerOperand()->stripPointerCasts();
+    }
+
+    return base;
+}
+
+/// Returns true if the object freed through \p base cannot be determined,
+/// thus the deallocation may end the lifetime of any heap object.
+bool isUnresolvedDeallocation(const llvm::Value* base)
+{
+    if (llvm::isa<llvm::ConstantPointerNull>(base) || llvm::isa<llvm::AllocaInst>(base)
+        || llvm::isa<llvm::GlobalValue>(base)
+    ) {
+        return false;
+    }
+
+    auto call = llvm::dyn_cast<llvm::CallInst>(base);
+    return call == nullptr || !isHeapAllocation(getLibraryFunction(call->getCalledFunction()));
+}
+
+/// Collects the pointers through which a library function may write and read memory.
+/// Partial writes also read the previous contents of the memory.
+void getLibraryEffects(
+    LibraryFunction function, llvm::ImmutableCallSite call,
+    llvm::SmallVectorImpl<const llvm::Value*>& mod,
+    llvm::SmallVectorImpl<const llvm::Value*>& ref)
+{
+    switch (function) {
+        case LibraryFunction::Memcpy:
+        case LibraryFunction::Strcpy:
+            mod.push_back(call.getArgument(0));
+            ref.push_back(call.getArgument(0));
+            ref.push_back(call.getArgument(1));
+            break;
+        case LibraryFunction::Memset:
+            mod.push_back(call.getArgument(0));
+            ref.push_back(call.getArgument(0));
+            break;
+        case LibraryFunction::Calloc:
+            mod.push_back(call.getInstruction());
+            ref.push_back(call.getInstruction());
+            break;
+        case LibraryFunction::Strlen:
+            ref.push_back(call.getArgument(0));
+            break;
+        case LibraryFunction::Strcmp:
+            ref.push_back(call.getArgument(0));
+            ref.push_back(call.getArgument(1));
+            break;
+        case LibraryFunction::Malloc:
+        case LibraryFunction::Free:
+        case LibraryFunction::None:
+            break;
+    }
+}
+
 struct CallInfo
 {
     llvm::DenseMap<MemoryObject*, memory::CallDef*> defs;
@@ -50,20 +171,44 @@ struct CallInfo
 
 struct FlatMemoryFunctionInfo
 {
+    // The memory region of pointers with unknown targets. If the memory is
+    // not partitioned, this is the only region.
     MemoryObject* memory;
     MemoryObject* stackPointer;
     MemoryObject* framePointer;
 
-    MemoryObjectUse* exitUse;
+    // The next free address of the heap. Unlike the stack pointer, it is
+    // returned to the callers, as heap allocations outlive their function.
+    MemoryObject* heapPointer;
+
+    // Memory objects of each points-to region, indexed by their region identifier.
+    std::vector<MemoryObject*> regions;
+
+    bool hasReturn = false;
+
+    // Scalar memory objects of the promoted global variables' fields. Globals
+    // are promoted module-wide, therefore their order is the same in each function.
+    std::vector<MemoryObject*> globalScalars;
+
+    // Maps the loads and stores of promoted globals and allocas onto the
+    // memory objects of their fields.
+    llvm::DenseMap<const llvm::Instruction*, MemoryObject*> scalarAccesses;
 
-    // Maps lifted globals onto their corresponding memory objects.
-    llvm::DenseMap<llvm::GlobalVariable*, MemoryObject*> globals;
+    // Maps promoted allocas onto the memory objects of their fields.
+    llvm::DenseMap<const llvm::AllocaInst*, std::vector<MemoryObject*>> allocaScalars;
+
+    // Initial values of promoted global fields, null if unknown.
+    llvm::DenseMap<const MemoryObject*, llvm::Constant*> scalarInitializers;
 
     // Maps non-lifted globals to their addresses in memory.
     llvm::DenseMap<llvm::GlobalVariable*, ExprRef<LiteralExpr>> globalPointers;
 
     llvm::DenseMap<llvm::CallSite, CallInfo> calls;
 
+    // Boolean objects tracking whether a heap allocation is still live,
+    // created only if the module is instrumented with memory safety checks.
+    llvm::DenseMap<const llvm::Value*, MemoryObject*> allocationFlags;
+
     std::unique_ptr<memory::MemorySSA> memorySSA;
 };
 
@@ -74,19 +219,37 @@ public:
     static constexpr unsigned StackBegin32  = 0x40000000;
     static constexpr unsigned HeapBegin32   = 0xF0000000;
 
+    static constexpr unsigned HeapAlignment = 8;
+
+    static constexpr unsigned MaxPromotedFields = 16;
+
+    /// Library functions accessing memory of a constant size are unrolled up to
+    /// this many bytes, larger accesses clobber the whole region.
+    static constexpr unsigned MaxLibraryConstantSize = 256;
+
+    /// Library functions accessing memory of a symbolic size (including strings)
+    /// are encoded precisely up to this many bytes.
+    static constexpr unsigned MaxLibrarySymbolicSize = 16;
+
     using DominatorTreeFuncTy = std::function<llvm::DominatorTree&(llvm::Function&)>;
+    using AliasAnalysisFuncTy = memory::AliasSetPartition::AliasAnalysisFuncTy;
 
 public:
     FlatMemoryModel(
         GazerContext& context,
         const LLVMFrontendSettings& settings,
         llvm::Module& module,
-        DominatorTreeFuncTy dominators
+        DominatorTreeFuncTy dominators,
+        AliasAnalysisFuncTy aliasAnalysis
     );
 
     void insertCallDefsUses(
         llvm::CallSite call, FlatMemoryFunctionInfo& info, memory::MemorySSABuilder& builder);
 
+    std::vector<MemoryObject*> createScalarObjects(
+        const llvm::Value* object, const memory::PromotableObject& promoted, llvm::Function& function,
+        FlatMemoryFunctionInfo& info, memory::MemorySSABuilder& builder, unsigned& nextId);
+
     MemoryTypeTranslator& getMemoryTypeTranslator() override { return *this; }
     
     MemoryInstructionHandler& getMemoryInstructionHandler(llvm::Function& function) override;
@@ -108,8 +271,8 @@ public:
         return BvType::Get(mContext, 8);
     }
 
-    gazer::ArrayType& memoryArrayType() {
-        return ArrayType::Get(ptrType(), cellType());
+    gazer::ArrayType& memoryArrayType(unsigned cellSize = 1) {
+        return ArrayType::Get(ptrType(), BvType::Get(mContext, cellSize * 8));
     }
 
     ExprRef<BvLiteralExpr> ptrConstant(unsigned addr) {
@@ -125,6 +288,51 @@ public:
 
     const LLVMFrontendSettings& getSettings() const { return mSettings; }
 
+    /// Returns the region of the memory pointed to by \p ptr.
+    unsigned getRegionFor(const llvm::Value* ptr) const {
+        if (mPointsTo != nullptr) {
+            return mPointsTo->getRegionFor(ptr);
+        }
+        return mAliasSets != nullptr ? mAliasSets->getRegionFor(ptr) : 0;
+    }
+
+    unsigned getNumRegions() const {
+        if (mPointsTo != nullptr) {
+            return mPointsTo->getNumRegions();
+        }
+        return mAliasSets != nullptr ? mAliasSets->getNumRegions() : 1;
+    }
+
+    llvm::StringRef getRegionName(unsigned region) const {
+        return mPointsTo != nullptr ? mPointsTo->getRegionName(region) : mAliasSets->getRegionName(region);
+    }
+
+    /// Returns true if \p function or its callees may read or write \p location.
+    /// Locations are the regions, followed by the fields of promoted globals.
+    bool mayAccess(const llvm::Function* function, unsigned location) const {
+        return mModRef->mayAccess(function, location);
+    }
+
+    /// Returns true if \p function or its callees may write \p location.
+    bool mayModify(const llvm::Function* function, unsigned location) const {
+        return mModRef->mayModify(function, location);
+    }
+
+    /// The location representing the heap pointer, modified by allocations.
+    unsigned getHeapLocation() const {
+        return mModRef->getNumLocations() - 1;
+    }
+
+    /// Returns the size of the array elements representing a given region.
+    unsigned getCellSize(unsigned region) const {
+        if (mPointsTo == nullptr || !mSettings.memoryWordCells) {
+            return 1;
+        }
+
+        uint64_t size = mPointsTo->getUniformAccessSize(region);
+        return size != 0 ? size : 1;
+    }
+
 private:
     const LLVMFrontendSettings& mSettings;
     const llvm::DataLayout& mDataLayout;
@@ -132,16 +340,58 @@ private:
     std::unordered_map<
         const llvm::Function*, std::unique_ptr<MemoryInstructionHandler>> mTranslators;
     std::unique_ptr<ExprBuilder> mExprBuilder;
+    std::unique_ptr<memory::PointsToAnalysis> mPointsTo;
+    std::unique_ptr<memory::AliasSetPartition> mAliasSets;
+    std::unique_ptr<memory::ModRefSummary> mModRef;
     LLVMTypeTranslator mTypes;
 };
 
 } // namespace
 
+/// Returns the constant at \p field within the initializer \p init,
+/// or nullptr if it cannot be determined.
+static llvm::Constant* getConstantField(
+    llvm::Constant* init, const memory::ScalarField& field, const llvm::DataLayout& dl)
+{
+    uint64_t offset = field.offset;
+    while (init != nullptr) {
+        llvm::Type* type = init->getType();
+        if (offset == 0 && type == field.type) {
+            return init;
+        }
+
+        if (llvm::isa<llvm::ConstantAggregateZero>(init)) {
+            return llvm::Constant::getNullValue(field.type);
+        }
+
+        if (llvm::isa<llvm::UndefValue>(init)) {
+            return llvm::UndefValue::get(field.type);
+        }
+
+        if (auto structTy = llvm::dyn_cast<llvm::StructType>(type)) {
+            const llvm::StructLayout* layout = dl.getStructLayout(structTy);
+            unsigned idx = layout->getElementContainingOffset(offset);
+            offset -= layout->getElementOffset(idx);
+            init = init->getAggregateElement(idx);
+        } else if (type->isArrayTy()) {
+            uint64_t elemSize = dl.getTypeAllocSize(type->getArrayElementType());
+            init = init->getAggregateElement(offset / elemSize);
+            offset %= elemSize;
+        } else {
+            // Type punning in the initializer
+            return nullptr;
+        }
+    }
+
+    return nullptr;
+}
+
 FlatMemoryModel::FlatMemoryModel(
     GazerContext& context,
     const LLVMFrontendSettings& settings,
     llvm::Module& module,
-    DominatorTreeFuncTy dominators
+    DominatorTreeFuncTy dominators,
+    AliasAnalysisFuncTy aliasAnalysis
 ) : MemoryTypeTranslator(context),
     mSettings(settings),
     mDataLayout(module.getDataLayout()),
@@ -150,18 +400,125 @@ FlatMemoryModel::FlatMemoryModel(
     // Initialize the expression builder
     mExprBuilder = CreateFoldingExprBuilder(mContext);
 
-    // If the global variable never has its address taken, we can lift it from
-    // the memory array into its own memory object, as distinct globals never alias.
-    llvm::SmallPtrSet<llvm::GlobalVariable*, 8> liftedGlobals;
-    llvm::SmallPtrSet<llvm::GlobalVariable*, 4> otherGlobals;
+    if (mSettings.memoryModel == MemoryModelSetting::Regions) {
+        mPointsTo = std::make_unique<memory::PointsToAnalysis>(
+            module, mSettings.getEntryFunction(module));
+
+        if (FlatMemoryDumpRegions) {
+            mPointsTo->print(llvm::errs());
+        }
+    } else if (mSettings.memoryModel == MemoryModelSetting::AliasSets) {
+        mAliasSets = std::make_unique<memory::AliasSetPartition>(
+            module, aliasAnalysis, mSettings.getEntryFunction(module));
+
+        if (FlatMemoryDumpRegions) {
+            mAliasSets->print(llvm::errs());
+        }
+    }
+
+    // If the global variable never has its address taken, we can lift its fields
+    // from the memory array into their own scalar memory objects, as distinct
+    // globals never alias.
+    std::vector<std::pair<llvm::GlobalVariable*, memory::PromotableObject>> liftedGlobals;
+    std::vector<llvm::GlobalVariable*> otherGlobals;
 
     for (llvm::GlobalVariable& gv : module.globals()) {
-        // FIXME: We currently do not lift globals which have array or struct types.
-        //if (!memory::isGlobalUsedAsPointer(gv) && gv.getType()->isSingleValueType()) {
-        //    liftedGlobals.insert(&gv);
-        //} else {
-            otherGlobals.insert(&gv);
-        //}
+        memory::PromotableObject promoted;
+        if (mSettings.promoteMemory
+            && memory::findPromotableFields(&gv, mDataLayout, promoted, MaxPromotedFields)
+        ) {
+            liftedGlobals.emplace_back(&gv, std::move(promoted));
+        } else {
+            otherGlobals.push_back(&gv);
+        }
+    }
+
+    // Allocas which do not escape may be promoted as well. Static allocas
+    // dominate all of their uses, thus their fields need no entry definition.
+    llvm::DenseMap<const llvm::AllocaInst*, memory::PromotableObject> promotedAllocas;
+    if (mSettings.promoteMemory) {
+        for (llvm::Function& function : module) {
+            for (llvm::Instruction& inst : llvm::instructions(function)) {
+                auto alloca = llvm::dyn_cast<llvm::AllocaInst>(&inst);
+                memory::PromotableObject promoted;
+                if (alloca != nullptr && alloca->isStaticAlloca()
+                    && memory::findPromotableFields(alloca, mDataLayout, promoted, MaxPromotedFields)
+                ) {
+                    promotedAllocas[alloca] = std::move(promoted);
+                }
+            }
+        }
+    }
+
+    // Summarize the memory locations accessed by each function, so that calls
+    // only pass and return the regions and global fields used by the callee.
+    llvm::DenseMap<const llvm::Instruction*, unsigned> scalarLocations;
+    unsigned numLocations = this->getNumRegions();
+    for (auto& [gv, promoted] : liftedGlobals) {
+        for (auto& [inst, idx] : promoted.accesses) {
+            scalarLocations[inst] = numLocations + idx;
+        }
+        numLocations += promoted.fields.size();
+    }
+    // Promoted allocas are local to their function, their accesses are not visible
+    // to the callers.
+    llvm::DenseSet<const llvm::Instruction*> localAccesses;
+    for (auto& [alloca, promoted] : promotedAllocas) {
+        for (auto& [inst, idx] : promoted.accesses) {
+            localAccesses.insert(inst);
+        }
+    }
+
+    // The heap pointer is the last location.
+    mModRef = std::make_unique<memory::ModRefSummary>(module, numLocations + 1,
+        [this, &scalarLocations, &localAccesses, &promotedAllocas](
+            const llvm::Instruction& inst, llvm::BitVector& mod, llvm::BitVector& ref
+        ) {
+            if (localAccesses.count(&inst) != 0) {
+                return;
+            }
+
+            auto getLocation = [&](const llvm::Value* ptr) {
+                auto it = scalarLocations.find(&inst);
+                return it != scalarLocations.end() ? it->second : this->getRegionFor(ptr);
+            };
+
+            if (auto store = llvm::dyn_cast<llvm::StoreInst>(&inst)) {
+                mod.set(getLocation(store->getPointerOperand()));
+            } else if (auto load = llvm::dyn_cast<llvm::LoadInst>(&inst)) {
+                ref.set(getLocation(load->getPointerOperand()));
+            } else if (auto alloca = llvm::dyn_cast<llvm::AllocaInst>(&inst)) {
+                if (promotedAllocas.count(alloca) == 0) {
+                    mod.set(this->getRegionFor(alloca));
+                }
+            } else if (auto call = llvm::dyn_cast<llvm::CallInst>(&inst)) {
+                // Indirect calls may clobber anything.
+                if (call->getCalledFunction() == nullptr) {
+                    mod.set();
+                    ref.set();
+                    return;
+                }
+
+                LibraryFunction libFunction = getLibraryFunction(call->getCalledFunction());
+                if (isHeapAllocation(libFunction)) {
+                    mod.set(this->getHeapLocation());
+                    ref.set(this->getHeapLocation());
+                }
+
+                llvm::SmallVector<const llvm::Value*, 2> modPtrs;
+                llvm::SmallVector<const llvm::Value*, 2> refPtrs;
+                getLibraryEffects(libFunction, call, modPtrs, refPtrs);
+                for (const llvm::Value* ptr : modPtrs) {
+                    mod.set(this->getRegionFor(ptr));
+                }
+                for (const llvm::Value* ptr : refPtrs) {
+                    ref.set(this->getRegionFor(ptr));
+                }
+            }
+        });
+
+    if (FlatMemoryDumpModRef) {
+        mModRef->print(llvm::errs());
     }
 
     for (llvm::Function& function : module) {
@@ -186,26 +543,80 @@ FlatMemoryModel::FlatMemoryModel(
             2, MemoryObjectType::Unknown, mDataLayout.getPointerSize(), nullptr, "FramePtr");
         info.framePointer->setTypeHint(ptrType());
 
-        builder.createLiveOnEntryDef(info.memory);
+        info.heapPointer = builder.createMemoryObject(
+            this->getNumRegions() + 2, MemoryObjectType::Unknown, mDataLayout.getPointerSize(),
+            nullptr, "HeapPtr");
+        info.heapPointer->setTypeHint(ptrType());
+
+        // Each region is represented by its own array, using the same address space.
+        info.regions.push_back(info.memory);
+        for (unsigned i = 1; i < this->getNumRegions(); ++i) {
+            auto region = builder.createMemoryObject(
+                i + 2, MemoryObjectType::Unknown, MemoryObject::UnknownSize, nullptr,
+                "Memory." + this->getRegionName(i).str());
+            region->setTypeHint(memoryArrayType(this->getCellSize(i)));
+            info.regions.push_back(region);
+        }
+
+        // Memory locations which are not accessed by this function or its
+        // callees are not part of its interface. The entry function has no
+        // callers, its entry definitions are local variables.
+        auto isAccessed = [&](unsigned location) {
+            return isEntryFunction || this->mayAccess(&function, location);
+        };
+        auto isModified = [&](unsigned location) {
+            return isEntryFunction || this->mayModify(&function, location);
+        };
+
+        for (unsigned i = 0; i < info.regions.size(); ++i) {
+            if (isAccessed(i)) {
+                builder.createLiveOnEntryDef(info.regions[i]);
+            }
+        }
         builder.createLiveOnEntryDef(info.stackPointer);
         builder.createLiveOnEntryDef(info.framePointer);
+        if (isAccessed(this->getHeapLocation())) {
+            builder.createLiveOnEntryDef(info.heapPointer);
+        }
 
         // Handle global variables
-        unsigned globalCnt = 2;
-        info.globals.reserve(liftedGlobals.size());
-
-        for (llvm::GlobalVariable* gv : liftedGlobals) {
-            auto gvObj = builder.createMemoryObject(
-                globalCnt++,
-                MemoryObjectType::Scalar,
-                mDataLayout.getTypeAllocSize(gv->getType()->getPointerElementType()),
-                gv->getType()->getPointerElementType(),
-                gv->getName()
-            );
-            info.globals[gv] = gvObj;
+        unsigned objectCnt = info.regions.size() + 3;
+
+        for (auto& [gv, promoted] : liftedGlobals) {
+            auto fields = this->createScalarObjects(
+                gv, promoted, function, info, builder, objectCnt);
+            for (unsigned i = 0; i < fields.size(); ++i) {
+                if (isAccessed(info.regions.size() + info.globalScalars.size() + i)) {
+                    builder.createLiveOnEntryDef(fields[i]);
+                }
+                if (isEntryFunction && gv->hasInitializer()) {
+                    builder.createGlobalInitializerDef(fields[i], gv);
+                    info.scalarInitializers[fields[i]] = getConstantField(
+                        gv->getInitializer(), promoted.fields[i], mDataLayout);
+                }
+            }
+            info.globalScalars.insert(info.globalScalars.end(), fields.begin(), fields.end());
+        }
 
-            if (isEntryFunction && gv->hasInitializer()) {
-                builder.createGlobalInitializerDef(gvObj, gv);
+        for (llvm::Instruction& inst : llvm::instructions(function)) {
+            auto alloca = llvm::dyn_cast<llvm::AllocaInst>(&inst);
+            if (alloca != nullptr && promotedAllocas.count(alloca) != 0) {
+                info.allocaScalars[alloca] = this->createScalarObjects(
+                    alloca, promotedAllocas[alloca], function, info, builder, objectCnt);
+            }
+        }
+
+        // Use-after-free checks need to know whether an allocation was freed.
+        if (module.getFunction(GazerIntrinsic::ValidAccessName) != nullptr) {
+            for (llvm::Instruction& inst : llvm::instructions(function)) {
+                auto call = llvm::dyn_cast<llvm::CallInst>(&inst);
+                if (call != nullptr && isHeapAllocation(getLibraryFunction(call->getCalledFunction()))) {
+                    info.allocationFlags[call] = builder.createMemoryObject(
+                        objectCnt++, MemoryObjectType::Scalar, 1,
+                        llvm::Type::getInt1Ty(module.getContext()),
+                        "Alive." + std::to_string(info.allocationFlags.size())
+                    );
+                }
             }
         }
 
@@ -218,23 +629,55 @@ FlatMemoryModel::FlatMemoryModel(
             globalAddr += siz;
 
             if (isEntryFunction && gv->hasInitializer()) {
-                builder.createGlobalInitializerDef(info.memory, gv);
+                builder.createGlobalInitializerDef(info.regions[this->getRegionFor(gv)], gv);
             }
         }
 
         // Handle definitions and uses in instructions.
         for (llvm::Instruction& inst : llvm::instructions(function)) {
             if (auto store = llvm::dyn_cast<llvm::StoreInst>(&inst)) {
-                builder.createStoreDef(info.memory, *store);
+                MemoryObject* object = info.scalarAccesses.lookup(store);
+                if (object == nullptr) {
+                    object = info.regions[this->getRegionFor(store->getPointerOperand())];
+                }
+                builder.createStoreDef(object, *store);
             } else if (auto load = llvm::dyn_cast<llvm::LoadInst>(&inst)) {
-                builder.createLoadUse(info.memory, *load);
+                MemoryObject* object = info.scalarAccesses.lookup(load);
+                if (object == nullptr) {
+                    object = info.regions[this->getRegionFor(load->getPointerOperand())];
+                }
+                builder.createLoadUse(object, *load);
             } else if (auto call = llvm::dyn_cast<llvm::CallInst>(&inst)) {
                 this->insertCallDefsUses(call, info, builder);
             } else if (auto ret = llvm::dyn_cast<llvm::ReturnInst>(&inst)) {
-                assert(info.exitUse == nullptr && "There must be at most one return use!");
-                info.exitUse = builder.createReturnUse(info.memory, *ret);
+                assert(!info.hasReturn && "There must be at most one return instruction!");
+                info.hasReturn = true;
+
+                // Only the modified locations are returned to the caller.
+                for (unsigned i = 0; i < info.regions.size(); ++i) {
+                    if (isModified(i)) {
+                        builder.createReturnUse(info.regions[i], *ret);
+                    }
+                }
+                for (unsigned i = 0; i < info.globalScalars.size(); ++i) {
+                    if (isModified(info.regions.size() + i)) {
+                        builder.createReturnUse(info.globalScalars[i], *ret);
+                    }
+                }
+                if (isModified(this->getHeapLocation())) {
+                    builder.createReturnUse(info.heapPointer, *ret);
+                }
             } else if (auto alloca = llvm::dyn_cast<llvm::AllocaInst>(&inst)) {
-                builder.createAllocaDef(info.memory, *alloca);
+                auto it = info.allocaScalars.find(alloca);
+                if (it != info.allocaScalars.end()) {
+                    // Promoted allocas do not occupy any space in the memory.
+                    for (MemoryObject* scalar : it->second) {
+                        builder.createAllocaDef(scalar, *alloca);
+                    }
+                    continue;
+                }
+
+                builder.createAllocaDef(info.regions[this->getRegionFor(alloca)], *alloca);
                 builder.createAllocaDef(info.stackPointer, *alloca);
             }
         }
@@ -248,21 +691,101 @@ FlatMemoryModel::FlatMemoryModel(
     }
 }
 
+auto FlatMemoryModel::createScalarObjects(
+    const llvm::Value* object, const memory::PromotableObject& promoted, llvm::Function& function,
+    FlatMemoryFunctionInfo& info, memory::MemorySSABuilder& builder, unsigned& nextId)
+    -> std::vector<MemoryObject*>
+{
+    std::vector<MemoryObject*> result;
+    for (const memory::ScalarField& field : promoted.fields) {
+        std::string name = object->getName().str();
+        if (promoted.fields.size() != 1) {
+            name += "." + std::to_string(field.offset);
+        }
+
+        MemoryObject* scalar = builder.createMemoryObject(
+            nextId++, MemoryObjectType::Scalar, mDataLayout.getTypeAllocSize(field.type),
+            field.type, name);
+        result.push_back(scalar);
+    }
+
+    for (auto& [inst, idx] : promoted.accesses) {
+        if (inst->getFunction() == &function) {
+            info.scalarAccesses[inst] = result[idx];
+        }
+    }
+
+    return result;
+}
+
 void FlatMemoryModel::insertCallDefsUses(
     llvm::CallSite call, FlatMemoryFunctionInfo& info, memory::MemorySSABuilder& builder)
 {
     llvm::Function* callee = call.getCalledFunction();
 
     if (callee == nullptr) {
-        builder.createCallDef(info.memory, call);
-        builder.createCallUse(info.memory, call);
+        for (MemoryObject* region : info.regions) {
+            builder.createCallDef(region, call);
+            builder.createCallUse(region, call);
+        }
+        return;
+    }
+
+    LibraryFunction libFunction = getLibraryFunction(callee);
+    if (libFunction != LibraryFunction::None) {
+        // Library calls define and use the regions of their pointer operands.
+        llvm::SmallVector<const llvm::Value*, 2> modPtrs;
+        llvm::SmallVector<const llvm::Value*, 2> refPtrs;
+        getLibraryEffects(libFunction, call, modPtrs, refPtrs);
+
+        llvm::SmallSetVector<MemoryObject*, 2> defined;
+        llvm::SmallSetVector<MemoryObject*, 2> used;
+        for (const llvm::Value* ptr : modPtrs) {
+            defined.insert(info.regions[this->getRegionFor(ptr)]);
+        }
+        for (const llvm::Value* ptr : refPtrs) {
+            used.insert(info.regions[this->getRegionFor(ptr)]);
+        }
+
+        // Allocations advance the heap pointer.
+        if (isHeapAllocation(libFunction)) {
+            defined.insert(info.heapPointer);
+            used.insert(info.heapPointer);
+        }
+
+        // Allocations and deallocations set the liveness of their object.
+        const llvm::Value* allocation = libFunction == LibraryFunction::Free
+            ? getBaseObject(call.getArgument(0)) : call.getInstruction();
+        if (MemoryObject* flag = info.allocationFlags.lookup(allocation)) {
+            defined.insert(flag);
+        } else if (libFunction == LibraryFunction::Free && isUnresolvedDeallocation(allocation)) {
+            for (auto& [object, flag] : info.allocationFlags) {
+                defined.insert(flag);
+                used.insert(flag);
+            }
+        }
+
+        auto& callInfo = info.calls[call];
+        for (MemoryObject* object : used) {
+            callInfo.uses[object] = builder.createCallUse(object, call);
+        }
+        for (MemoryObject* object : defined) {
+            callInfo.defs[object] = builder.createCallDef(object, call);
+        }
         return;
     }
 
     llvm::StringRef name = callee->getName();
 
+    if (name == GazerIntrinsic::ValidAccessName) {
+        const llvm::Value* base = getBaseObject(call.getArgument(2));
+        if (MemoryObject* flag = info.allocationFlags.lookup(base)) {
+            info.calls[call].uses[flag] = builder.createCallUse(flag, call);
+        }
+        return;
+    }
+
     if (name.startswith("gazer.") || name.startswith("llvm.") || name.startswith("verifier.")) {
-        // TODO: This may need to change in the case of some intrinsics (e.g. llvm.memcpy)
         return;
     }
 
@@ -271,7 +794,7 @@ void FlatMemoryModel::insertCallDefsUses(
     }
 
     if (callee->isDeclaration()) {
-        // TODO: We could handle some know function here or clobber the memory according to
+        // TODO: Unknown external functions could clobber the memory according to
         // some configuration option.
         return;
     }
@@ -280,15 +803,29 @@ void FlatMemoryModel::insertCallDefsUses(
 
     auto& callInfo = info.calls[call];
 
-    if (definesMemory) {
-        callInfo.defs[info.memory] = builder.createCallDef(info.memory, call);
+    // The call passes the locations accessed by the callee, and receives
+    // the locations it modifies.
+    auto insertDefUse = [&](MemoryObject* object, unsigned location) {
+        if (!this->mayAccess(callee, location)) {
+            return;
+        }
+
+        if (definesMemory && this->mayModify(callee, location)) {
+            callInfo.defs[object] = builder.createCallDef(object, call);
+        }
+        callInfo.uses[object] = builder.createCallUse(object, call);
+    };
+
+    for (unsigned i = 0; i < info.regions.size(); ++i) {
+        insertDefUse(info.regions[i], i);
     }
+    for (unsigned i = 0; i < info.globalScalars.size(); ++i) {
+        insertDefUse(info.globalScalars[i], info.regions.size() + i);
+    }
+    insertDefUse(info.heapPointer, this->getHeapLocation());
 
-    callInfo.uses[info.memory] = builder.createCallUse(info.memory, call);
     callInfo.uses[info.stackPointer] = builder.createCallUse(info.stackPointer, call);
     callInfo.uses[info.framePointer] = builder.createCallUse(info.framePointer, call);
-
-    // FIXME: Add global clobbers
 }
 
 // Flat memory model instruction translation
@@ -341,7 +878,11 @@ public:
 
     void handleBlock(const llvm::BasicBlock& bb, llvm2cfa::GenerationStepExtensionPoint& ep) override;
 
-    ExprPtr isValidAccess(llvm::Value* ptr, const ExprPtr& expr) override;
+    bool handleExternalCall(
+        llvm::CallSite call, llvm2cfa::GenerationStepExtensionPoint& ep) override;
+
+    ExprPtr isValidAccess(
+        llvm::CallSite check, llvm2cfa::GenerationStepExtensionPoint& ep) override;
 
 private:
     ExprPtr handleGlobalInitializer(
@@ -355,17 +896,84 @@ private:
 
     ExprPtr buildMemoryRead(
         gazer::Type& targetTy, unsigned size, const ExprPtr& array, const ExprPtr& pointer);
+
+    /// Reads a single cell of \p array. If the array was built from at most
+    /// memoryFlattenReads stores, the read is resolved into an if-then-else
+    /// chain over the addresses of these stores instead of an array read.
+    ExprPtr buildCellRead(const ExprPtr& array, const ExprPtr& address);
+
+    /// Collects the stores \p array was built from, latest first, and returns
+    /// the array they were applied to. Returns nullptr if there are more than
+    /// memoryFlattenReads stores.
+    ExprPtr collectStores(const ExprPtr& array, llvm::SmallVectorImpl<ExprRef<ArrayWriteExpr>>& writes);
+
+    /// Defines the variable of \p def as \p array. If flattening is enabled
+    /// and \p array holds a short store chain, the chain is kept symbolic
+    /// instead of being assigned to an array variable.
+    void defineArray(
+        MemoryObjectDef* def, const ExprPtr& array, llvm2cfa::GenerationStepExtensionPoint& ep);
     
     ExprPtr buildMemoryWrite(
         const ExprPtr& array, const ExprPtr& value, const ExprPtr& pointer, unsigned size);
 
+    /// Overwrites \p size bytes starting from \p pointer with undefined values.
+    ExprPtr buildMemoryClobber(const ExprPtr& array, const ExprPtr& pointer, unsigned size);
+
+    /// Writes the bytes returned by \p byteAt into the range of \p length bytes
+    /// starting from \p pointer. Lengths which are too large to be encoded
+    /// precisely clobber the whole array.
+    ExprPtr buildBoundedWrite(
+        const ExprPtr& array, const ExprPtr& pointer, const llvm::Value* length,
+        llvm::function_ref<ExprPtr(unsigned)> byteAt, llvm2cfa::GenerationStepExtensionPoint& ep);
+
+    // Library function models
+    ExprPtr buildMemcpy(llvm::CallSite call, llvm2cfa::GenerationStepExtensionPoint& ep);
+    ExprPtr buildMemset(llvm::CallSite call, llvm2cfa::GenerationStepExtensionPoint& ep);
+    ExprPtr buildStrcpy(llvm::CallSite call, llvm2cfa::GenerationStepExtensionPoint& ep);
+    ExprPtr buildStrlen(llvm::CallSite call, BvType& resultTy, llvm2cfa::GenerationStepExtensionPoint& ep);
+    ExprPtr buildStrcmp(llvm::CallSite call, BvType& resultTy, llvm2cfa::GenerationStepExtensionPoint& ep);
+
+    /// Allocates \p size bytes from the heap, returning the address of the allocation.
+    ExprPtr buildHeapAllocation(
+        llvm::CallSite call, const ExprPtr& size, llvm2cfa::GenerationStepExtensionPoint& ep);
+
+    /// Sets the liveness flag of \p allocation after \p call, if there is one.
+    void defineAllocationFlag(
+        llvm::CallSite call, const llvm::Value* allocation, bool isLive,
+        llvm2cfa::GenerationStepExtensionPoint& ep);
+
+    /// Extends or truncates a bit-vector to the width of pointers.
+    /// Returns nullptr for other types.
+    ExprPtr toPointerWidth(const ExprPtr& value);
+
+    /// Returns the array of the region pointed by \p ptr before \p call.
+    ExprPtr getCallArray(
+        llvm::CallSite call, const llvm::Value* ptr, llvm2cfa::GenerationStepExtensionPoint& ep);
+
+    /// Assigns the array of the region pointed by \p ptr after \p call.
+    void defineCallArray(
+        llvm::CallSite call, const llvm::Value* ptr, const ExprPtr& array,
+        llvm2cfa::GenerationStepExtensionPoint& ep);
+
+    /// Returns the width of the cells of a memory array.
+    unsigned getCellWidth(const ExprPtr& array) const {
+        return llvm::cast<BvType>(llvm::cast<ArrayType>(array->getType()).getElementType()).getWidth();
+    }
+
     memory::MemorySSA& getMemorySSA() const { return *mInfo.memorySSA; }
 
+    MemoryObject* getRegionObject(const llvm::Value* ptr) const {
+        return mInfo.regions[mMemoryModel.getRegionFor(ptr)];
+    }
+
 private:
     FlatMemoryModel& mMemoryModel;
     FlatMemoryFunctionInfo& mInfo;
     ExprBuilder& mExprBuilder;
-    const llvm::DataLayout& mDataLayout;
+    // A private copy, as the data layout lazily caches struct layouts and
+    // functions may be translated in parallel.
+    llvm::DataLayout mDataLayout;
+    llvm::DenseMap<Variable*, ExprPtr> mArrayDefinitions;
 };
 
 } // namespace
@@ -374,8 +982,26 @@ private:
 auto FlatMemoryModelInstTranslator::handleAlloca(const llvm::AllocaInst& alloc, llvm2cfa::GenerationStepExtensionPoint& ep)
     -> ExprPtr
 {
+    auto scalarIt = mInfo.allocaScalars.find(&alloc);
+    if (scalarIt != mInfo.allocaScalars.end()) {
+        // The fields of a promoted alloca are uninitialized, and as its address
+        // is only used to access these fields, it has no meaningful value.
+        for (MemoryObject* scalar : scalarIt->second) {
+            MemoryObjectDef* def = mMemorySSA.getUniqueDefinitionFor(&alloc, scalar);
+            assert(def != nullptr && "There must be exactly one definition for each promoted field!");
+
+            Variable* defVar = ep.getVariableFor(def);
+            ExprPtr undef = mExprBuilder.Undef(defVar->getType());
+            if (!ep.tryToEliminate(def, defVar, undef)) {
+                ep.insertAssignment(defVar, undef);
+            }
+        }
+
+        return mExprBuilder.Undef(mMemoryModel.ptrType());
+    }
+
     MemoryObjectDef* spDef = mMemorySSA.getUniqueDefinitionFor(&alloc, mInfo.stackPointer);
-    MemoryObjectDef* memDef = mMemorySSA.getUniqueDefinitionFor(&alloc, mInfo.memory);
+    MemoryObjectDef* memDef = mMemorySSA.getUniqueDefinitionFor(&alloc, this->getRegionObject(&alloc));
 
     assert(memDef != nullptr && "There must be exactly one Memory definition for an alloca!");
     assert(spDef != nullptr && "There must be exactly one StackPtr definition for an alloca!");
@@ -394,14 +1020,8 @@ auto FlatMemoryModelInstTranslator::handleAlloca(const llvm::AllocaInst& alloc,
         ptr, mMemoryModel.ptrConstant(size)
     ));
 
-    ExprPtr resArray = ep.getAsOperand(memDef->getReachingDef());
-    for (unsigned i = 0; i < size; ++i) {
-        resArray = mExprBuilder.Write(
-            resArray,
-            this->pointerOffset(ptr, i),
-            mExprBuilder.Undef(BvType::Get(mExprBuilder.getContext(), 8))
-        );
-    }
+    ExprPtr resArray = this->buildMemoryClobber(
+        ep.getAsOperand(memDef->getReachingDef()), ptr, size);
 
     Variable* memVar = ep.getVariableFor(&*memDef);
     if (!ep.tryToEliminate(&*memDef, memVar, resArray)) {
@@ -546,16 +1166,25 @@ void FlatMemoryModelInstTranslator::handleBlock(const llvm::BasicBlock& bb, llvm
     for (MemoryObjectDef& def : mMemorySSA.definitionAnnotationsFor(&bb)) {
         Variable* defVariable = ep.getVariableFor(&def);
         if (auto globalInit = llvm::dyn_cast<memory::GlobalInitializerDef>(&def)) {
-            ExprPtr pointer = ep.getAsOperand(globalInit->getGlobalVariable());
-            ExprPtr globalValue = this->handleGlobalInitializer(globalInit, pointer, ep);
-            if (!ep.tryToEliminate(&def, defVariable, globalValue)) {
-                ep.insertAssignment(defVariable, globalValue);
+            ExprPtr globalValue;
+            if (def.getObject()->getObjectType() == MemoryObjectType::Scalar) {
+                llvm::Constant* init = mInfo.scalarInitializers.lookup(def.getObject());
+                globalValue = init != nullptr && !init->getType()->isAggregateType()
+                    ? ep.getAsOperand(init)
+                    : mExprBuilder.Undef(defVariable->getType());
+            } else {
+                ExprPtr pointer = ep.getAsOperand(globalInit->getGlobalVariable());
+                globalValue = this->handleGlobalInitializer(globalInit, pointer, ep);
             }
+
+            this->defineArray(&def, globalValue, ep);
         } else if (auto liveOnEntry = llvm::dyn_cast<memory::LiveOnEntryDef>(&def)) {
             ExprPtr initVal;
             if (def.getObject() == mInfo.stackPointer || def.getObject() == mInfo.framePointer) {
                 // TODO: 64 bit
                 initVal = mMemoryModel.ptrConstant(FlatMemoryModel::StackBegin32);
+            } else if (def.getObject() == mInfo.heapPointer) {
+                initVal = mMemoryModel.ptrConstant(FlatMemoryModel::HeapBegin32);
             } else if (defVariable->getType().isArrayType()) {
                 initVal = ArrayLiteralExpr::GetEmpty(llvm::cast<ArrayType>(defVariable->getType()));
             } else {
@@ -574,7 +1203,20 @@ void FlatMemoryModelInstTranslator::handleStore(
     const llvm::StoreInst& store,
     llvm2cfa::GenerationStepExtensionPoint& ep)
 {
-    MemoryObjectDef* memoryDef = mMemorySSA.getUniqueDefinitionFor(&store, mInfo.memory);
+    if (MemoryObject* scalar = mInfo.scalarAccesses.lookup(&store)) {
+        MemoryObjectDef* def = mMemorySSA.getUniqueDefinitionFor(&store, scalar);
+        assert(def != nullptr && "There must be exactly one definition for a promoted store!");
+
+        Variable* defVariable = ep.getVariableFor(def);
+        ExprPtr value = ep.getAsOperand(store.getValueOperand());
+        if (!ep.tryToEliminate(def, defVariable, value)) {
+            ep.insertAssignment(defVariable, value);
+        }
+        return;
+    }
+
+    MemoryObjectDef* memoryDef = mMemorySSA.getUniqueDefinitionFor(
+        &store, this->getRegionObject(store.getPointerOperand()));
     assert(memoryDef != nullptr && "There must be exactly one definition for Memory on a store!");
 
     unsigned size = mDataLayout.getTypeAllocSize(store.getValueOperand()->getType());
@@ -583,19 +1225,23 @@ void FlatMemoryModelInstTranslator::handleStore(
     ExprPtr value = ep.getAsOperand(store.getValueOperand());
     ExprPtr pointer = ep.getAsOperand(store.getPointerOperand());
 
-    Variable* defVariable = ep.getVariableFor(memoryDef);
     ExprPtr write = this->buildMemoryWrite(array, value, pointer, size);
-
-    if (!ep.tryToEliminate(memoryDef, defVariable, write)) {
-        ep.insertAssignment(defVariable, write);
-    }
+    this->defineArray(memoryDef, write, ep);
 }
 
 ExprPtr FlatMemoryModelInstTranslator::handleLoad(
     const llvm::LoadInst& load,
     llvm2cfa::GenerationStepExtensionPoint& ep)
 {
-    MemoryObjectUse* use = mMemorySSA.getUniqueUseFor(&load, mInfo.memory);
+    if (MemoryObject* scalar = mInfo.scalarAccesses.lookup(&load)) {
+        MemoryObjectUse* use = mMemorySSA.getUniqueUseFor(&load, scalar);
+        assert(use != nullptr && "Each promoted load must have a valid use!");
+
+        return ep.getAsOperand(use->getReachingDef());
+    }
+
+    MemoryObjectUse* use = mMemorySSA.getUniqueUseFor(
+        &load, this->getRegionObject(load.getPointerOperand()));
     assert(use != nullptr && "Each load must have a valid use for Memory!");
 
     MemoryObjectDef* def = use->getReachingDef();
@@ -624,25 +1270,49 @@ void FlatMemoryModelInstTranslator::handleCall(
     auto& calleeInfo = mMemoryModel.getInfoFor(callee);
     auto& callInstInfo = mInfo.calls[call];
 
-    // Map the memory call definition to its return use.
+    // Regions are module-wide, thus each region of the caller corresponds to
+    // the same region of the callee.
+    assert(mInfo.regions.size() == calleeInfo.regions.size());
+    // The same holds for the fields of promoted globals.
+    assert(mInfo.globalScalars.size() == calleeInfo.globalScalars.size());
+    llvm::SmallVector<std::pair<MemoryObject*, MemoryObject*>, 8> objects;
+    for (unsigned i = 0; i < mInfo.regions.size(); ++i) {
+        objects.emplace_back(mInfo.regions[i], calleeInfo.regions[i]);
+    }
+    for (unsigned i = 0; i < mInfo.globalScalars.size(); ++i) {
+        objects.emplace_back(mInfo.globalScalars[i], calleeInfo.globalScalars[i]);
+    }
+    objects.emplace_back(mInfo.heapPointer, calleeInfo.heapPointer);
+
+    // Map the memory call definitions to their return uses.
     // We only define memory, as the stack pointer should be back to its
     // "original" position when the call returns.
-    MemoryObjectUse* use = calleeInfo.memory->getExitUse();
-    if (use != nullptr) {
-        // It is possible that the return use is ommited if the function
-        // does not return.
-        outputAssignments.emplace_back(
-            parentEp.getVariableFor(callInstInfo.defs[mInfo.memory]),
-            calleeEp.getOutputVariableFor(use->getReachingDef())->getRefExpr()
-        );
+    for (auto [actual, formal] : objects) {
+        MemoryObjectUse* use = formal->getExitUse();
+        if (use != nullptr) {
+            // It is possible that the return use is ommited if the function
+            // does not return or does not modify the object.
+            assert(callInstInfo.defs.count(actual) != 0
+                && "Objects returned by the callee must be defined by the call!");
+            outputAssignments.emplace_back(
+                parentEp.getVariableFor(callInstInfo.defs[actual]),
+                calleeEp.getOutputVariableFor(use->getReachingDef())->getRefExpr()
+            );
+        }
     }
 
-    // Map the memory, stack pointer and frame pointer to the inputs.
-    for (auto [actual, formal] : std::initializer_list<std::pair<MemoryObject*, MemoryObject*>>{ 
-        { mInfo.memory, calleeInfo.memory },
-        { mInfo.stackPointer, calleeInfo.stackPointer },
-        { mInfo.framePointer, calleeInfo.framePointer }})
-    {
+    // Map the memory regions, stack pointer and frame pointer to the inputs.
+    objects.emplace_back(mInfo.stackPointer, calleeInfo.stackPointer);
+    objects.emplace_back(mInfo.framePointer, calleeInfo.framePointer);
+
+    for (auto [actual, formal] : objects) {
+        if (!formal->hasEntryDef()) {
+            // The callee does not access this object.
+            continue;
+        }
+
+        assert(callInstInfo.uses.count(actual) != 0
+            && "Objects accessed by the callee must be used by the call!");
         inputAssignments.emplace_back(
             calleeEp.getInputVariableFor(formal->getEntryDef()),
             parentEp.getAsOperand(callInstInfo.uses[actual]->getReachingDef())
@@ -650,9 +1320,433 @@ void FlatMemoryModelInstTranslator::handleCall(
     }
 }
 
-ExprPtr FlatMemoryModelInstTranslator::isValidAccess(llvm::Value* ptr, const ExprPtr& expr)
+// Library function models
+//==------------------------------------------------------------------------==//
+
+bool FlatMemoryModelInstTranslator::handleExternalCall(
+    llvm::CallSite call, llvm2cfa::GenerationStepExtensionPoint& ep)
+{
+    LibraryFunction function = getLibraryFunction(call.getCalledFunction());
+    llvm::Instruction* inst = call.getInstruction();
+
+    // Library functions returning their destination pointer.
+    auto defineDestination = [&](const ExprPtr& array) {
+        this->defineCallArray(call, call.getArgument(0), array, ep);
+        if (inst->getType()->isVoidTy()) {
+            return false;
+        }
+
+        ep.insertAssignment(ep.getVariableFor(inst), ep.getAsOperand(call.getArgument(0)));
+        return true;
+    };
+
+    switch (function) {
+        case LibraryFunction::Memcpy:
+            return defineDestination(this->buildMemcpy(call, ep));
+        case LibraryFunction::Memset:
+            return defineDestination(this->buildMemset(call, ep));
+        case LibraryFunction::Strcpy:
+            return defineDestination(this->buildStrcpy(call, ep));
+        case LibraryFunction::Malloc:
+            ep.insertAssignment(
+                ep.getVariableFor(inst),
+                this->buildHeapAllocation(call, ep.getAsOperand(call.getArgument(0)), ep)
+            );
+            this->defineAllocationFlag(call, inst, true, ep);
+            return true;
+        case LibraryFunction::Calloc: {
+            ExprPtr count = this->toPointerWidth(ep.getAsOperand(call.getArgument(0)));
+            ExprPtr elemSize = this->toPointerWidth(ep.getAsOperand(call.getArgument(1)));
+            ExprPtr size = nullptr;
+            if (count != nullptr && elemSize != nullptr) {
+                // An overflowing size makes the allocation fail.
+                ExprPtr zero = mMemoryModel.ptrConstant(0);
+                size = mExprBuilder.Mul(count, elemSize);
+                size = mExprBuilder.Select(
+                    mExprBuilder.Or(
+                        mExprBuilder.Eq(count, zero),
+                        mExprBuilder.Eq(mExprBuilder.BvUDiv(size, count), elemSize)
+                    ),
+                    size,
+                    mExprBuilder.Sub(zero, mMemoryModel.ptrConstant(1))
+                );
+            }
+
+            ExprPtr pointer = this->buildHeapAllocation(call, size, ep);
+            ep.insertAssignment(ep.getVariableFor(inst), pointer);
+
+            // The allocated memory is zero-initialized. Larger allocations are
+            // left uninitialized, which over-approximates their contents.
+            ExprPtr array = this->getCallArray(call, inst, ep);
+
+            auto constCount = llvm::dyn_cast<llvm::ConstantInt>(call.getArgument(0));
+            auto constSize = llvm::dyn_cast<llvm::ConstantInt>(call.getArgument(1));
+            if (constCount != nullptr && constSize != nullptr
+                && constCount->getLimitedValue() * constSize->getLimitedValue()
+                    <= FlatMemoryModel::MaxLibraryConstantSize
+            ) {
+                unsigned cellWidth = this->getCellWidth(array);
+                unsigned total = constCount->getLimitedValue() * constSize->getLimitedValue();
+                for (unsigned i = 0; i < total; i += cellWidth / 8) {
+                    array = mExprBuilder.Write(
+                        array, this->pointerOffset(pointer, i),
+                        BvLiteralExpr::Get(BvType::Get(mMemoryModel.getContext(), cellWidth), 0)
+                    );
+                }
+            }
+
+            this->defineCallArray(call, inst, array, ep);
+            this->defineAllocationFlag(call, inst, true, ep);
+            return true;
+        }
+        case LibraryFunction::Strlen:
+        case LibraryFunction::Strcmp: {
+            auto resultTy = llvm::dyn_cast<BvType>(&mTypes.get(inst->getType()));
+            if (resultTy == nullptr) {
+                return false;
+            }
+
+            ExprPtr value = function == LibraryFunction::Strlen
+                ? this->buildStrlen(call, *resultTy, ep)
+                : this->buildStrcmp(call, *resultTy, ep);
+            ep.insertAssignment(ep.getVariableFor(inst), value);
+            return true;
+        }
+        case LibraryFunction::Free: {
+            // Allocations are never reused, deallocation only ends the
+            // lifetime of the object.
+            const llvm::Value* base = getBaseObject(call.getArgument(0));
+            if (mInfo.allocationFlags.count(base) != 0 || !isUnresolvedDeallocation(base)) {
+                this->defineAllocationFlag(call, base, false, ep);
+                return false;
+            }
+
+            // The freed object is unknown: any of the live objects may die.
+            BoolType& boolTy = BoolType::Get(mMemoryModel.getContext());
+            for (auto& [allocation, flag] : mInfo.allocationFlags) {
+                MemoryObjectUse* use = mMemorySSA.getUniqueUseFor(inst, flag);
+                MemoryObjectDef* def = mMemorySSA.getUniqueDefinitionFor(inst, flag);
+                assert(use != nullptr && def != nullptr
+                    && "Unresolved deallocations must use and define all liveness flags!");
+
+                ep.insertAssignment(ep.getVariableFor(def), mExprBuilder.And(
+                    ep.getAsOperand(use->getReachingDef()), mExprBuilder.Undef(boolTy)
+                ));
+            }
+            return false;
+        }
+        case LibraryFunction::None:
+            return false;
+    }
+
+    llvm_unreachable("Unknown library function!");
+}
+
+void FlatMemoryModelInstTranslator::defineAllocationFlag(
+    llvm::CallSite call, const llvm::Value* allocation, bool isLive,
+    llvm2cfa::GenerationStepExtensionPoint& ep)
+{
+    MemoryObject* flag = mInfo.allocationFlags.lookup(allocation);
+    if (flag == nullptr) {
+        return;
+    }
+
+    MemoryObjectDef* def = mMemorySSA.getUniqueDefinitionFor(call.getInstruction(), flag);
+    assert(def != nullptr && "Allocations and deallocations must define their liveness flag!");
+
+    ep.insertAssignment(
+        ep.getVariableFor(def), BoolLiteralExpr::Get(BoolType::Get(mMemoryModel.getContext()), isLive));
+}
+
+ExprPtr FlatMemoryModelInstTranslator::toPointerWidth(const ExprPtr& value)
+{
+    auto type = llvm::dyn_cast<BvType>(&value->getType());
+    if (type == nullptr) {
+        return nullptr;
+    }
+
+    BvType& ptrTy = mMemoryModel.ptrType();
+    if (type->getWidth() < ptrTy.getWidth()) {
+        return mExprBuilder.ZExt(value, ptrTy);
+    }
+    if (type->getWidth() > ptrTy.getWidth()) {
+        return mExprBuilder.Trunc(value, ptrTy);
+    }
+
+    return value;
+}
+
+ExprPtr FlatMemoryModelInstTranslator::buildHeapAllocation(
+    llvm::CallSite call, const ExprPtr& size, llvm2cfa::GenerationStepExtensionPoint& ep)
+{
+    llvm::Instruction* inst = call.getInstruction();
+
+    MemoryObjectUse* use = mMemorySSA.getUniqueUseFor(inst, mInfo.heapPointer);
+    MemoryObjectDef* def = mMemorySSA.getUniqueDefinitionFor(inst, mInfo.heapPointer);
+    assert(use != nullptr && def != nullptr && "Allocations must use and define the heap pointer!");
+
+    ExprPtr pointer = ep.getAsOperand(use->getReachingDef());
+    ExprPtr length = size != nullptr ? this->toPointerWidth(size) : nullptr;
+
+    if (length == nullptr) {
+        // Sizes of an unknown representation: the allocation may overlap
+        // with anything, the heap pointer is left unchanged.
+        ep.insertAssignment(ep.getVariableFor(def), pointer);
+        return mExprBuilder.Undef(mMemoryModel.ptrType());
+    }
+
+    // Bump the heap pointer by the size of the allocation, keeping it aligned.
+    ExprPtr alignment = mMemoryModel.ptrConstant(FlatMemoryModel::HeapAlignment);
+    ExprPtr alignedLength = mExprBuilder.BvAnd(
+        mExprBuilder.Add(length, mExprBuilder.Sub(alignment, mMemoryModel.ptrConstant(1))),
+        mExprBuilder.Sub(mMemoryModel.ptrConstant(0), alignment)
+    );
+    ExprPtr next = mExprBuilder.Add(pointer, alignedLength);
+
+    // Allocations which would wrap around the address space (and thus overlap
+    // with globals and the stack) fail, returning a null pointer.
+    ExprPtr fits = mExprBuilder.And(
+        mExprBuilder.BvUGtEq(alignedLength, length),
+        mExprBuilder.BvUGtEq(next, pointer)
+    );
+    ep.insertAssignment(ep.getVariableFor(def), mExprBuilder.Select(fits, next, pointer));
+
+    return mExprBuilder.Select(fits, pointer, mMemoryModel.ptrConstant(0));
+}
+
+ExprPtr FlatMemoryModelInstTranslator::getCallArray(
+    llvm::CallSite call, const llvm::Value* ptr, llvm2cfa::GenerationStepExtensionPoint& ep)
+{
+    MemoryObjectUse* use = mMemorySSA.getUniqueUseFor(
+        call.getInstruction(), this->getRegionObject(ptr));
+    assert(use != nullptr && "Library calls must use the regions they access!");
+
+    return ep.getAsOperand(use->getReachingDef());
+}
+
+void FlatMemoryModelInstTranslator::defineCallArray(
+    llvm::CallSite call, const llvm::Value* ptr, const ExprPtr& array,
+    llvm2cfa::GenerationStepExtensionPoint& ep)
+{
+    MemoryObjectDef* def = mMemorySSA.getUniqueDefinitionFor(
+        call.getInstruction(), this->getRegionObject(ptr));
+    assert(def != nullptr && "Library calls must define the regions they modify!");
+
+    ep.insertAssignment(ep.getVariableFor(def), array);
+}
+
+ExprPtr FlatMemoryModelInstTranslator::buildBoundedWrite(
+    const ExprPtr& array, const ExprPtr& pointer, const llvm::Value* length,
+    llvm::function_ref<ExprPtr(unsigned)> byteAt, llvm2cfa::GenerationStepExtensionPoint& ep)
+{
+    auto& arrayTy = llvm::cast<ArrayType>(array->getType());
+
+    // Library functions access memory byte-by-byte.
+    if (this->getCellWidth(array) != 8) {
+        return mExprBuilder.Undef(arrayTy);
+    }
+
+    if (auto ci = llvm::dyn_cast<llvm::ConstantInt>(length)) {
+        uint64_t size = ci->getLimitedValue();
+        if (size > FlatMemoryModel::MaxLibraryConstantSize) {
+            return mExprBuilder.Undef(arrayTy);
+        }
+
+        ExprPtr result = array;
+        for (unsigned i = 0; i < size; ++i) {
+            result = mExprBuilder.Write(result, this->pointerOffset(pointer, i), byteAt(i));
+        }
+
+        return result;
+    }
+
+    // Symbolic lengths are encoded as guarded writes up to a fixed bound.
+    ExprPtr len = this->toPointerWidth(ep.getAsOperand(length));
+    if (len == nullptr) {
+        return mExprBuilder.Undef(arrayTy);
+    }
+
+    unsigned bound = FlatMemoryModel::MaxLibrarySymbolicSize;
+
+    ExprPtr result = array;
+    for (unsigned i = 0; i < bound; ++i) {
+        ExprPtr address = this->pointerOffset(pointer, i);
+        result = mExprBuilder.Write(result, address, mExprBuilder.Select(
+            mExprBuilder.BvULt(mMemoryModel.ptrConstant(i), len),
+            byteAt(i),
+            mExprBuilder.Read(array, address)
+        ));
+    }
+
+    return mExprBuilder.Select(
+        mExprBuilder.BvULtEq(len, mMemoryModel.ptrConstant(bound)),
+        result,
+        mExprBuilder.Undef(arrayTy)
+    );
+}
+
+ExprPtr FlatMemoryModelInstTranslator::buildMemcpy(
+    llvm::CallSite call, llvm2cfa::GenerationStepExtensionPoint& ep)
+{
+    ExprPtr dstArray = this->getCallArray(call, call.getArgument(0), ep);
+    ExprPtr srcArray = this->getCallArray(call, call.getArgument(1), ep);
+    ExprPtr dst = ep.getAsOperand(call.getArgument(0));
+    ExprPtr src = ep.getAsOperand(call.getArgument(1));
+
+    if (this->getCellWidth(srcArray) != 8) {
+        return mExprBuilder.Undef(dstArray->getType());
+    }
+
+    // All bytes are read from the original contents of the source, thus
+    // overlapping ranges (as in memmove) are handled properly.
+    return this->buildBoundedWrite(dstArray, dst, call.getArgument(2), [&](unsigned i) {
+        return mExprBuilder.Read(srcArray, this->pointerOffset(src, i));
+    }, ep);
+}
+
+ExprPtr FlatMemoryModelInstTranslator::buildMemset(
+    llvm::CallSite call, llvm2cfa::GenerationStepExtensionPoint& ep)
+{
+    ExprPtr array = this->getCallArray(call, call.getArgument(0), ep);
+    ExprPtr dst = ep.getAsOperand(call.getArgument(0));
+
+    // The value is an 'int' in the C library function and an i8 in the intrinsic.
+    ExprPtr value = ep.getAsOperand(call.getArgument(1));
+    auto valueTy = llvm::dyn_cast<BvType>(&value->getType());
+    if (valueTy == nullptr) {
+        return mExprBuilder.Undef(array->getType());
+    }
+    if (valueTy->getWidth() > 8) {
+        value = mExprBuilder.Trunc(value, mMemoryModel.cellType());
+    }
+
+    return this->buildBoundedWrite(array, dst, call.getArgument(2), [&value](unsigned) {
+        return value;
+    }, ep);
+}
+
+ExprPtr FlatMemoryModelInstTranslator::buildStrcpy(
+    llvm::CallSite call, llvm2cfa::GenerationStepExtensionPoint& ep)
+{
+    ExprPtr dstArray = this->getCallArray(call, call.getArgument(0), ep);
+    ExprPtr srcArray = this->getCallArray(call, call.getArgument(1), ep);
+    ExprPtr dst = ep.getAsOperand(call.getArgument(0));
+    ExprPtr src = ep.getAsOperand(call.getArgument(1));
+
+    if (this->getCellWidth(dstArray) != 8 || this->getCellWidth(srcArray) != 8) {
+        return mExprBuilder.Undef(dstArray->getType());
+    }
+
+    ExprPtr zero = BvLiteralExpr::Get(mMemoryModel.cellType(), 0);
+
+    // The i-th byte is copied if there was no terminating zero before it.
+    ExprPtr result = dstArray;
+    ExprPtr copying = mExprBuilder.True();
+    for (unsigned i = 0; i < FlatMemoryModel::MaxLibrarySymbolicSize; ++i) {
+        ExprPtr address = this->pointerOffset(dst, i);
+        ExprPtr byte = mExprBuilder.Read(srcArray, this->pointerOffset(src, i));
+
+        result = mExprBuilder.Write(result, address, mExprBuilder.Select(
+            copying, byte, mExprBuilder.Read(dstArray, address)
+        ));
+        copying = mExprBuilder.And(copying, mExprBuilder.NotEq(byte, zero));
+    }
+
+    // Longer strings clobber the destination.
+    return mExprBuilder.Select(copying, mExprBuilder.Undef(dstArray->getType()), result);
+}
+
+ExprPtr FlatMemoryModelInstTranslator::buildStrlen(
+    llvm::CallSite call, BvType& resultTy, llvm2cfa::GenerationStepExtensionPoint& ep)
+{
+    ExprPtr array = this->getCallArray(call, call.getArgument(0), ep);
+    ExprPtr str = ep.getAsOperand(call.getArgument(0));
+
+    if (this->getCellWidth(array) != 8) {
+        return mExprBuilder.Undef(resultTy);
+    }
+
+    ExprPtr zero = BvLiteralExpr::Get(mMemoryModel.cellType(), 0);
+
+    // Build the result backwards: the length is the index of the first zero byte.
+    ExprPtr result = mExprBuilder.Undef(resultTy);
+    for (unsigned i = FlatMemoryModel::MaxLibrarySymbolicSize; i-- > 0;) {
+        ExprPtr byte = mExprBuilder.Read(array, this->pointerOffset(str, i));
+        result = mExprBuilder.Select(
+            mExprBuilder.Eq(byte, zero), BvLiteralExpr::Get(resultTy, i), result
+        );
+    }
+
+    return result;
+}
+
+ExprPtr FlatMemoryModelInstTranslator::buildStrcmp(
+    llvm::CallSite call, BvType& resultTy, llvm2cfa::GenerationStepExtensionPoint& ep)
 {
-    return mExprBuilder.True();
+    ExprPtr lhsArray = this->getCallArray(call, call.getArgument(0), ep);
+    ExprPtr rhsArray = this->getCallArray(call, call.getArgument(1), ep);
+    ExprPtr lhs = ep.getAsOperand(call.getArgument(0));
+    ExprPtr rhs = ep.getAsOperand(call.getArgument(1));
+
+    if (this->getCellWidth(lhsArray) != 8 || this->getCellWidth(rhsArray) != 8) {
+        return mExprBuilder.Undef(resultTy);
+    }
+
+    ExprPtr zero = BvLiteralExpr::Get(mMemoryModel.cellType(), 0);
+    ExprPtr less = BvLiteralExpr::Get(resultTy, llvm::APInt::getAllOnesValue(resultTy.getWidth()));
+    ExprPtr greater = BvLiteralExpr::Get(resultTy, 1);
+
+    // The result is decided by the first differing byte, or the first common
+    // terminating zero. Characters are compared as unsigned values.
+    ExprPtr result = mExprBuilder.Undef(resultTy);
+    for (unsigned i = FlatMemoryModel::MaxLibrarySymbolicSize; i-- > 0;) {
+        ExprPtr left = mExprBuilder.Read(lhsArray, this->pointerOffset(lhs, i));
+        ExprPtr right = mExprBuilder.Read(rhsArray, this->pointerOffset(rhs, i));
+
+        result = mExprBuilder.Select(
+            mExprBuilder.NotEq(left, right),
+            mExprBuilder.Select(mExprBuilder.BvULt(left, right), less, greater),
+            mExprBuilder.Select(
+                mExprBuilder.Eq(left, zero), BvLiteralExpr::Get(resultTy, 0), result
+            )
+        );
+    }
+
+    return result;
+}
+
+ExprPtr FlatMemoryModelInstTranslator::isValidAccess(
+    llvm::CallSite check, llvm2cfa::GenerationStepExtensionPoint& ep)
+{
+    ExprPtr pointer = ep.getAsOperand(check.getArgument(0));
+    ExprPtr size = this->toPointerWidth(ep.getAsOperand(check.getArgument(1)));
+
+    ExprPtr valid = mExprBuilder.NotEq(pointer, mMemoryModel.ptrConstant(0));
+
+    // Accesses to known objects must lie within their bounds. The range check
+    // pointer - base <= objSize - size is encoded with unsigned comparisons,
+    // which also rejects pointers below the base address.
+    if (!llvm::isa<llvm::ConstantPointerNull>(check.getArgument(2))) {
+        ExprPtr base = ep.getAsOperand(check.getArgument(2));
+        ExprPtr objSize = this->toPointerWidth(ep.getAsOperand(check.getArgument(3)));
+
+        valid = mExprBuilder.And({
+            valid,
+            mExprBuilder.BvULtEq(size, objSize),
+            mExprBuilder.BvULtEq(mExprBuilder.Sub(pointer, base), mExprBuilder.Sub(objSize, size))
+        });
+    }
+
+    // Heap objects must not be accessed after deallocation.
+    MemoryObject* flag = mInfo.allocationFlags.lookup(getBaseObject(check.getArgument(2)));
+    if (flag != nullptr) {
+        MemoryObjectUse* use = mMemorySSA.getUniqueUseFor(check.getInstruction(), flag);
+        assert(use != nullptr && "Memory safety checks must use the liveness flag of their object!");
+
+        valid = mExprBuilder.And(valid, ep.getAsOperand(use->getReachingDef()));
+    }
+
+    return valid;
 }
 
 auto FlatMemoryModelInstTranslator::handleGlobalInitializer(
@@ -669,15 +1763,7 @@ auto FlatMemoryModelInstTranslator::handleGlobalInitializer(
     unsigned size = mDataLayout.getTypeAllocSize(gv->getType()->getPointerElementType());
 
     if (!gv->hasInitializer()) {
-        for (unsigned i = 0; i < size; ++i) {
-            array = mExprBuilder.Write(
-                array,
-                this->pointerOffset(pointer, i),
-                mExprBuilder.Undef(BvType::Get(mExprBuilder.getContext(), 8))
-            );
-        }
-
-        return array;
+        return this->buildMemoryClobber(array, pointer, size);
     }
 
     llvm::Value* initializer = gv->getInitializer();
@@ -686,6 +1772,81 @@ auto FlatMemoryModelInstTranslator::handleGlobalInitializer(
     return this->buildMemoryWrite(array, val, pointer, size);
 }
 
+void FlatMemoryModelInstTranslator::defineArray(
+    MemoryObjectDef* def, const ExprPtr& array, llvm2cfa::GenerationStepExtensionPoint& ep)
+{
+    Variable* defVariable = ep.getVariableFor(def);
+    bool flatten = mMemoryModel.getSettings().memoryFlattenReads != 0;
+
+    // Short store chains are inlined into their uses even if variable
+    // elimination is turned off, so reads over them become if-then-else
+    // chains and the chain itself never appears in an array assignment.
+    llvm::SmallVector<ExprRef<ArrayWriteExpr>, 8> writes;
+    if (flatten && this->collectStores(array, writes) != nullptr && ep.tryToInline(def, defVariable, array)) {
+        return;
+    }
+
+    if (ep.tryToEliminate(def, defVariable, array)) {
+        return;
+    }
+
+    ep.insertAssignment(defVariable, array);
+    if (flatten) {
+        mArrayDefinitions[defVariable] = array;
+    }
+}
+
+ExprPtr FlatMemoryModelInstTranslator::collectStores(
+    const ExprPtr& array, llvm::SmallVectorImpl<ExprRef<ArrayWriteExpr>>& writes)
+{
+    unsigned limit = mMemoryModel.getSettings().memoryFlattenReads;
+
+    // Look through the variables of earlier definitions which had to be kept.
+    ExprPtr current = array;
+    while (true) {
+        if (auto varRef = llvm::dyn_cast<VarRefExpr>(current)) {
+            auto it = mArrayDefinitions.find(&varRef->getVariable());
+            if (it == mArrayDefinitions.end()) {
+                return current;
+            }
+            current = it->second;
+        } else if (auto write = llvm::dyn_cast<ArrayWriteExpr>(current)) {
+            if (writes.size() == limit) {
+                return nullptr;
+            }
+            writes.push_back(write);
+            current = write->getOperand(0);
+        } else {
+            return current;
+        }
+    }
+}
+
+ExprPtr FlatMemoryModelInstTranslator::buildCellRead(const ExprPtr& array, const ExprPtr& address)
+{
+    unsigned limit = mMemoryModel.getSettings().memoryFlattenReads;
+    if (limit == 0) {
+        return mExprBuilder.Read(array, address);
+    }
+
+    llvm::SmallVector<ExprRef<ArrayWriteExpr>, 8> writes;
+    ExprPtr base = this->collectStores(array, writes);
+    if (base == nullptr) {
+        // Long store chains are left to the array theory of the solver.
+        return mExprBuilder.Read(array, address);
+    }
+
+    // The latest store to a matching address determines the value of the
+    // cell, other cells hold the value of the initial (or unknown) array.
+    ExprPtr result = mExprBuilder.Read(base, address);
+    for (auto it = writes.rbegin(), ie = writes.rend(); it != ie; ++it) {
+        result = mExprBuilder.Select(
+            mExprBuilder.Eq((*it)->getIndex(), address), (*it)->getElementValue(), result);
+    }
+
+    return result;
+}
+
 auto FlatMemoryModelInstTranslator::buildMemoryRead(
     gazer::Type& targetTy, unsigned size, const ExprPtr& array, const ExprPtr& pointer) -> ExprPtr
 {
@@ -693,23 +1854,39 @@ auto FlatMemoryModelInstTranslator::buildMemoryRead(
     assert(pointer != nullptr);
     assert(array->getType().isArrayType());
 
+    unsigned cellWidth = this->getCellWidth(array);
+    if (cellWidth != 8) {
+        // Word-sized cells are only used if all accesses fit into exactly one cell.
+        assert(cellWidth == size * 8 && "Accesses must have the same size as word cells!");
+        ExprPtr cell = this->buildCellRead(array, pointer);
+
+        if (auto bvTy = llvm::dyn_cast<BvType>(&targetTy)) {
+            return bvTy->getWidth() < cellWidth ? mExprBuilder.Extract(cell, 0, bvTy->getWidth()) : cell;
+        }
+        if (targetTy.isBoolType()) {
+            return mExprBuilder.NotEq(cell, mExprBuilder.BvLit(0, cellWidth));
+        }
+
+        return mExprBuilder.Undef(targetTy);
+    }
+
     switch (targetTy.getTypeID()) {
         case Type::BvTypeID: {
-            ExprPtr result = mExprBuilder.Read(array, pointer);
+            ExprPtr result = this->buildCellRead(array, pointer);
             for (unsigned i = 1; i < size; ++i) {
                 // TODO: Little/big endian
                 result = mExprBuilder.BvConcat(
-                    mExprBuilder.Read(array, this->pointerOffset(pointer, i)), result);
+                    this->buildCellRead(array, this->pointerOffset(pointer, i)), result);
             }
 
             return result;
         }
         case Type::BoolTypeID: {
-            ExprPtr result = mExprBuilder.NotEq(mExprBuilder.Read(array, pointer), mExprBuilder.BvLit8(0));
+            ExprPtr result = mExprBuilder.NotEq(this->buildCellRead(array, pointer), mExprBuilder.BvLit8(0));
             for (unsigned i = 1; i < size; ++i) {
                 result = mExprBuilder.And(
                     mExprBuilder.NotEq(
-                        mExprBuilder.Read(array, this->pointerOffset(pointer, i)),
+                        this->buildCellRead(array, this->pointerOffset(pointer, i)),
                         mExprBuilder.BvLit8(0)
                     ),
                     result
@@ -733,6 +1910,46 @@ auto FlatMemoryModelInstTranslator::buildMemoryRead(
 auto FlatMemoryModelInstTranslator::buildMemoryWrite(
     const ExprPtr& array, const ExprPtr& value, const ExprPtr& pointer, unsigned size) -> ExprPtr
 {
+    unsigned cellWidth = this->getCellWidth(array);
+    if (cellWidth != 8) {
+        auto& cellTy = BvType::Get(mMemoryModel.getContext(), cellWidth);
+        if (auto bvTy = llvm::dyn_cast<BvType>(&value->getType())) {
+            if (bvTy->getWidth() <= cellWidth) {
+                return mExprBuilder.Write(
+                    array, pointer, bvTy->getWidth() == cellWidth ? value : mExprBuilder.ZExt(value, cellTy)
+                );
+            }
+
+            // Wider values (e.g. global initializers) are split into cells.
+            unsigned numCells = (bvTy->getWidth() + cellWidth - 1) / cellWidth;
+            ExprPtr extended = value;
+            if (numCells * cellWidth != bvTy->getWidth()) {
+                extended = mExprBuilder.ZExt(value, BvType::Get(mMemoryModel.getContext(), numCells * cellWidth));
+            }
+
+            ExprPtr result = array;
+            for (unsigned i = 0; i < numCells; ++i) {
+                result = mExprBuilder.Write(
+                    result,
+                    this->pointerOffset(pointer, i * cellWidth / 8),
+                    mExprBuilder.Extract(extended, i * cellWidth, cellWidth)
+                );
+            }
+
+            return result;
+        }
+
+        if (value->getType().isBoolType()) {
+            return mExprBuilder.Write(
+                array,
+                pointer,
+                mExprBuilder.Select(value, mExprBuilder.BvLit(1, cellWidth), mExprBuilder.BvLit(0, cellWidth))
+            );
+        }
+
+        return this->buildMemoryClobber(array, pointer, size);
+    }
+
     if (auto bvTy = llvm::dyn_cast<BvType>(&value->getType())) {
         if (bvTy->getWidth() == 8) {
             return mExprBuilder.Write(array, pointer, value);
@@ -769,12 +1986,20 @@ auto FlatMemoryModelInstTranslator::buildMemoryWrite(
     
     // The value is undefined - but even with unknown/unhandled types, we know
     // which bytes we want to modify -- we just do not know the value.
+    return this->buildMemoryClobber(array, pointer, size);
+}
+
+auto FlatMemoryModelInstTranslator::buildMemoryClobber(
+    const ExprPtr& array, const ExprPtr& pointer, unsigned size) -> ExprPtr
+{
+    unsigned cellWidth = this->getCellWidth(array);
+    unsigned cellSize = cellWidth / 8;
+    auto& cellTy = BvType::Get(mMemoryModel.getContext(), cellWidth);
+
     ExprPtr result = array;
-    for (unsigned i = 0; i < size; ++i) {
+    for (unsigned i = 0; i < size; i += cellSize) {
         result = mExprBuilder.Write(
-            result,
-            this->pointerOffset(pointer, i),
-            mExprBuilder.Undef(BvType::Get(mMemoryModel.getContext(), 8))
+            result, this->pointerOffset(pointer, i), mExprBuilder.Undef(cellTy)
         );
     }
 
@@ -801,8 +2026,9 @@ auto gazer::CreateFlatMemoryModel(
     GazerContext& context,
     const LLVMFrontendSettings& settings,
     llvm::Module& module,
-    std::function<llvm::DominatorTree&(llvm::Function&)> dominators
+    std::function<llvm::DominatorTree&(llvm::Function&)> dominators,
+    std::function<llvm::AAResults&(llvm::Function&)> aliasAnalysis
 ) -> std::unique_ptr<MemoryModel>
 {
-    return std::make_unique<FlatMemoryModel>(context, settings, module, dominators);
+    return std::make_unique<FlatMemoryModel>(context, settings, module, dominators, aliasAnalysis);
 }
\ No newline at end of file
@@ -94,7 +94,8 @@ public:
         llvm::SmallVectorImpl<VariableAssignment>& inputAssignments,
         llvm::SmallVectorImpl<VariableAssignment>& outputAssignments) override {}
 
-    ExprPtr isValidAccess(llvm::Value* ptr, const ExprPtr& expr) override {
+    ExprPtr isValidAccess(
+        llvm::CallSite check, llvm2cfa::GenerationStepExtensionPoint& ep) override {
         return BoolLiteralExpr::True(BoolType::Get(mContext));
     }
 
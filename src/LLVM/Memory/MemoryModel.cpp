@@ -20,6 +20,7 @@
 #include "gazer/LLVM/Memory/MemorySSA.h"
 #include "gazer/LLVM/Memory/MemoryModel.h"
 
+#include <llvm/Analysis/AliasAnalysis.h>
 #include <llvm/Transforms/Utils/UnifyFunctionExitNodes.h>
 
 using namespace gazer;
@@ -32,7 +33,11 @@ char MemoryModelWrapperPass::ID;
 void MemoryModelWrapperPass::getAnalysisUsage(llvm::AnalysisUsage& au) const
 {
     switch (mSettings.memoryModel) {
+        case MemoryModelSetting::AliasSets:
+            au.addRequired<llvm::AAResultsWrapperPass>();
+            LLVM_FALLTHROUGH;
         case MemoryModelSetting::Flat:
+        case MemoryModelSetting::Regions:
             au.addRequired<llvm::UnifyFunctionExitNodes>();
             au.addRequired<llvm::DominatorTreeWrapperPass>();
         case MemoryModelSetting::Havoc:
@@ -47,12 +52,17 @@ void MemoryModelWrapperPass::getAnalysisUsage(llvm::AnalysisUsage& au) const
 bool MemoryModelWrapperPass::runOnModule(llvm::Module& module)
 {
     switch (mSettings.memoryModel) {
-        case MemoryModelSetting::Flat: {
+        case MemoryModelSetting::Flat:
+        case MemoryModelSetting::Regions:
+        case MemoryModelSetting::AliasSets: {
             auto dominators = [this](llvm::Function& function) -> llvm::DominatorTree& {
                 return getAnalysis<llvm::DominatorTreeWrapperPass>(function).getDomTree();
             };
+            auto aliasAnalysis = [this](llvm::Function& function) -> llvm::AAResults& {
+                return getAnalysis<llvm::AAResultsWrapperPass>(function).getAAResults();
+            };
 
-            mMemoryModel = CreateFlatMemoryModel(mContext, mSettings, module, dominators);
+            mMemoryModel = CreateFlatMemoryModel(mContext, mSettings, module, dominators, aliasAnalysis);
             break;
         }
         case MemoryModelSetting::Havoc: {
@@ -131,18 +131,33 @@ MemoryObject* MemorySSABuilder::createMemoryObject(
     return &*ptr;
 }
 
+void MemorySSABuilder::addBlockDef(MemoryObjectDef* def, llvm::BasicBlock* block)
+{
+    mObjectInfo[def->getObject()].defBlocks.insert(block);
+    mBlockAccesses[block].blockDefs.push_back(def);
+    def->getObject()->addDefinition(def);
+}
+
+void MemorySSABuilder::addInstructionAccess(llvm::Instruction* inst, AccessPtr access)
+{
+    if (auto def = access.dyn_cast<MemoryObjectDef*>()) {
+        mObjectInfo[def->getObject()].defBlocks.insert(inst->getParent());
+        def->getObject()->addDefinition(def);
+    } else {
+        auto use = access.get<MemoryObjectUse*>();
+        use->getObject()->addUse(use);
+    }
+
+    mBlockAccesses[inst->getParent()].accesses.emplace_back(inst, access);
+}
+
 memory::LiveOnEntryDef* MemorySSABuilder::createLiveOnEntryDef(gazer::MemoryObject* object)
 {
     assert(!object->hasEntryDef() && "Attempting to insert two entry definitions for a single object!");
 
     llvm::BasicBlock* entryBlock = &mFunction.getEntryBlock();
     auto def = new memory::LiveOnEntryDef(object, mVersionNumber++, entryBlock);
-    mObjectInfo[object].defBlocks.insert(entryBlock);
-
-    mValueDefs[&mFunction.getEntryBlock()].emplace_back(def);
-
-
-    object->addDefinition(def);
+    this->addBlockDef(def, entryBlock);
     object->setEntryDef(def);
 
     return def;
@@ -153,11 +168,7 @@ memory::GlobalInitializerDef* MemorySSABuilder::createGlobalInitializerDef(
 {
     llvm::BasicBlock* entryBlock = &mFunction.getEntryBlock();
     auto def = new memory::GlobalInitializerDef(object, mVersionNumber++, entryBlock, gv);
-    mObjectInfo[object].defBlocks.insert(entryBlock);
-
-    mValueDefs[&mFunction.getEntryBlock()].emplace_back(def);
-    
-    object->addDefinition(def);
+    this->addBlockDef(def, entryBlock);
 
     return def;
 }
@@ -165,9 +176,7 @@ memory::GlobalInitializerDef* MemorySSABuilder::createGlobalInitializerDef(
 memory::StoreDef* MemorySSABuilder::createStoreDef(MemoryObject* object, llvm::StoreInst& inst)
 {
     auto def = new memory::StoreDef(object, mVersionNumber++, inst);
-    mObjectInfo[object].defBlocks.insert(inst.getParent());
-    mValueDefs[&inst].push_back(def);
-    object->addDefinition(def);
+    this->addInstructionAccess(&inst, def);
 
     return def;
 }
@@ -175,9 +184,7 @@ memory::StoreDef* MemorySSABuilder::createStoreDef(MemoryObject* object, llvm::S
 memory::CallDef* MemorySSABuilder::createCallDef(gazer::MemoryObject* object, llvm::CallSite call)
 {
     auto def = new memory::CallDef(object, mVersionNumber++, call);
-    mObjectInfo[object].defBlocks.insert(call.getInstruction()->getParent());
-    mValueDefs[call.getInstruction()].push_back(def);
-    object->addDefinition(def);
+    this->addInstructionAccess(call.getInstruction(), def);
 
     return def;
 }
@@ -187,9 +194,7 @@ memory::AllocaDef* MemorySSABuilder::createAllocaDef(
 )
 {
     auto def = new memory::AllocaDef(object, mVersionNumber++, alloca);
-    mObjectInfo[object].defBlocks.insert(alloca.getParent());
-    mValueDefs[&alloca].push_back(def);
-    object->addDefinition(def);
+    this->addInstructionAccess(&alloca, def);
 
     return def;
 }
@@ -197,8 +202,7 @@ memory::AllocaDef* MemorySSABuilder::createAllocaDef(
 memory::LoadUse* MemorySSABuilder::createLoadUse(MemoryObject* object, llvm::LoadInst& load)
 {
     auto use = new memory::LoadUse(object, load);
-    mValueUses[&load].push_back(use);
-    object->addUse(use);
+    this->addInstructionAccess(&load, use);
 
     return use;
 }
@@ -206,8 +210,7 @@ memory::LoadUse* MemorySSABuilder::createLoadUse(MemoryObject* object, llvm::Loa
 memory::CallUse* MemorySSABuilder::createCallUse(MemoryObject* object, llvm::CallSite call)
 {
     auto use = new memory::CallUse(object, call);
-    mValueUses[call.getInstruction()].push_back(use);
-    object->addUse(use);
+    this->addInstructionAccess(call.getInstruction(), use);
 
     return use;
 }
@@ -216,8 +219,7 @@ memory::RetUse* MemorySSABuilder::createReturnUse(MemoryObject* object, llvm::Re
 {
     assert(!object->hasExitUse() && "Attempting to add a duplicate exit use!");
     auto use = new memory::RetUse(object, ret);
-    mValueUses[&ret].push_back(use);
-    object->addUse(use);
+    this->addInstructionAccess(&ret, use);
     object->setExitUse(use);
 
     return use;
@@ -225,19 +227,160 @@ memory::RetUse* MemorySSABuilder::createReturnUse(MemoryObject* object, llvm::Re
 
 auto MemorySSABuilder::build() -> std::unique_ptr<MemorySSA>
 {
+    for (auto& object : mObjectStorage) {
+        mObjectInfo[&*object].object = &*object;
+    }
+
+    this->sortBlockAccesses();
+    this->calculateLiveInBlocks();
     this->calculatePHINodes();
     this->renamePass();
 
+    // Materialize the per-value annotations used by the def-use queries.
+    MemorySSA::ValueToDefSetMap valueDefs;
+    MemorySSA::ValueToUseSetMap valueUses;
+
+    for (auto& entry : mBlockAccesses) {
+        BlockAccessInfo& info = entry.second;
+        if (!info.blockDefs.empty()) {
+            valueDefs[entry.first].assign(info.blockDefs.begin(), info.blockDefs.end());
+        }
+
+        for (auto& [inst, access] : info.accesses) {
+            if (auto def = access.dyn_cast<MemoryObjectDef*>()) {
+                valueDefs[inst].push_back(def);
+            } else {
+                valueUses[inst].push_back(access.get<MemoryObjectUse*>());
+            }
+        }
+    }
+
     return std::unique_ptr<MemorySSA>(new MemorySSA(
-        mFunction, std::move(mObjectStorage), std::move(mValueDefs), std::move(mValueUses)
+        mFunction, std::move(mObjectStorage), std::move(valueDefs), std::move(valueUses)
     ));
 }
 
+void MemorySSABuilder::sortBlockAccesses()
+{
+    // Clients may annotate instructions in any order, the renaming pass however
+    // must visit them in program order, with the uses of an instruction preceding
+    // its definitions.
+    llvm::DenseMap<const llvm::Instruction*, unsigned> position;
+
+    for (auto& entry : mBlockAccesses) {
+        auto& accesses = entry.second.accesses;
+        if (accesses.empty()) {
+            continue;
+        }
+
+        position.clear();
+        for (auto& access : accesses) {
+            position[access.first] = 0;
+        }
+
+        unsigned idx = 0;
+        for (llvm::Instruction& inst : *entry.first) {
+            auto it = position.find(&inst);
+            if (it != position.end()) {
+                it->second = idx++;
+            }
+        }
+
+        std::stable_sort(accesses.begin(), accesses.end(), [&position](auto& lhs, auto& rhs) {
+            unsigned lhsPos = position[lhs.first];
+            unsigned rhsPos = position[rhs.first];
+            if (lhsPos != rhsPos) {
+                return lhsPos < rhsPos;
+            }
+
+            return lhs.second.template is<MemoryObjectUse*>() && rhs.second.template is<MemoryObjectDef*>();
+        });
+    }
+}
+
+static bool isKillingDef(const MemoryObjectDef* def)
+{
+    switch (def->getKind()) {
+        case MemoryObjectDef::LiveOnEntry:
+        case MemoryObjectDef::Call:
+            return true;
+        case MemoryObjectDef::PHI:
+            return false;
+        case MemoryObjectDef::GlobalInitializer:
+        case MemoryObjectDef::Alloca:
+        case MemoryObjectDef::Store:
+            return def->getObject()->getObjectType() == MemoryObjectType::Scalar;
+    }
+
+    llvm_unreachable("Unknown memory object definition kind!");
+}
+
+void MemorySSABuilder::calculateLiveInBlocks()
+{
+    // Find the blocks in which an object may be read before being defined.
+    llvm::SmallPtrSet<MemoryObject*, 16> defined;
+    auto visit = [this, &defined](MemoryObjectDef* def, MemoryObjectUse* use, llvm::BasicBlock* bb) {
+        MemoryObject* object = def != nullptr ? def->getObject() : use->getObject();
+        if (defined.count(object) != 0) {
+            return;
+        }
+
+        if (def == nullptr || !isKillingDef(def)) {
+            mObjectInfo[object].liveInBlocks.insert(bb);
+        }
+
+        if (def != nullptr) {
+            defined.insert(object);
+        }
+    };
+
+    for (auto& entry : mBlockAccesses) {
+        defined.clear();
+        for (MemoryObjectDef* def : entry.second.blockDefs) {
+            visit(def, nullptr, entry.first);
+        }
+
+        for (auto& access : entry.second.accesses) {
+            visit(
+                access.second.dyn_cast<MemoryObjectDef*>(),
+                access.second.dyn_cast<MemoryObjectUse*>(),
+                entry.first
+            );
+        }
+    }
+
+    // Propagate liveness backwards until reaching a block defining the object.
+    llvm::SmallVector<llvm::BasicBlock*, 32> worklist;
+    for (auto& entry : mObjectInfo) {
+        MemoryObjectInfo& info = entry.second;
+        worklist.assign(info.liveInBlocks.begin(), info.liveInBlocks.end());
+
+        while (!worklist.empty()) {
+            llvm::BasicBlock* bb = worklist.pop_back_val();
+            for (llvm::BasicBlock* pred : llvm::predecessors(bb)) {
+                if (info.defBlocks.count(pred) != 0) {
+                    continue;
+                }
+
+                if (info.liveInBlocks.insert(pred).second) {
+                    worklist.push_back(pred);
+                }
+            }
+        }
+    }
+}
+
 void MemorySSABuilder::calculatePHINodes()
 {
     for (auto& object : mObjectStorage) {
+        MemoryObjectInfo& info = mObjectInfo[&*object];
+        if (info.liveInBlocks.empty()) {
+            continue;
+        }
+
         llvm::ForwardIDFCalculator idf(mDominatorTree);
-        idf.setDefiningBlocks(mObjectInfo[&*object].defBlocks);
+        idf.setDefiningBlocks(info.defBlocks);
+        idf.setLiveInBlocks(info.liveInBlocks);
 
         llvm::SmallVector<llvm::BasicBlock*, 32> phiBlocks;
         idf.calculate(phiBlocks);
@@ -245,76 +388,91 @@ void MemorySSABuilder::calculatePHINodes()
         for (llvm::BasicBlock* bb : phiBlocks) {
             auto phi = new memory::PhiDef(&*object, mVersionNumber++, bb);
             object->addDefinition(phi);
-            mValueDefs[bb].push_back(phi);
+            mBlockAccesses[bb].blockDefs.push_back(phi);
         }
     }
 }
 
 void MemorySSABuilder::renamePass()
 {
-    llvm::DomTreeNode* root = mDominatorTree.getRootNode();
-    renameBlock(root->getBlock());
-}
-
-void MemorySSABuilder::renameBlock(llvm::BasicBlock* block)
-{
-    llvm::SmallDenseMap<MemoryObject*, unsigned, 4> defsInThisBlock;
-
-    // Handle all block-level annotations first
-    for (auto& def : mValueDefs[block]) {
-        MemoryObject* object = def->getObject();
-
-        MemoryObjectDef* reachingDef = mObjectInfo[object].getCurrentTopDefinition();
-        if (reachingDef != nullptr) {
-            def->setReachingDef(reachingDef);
+    // Walk the dominator tree in pre-order using an explicit stack, as the
+    // dominator trees of large functions may be arbitrarily deep.
+    struct WorkItem
+    {
+        llvm::DomTreeNode* node;
+        llvm::DomTreeNode::iterator nextChild;
+        size_t trailSize;
+    };
+
+    llvm::SmallVector<WorkItem, 32> worklist;
+    auto enter = [this, &worklist](llvm::DomTreeNode* node) {
+        size_t trailSize = mRenameTrail.size();
+        this->renameBlock(node->getBlock());
+        worklist.push_back({node, node->begin(), trailSize});
+    };
+
+    enter(mDominatorTree.getRootNode());
+    while (!worklist.empty()) {
+        WorkItem& item = worklist.back();
+        if (item.nextChild != item.node->end()) {
+            llvm::DomTreeNode* child = *item.nextChild++;
+            enter(child);
+            continue;
         }
 
-        mObjectInfo[object].renameStack.push_back(&*def);
-        defsInThisBlock[object]++;
+        // All dominated blocks were visited, unwind the stacks.
+        while (mRenameTrail.size() > item.trailSize) {
+            mRenameTrail.pop_back_val()->renameStack.pop_back();
+        }
+        worklist.pop_back();
     }
+}
 
-    // Handle each instruction in this block
-    for (llvm::Instruction& inst : *block) {
-        for (auto& use : mValueUses[&inst]) {
-            MemoryObject* object = use->getObject();
-            MemoryObjectDef* reachingDef = mObjectInfo[object].getCurrentTopDefinition();
-            use->setReachingDef(reachingDef);
+void MemorySSABuilder::renameBlock(llvm::BasicBlock* block)
+{
+    auto pushDef = [this](MemoryObjectDef* def) {
+        MemoryObjectInfo& info = mObjectInfo[def->getObject()];
+
+        // Set the previously reaching definition for this access
+        def->setReachingDef(info.getCurrentTopDefinition());
+
+        // Push the new definition to the top of the renaming stack
+        info.renameStack.push_back(def);
+        mRenameTrail.push_back(&info);
+    };
+
+    auto it = mBlockAccesses.find(block);
+    if (it != mBlockAccesses.end()) {
+        // Handle all block-level annotations first
+        for (MemoryObjectDef* def : it->second.blockDefs) {
+            pushDef(def);
         }
 
-        for (auto& def : mValueDefs[&inst]) {
-            MemoryObject* object = def->getObject();
-
-            // Set the previously reaching definition for this access
-            MemoryObjectDef* reachingDef = mObjectInfo[object].getCurrentTopDefinition();
-            def->setReachingDef(reachingDef);
-
-            // Push the new definition to the top of the renaming stack
-            mObjectInfo[object].renameStack.push_back(&*def);
-            defsInThisBlock[object]++;
+        // Handle each instruction annotation in this block
+        for (auto& access : it->second.accesses) {
+            if (auto def = access.second.dyn_cast<MemoryObjectDef*>()) {
+                pushDef(def);
+            } else {
+                auto use = access.second.get<MemoryObjectUse*>();
+                use->setReachingDef(mObjectInfo[use->getObject()].getCurrentTopDefinition());
+            }
         }
     }
 
     // Handle successor PHIs
     for (llvm::BasicBlock* child : llvm::successors(block)) {
-        for (auto& def : mValueDefs[child]) {
-            if (auto phi = llvm::dyn_cast<memory::PhiDef>(&*def)) {
+        auto childIt = mBlockAccesses.find(child);
+        if (childIt == mBlockAccesses.end()) {
+            continue;
+        }
+
+        for (MemoryObjectDef* def : childIt->second.blockDefs) {
+            if (auto phi = llvm::dyn_cast<memory::PhiDef>(def)) {
                 MemoryObject* object = phi->getObject();
                 phi->addIncoming(mObjectInfo[object].getCurrentTopDefinition(), block);
             }
         }
     }
-
-    // Handle successors
-    for (llvm::DomTreeNode* child : mDominatorTree.getNode(block)->getChildren()) {
-        renameBlock(child->getBlock());
-    }
-
-    // Finally, unwind the stacks
-    for (auto& pair : defsInThisBlock) {
-        MemoryObject* object = pair.first;
-        auto& stack = mObjectInfo[object].renameStack;
-        stack.resize(stack.size() - pair.second);
-    }
 }
 
 // Printing
@@ -19,6 +19,11 @@
 
 #include <llvm/IR/GlobalVariable.h>
 #include <llvm/IR/Instructions.h>
+#include <llvm/IR/IntrinsicInst.h>
+#include <llvm/IR/Operator.h>
+#include <llvm/IR/DataLayout.h>
+
+#include <algorithm>
 
 using namespace gazer;
 
@@ -47,3 +52,116 @@ bool gazer::memory::isGlobalUsedAsPointer(llvm::GlobalVariable& gv)
 
     return false;
 }
+
+bool gazer::memory::findPromotableFields(
+    const llvm::Value* object, const llvm::DataLayout& dl,
+    PromotableObject& result, unsigned maxFields)
+{
+    uint64_t objectSize;
+    if (auto gv = llvm::dyn_cast<llvm::GlobalVariable>(object)) {
+        if (gv->isThreadLocal() || gv->isExternallyInitialized()) {
+            return false;
+        }
+        objectSize = dl.getTypeAllocSize(gv->getValueType());
+    } else if (auto alloca = llvm::dyn_cast<llvm::AllocaInst>(object)) {
+        auto arraySize = llvm::dyn_cast<llvm::ConstantInt>(alloca->getArraySize());
+        if (arraySize == nullptr) {
+            return false;
+        }
+        objectSize = dl.getTypeAllocSize(alloca->getAllocatedType()) * arraySize->getZExtValue();
+    } else {
+        return false;
+    }
+
+    struct Access
+    {
+        const llvm::Instruction* inst;
+        uint64_t offset;
+        llvm::Type* type;
+    };
+
+    llvm::SmallVector<Access, 8> accesses;
+    llvm::SmallVector<std::pair<const llvm::Value*, int64_t>, 8> worklist;
+    worklist.emplace_back(object, 0);
+
+    while (!worklist.empty()) {
+        auto [ptr, offset] = worklist.pop_back_val();
+
+        for (const llvm::Use& use : ptr->uses()) {
+            const llvm::User* user = use.getUser();
+            llvm::Type* accessTy = nullptr;
+
+            if (auto load = llvm::dyn_cast<llvm::LoadInst>(user)) {
+                if (!load->isSimple()) {
+                    return false;
+                }
+                accessTy = load->getType();
+            } else if (auto store = llvm::dyn_cast<llvm::StoreInst>(user)) {
+                // We want stores TO the object, not OF its address.
+                if (!store->isSimple() || store->getValueOperand() == ptr) {
+                    return false;
+                }
+                accessTy = store->getValueOperand()->getType();
+            } else if (auto gep = llvm::dyn_cast<llvm::GEPOperator>(user)) {
+                llvm::APInt gepOffset(dl.getIndexTypeSizeInBits(gep->getType()), 0);
+                if (gep->getPointerOperand() != ptr || !gep->accumulateConstantOffset(dl, gepOffset)) {
+                    return false;
+                }
+                worklist.emplace_back(gep, offset + gepOffset.getSExtValue());
+                continue;
+            } else if (auto cast = llvm::dyn_cast<llvm::BitCastOperator>(user)) {
+                // Type punning is caught by the field type checks below.
+                worklist.emplace_back(cast, offset);
+                continue;
+            } else if (auto intrinsic = llvm::dyn_cast<llvm::IntrinsicInst>(user)) {
+                auto id = intrinsic->getIntrinsicID();
+                if (id != llvm::Intrinsic::lifetime_start && id != llvm::Intrinsic::lifetime_end) {
+                    return false;
+                }
+                continue;
+            } else {
+                return false;
+            }
+
+            // Only first-class scalar values may be promoted.
+            if (!accessTy->isSingleValueType() || accessTy->isVectorTy()) {
+                return false;
+            }
+
+            if (offset < 0 || offset + dl.getTypeStoreSize(accessTy) > objectSize) {
+                return false;
+            }
+
+            accesses.push_back({llvm::cast<llvm::Instruction>(user), static_cast<uint64_t>(offset), accessTy});
+        }
+    }
+
+    std::sort(accesses.begin(), accesses.end(), [](const Access& lhs, const Access& rhs) {
+        return lhs.offset < rhs.offset;
+    });
+
+    // Accesses to the same field must have the same type, and distinct fields
+    // may not overlap.
+    for (const Access& access : accesses) {
+        if (!result.fields.empty()) {
+            ScalarField& last = result.fields.back();
+            if (last.offset == access.offset && last.type == access.type) {
+                result.accesses[access.inst] = result.fields.size() - 1;
+                continue;
+            }
+
+            if (access.offset < last.offset + dl.getTypeStoreSize(last.type)) {
+                return false;
+            }
+        }
+
+        if (result.fields.size() == maxFields) {
+            return false;
+        }
+
+        result.fields.push_back({access.offset, access.type});
+        result.accesses[access.inst] = result.fields.size() - 1;
+    }
+
+    return true;
+}
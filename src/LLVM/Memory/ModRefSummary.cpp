@@ -0,0 +1,131 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "gazer/LLVM/Memory/ModRefSummary.h"
+
+#include <llvm/Analysis/CallGraph.h>
+#include <llvm/ADT/SCCIterator.h>
+#include <llvm/ADT/STLExtras.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <vector>
+
+using namespace gazer;
+using namespace gazer::memory;
+
+ModRefSummary::ModRefSummary(
+    llvm::Module& module, unsigned numLocations, LocalEffectsFn localEffects
+) : mNumLocations(numLocations)
+{
+    llvm::CallGraph callGraph(module);
+
+    // The SCC iterator visits the components in post-order, thus the
+    // summaries of all callees outside of the current component are
+    // already available.
+    for (auto it = llvm::scc_begin(&callGraph); !it.isAtEnd(); ++it) {
+        Summary summary{llvm::BitVector(numLocations), llvm::BitVector(numLocations)};
+
+        llvm::SmallVector<const llvm::Function*, 2> members;
+        for (llvm::CallGraphNode* node : *it) {
+            const llvm::Function* function = node->getFunction();
+            if (function != nullptr && !function->isDeclaration()) {
+                members.push_back(function);
+            }
+        }
+
+        for (const llvm::Function* function : members) {
+            for (const llvm::Instruction& inst : llvm::instructions(function)) {
+                if (auto call = llvm::dyn_cast<llvm::CallInst>(&inst)) {
+                    const llvm::Function* callee = call->getCalledFunction();
+                    if (callee != nullptr && !callee->isDeclaration()) {
+                        // Callees within the same component contribute their
+                        // local effects to the shared summary.
+                        if (const Summary* calleeSummary = this->lookup(callee)) {
+                            summary.mod |= calleeSummary->mod;
+                            summary.ref |= calleeSummary->ref;
+                        }
+                        continue;
+                    }
+                }
+
+                localEffects(inst, summary.mod, summary.ref);
+            }
+        }
+
+        for (const llvm::Function* function : members) {
+            mSummaries[function] = summary;
+        }
+    }
+}
+
+auto ModRefSummary::lookup(const llvm::Function* function) const -> const Summary*
+{
+    auto it = mSummaries.find(function);
+    if (it == mSummaries.end()) {
+        return nullptr;
+    }
+
+    return &it->second;
+}
+
+bool ModRefSummary::mayModify(const llvm::Function* function, unsigned location) const
+{
+    assert(location < mNumLocations && "Location index out of range!");
+    const Summary* summary = this->lookup(function);
+
+    // Be conservative with functions we know nothing about.
+    return summary == nullptr || summary->mod.test(location);
+}
+
+bool ModRefSummary::mayReference(const llvm::Function* function, unsigned location) const
+{
+    assert(location < mNumLocations && "Location index out of range!");
+    const Summary* summary = this->lookup(function);
+
+    return summary == nullptr || summary->ref.test(location);
+}
+
+void ModRefSummary::print(llvm::raw_ostream& os) const
+{
+    auto printSet = [&os](const llvm::BitVector& set) {
+        os << "{";
+        bool first = true;
+        for (unsigned i : set.set_bits()) {
+            os << (first ? "" : ", ") << i;
+            first = false;
+        }
+        os << "}";
+    };
+
+    // Print the summaries in a deterministic order.
+    std::vector<std::pair<llvm::StringRef, const Summary*>> summaries;
+    for (auto& [function, summary] : mSummaries) {
+        summaries.emplace_back(function->getName(), &summary);
+    }
+    llvm::sort(summaries, [](auto& lhs, auto& rhs) { return lhs.first < rhs.first; });
+
+    for (auto& [name, summary] : summaries) {
+        os << name << ": mod ";
+        printSet(summary->mod);
+        os << " ref ";
+        printSet(summary->ref);
+        os << "\n";
+    }
+}
@@ -0,0 +1,974 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "gazer/LLVM/Memory/PointsToAnalysis.h"
+
+#include <llvm/IR/CallSite.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/DataLayout.h>
+#include <llvm/IR/GetElementPtrTypeIterator.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/IntrinsicInst.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Operator.h>
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/StringSet.h>
+#include <llvm/Support/Debug.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <map>
+#include <optional>
+#include <numeric>
+
+#define DEBUG_TYPE "PointsToAnalysis"
+
+using namespace gazer;
+using namespace gazer::memory;
+
+namespace
+{
+
+constexpr unsigned NoNode = ~0u;
+
+/// A cell is a byte offset within an abstract memory node.
+/// Cells with no node represent null or undefined pointers.
+struct Cell
+{
+    unsigned node = NoNode;
+    int64_t offset = 0;
+
+    bool isNull() const { return node == NoNode; }
+};
+
+struct Node
+{
+    explicit Node(unsigned parent)
+        : parent(parent)
+    {}
+
+    /// The parent of this node in the union-find forest.
+    unsigned parent;
+
+    /// The offset of this node's beginning within its parent.
+    int64_t delta = 0;
+
+    /// True if the offsets of this node cannot be distinguished anymore.
+    bool collapsed = false;
+
+    /// A common divisor of the distances between the offsets this node may be
+    /// accessed at, introduced by variable indices or collapsing.
+    uint64_t stride = 0;
+
+    /// The cells pointed to by the pointers stored at a given offset.
+    /// Only maintained for representative nodes.
+    std::map<int64_t, Cell> fields;
+};
+
+bool containsPointer(llvm::Type* type)
+{
+    if (type->isPointerTy()) {
+        return true;
+    }
+
+    if (type->isArrayTy()) {
+        return containsPointer(type->getArrayElementType());
+    }
+
+    if (type->isVectorTy()) {
+        return containsPointer(type->getScalarType());
+    }
+
+    if (auto structTy = llvm::dyn_cast<llvm::StructType>(type)) {
+        return llvm::any_of(structTy->elements(), containsPointer);
+    }
+
+    return false;
+}
+
+bool isAllocationFunction(llvm::StringRef name)
+{
+    return name == "malloc" || name == "calloc" || name == "valloc"
+        || name == "aligned_alloc" || name == "memalign"
+        || name == "_Znwm" || name == "_Znam" || name == "_Znwj" || name == "_Znaj";
+}
+
+} // end anonymous namespace
+
+class PointsToAnalysis::Impl
+{
+public:
+    Impl(llvm::Module& module, const llvm::Function* entry)
+        : mModule(module), mDataLayout(module.getDataLayout()), mEntry(entry)
+    {}
+
+    void analyze();
+
+    RegionID getRegionFor(const llvm::Value* ptr) const
+    {
+        auto it = mRegionOf.find(ptr);
+        return it == mRegionOf.end() ? UnknownRegion : it->second;
+    }
+
+private:
+    // Union-find
+    //==--------------------------------------------------------------------==//
+    unsigned createNode();
+    std::pair<unsigned, int64_t> find(unsigned node);
+    Cell resolve(Cell cell);
+    int64_t getFieldKey(Cell resolved) const {
+        return mNodes[resolved.node].collapsed ? 0 : resolved.offset;
+    }
+    void addStride(unsigned node, uint64_t stride);
+
+    /// Unifies the nodes of two cells so that they are at the same offset.
+    void merge(Cell lhs, Cell rhs);
+    void collapse(unsigned node);
+    void solve();
+
+    // Constraint generation
+    //==--------------------------------------------------------------------==//
+    Cell unknown() { return {mUnknown, 0}; }
+    Cell createObject(const llvm::Value* object);
+    Cell getPointee(Cell ptr);
+    Cell getCell(const llvm::Value* value);
+    Cell getConstantCell(const llvm::Constant* constant);
+    Cell getReturnCell(const llvm::Function* function);
+    Cell offsetCell(Cell base, const llvm::GEPOperator& gep);
+
+    void define(const llvm::Value* value, Cell cell);
+    void escape(const llvm::Value* value);
+    void escapeContents(const llvm::Value* ptr);
+
+    /// Integers of the width of pointers may hold pointers converted by
+    /// ptrtoint, thus the pointers loaded from their cells are unknown.
+    bool isPointerSizedInt(llvm::Type* type) const {
+        return type->isIntegerTy(mDataLayout.getPointerSizeInBits());
+    }
+
+    void visitInitializer(Cell base, const llvm::Constant* init);
+    void visitInstruction(llvm::Instruction& inst);
+    void visitCall(llvm::CallSite call);
+    void addAccess(const llvm::Value* ptr, uint64_t size) { mAccesses.emplace_back(ptr, size); }
+
+    // Regions
+    //==--------------------------------------------------------------------==//
+    RegionID getOrCreateRegion(unsigned node, const llvm::Value* object);
+    void recordAccess(const llvm::Value* ptr);
+    void computeRegions();
+    void computeAccessSizes();
+
+public:
+    struct Region
+    {
+        std::string name;
+        std::vector<const llvm::Value*> objects;
+        bool collapsed = false;
+        uint64_t accessSize = 0;
+    };
+
+    std::vector<Region> mRegions;
+
+private:
+    llvm::Module& mModule;
+    const llvm::DataLayout& mDataLayout;
+    const llvm::Function* mEntry;
+
+    std::vector<Node> mNodes;
+    std::vector<std::pair<Cell, Cell>> mWorklist;
+    unsigned mUnknown;
+
+    llvm::DenseMap<const llvm::Value*, Cell> mCells;
+    llvm::DenseMap<const llvm::Function*, Cell> mReturnCells;
+    std::vector<const llvm::Value*> mObjects;
+    std::vector<std::pair<const llvm::Value*, uint64_t>> mAccesses;
+
+    llvm::DenseMap<unsigned, RegionID> mRegionOfNode;
+    llvm::DenseMap<const llvm::Value*, RegionID> mRegionOf;
+    llvm::StringSet<> mRegionNames;
+};
+
+unsigned PointsToAnalysis::Impl::createNode()
+{
+    unsigned idx = mNodes.size();
+    mNodes.emplace_back(idx);
+
+    return idx;
+}
+
+std::pair<unsigned, int64_t> PointsToAnalysis::Impl::find(unsigned node)
+{
+    unsigned root = node;
+    int64_t total = 0;
+    while (mNodes[root].parent != root) {
+        total += mNodes[root].delta;
+        root = mNodes[root].parent;
+    }
+
+    // Compress the path, keeping the offsets relative to the root.
+    int64_t remaining = total;
+    while (node != root && mNodes[node].parent != root) {
+        unsigned next = mNodes[node].parent;
+        int64_t delta = mNodes[node].delta;
+        mNodes[node].parent = root;
+        mNodes[node].delta = remaining;
+        remaining -= delta;
+        node = next;
+    }
+
+    return {root, total};
+}
+
+Cell PointsToAnalysis::Impl::resolve(Cell cell)
+{
+    assert(!cell.isNull());
+
+    // Offsets are kept even for collapsed nodes, as they are needed to
+    // determine the alignment of accesses.
+    auto [root, delta] = this->find(cell.node);
+    return {root, cell.offset + delta};
+}
+
+void PointsToAnalysis::Impl::addStride(unsigned node, uint64_t stride)
+{
+    mNodes[node].stride = std::gcd(mNodes[node].stride, stride);
+}
+
+void PointsToAnalysis::Impl::merge(Cell lhs, Cell rhs)
+{
+    if (lhs.isNull() || rhs.isNull()) {
+        return;
+    }
+
+    mWorklist.emplace_back(lhs, rhs);
+    this->solve();
+}
+
+void PointsToAnalysis::Impl::collapse(unsigned node)
+{
+    assert(mNodes[node].parent == node && "Only representatives may be collapsed!");
+    if (mNodes[node].collapsed) {
+        return;
+    }
+
+    mNodes[node].collapsed = true;
+
+    // All fields are merged into a single one.
+    auto fields = std::move(mNodes[node].fields);
+    mNodes[node].fields.clear();
+    if (fields.empty()) {
+        return;
+    }
+
+    Cell first = fields.begin()->second;
+    mNodes[node].fields[0] = first;
+    for (auto& [offset, cell] : fields) {
+        mWorklist.emplace_back(first, cell);
+    }
+}
+
+void PointsToAnalysis::Impl::solve()
+{
+    while (!mWorklist.empty()) {
+        auto [lhs, rhs] = mWorklist.back();
+        mWorklist.pop_back();
+
+        Cell x = this->resolve(lhs);
+        Cell y = this->resolve(rhs);
+
+        if (x.node == y.node) {
+            if (x.offset != y.offset) {
+                // The same pointer may point to different offsets of the node.
+                this->addStride(x.node, std::abs(x.offset - y.offset));
+                this->collapse(x.node);
+            }
+            continue;
+        }
+
+        // Merge the node with fewer fields into the other one.
+        if (mNodes[x.node].fields.size() > mNodes[y.node].fields.size()) {
+            std::swap(x, y);
+        }
+
+        Node& from = mNodes[x.node];
+        int64_t shift = y.offset - x.offset;
+        from.parent = y.node;
+        from.delta = shift;
+
+        bool fromCollapsed = from.collapsed;
+        auto fields = std::move(from.fields);
+        from.fields.clear();
+
+        Node& to = mNodes[y.node];
+        to.stride = std::gcd(to.stride, from.stride);
+        for (auto& [offset, cell] : fields) {
+            int64_t target = to.collapsed ? 0 : offset + shift;
+            auto [it, inserted] = to.fields.try_emplace(target, cell);
+            if (!inserted) {
+                mWorklist.emplace_back(it->second, cell);
+            }
+        }
+
+        if (fromCollapsed) {
+            this->collapse(y.node);
+        }
+    }
+}
+
+Cell PointsToAnalysis::Impl::createObject(const llvm::Value* object)
+{
+    mObjects.push_back(object);
+    return {this->createNode(), 0};
+}
+
+Cell PointsToAnalysis::Impl::getPointee(Cell ptr)
+{
+    if (ptr.isNull()) {
+        return {};
+    }
+
+    Cell cell = this->resolve(ptr);
+    int64_t key = this->getFieldKey(cell);
+    auto it = mNodes[cell.node].fields.find(key);
+    if (it != mNodes[cell.node].fields.end()) {
+        return it->second;
+    }
+
+    Cell pointee = {this->createNode(), 0};
+    mNodes[cell.node].fields[key] = pointee;
+
+    return pointee;
+}
+
+Cell PointsToAnalysis::Impl::getCell(const llvm::Value* value)
+{
+    if (auto constant = llvm::dyn_cast<llvm::Constant>(value)) {
+        return this->getConstantCell(constant);
+    }
+
+    // Values may be used before their definition is visited (e.g. in PHI nodes),
+    // in this case we create a placeholder which is unified later.
+    auto it = mCells.find(value);
+    if (it != mCells.end()) {
+        return it->second;
+    }
+
+    Cell cell = {this->createNode(), 0};
+    mCells[value] = cell;
+
+    return cell;
+}
+
+Cell PointsToAnalysis::Impl::getConstantCell(const llvm::Constant* constant)
+{
+    if (llvm::isa<llvm::ConstantPointerNull>(constant) || llvm::isa<llvm::UndefValue>(constant)) {
+        return {};
+    }
+
+    if (auto gv = llvm::dyn_cast<llvm::GlobalVariable>(constant)) {
+        auto it = mCells.find(gv);
+        assert(it != mCells.end() && "Global variables must be visited first!");
+        return it->second;
+    }
+
+    if (auto alias = llvm::dyn_cast<llvm::GlobalAlias>(constant)) {
+        return this->getConstantCell(alias->getAliasee());
+    }
+
+    if (llvm::isa<llvm::Function>(constant)) {
+        // Functions do not occupy any memory which can be read or written.
+        return {};
+    }
+
+    if (auto expr = llvm::dyn_cast<llvm::ConstantExpr>(constant)) {
+        switch (expr->getOpcode()) {
+            case llvm::Instruction::BitCast:
+            case llvm::Instruction::AddrSpaceCast:
+                return this->getConstantCell(expr->getOperand(0));
+            case llvm::Instruction::GetElementPtr:
+                return this->offsetCell(
+                    this->getConstantCell(expr->getOperand(0)), *llvm::cast<llvm::GEPOperator>(expr)
+                );
+            default:
+                break;
+        }
+    }
+
+    return this->unknown();
+}
+
+Cell PointsToAnalysis::Impl::getReturnCell(const llvm::Function* function)
+{
+    auto it = mReturnCells.find(function);
+    if (it != mReturnCells.end()) {
+        return it->second;
+    }
+
+    Cell cell = {this->createNode(), 0};
+    mReturnCells[function] = cell;
+
+    return cell;
+}
+
+Cell PointsToAnalysis::Impl::offsetCell(Cell base, const llvm::GEPOperator& gep)
+{
+    if (base.isNull()) {
+        return base;
+    }
+
+    int64_t offset = 0;
+    uint64_t stride = 0;
+    for (auto ti = llvm::gep_type_begin(gep); ti != llvm::gep_type_end(gep); ++ti) {
+        auto index = llvm::dyn_cast<llvm::ConstantInt>(ti.getOperand());
+        if (llvm::StructType* structTy = ti.getStructTypeOrNull()) {
+            assert(index != nullptr && "Struct indices must be constant!");
+            offset += mDataLayout.getStructLayout(structTy)->getElementOffset(index->getZExtValue());
+            continue;
+        }
+
+        uint64_t size = mDataLayout.getTypeAllocSize(ti.getIndexedType());
+        if (index != nullptr) {
+            offset += index->getSExtValue() * static_cast<int64_t>(size);
+        } else {
+            stride = std::gcd(stride, size);
+        }
+    }
+
+    if (stride == 0) {
+        return {base.node, base.offset + offset};
+    }
+
+    // Non-constant indices make the fields of the base indistinguishable.
+    Cell resolved = this->resolve(base);
+    this->addStride(resolved.node, stride);
+    this->collapse(resolved.node);
+    this->solve();
+
+    return {base.node, base.offset + offset};
+}
+
+void PointsToAnalysis::Impl::define(const llvm::Value* value, Cell cell)
+{
+    if (cell.isNull()) {
+        return;
+    }
+
+    auto [it, inserted] = mCells.try_emplace(value, cell);
+    if (!inserted) {
+        this->merge(it->second, cell);
+    }
+}
+
+void PointsToAnalysis::Impl::escape(const llvm::Value* value)
+{
+    if (value->getType()->isPointerTy()) {
+        this->merge(this->getCell(value), this->unknown());
+    }
+}
+
+void PointsToAnalysis::Impl::escapeContents(const llvm::Value* ptr)
+{
+    // The pointers stored in the memory of ptr are not tracked precisely.
+    Cell cell = this->getCell(ptr);
+    if (cell.isNull()) {
+        return;
+    }
+
+    unsigned node = this->resolve(cell).node;
+    this->addStride(node, 1);
+    this->collapse(node);
+    this->solve();
+    this->merge(this->getPointee(cell), this->unknown());
+}
+
+void PointsToAnalysis::Impl::visitInitializer(Cell base, const llvm::Constant* init)
+{
+    llvm::Type* type = init->getType();
+    if (!containsPointer(type)) {
+        return;
+    }
+
+    if (type->isPointerTy()) {
+        this->merge(this->getPointee(base), this->getConstantCell(init));
+        return;
+    }
+
+    if (auto structTy = llvm::dyn_cast<llvm::StructType>(type)) {
+        const llvm::StructLayout* layout = mDataLayout.getStructLayout(structTy);
+        for (unsigned i = 0; i < structTy->getNumElements(); ++i) {
+            Cell field = {base.node, base.offset + static_cast<int64_t>(layout->getElementOffset(i))};
+            this->visitInitializer(field, init->getAggregateElement(i));
+        }
+        return;
+    }
+
+    // Arrays and vectors
+    llvm::Type* elemTy = type->isArrayTy() ? type->getArrayElementType() : type->getScalarType();
+    uint64_t elemSize = mDataLayout.getTypeAllocSize(elemTy);
+    for (unsigned i = 0; llvm::Constant* elem = init->getAggregateElement(i); ++i) {
+        Cell field = {base.node, base.offset + static_cast<int64_t>(i * elemSize)};
+        this->visitInitializer(field, elem);
+    }
+}
+
+void PointsToAnalysis::Impl::visitInstruction(llvm::Instruction& inst)
+{
+    if (auto alloca = llvm::dyn_cast<llvm::AllocaInst>(&inst)) {
+        this->define(alloca, this->createObject(alloca));
+    } else if (auto gep = llvm::dyn_cast<llvm::GetElementPtrInst>(&inst)) {
+        this->define(gep, this->offsetCell(
+            this->getCell(gep->getPointerOperand()), *llvm::cast<llvm::GEPOperator>(gep)
+        ));
+    } else if (auto load = llvm::dyn_cast<llvm::LoadInst>(&inst)) {
+        this->addAccess(load->getPointerOperand(), mDataLayout.getTypeAllocSize(load->getType()));
+        if (load->getType()->isPointerTy()) {
+            this->define(load, this->getPointee(this->getCell(load->getPointerOperand())));
+        } else if (containsPointer(load->getType())) {
+            this->escapeContents(load->getPointerOperand());
+        } else if (this->isPointerSizedInt(load->getType())) {
+            this->merge(this->getPointee(this->getCell(load->getPointerOperand())), this->unknown());
+        }
+    } else if (auto store = llvm::dyn_cast<llvm::StoreInst>(&inst)) {
+        llvm::Value* value = store->getValueOperand();
+        this->addAccess(store->getPointerOperand(), mDataLayout.getTypeAllocSize(value->getType()));
+        if (value->getType()->isPointerTy()) {
+            this->merge(this->getPointee(this->getCell(store->getPointerOperand())), this->getCell(value));
+        } else if (containsPointer(value->getType())) {
+            this->escapeContents(store->getPointerOperand());
+        } else if (this->isPointerSizedInt(value->getType())) {
+            this->merge(this->getPointee(this->getCell(store->getPointerOperand())), this->unknown());
+        }
+    } else if (auto phi = llvm::dyn_cast<llvm::PHINode>(&inst)) {
+        if (phi->getType()->isPointerTy()) {
+            Cell cell = this->getCell(phi);
+            for (llvm::Value* incoming : phi->incoming_values()) {
+                this->merge(cell, this->getCell(incoming));
+            }
+        }
+    } else if (auto select = llvm::dyn_cast<llvm::SelectInst>(&inst)) {
+        if (select->getType()->isPointerTy()) {
+            Cell cell = this->getCell(select);
+            this->merge(cell, this->getCell(select->getTrueValue()));
+            this->merge(cell, this->getCell(select->getFalseValue()));
+        }
+    } else if (auto ret = llvm::dyn_cast<llvm::ReturnInst>(&inst)) {
+        llvm::Value* retVal = ret->getReturnValue();
+        if (retVal != nullptr && retVal->getType()->isPointerTy()) {
+            this->merge(this->getReturnCell(ret->getFunction()), this->getCell(retVal));
+        }
+    } else if (llvm::isa<llvm::CallInst>(&inst) || llvm::isa<llvm::InvokeInst>(&inst)) {
+        this->visitCall(llvm::CallSite(&inst));
+    } else if (auto cast = llvm::dyn_cast<llvm::CastInst>(&inst)) {
+        switch (cast->getOpcode()) {
+            case llvm::Instruction::BitCast:
+            case llvm::Instruction::AddrSpaceCast:
+                if (cast->getType()->isPointerTy()) {
+                    this->define(cast, this->getCell(cast->getOperand(0)));
+                }
+                break;
+            case llvm::Instruction::PtrToInt:
+                this->escape(cast->getOperand(0));
+                break;
+            case llvm::Instruction::IntToPtr:
+                this->define(cast, this->unknown());
+                break;
+            default:
+                break;
+        }
+    } else if (llvm::isa<llvm::AtomicCmpXchgInst>(&inst) || llvm::isa<llvm::AtomicRMWInst>(&inst)) {
+        for (llvm::Value* op : inst.operands()) {
+            this->escape(op);
+        }
+        this->addAccess(inst.getOperand(0), 0);
+    } else if (llvm::isa<llvm::CmpInst>(&inst)) {
+        // Comparisons do not propagate pointers.
+    } else {
+        // Pointers hidden in aggregates or produced by unhandled instructions
+        // are not tracked.
+        for (llvm::Value* op : inst.operands()) {
+            this->escape(op);
+        }
+        if (inst.getType()->isPointerTy()) {
+            this->define(&inst, this->unknown());
+        }
+    }
+}
+
+void PointsToAnalysis::Impl::visitCall(llvm::CallSite call)
+{
+    llvm::Instruction* inst = call.getInstruction();
+
+    // Library functions and intrinsics access memory byte-by-byte.
+    auto addByteAccesses = [this, &call]() {
+        for (llvm::Value* arg : call.args()) {
+            if (arg->getType()->isPointerTy()) {
+                this->addAccess(arg, 1);
+            }
+        }
+    };
+
+    auto callee = llvm::dyn_cast<llvm::Function>(call.getCalledValue()->stripPointerCasts());
+    if (callee == nullptr) {
+        // Indirect calls and inline assembly may do anything with their arguments.
+        for (llvm::Value* arg : call.args()) {
+            this->escape(arg);
+        }
+        if (inst->getType()->isPointerTy()) {
+            this->define(inst, this->unknown());
+        }
+        return;
+    }
+
+    switch (callee->getIntrinsicID()) {
+        case llvm::Intrinsic::memcpy:
+        case llvm::Intrinsic::memmove:
+            this->merge(this->getCell(call.getArgument(0)), this->getCell(call.getArgument(1)));
+            addByteAccesses();
+            return;
+        case llvm::Intrinsic::memset:
+            addByteAccesses();
+            return;
+        case llvm::Intrinsic::ssa_copy:
+        case llvm::Intrinsic::ptr_annotation:
+        case llvm::Intrinsic::launder_invariant_group:
+        case llvm::Intrinsic::strip_invariant_group:
+            this->define(inst, this->getCell(call.getArgument(0)));
+            return;
+        case llvm::Intrinsic::not_intrinsic:
+            break;
+        default:
+            if (inst->getType()->isPointerTy()) {
+                this->define(inst, this->unknown());
+            }
+            return;
+    }
+
+    llvm::StringRef name = callee->getName();
+
+    if (isAllocationFunction(name)) {
+        this->define(inst, this->createObject(inst));
+        return;
+    }
+
+    if (name == "realloc") {
+        Cell object = this->createObject(inst);
+        this->merge(object, this->getCell(call.getArgument(0)));
+        this->define(inst, object);
+        return;
+    }
+
+    if (name == "memcpy" || name == "memmove") {
+        this->merge(this->getCell(call.getArgument(0)), this->getCell(call.getArgument(1)));
+        this->define(inst, this->getCell(call.getArgument(0)));
+        addByteAccesses();
+        return;
+    }
+
+    if (name == "memset" || name == "strcpy" || name == "strncpy" || name == "strcat") {
+        this->define(inst, this->getCell(call.getArgument(0)));
+        addByteAccesses();
+        return;
+    }
+
+    if (name == "strlen" || name == "strcmp" || name == "strncmp") {
+        addByteAccesses();
+        return;
+    }
+
+    if (name == "free") {
+        return;
+    }
+
+    if (name.startswith("gazer.") || name.startswith("verifier.") || name.startswith("__VERIFIER_")) {
+        // Verifier functions do not capture their arguments, but their pointer
+        // results (if any) are nondeterministic.
+        if (inst->getType()->isPointerTy()) {
+            this->define(inst, this->unknown());
+        }
+        return;
+    }
+
+    if (callee->isDeclaration()) {
+        for (llvm::Value* arg : call.args()) {
+            this->escape(arg);
+        }
+        if (inst->getType()->isPointerTy()) {
+            this->define(inst, this->unknown());
+        }
+        return;
+    }
+
+    unsigned idx = 0;
+    for (llvm::Value* arg : call.args()) {
+        if (idx < callee->arg_size()) {
+            llvm::Argument* param = callee->arg_begin() + idx;
+            if (param->getType()->isPointerTy() && arg->getType()->isPointerTy()) {
+                this->merge(this->getCell(param), this->getCell(arg));
+            } else {
+                this->escape(arg);
+            }
+        } else {
+            // Variadic arguments
+            this->escape(arg);
+        }
+        ++idx;
+    }
+
+    if (inst->getType()->isPointerTy()) {
+        this->merge(this->getCell(inst), this->getReturnCell(callee));
+    }
+}
+
+void PointsToAnalysis::Impl::analyze()
+{
+    // The unknown node points to itself.
+    mUnknown = this->createNode();
+    mNodes[mUnknown].collapsed = true;
+    mNodes[mUnknown].fields[0] = this->unknown();
+
+    for (llvm::GlobalVariable& gv : mModule.globals()) {
+        mCells[&gv] = this->createObject(&gv);
+    }
+
+    for (llvm::GlobalVariable& gv : mModule.globals()) {
+        if (gv.hasInitializer()) {
+            this->visitInitializer(mCells[&gv], gv.getInitializer());
+        }
+    }
+
+    for (llvm::Function& function : mModule) {
+        if (function.isDeclaration()) {
+            continue;
+        }
+
+        if (&function == mEntry || function.hasAddressTaken()) {
+            // The function may be called with arbitrary arguments.
+            for (llvm::Argument& arg : function.args()) {
+                this->escape(&arg);
+            }
+            if (function.getReturnType()->isPointerTy()) {
+                this->merge(this->getReturnCell(&function), this->unknown());
+            }
+        }
+
+        for (llvm::Instruction& inst : llvm::instructions(function)) {
+            this->visitInstruction(inst);
+        }
+    }
+
+    this->computeRegions();
+}
+
+auto PointsToAnalysis::Impl::getOrCreateRegion(unsigned node, const llvm::Value* object)
+    -> RegionID
+{
+    unsigned root = this->find(node).first;
+    auto it = mRegionOfNode.find(root);
+    if (it != mRegionOfNode.end()) {
+        return it->second;
+    }
+
+    RegionID id = mRegions.size();
+    mRegionOfNode[root] = id;
+
+    Region& region = mRegions.emplace_back();
+    region.collapsed = mNodes[root].collapsed;
+
+    std::string name = object != nullptr && object->hasName() ? object->getName().str() : "region";
+    if (!mRegionNames.insert(name).second) {
+        name += "." + std::to_string(id);
+        mRegionNames.insert(name);
+    }
+    region.name = name;
+
+    return id;
+}
+
+void PointsToAnalysis::Impl::recordAccess(const llvm::Value* ptr)
+{
+    if (mRegionOf.count(ptr) != 0) {
+        return;
+    }
+
+    Cell cell = this->getCell(ptr);
+    if (cell.isNull()) {
+        return;
+    }
+
+    mRegionOf[ptr] = this->getOrCreateRegion(cell.node, nullptr);
+}
+
+void PointsToAnalysis::Impl::computeRegions()
+{
+    RegionID unknownId = this->getOrCreateRegion(mUnknown, nullptr);
+    assert(unknownId == UnknownRegion);
+    mRegions[UnknownRegion].name = "unknown";
+
+    for (const llvm::Value* object : mObjects) {
+        RegionID id = this->getOrCreateRegion(this->getCell(object).node, object);
+        mRegions[id].objects.push_back(object);
+        mRegionOf[object] = id;
+    }
+
+    for (auto& [ptr, size] : mAccesses) {
+        this->recordAccess(ptr);
+    }
+
+    this->computeAccessSizes();
+
+    // Pointers which are never dereferenced may still be queried, map them onto
+    // existing regions. If their node is not accessed by any instruction, the
+    // choice of region is irrelevant.
+    for (auto& [value, cell] : mCells) {
+        if (mRegionOf.count(value) == 0) {
+            auto it = mRegionOfNode.find(this->find(cell.node).first);
+            if (it != mRegionOfNode.end()) {
+                mRegionOf[value] = it->second;
+            }
+        }
+    }
+
+    LLVM_DEBUG(llvm::dbgs() << "Points-to analysis found " << mRegions.size() << " regions.\n");
+}
+
+void PointsToAnalysis::Impl::computeAccessSizes()
+{
+    // A region has a uniform access size S if all of its accesses are S bytes
+    // long and they are at offsets which are multiples of S from the beginning
+    // of their objects. As all offsets are relative to the representative node,
+    // it is sufficient to check that all access offsets and object offsets are
+    // congruent modulo S.
+    constexpr uint64_t Mixed = ~0ull;
+
+    std::vector<uint64_t> sizes(mRegions.size(), 0);
+    std::vector<uint64_t> strides(mRegions.size(), 0);
+    std::vector<std::optional<int64_t>> anchors(mRegions.size());
+
+    auto addOffset = [&](const llvm::Value* value) {
+        Cell cell = this->getCell(value);
+        if (cell.isNull()) {
+            return;
+        }
+
+        cell = this->resolve(cell);
+        auto it = mRegionOfNode.find(cell.node);
+        if (it == mRegionOfNode.end()) {
+            return;
+        }
+
+        RegionID id = it->second;
+        strides[id] = std::gcd(strides[id], mNodes[cell.node].stride);
+        if (!anchors[id]) {
+            anchors[id] = cell.offset;
+        } else {
+            strides[id] = std::gcd(strides[id], std::abs(cell.offset - *anchors[id]));
+        }
+    };
+
+    for (const llvm::Value* object : mObjects) {
+        addOffset(object);
+    }
+
+    for (auto& [ptr, size] : mAccesses) {
+        addOffset(ptr);
+
+        auto it = mRegionOf.find(ptr);
+        if (it == mRegionOf.end()) {
+            continue;
+        }
+
+        uint64_t& regionSize = sizes[it->second];
+        if (size == 0 || (regionSize != 0 && regionSize != size)) {
+            regionSize = Mixed;
+        } else {
+            regionSize = size;
+        }
+    }
+
+    for (RegionID id = 0; id < mRegions.size(); ++id) {
+        uint64_t size = sizes[id];
+        if (id == UnknownRegion || size == 0 || size == Mixed || strides[id] % size != 0) {
+            continue;
+        }
+
+        mRegions[id].accessSize = size;
+    }
+}
+
+// Public interface
+//==------------------------------------------------------------------------==//
+
+PointsToAnalysis::PointsToAnalysis(llvm::Module& module, const llvm::Function* entry)
+    : pImpl(std::make_unique<Impl>(module, entry))
+{
+    pImpl->analyze();
+}
+
+PointsToAnalysis::~PointsToAnalysis() = default;
+
+auto PointsToAnalysis::getRegionFor(const llvm::Value* ptr) const -> RegionID
+{
+    return pImpl->getRegionFor(ptr);
+}
+
+unsigned PointsToAnalysis::getNumRegions() const
+{
+    return pImpl->mRegions.size();
+}
+
+llvm::ArrayRef<const llvm::Value*> PointsToAnalysis::getRegionObjects(RegionID region) const
+{
+    assert(region < pImpl->mRegions.size());
+    return pImpl->mRegions[region].objects;
+}
+
+llvm::StringRef PointsToAnalysis::getRegionName(RegionID region) const
+{
+    assert(region < pImpl->mRegions.size());
+    return pImpl->mRegions[region].name;
+}
+
+bool PointsToAnalysis::isCollapsed(RegionID region) const
+{
+    assert(region < pImpl->mRegions.size());
+    return pImpl->mRegions[region].collapsed;
+}
+
+uint64_t PointsToAnalysis::getUniformAccessSize(RegionID region) const
+{
+    assert(region < pImpl->mRegions.size());
+    return pImpl->mRegions[region].accessSize;
+}
+
+void PointsToAnalysis::print(llvm::raw_ostream& os) const
+{
+    for (RegionID id = 0; id < pImpl->mRegions.size(); ++id) {
+        auto& region = pImpl->mRegions[id];
+        os << "Region " << id << " (" << region.name << ")";
+        if (region.collapsed) {
+            os << " collapsed";
+        }
+        if (region.accessSize != 0) {
+            os << " cells=" << region.accessSize;
+        }
+        os << ":";
+        for (const llvm::Value* object : region.objects) {
+            os << " ";
+            object->printAsOperand(os, false);
+        }
+        os << "\n";
+    }
+}
@@ -0,0 +1,147 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "gazer/LLVM/PipelineReport.h"
+#include "gazer/Automaton/Cfa.h"
+
+#include <llvm/Config/llvm-config.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/Format.h>
+#include <llvm/Support/FormatVariadic.h>
+#include <llvm/Support/JSON.h>
+#include <llvm/Support/raw_ostream.h>
+
+#ifdef LLVM_ON_UNIX
+#include <sys/resource.h>
+#endif
+
+using namespace gazer;
+
+static uint64_t getPeakRss()
+{
+#ifdef LLVM_ON_UNIX
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    #ifdef __APPLE__
+    // Darwin reports the maximum resident set size in bytes.
+    return usage.ru_maxrss / 1024;
+    #else
+    return usage.ru_maxrss;
+    #endif
+#else
+    return 0;
+#endif
+}
+
+PipelineSnapshot PipelineSnapshot::take(const llvm::Module* module, const AutomataSystem* system)
+{
+    PipelineSnapshot snapshot;
+
+    if (module != nullptr) {
+        snapshot.instructions = module->getInstructionCount();
+    }
+
+    if (system != nullptr) {
+        for (const Cfa& cfa : *system) {
+            snapshot.automata += 1;
+            snapshot.locations += cfa.getNumLocations();
+            snapshot.transitions += cfa.getNumTransitions();
+            snapshot.locals += cfa.getNumLocals();
+        }
+    }
+
+    snapshot.peakRss = getPeakRss();
+
+    // Take the time last, so the measurement itself is not accounted to the next step.
+    snapshot.time = std::chrono::steady_clock::now();
+
+    return snapshot;
+}
+
+static double elapsedSeconds(const PipelineReport::Step& step)
+{
+    return std::chrono::duration<double>(step.after.time - step.before.time).count();
+}
+
+static int64_t difference(uint64_t before, uint64_t after)
+{
+    return static_cast<int64_t>(after) - static_cast<int64_t>(before);
+}
+
+void PipelineReport::print(llvm::raw_ostream& os) const
+{
+    double totalTime = 0.0;
+    for (const Step& step : mSteps) {
+        totalTime += elapsedSeconds(step);
+    }
+
+    os << "===" << std::string(73, '-') << "===\n";
+    os << "                      Gazer verification pipeline report\n";
+    os << "===" << std::string(73, '-') << "===\n";
+    os << llvm::format("  Total Execution Time: %.4f seconds\n\n", totalTime);
+
+    os << "    ---Wall Time---  --RSS (KB)--     ---Instructions---      --Locations--   --- Name ---\n";
+    for (const Step& step : mSteps) {
+        double time = elapsedSeconds(step);
+        os << llvm::format("  %8.4f (%5.1f%%)", time, totalTime == 0.0 ? 0.0 : time / totalTime * 100.0);
+        os << llvm::format("   %+11lld", static_cast<long long>(difference(step.before.peakRss, step.after.peakRss)));
+        os << llvm::format("   %8llu -> %-8llu",
+            static_cast<unsigned long long>(step.before.instructions),
+            static_cast<unsigned long long>(step.after.instructions));
+        os << llvm::format("   %6llu -> %-6llu",
+            static_cast<unsigned long long>(step.before.locations),
+            static_cast<unsigned long long>(step.after.locations));
+        os << "   " << step.name << "\n";
+    }
+    os << "\n";
+    os.flush();
+}
+
+static llvm::json::Object snapshotToJson(const PipelineSnapshot& snapshot)
+{
+    return llvm::json::Object{
+        {"peak_rss_kb", static_cast<int64_t>(snapshot.peakRss)},
+        {"instructions", static_cast<int64_t>(snapshot.instructions)},
+        {"automata", static_cast<int64_t>(snapshot.automata)},
+        {"locations", static_cast<int64_t>(snapshot.locations)},
+        {"transitions", static_cast<int64_t>(snapshot.transitions)},
+        {"locals", static_cast<int64_t>(snapshot.locals)}
+    };
+}
+
+void PipelineReport::printJson(llvm::raw_ostream& os) const
+{
+    llvm::json::Array steps;
+    for (const Step& step : mSteps) {
+        steps.push_back(llvm::json::Object{
+            {"name", step.name},
+            {"wall_time_sec", elapsedSeconds(step)},
+            {"peak_rss_delta_kb", difference(step.before.peakRss, step.after.peakRss)},
+            {"before", snapshotToJson(step.before)},
+            {"after", snapshotToJson(step.after)}
+        });
+    }
+
+    llvm::json::Object root{
+        {"steps", std::move(steps)},
+        {"peak_rss_kb", static_cast<int64_t>(getPeakRss())}
+    };
+
+    os << llvm::formatv("{0:2}", llvm::json::Value(std::move(root))) << "\n";
+}
@@ -17,20 +17,36 @@
 //===----------------------------------------------------------------------===//
 
 #include "gazer/LLVM/Transform/BackwardSlicer.h"
-
+#include "gazer/LLVM/Instrumentation/Check.h"
+
+#include <llvm/ADT/SCCIterator.h>
+#include <llvm/ADT/Statistic.h>
+#include <llvm/Analysis/LoopInfo.h>
+#include <llvm/Analysis/ScalarEvolution.h>
+#include <llvm/Analysis/ScalarEvolutionExpressions.h>
+#include <llvm/IR/CFG.h>
 #include <llvm/IR/Instructions.h>
 #include <llvm/IR/InstIterator.h>
+#include <llvm/IR/IntrinsicInst.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/Debug.h>
+#include <llvm/Transforms/Utils/BasicBlockUtils.h>
+#include <llvm/Transforms/Utils/Local.h>
+
+#define DEBUG_TYPE "BackwardSlicer"
 
 using namespace gazer;
 using namespace llvm;
 
+STATISTIC(NumSlicedFunctions, "Number of sliced functions");
+STATISTIC(NumSlicedInstructions, "Number of instructions removed by slicing");
+
 BackwardSlicer::BackwardSlicer(
     llvm::Function& function,
     std::function<bool(llvm::Instruction*)> criterion
-) : mFunction(function), mCriterion(criterion)
+) : mFunction(function), mCriterion(criterion), mPDT(function)
 {
-    llvm::PostDominatorTree pdt(function);
-    mPDG = ProgramDependenceGraph::Create(function, pdt);
+    mPDG = ProgramDependenceGraph::Create(function, mPDT);
 }
 
 bool BackwardSlicer::collectRequiredNodes(llvm::DenseSet<llvm::Instruction*>& visited)
@@ -49,62 +65,90 @@ bool BackwardSlicer::collectRequiredNodes(llvm::DenseSet<llvm::Instruction*>& vi
         return false;
     }
 
-    // Walk the PDG, collecting needed nodes
-    while (!wl.empty()) {
-        Instruction* current = wl.pop_back_val();
-        visited.insert(current);
+    // Branches without an immediate post-dominator cannot be redirected,
+    // they must be kept along with their conditions.
+    for (llvm::BasicBlock& bb : mFunction) {
+        if (bb.getTerminator()->getNumSuccessors() <= 1) {
+            continue;
+        }
 
-        //llvm::errs() << "Visiting " << *current << "\n";
-        auto pdgNode = mPDG->getNode(current);
-        for (PDGEdge* edge : pdgNode->incoming()) {
-            llvm::Instruction* inst = edge->getSource()->getInstruction();
-            //llvm::errs() << "  Child " << *inst << "\n";
-            if (visited.count(inst) == 0) {
-                //llvm::errs() << "  not visited yet\n";
-                wl.push_back(inst);
-            }
+        auto node = mPDT.getNode(&bb);
+        if (node == nullptr || node->getIDom() == nullptr || node->getIDom()->getBlock() == nullptr) {
+            wl.push_back(bb.getTerminator());
         }
     }
 
-    return true;
-}
+    do {
+        // Walk the PDG, collecting needed nodes
+        while (!wl.empty()) {
+            Instruction* current = wl.pop_back_val();
+            if (!visited.insert(current).second) {
+                continue;
+            }
 
-void BackwardSlicer::sliceBlocks(
-    const llvm::DenseSet<llvm::Instruction*>& required,
-    llvm::SmallVectorImpl<llvm::BasicBlock*>& preservedBlocks
-) {
-    auto& list = mFunction.getBasicBlockList();
-    auto it = list.begin(), ie = list.end();
+            auto pdgNode = mPDG->getNode(current);
+            for (PDGEdge* edge : pdgNode->incoming()) {
+                llvm::Instruction* inst = edge->getSource()->getInstruction();
+                if (visited.count(inst) == 0) {
+                    wl.push_back(inst);
+                }
+            }
+        }
 
-    while (it != ie) {
-        llvm::BasicBlock& bb = *(it++);        
-        bool shouldRemove = std::all_of(bb.begin(), bb.end(), [&required](llvm::Instruction& inst) {
-            return required.count(&inst) == 0;
-        });
+        // A branch cannot be redirected to a post-dominator having a required
+        // PHI node, as there would be no incoming value for the branch's block.
+        // Such branches are kept, and so must be their dependencies.
+        for (llvm::BasicBlock& bb : mFunction) {
+            llvm::Instruction* terminator = bb.getTerminator();
+            if (terminator->getNumSuccessors() <= 1 || visited.count(terminator) != 0) {
+                continue;
+            }
 
-        if (!shouldRemove) {
-            preservedBlocks.push_back(&bb);
-            continue;
+            llvm::BasicBlock* target = mPDT.getNode(&bb)->getIDom()->getBlock();
+            bool hasRequiredPhi = llvm::any_of(target->phis(), [&visited](llvm::PHINode& phi) {
+                return visited.count(&phi) != 0;
+            });
+
+            if (hasRequiredPhi) {
+                wl.push_back(terminator);
+            }
         }
+    } while (!wl.empty());
 
-        // Remove all instructions in this block
-        for (auto j = bb.begin(); j != bb.end();) {
-            llvm::Instruction& inst = *(j++);
+    return true;
+}
 
-            inst.replaceAllUsesWith(UndefValue::get(inst.getType()));
-            inst.dropAllReferences();
-            inst.eraseFromParent();
+void BackwardSlicer::sliceBlocks(const llvm::DenseSet<llvm::Instruction*>& required)
+{
+    // The slice does not depend on the outcome of the remaining branches,
+    // so they may jump directly to their immediate post-dominator. The
+    // targets are collected first, as the redirection invalidates the tree.
+    llvm::SmallVector<std::pair<llvm::BasicBlock*, llvm::BasicBlock*>, 16> redirects;
+    for (llvm::BasicBlock& bb : mFunction) {
+        llvm::Instruction* terminator = bb.getTerminator();
+        if (terminator->getNumSuccessors() <= 1 || required.count(terminator) != 0) {
+            continue;
         }
 
-        // Update successors PHI's
-        for (llvm::BasicBlock* succ : llvm::successors(&bb)) {
-            succ->removePredecessor(&bb);
+        llvm::BasicBlock* target = mPDT.getNode(&bb)->getIDom()->getBlock();
+        assert(target != nullptr && "Branches without a post-dominator must be in the slice!");
+        assert(!llvm::isa<llvm::PHINode>(target->front())
+            && "Branches targeting a required PHI node must be in the slice!");
+
+        redirects.emplace_back(&bb, target);
+    }
+
+    for (auto& [bb, target] : redirects) {
+        llvm::Instruction* terminator = bb->getTerminator();
+        for (llvm::BasicBlock* succ : llvm::successors(bb)) {
+            succ->removePredecessor(bb);
         }
 
-        // Insert a new 'unreachable' instruction as the terminator
-        auto unreachable = new UnreachableInst(mFunction.getContext());
-        bb.getInstList().push_back(unreachable);
+        llvm::ReplaceInstWithInst(terminator, llvm::BranchInst::Create(target));
     }
+
+    // Blocks which were only reachable through a redirected branch are now dead.
+    llvm::removeUnreachableBlocks(mFunction);
 }
 
 void BackwardSlicer::sliceInstructions(
@@ -126,9 +170,8 @@ void BackwardSlicer::sliceInstructions(
             continue;
         }
 
-        // Do not remove intrinsics and debug-related stuff.
-        // TODO: We should be more refined here, instead of keeping all calls.
-        if (auto call = llvm::dyn_cast<llvm::CallInst>(&current)) {
+        // Do not remove debug-related stuff.
+        if (llvm::isa<llvm::DbgInfoIntrinsic>(&current)) {
             continue;
         }
 
@@ -143,22 +186,17 @@ bool BackwardSlicer::slice()
     llvm::DenseSet<llvm::Instruction*> required;
     bool shouldContinue = this->collectRequiredNodes(required);
 
-    //mFunction.dump();
-    //mPDG->view();
     if (!shouldContinue) {
         return false;
     }
-    
-    // Slice blocks which should completely be removed.
-    llvm::SmallVector<llvm::BasicBlock*, 32> preservedBlocks;
-    this->sliceBlocks(required, preservedBlocks);
 
-    // Slice the remaining blocks.
-    for (llvm::BasicBlock* bb : preservedBlocks) {
-        this->sliceInstructions(*bb, required);
+    // Remove the unneeded instructions first, so that only the required
+    // PHI nodes remain when the branches are redirected.
+    for (llvm::BasicBlock& bb : mFunction) {
+        this->sliceInstructions(bb, required);
     }
 
-    //mFunction.dump();
+    this->sliceBlocks(required);
 
     return true;
 }
@@ -172,7 +210,7 @@ namespace
 class BackwardSlicerPass : public llvm::FunctionPass
 {
 public:
-    char ID;
+    static char ID;
 
     BackwardSlicerPass(std::function<bool(llvm::Instruction*)> criteria)
         : FunctionPass(ID), mCriteria(criteria)
@@ -184,13 +222,228 @@ public:
         return slicer.slice();
     }
 
+    llvm::StringRef getPassName() const override
+    { return "Backward slicing"; }
+
 private:
     std::function<bool(llvm::Instruction*)> mCriteria;
 };
 
+class InterproceduralSlicerPass : public llvm::ModulePass
+{
+public:
+    static char ID;
+
+    InterproceduralSlicerPass(llvm::Function* entry)
+        : ModulePass(ID), mEntryFunction(entry)
+    {}
+
+    void getAnalysisUsage(llvm::AnalysisUsage& au) const override
+    {
+        au.addRequired<llvm::LoopInfoWrapperPass>();
+        au.addRequired<llvm::ScalarEvolutionWrapperPass>();
+    }
+
+    bool runOnModule(llvm::Module& module) override;
+
+    llvm::StringRef getPassName() const override
+    { return "Interprocedural backward slicing"; }
+
+private:
+    void collectUnboundedLoopExits(llvm::Function& function, llvm::DenseSet<llvm::Instruction*>& exits);
+    bool mayRestrict(llvm::Instruction& inst) const;
+    bool isCriterion(llvm::Function& function, llvm::Instruction& inst) const;
+
+private:
+    llvm::Function* mEntryFunction;
+
+    /// Functions which may block some of their executions, by an assumption,
+    /// a failing or non-returning call, an unreachable instruction or a
+    /// loop which may not terminate.
+    llvm::DenseSet<llvm::Function*> mRestrictingFunctions;
+
+    /// The exit branches of loops which are not known to terminate.
+    llvm::DenseMap<llvm::Function*, llvm::DenseSet<llvm::Instruction*>> mUnboundedLoopExits;
+};
+
 } // end anonymous namespace
 
+char BackwardSlicerPass::ID;
+char InterproceduralSlicerPass::ID;
+
+void InterproceduralSlicerPass::collectUnboundedLoopExits(
+    llvm::Function& function, llvm::DenseSet<llvm::Instruction*>& exits)
+{
+    auto& loopInfo = getAnalysis<llvm::LoopInfoWrapperPass>(function).getLoopInfo();
+    auto& se = getAnalysis<llvm::ScalarEvolutionWrapperPass>(function).getSE();
+
+    // Only loops with a constant trip count are known to terminate. Symbolic
+    // trip counts may rely on the absence of overflows, which does not hold
+    // for the bit-vector semantics of the verifier.
+    for (llvm::Loop* loop : loopInfo.getLoopsInPreorder()) {
+        if (llvm::isa<llvm::SCEVConstant>(se.getBackedgeTakenCount(loop))) {
+            continue;
+        }
+
+        llvm::SmallVector<llvm::BasicBlock*, 4> exiting;
+        loop->getExitingBlocks(exiting);
+        for (llvm::BasicBlock* bb : exiting) {
+            exits.insert(bb->getTerminator());
+        }
+    }
+
+    // Cycles which are not natural loops are never known to terminate.
+    for (auto it = llvm::scc_begin(&function); !it.isAtEnd(); ++it) {
+        const std::vector<llvm::BasicBlock*>& scc = *it;
+        bool isCycle = scc.size() > 1
+            || llvm::is_contained(llvm::successors(scc.front()), scc.front());
+        if (!isCycle) {
+            continue;
+        }
+
+        llvm::Loop* loop = loopInfo.getLoopFor(scc.front());
+        while (loop != nullptr && loop->getNumBlocks() < scc.size()) {
+            loop = loop->getParentLoop();
+        }
+
+        bool isNaturalLoop = loop != nullptr && llvm::all_of(scc, [loop](llvm::BasicBlock* bb) {
+            return loop->contains(bb);
+        });
+
+        if (isNaturalLoop) {
+            continue;
+        }
+
+        for (llvm::BasicBlock* bb : scc) {
+            if (bb->getTerminator()->getNumSuccessors() > 1) {
+                exits.insert(bb->getTerminator());
+            }
+        }
+    }
+}
+
+bool InterproceduralSlicerPass::mayRestrict(llvm::Instruction& inst) const
+{
+    if (llvm::isa<llvm::UnreachableInst>(&inst)) {
+        return true;
+    }
+
+    auto call = llvm::dyn_cast<llvm::CallInst>(&inst);
+    if (call == nullptr || llvm::isa<llvm::DbgInfoIntrinsic>(call)) {
+        return false;
+    }
+
+    llvm::Function* callee = call->getCalledFunction();
+    if (callee == nullptr || call->doesNotReturn()) {
+        return true;
+    }
+
+    // External functions other than the verifier intrinsics are assumed to return.
+    return callee->getName() == CheckRegistry::ErrorFunctionName
+        || callee->getName() == "verifier.assume"
+        || mRestrictingFunctions.count(callee) != 0;
+}
+
+bool InterproceduralSlicerPass::isCriterion(llvm::Function& function, llvm::Instruction& inst) const
+{
+    if (llvm::isa<llvm::UnreachableInst>(&inst)) {
+        // Unreachable instructions are handled by the slicer's post-dominator tree.
+        return false;
+    }
+
+    if (this->mayRestrict(inst)) {
+        return true;
+    }
+
+    // Slicing away a loop which may not terminate would make its successors reachable.
+    auto loopExits = mUnboundedLoopExits.find(&function);
+    if (loopExits != mUnboundedLoopExits.end() && loopExits->second.count(&inst) != 0) {
+        return true;
+    }
+
+    if (&function == mEntryFunction) {
+        return false;
+    }
+
+    // Other functions must preserve everything their callers may observe.
+    if (llvm::isa<llvm::ReturnInst>(&inst)) {
+        return true;
+    }
+
+    if (auto store = llvm::dyn_cast<llvm::StoreInst>(&inst)) {
+        return !llvm::isa<llvm::AllocaInst>(store->getPointerOperand()->stripInBoundsOffsets());
+    }
+
+    return inst.mayHaveSideEffects() && !llvm::isa<llvm::DbgInfoIntrinsic>(&inst);
+}
+
+bool InterproceduralSlicerPass::runOnModule(llvm::Module& module)
+{
+    for (llvm::Function& function : module) {
+        if (function.isDeclaration()) {
+            continue;
+        }
+
+        auto& exits = mUnboundedLoopExits[&function];
+        this->collectUnboundedLoopExits(function, exits);
+        if (!exits.empty()) {
+            mRestrictingFunctions.insert(&function);
+        }
+    }
+
+    // Find the functions which may restrict the executions of their callers.
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (llvm::Function& function : module) {
+            if (function.isDeclaration() || mRestrictingFunctions.count(&function) != 0) {
+                continue;
+            }
+
+            for (llvm::Instruction& inst : llvm::instructions(function)) {
+                if (this->mayRestrict(inst)) {
+                    mRestrictingFunctions.insert(&function);
+                    changed = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    bool modified = false;
+    for (llvm::Function& function : module) {
+        if (function.isDeclaration()) {
+            continue;
+        }
+
+        unsigned numInstsBefore = function.getInstructionCount();
+
+        BackwardSlicer slicer(function, [this, &function](llvm::Instruction* inst) {
+            return this->isCriterion(function, *inst);
+        });
+
+        if (!slicer.slice()) {
+            continue;
+        }
+
+        unsigned numSliced = numInstsBefore - function.getInstructionCount();
+        LLVM_DEBUG(llvm::dbgs() << "Sliced " << numSliced << " of " << numInstsBefore
+            << " instructions from '" << function.getName() << "'.\n");
+
+        NumSlicedInstructions += numSliced;
+        ++NumSlicedFunctions;
+        modified = true;
+    }
+
+    return modified;
+}
+
 llvm::Pass* gazer::createBackwardSlicerPass(std::function<bool(llvm::Instruction*)> criteria)
 {
     return new BackwardSlicerPass(criteria);
-}
\ No newline at end of file
+}
+
+llvm::Pass* gazer::createInterproceduralSlicerPass(llvm::Function& entry)
+{
+    return new InterproceduralSlicerPass(&entry);
+}
@@ -51,6 +51,10 @@ struct InlineGlobalVariablesPass final : public ModulePass
 
     bool runOnModule(Module& module) override;
 
+    llvm::StringRef getPassName() const override {
+        return "Inline global variables";
+    }
+
     static llvm::Function* shouldInlineGlobal(llvm::CallGraph& cg, llvm::GlobalVariable& gv);
 };
 
@@ -0,0 +1,331 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file This file defines a loop acceleration pass, which replaces loops
+/// with a closed-form effect by straight-line code.
+///
+/// A loop is accelerated if it has a single exit, its trip count and the
+/// values it leaves to the rest of the function are computable by scalar
+/// evolution, and its only side effects are stores whose addresses and
+/// values are affine in the iteration number (e.g. array fills). The stores
+/// are emitted into the preheader for each iteration, which requires a
+/// constant trip count, and the loop is deleted. As a result, the verifier
+/// does not need to unroll such loops one iteration at a time.
+///
+/// Loops with more than one exit are left intact. Note that this includes
+/// loops containing instrumented checks, as these branch to an error block.
+///
+//===----------------------------------------------------------------------===//
+#include "gazer/LLVM/Transform/Passes.h"
+
+#include <llvm/Analysis/LoopInfo.h>
+#include <llvm/Analysis/ScalarEvolution.h>
+#include <llvm/Analysis/ScalarEvolutionExpander.h>
+#include <llvm/Analysis/ScalarEvolutionExpressions.h>
+#include <llvm/IR/Dominators.h>
+#include <llvm/IR/IntrinsicInst.h>
+#include <llvm/Transforms/Utils.h>
+#include <llvm/Transforms/Utils/LoopUtils.h>
+#include <llvm/Support/Debug.h>
+
+#define DEBUG_TYPE "LoopAcceleration"
+
+using namespace gazer;
+
+namespace
+{
+
+class LoopAccelerationPass : public llvm::FunctionPass
+{
+public:
+    static char ID;
+
+    explicit LoopAccelerationPass(unsigned maxStores)
+        : FunctionPass(ID), mMaxStores(maxStores)
+    {}
+
+    void getAnalysisUsage(llvm::AnalysisUsage& au) const override
+    {
+        au.addRequiredID(llvm::LoopSimplifyID);
+        au.addRequiredID(llvm::LCSSAID);
+        au.addRequired<llvm::DominatorTreeWrapperPass>();
+        au.addRequired<llvm::LoopInfoWrapperPass>();
+        au.addRequired<llvm::ScalarEvolutionWrapperPass>();
+    }
+
+    bool runOnFunction(llvm::Function& function) override;
+
+    llvm::StringRef getPassName() const override {
+        return "Loop acceleration";
+    }
+
+private:
+    bool accelerate(llvm::Loop* loop);
+
+    /// Collects the stores of the loop in execution order.
+    /// \return False if the loop has side effects other than unconditional stores.
+    bool collectStores(
+        llvm::Loop* loop,
+        llvm::SmallVectorImpl<llvm::StoreInst*>& beforeExit,
+        llvm::SmallVectorImpl<llvm::StoreInst*>& afterExit
+    );
+
+    /// Returns the closed form of \p value in the given iteration of \p loop,
+    /// or nullptr if it cannot be computed.
+    const llvm::SCEV* getValueAtIteration(llvm::Loop* loop, llvm::Value* value, const llvm::SCEV* iteration);
+
+private:
+    unsigned mMaxStores;
+    llvm::DominatorTree* mDT = nullptr;
+    llvm::LoopInfo* mLI = nullptr;
+    llvm::ScalarEvolution* mSE = nullptr;
+};
+
+} // end anonymous namespace
+
+char LoopAccelerationPass::ID;
+
+bool LoopAccelerationPass::runOnFunction(llvm::Function& function)
+{
+    mDT = &getAnalysis<llvm::DominatorTreeWrapperPass>().getDomTree();
+    mLI = &getAnalysis<llvm::LoopInfoWrapperPass>().getLoopInfo();
+    mSE = &getAnalysis<llvm::ScalarEvolutionWrapperPass>().getSE();
+
+    // Visit inner loops first: once they are deleted, their parents may become
+    // eligible. Only innermost loops are deleted, so the remaining pointers
+    // stay valid.
+    llvm::SmallVector<llvm::Loop*, 8> loops = mLI->getLoopsInPreorder();
+
+    bool changed = false;
+    for (auto it = loops.rbegin(); it != loops.rend(); ++it) {
+        changed |= this->accelerate(*it);
+    }
+
+    return changed;
+}
+
+bool LoopAccelerationPass::collectStores(
+    llvm::Loop* loop,
+    llvm::SmallVectorImpl<llvm::StoreInst*>& beforeExit,
+    llvm::SmallVectorImpl<llvm::StoreInst*>& afterExit)
+{
+    llvm::BasicBlock* exiting = loop->getExitingBlock();
+    llvm::BasicBlock* latch = loop->getLoopLatch();
+
+    // Blocks containing stores must be executed in each iteration, which
+    // puts them on a single dominator chain. Sorting them by their depth in
+    // the dominator tree yields their execution order.
+    llvm::SmallVector<llvm::BasicBlock*, 4> storeBlocks;
+
+    for (llvm::BasicBlock* bb : loop->blocks()) {
+        bool hasStore = false;
+        for (llvm::Instruction& inst : *bb) {
+            if (auto store = llvm::dyn_cast<llvm::StoreInst>(&inst)) {
+                if (!store->isSimple()) {
+                    return false;
+                }
+                hasStore = true;
+            } else if (llvm::isa<llvm::DbgInfoIntrinsic>(inst)) {
+                continue;
+            } else if (llvm::isa<llvm::CallBase>(inst) || inst.mayReadOrWriteMemory() || inst.mayHaveSideEffects()) {
+                return false;
+            } else if (inst.isTerminator() && !llvm::isa<llvm::BranchInst>(inst)) {
+                return false;
+            }
+        }
+
+        if (hasStore) {
+            if (!mDT->dominates(bb, latch)) {
+                return false;
+            }
+            storeBlocks.push_back(bb);
+        }
+    }
+
+    std::sort(storeBlocks.begin(), storeBlocks.end(), [this](llvm::BasicBlock* lhs, llvm::BasicBlock* rhs) {
+        return mDT->getNode(lhs)->getLevel() < mDT->getNode(rhs)->getLevel();
+    });
+
+    for (llvm::BasicBlock* bb : storeBlocks) {
+        // Stores before the exit condition are also executed in the last iteration.
+        auto& stores = mDT->dominates(bb, exiting) ? beforeExit : afterExit;
+        for (llvm::Instruction& inst : *bb) {
+            if (auto store = llvm::dyn_cast<llvm::StoreInst>(&inst)) {
+                stores.push_back(store);
+            }
+        }
+    }
+
+    return true;
+}
+
+const llvm::SCEV* LoopAccelerationPass::getValueAtIteration(
+    llvm::Loop* loop, llvm::Value* value, const llvm::SCEV* iteration)
+{
+    if (loop->isLoopInvariant(value)) {
+        return mSE->isSCEVable(value->getType()) ? mSE->getSCEV(value) : nullptr;
+    }
+
+    if (!mSE->isSCEVable(value->getType())) {
+        return nullptr;
+    }
+
+    auto addRec = llvm::dyn_cast<llvm::SCEVAddRecExpr>(mSE->getSCEV(value));
+    if (addRec == nullptr || addRec->getLoop() != loop || !addRec->isAffine()) {
+        return nullptr;
+    }
+
+    return addRec->evaluateAtIteration(iteration, *mSE);
+}
+
+bool LoopAccelerationPass::accelerate(llvm::Loop* loop)
+{
+    if (!loop->getSubLoops().empty()) {
+        return false;
+    }
+
+    llvm::BasicBlock* preheader = loop->getLoopPreheader();
+    llvm::BasicBlock* exiting = loop->getExitingBlock();
+    llvm::BasicBlock* exit = loop->getUniqueExitBlock();
+    llvm::BasicBlock* latch = loop->getLoopLatch();
+
+    if (preheader == nullptr || exiting == nullptr || exit == nullptr || latch == nullptr
+        || !mDT->dominates(exiting, latch)
+    ) {
+        return false;
+    }
+
+    const llvm::SCEV* backedgeCount = mSE->getBackedgeTakenCount(loop);
+    if (llvm::isa<llvm::SCEVCouldNotCompute>(backedgeCount)) {
+        return false;
+    }
+
+    llvm::SmallVector<llvm::StoreInst*, 4> beforeExit;
+    llvm::SmallVector<llvm::StoreInst*, 4> afterExit;
+    if (!this->collectStores(loop, beforeExit, afterExit)) {
+        return false;
+    }
+
+    // Compute the values leaving the loop.
+    llvm::SmallVector<std::pair<llvm::PHINode*, const llvm::SCEV*>, 4> exitValues;
+    for (llvm::PHINode& phi : exit->phis()) {
+        llvm::Value* incoming = phi.getIncomingValueForBlock(exiting);
+        if (loop->isLoopInvariant(incoming)) {
+            continue;
+        }
+
+        if (!mSE->isSCEVable(phi.getType())) {
+            return false;
+        }
+
+        const llvm::SCEV* exitValue = mSE->getSCEVAtScope(incoming, loop->getParentLoop());
+        if (llvm::isa<llvm::SCEVCouldNotCompute>(exitValue)
+            || !mSE->isLoopInvariant(exitValue, loop)
+            || !llvm::isSafeToExpand(exitValue, *mSE)
+        ) {
+            return false;
+        }
+
+        exitValues.emplace_back(&phi, exitValue);
+    }
+
+    // The stores are emitted for each iteration, thus the trip count must be a known constant.
+    uint64_t numIterations = 0;
+    bool hasStores = !beforeExit.empty() || !afterExit.empty();
+    if (hasStores) {
+        auto constant = llvm::dyn_cast<llvm::SCEVConstant>(backedgeCount);
+        if (constant == nullptr || constant->getAPInt().getActiveBits() > 32) {
+            return false;
+        }
+
+        numIterations = constant->getAPInt().getZExtValue();
+        uint64_t numStores = (numIterations + 1) * beforeExit.size() + numIterations * afterExit.size();
+        if (numStores > mMaxStores) {
+            return false;
+        }
+
+        // Check that all stores can be summarized before changing anything.
+        const llvm::SCEV* zero = mSE->getZero(constant->getType());
+        for (llvm::StoreInst* store : llvm::concat<llvm::StoreInst*>(beforeExit, afterExit)) {
+            const llvm::SCEV* pointer = this->getValueAtIteration(loop, store->getPointerOperand(), zero);
+            if (pointer == nullptr || !llvm::isSafeToExpand(pointer, *mSE)) {
+                return false;
+            }
+
+            llvm::Value* value = store->getValueOperand();
+            if (!loop->isLoopInvariant(value) && this->getValueAtIteration(loop, value, zero) == nullptr) {
+                return false;
+            }
+        }
+    }
+
+    LLVM_DEBUG(llvm::dbgs() << "Accelerating loop " << loop->getHeader()->getName()
+        << " with backedge-taken count " << *backedgeCount << "\n");
+
+    const llvm::DataLayout& dl = preheader->getModule()->getDataLayout();
+    llvm::SCEVExpander expander(*mSE, dl, "accel");
+    llvm::Instruction* insertPt = preheader->getTerminator();
+
+    auto emitStore = [&](llvm::StoreInst* store, uint64_t iteration) {
+        const llvm::SCEV* k = mSE->getConstant(backedgeCount->getType(), iteration);
+
+        llvm::Value* pointer = store->getPointerOperand();
+        pointer = expander.expandCodeFor(
+            this->getValueAtIteration(loop, pointer, k), pointer->getType(), insertPt);
+
+        llvm::Value* value = store->getValueOperand();
+        if (!loop->isLoopInvariant(value)) {
+            value = expander.expandCodeFor(
+                this->getValueAtIteration(loop, value, k), value->getType(), insertPt);
+        }
+
+        auto clone = llvm::cast<llvm::StoreInst>(store->clone());
+        clone->setOperand(0, value);
+        clone->setOperand(1, pointer);
+        clone->insertBefore(insertPt);
+    };
+
+    for (uint64_t i = 0; hasStores && i <= numIterations; ++i) {
+        for (llvm::StoreInst* store : beforeExit) {
+            emitStore(store, i);
+        }
+
+        if (i < numIterations) {
+            for (llvm::StoreInst* store : afterExit) {
+                emitStore(store, i);
+            }
+        }
+    }
+
+    for (auto& [phi, exitValue] : exitValues) {
+        llvm::Value* value = expander.expandCodeFor(exitValue, phi->getType(), insertPt);
+        for (unsigned i = 0; i < phi->getNumIncomingValues(); ++i) {
+            phi->setIncomingValue(i, value);
+        }
+    }
+
+    mSE->forgetLoop(loop);
+    llvm::deleteDeadLoop(loop, mDT, mSE, mLI);
+
+    return true;
+}
+
+llvm::Pass* gazer::createLoopAccelerationPass(unsigned maxStores)
+{
+    return new LoopAccelerationPass(maxStores);
+}
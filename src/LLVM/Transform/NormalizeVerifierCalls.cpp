@@ -47,6 +47,10 @@ public:
     bool runOnModule(llvm::Module& module) override;
     void runOnFunction(llvm::Function& function);
 
+    llvm::StringRef getPassName() const override {
+        return "Normalize verifier calls";
+    }
+
 private:
     llvm::FunctionCallee mAssume;
     llvm::FunctionCallee mError;
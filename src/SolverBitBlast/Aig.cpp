@@ -0,0 +1,208 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "Aig.h"
+
+#include <algorithm>
+
+using namespace gazer::bitblast;
+
+AigManager::AigManager()
+{
+    // Node zero is the constant false node.
+    mNodes.push_back({AigFalse, AigFalse});
+}
+
+AigLit AigManager::createInput()
+{
+    unsigned idx = mNodes.size();
+    mNodes.push_back({InputMarker, InputMarker});
+    ++mNumInputs;
+
+    return idx << 1;
+}
+
+AigLit AigManager::createAnd(AigLit lhs, AigLit rhs)
+{
+    if (lhs > rhs) {
+        std::swap(lhs, rhs);
+    }
+
+    bool simplified = false;
+    AigLit result = this->simplifyAnd(lhs, rhs, simplified);
+    if (simplified) {
+        ++mNumRewrites;
+        return result;
+    }
+
+    return this->lookupOrCreateAnd(lhs, rhs);
+}
+
+AigLit AigManager::lookupOrCreateAnd(AigLit lhs, AigLit rhs)
+{
+    uint64_t key = (static_cast<uint64_t>(lhs) << 32) | rhs;
+    auto it = mStrash.find(key);
+    if (it != mStrash.end()) {
+        ++mNumHashHits;
+        return it->second << 1;
+    }
+
+    unsigned idx = mNodes.size();
+    mNodes.push_back({lhs, rhs});
+    mStrash[key] = idx;
+
+    return idx << 1;
+}
+
+AigLit AigManager::simplifyAnd(AigLit a, AigLit b, bool& simplified)
+{
+    simplified = true;
+
+    // One-level rules. As the operands are ordered, a constant is always
+    // the first operand.
+    if (a == AigFalse) { return AigFalse; }
+    if (a == AigTrue) { return b; }
+    if (a == b) { return a; }
+    if (a == aigNot(b)) { return AigFalse; }
+
+    bool aIsAnd = this->isAnd(aigNode(a));
+    bool bIsAnd = this->isAnd(aigNode(b));
+
+    // Asymmetric two-level rules, where only one side is inspected.
+    auto asymmetric = [this](AigLit x, AigLit y, bool& found) -> AigLit {
+        found = true;
+        AigLit y0 = mNodes[aigNode(y)].fanin0;
+        AigLit y1 = mNodes[aigNode(y)].fanin1;
+
+        if (!aigIsNegated(y)) {
+            // Contradiction: x & (!x & z) = false
+            if (x == aigNot(y0) || x == aigNot(y1)) { return AigFalse; }
+            // Idempotence: x & (x & z) = x & z
+            if (x == y0 || x == y1) { return y; }
+        } else {
+            // Subsumption: x & !(!x & z) = x
+            if (x == aigNot(y0) || x == aigNot(y1)) { return x; }
+            // Substitution: x & !(x & z) = x & !z
+            if (x == y0) { return this->createAnd(x, aigNot(y1)); }
+            if (x == y1) { return this->createAnd(x, aigNot(y0)); }
+        }
+
+        found = false;
+        return AigFalse;
+    };
+
+    bool found;
+    if (bIsAnd) {
+        AigLit result = asymmetric(a, b, found);
+        if (found) { return result; }
+    }
+
+    if (aIsAnd) {
+        AigLit result = asymmetric(b, a, found);
+        if (found) { return result; }
+    }
+
+    // Symmetric two-level rules.
+    if (aIsAnd && bIsAnd) {
+        AigLit a0 = mNodes[aigNode(a)].fanin0;
+        AigLit a1 = mNodes[aigNode(a)].fanin1;
+        AigLit b0 = mNodes[aigNode(b)].fanin0;
+        AigLit b1 = mNodes[aigNode(b)].fanin1;
+
+        bool aNeg = aigIsNegated(a);
+        bool bNeg = aigIsNegated(b);
+
+        if (!aNeg && !bNeg) {
+            // Contradiction: (x & y) & (!x & z) = false
+            if (a0 == aigNot(b0) || a0 == aigNot(b1) || a1 == aigNot(b0) || a1 == aigNot(b1)) {
+                return AigFalse;
+            }
+        } else if (aNeg != bNeg) {
+            // Subsumption: !(x & y) & (!x & z) = !x & z
+            AigLit n0 = aNeg ? a0 : b0;
+            AigLit n1 = aNeg ? a1 : b1;
+            AigLit p = aNeg ? b : a;
+            AigLit p0 = aNeg ? b0 : a0;
+            AigLit p1 = aNeg ? b1 : a1;
+            if (n0 == aigNot(p0) || n0 == aigNot(p1) || n1 == aigNot(p0) || n1 == aigNot(p1)) {
+                return p;
+            }
+        } else {
+            // Resolution: !(x & y) & !(x & !y) = !x
+            if ((a0 == b0 && a1 == aigNot(b1)) || (a0 == b1 && a1 == aigNot(b0))) {
+                return aigNot(a0);
+            }
+            if ((a1 == b1 && a0 == aigNot(b0)) || (a1 == b0 && a0 == aigNot(b1))) {
+                return aigNot(a1);
+            }
+        }
+    }
+
+    simplified = false;
+    return AigFalse;
+}
+
+AigLit AigManager::createXor(AigLit lhs, AigLit rhs)
+{
+    if (aigIsConst(lhs)) {
+        return lhs == AigFalse ? rhs : aigNot(rhs);
+    }
+    if (aigIsConst(rhs)) {
+        return rhs == AigFalse ? lhs : aigNot(lhs);
+    }
+    if (lhs == rhs) {
+        return AigFalse;
+    }
+    if (lhs == aigNot(rhs)) {
+        return AigTrue;
+    }
+
+    return this->createOr(
+        this->createAnd(lhs, aigNot(rhs)),
+        this->createAnd(aigNot(lhs), rhs)
+    );
+}
+
+AigLit AigManager::createIte(AigLit cond, AigLit then, AigLit elze)
+{
+    if (cond == AigTrue || then == elze) {
+        return then;
+    }
+    if (cond == AigFalse) {
+        return elze;
+    }
+    if (then == aigNot(elze)) {
+        return this->createIff(cond, then);
+    }
+    if (then == AigTrue || cond == then) {
+        return this->createOr(cond, elze);
+    }
+    if (then == AigFalse || cond == aigNot(then)) {
+        return this->createAnd(aigNot(cond), elze);
+    }
+    if (elze == AigFalse || cond == elze) {
+        return this->createAnd(cond, then);
+    }
+    if (elze == AigTrue || cond == aigNot(elze)) {
+        return this->createOr(aigNot(cond), then);
+    }
+
+    return this->createOr(
+        this->createAnd(cond, then),
+        this->createAnd(aigNot(cond), elze)
+    );
+}
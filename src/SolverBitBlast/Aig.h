@@ -0,0 +1,111 @@
+//==- Aig.h - And-inverter graphs -------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file This file defines a structurally hashed and-inverter graph (AIG),
+/// which serves as the intermediate representation between bit-blasted
+/// expressions and CNF.
+///
+/// Each AND node is simplified upon creation using constant propagation and
+/// the two-level local rewriting rules described by Brummayer and Biere in
+/// "Local Two-Level And-Inverter Graph Minimization without Blowup".
+///
+//===----------------------------------------------------------------------===//
+#ifndef GAZER_SRC_SOLVERBITBLAST_AIG_H
+#define GAZER_SRC_SOLVERBITBLAST_AIG_H
+
+#include <llvm/ADT/DenseMap.h>
+
+#include <vector>
+
+namespace gazer::bitblast
+{
+
+/// An AIG literal is represented as (node << 1) | sign, where a set sign bit
+/// denotes negation. Node zero is the constant false node.
+using AigLit = unsigned;
+
+constexpr AigLit AigFalse = 0;
+constexpr AigLit AigTrue = 1;
+
+inline unsigned aigNode(AigLit lit) { return lit >> 1; }
+inline bool aigIsNegated(AigLit lit) { return (lit & 1u) != 0; }
+inline AigLit aigNot(AigLit lit) { return lit ^ 1u; }
+inline AigLit aigRegular(AigLit lit) { return lit & ~1u; }
+inline bool aigIsConst(AigLit lit) { return aigNode(lit) == 0; }
+
+class AigManager
+{
+    struct Node
+    {
+        AigLit fanin0;
+        AigLit fanin1;
+    };
+
+    static constexpr AigLit InputMarker = ~0u;
+public:
+    AigManager();
+
+    AigManager(const AigManager&) = delete;
+    AigManager& operator=(const AigManager&) = delete;
+
+    /// Creates a new, unconstrained input node.
+    AigLit createInput();
+
+    AigLit createAnd(AigLit lhs, AigLit rhs);
+    AigLit createOr(AigLit lhs, AigLit rhs) {
+        return aigNot(createAnd(aigNot(lhs), aigNot(rhs)));
+    }
+    AigLit createImply(AigLit lhs, AigLit rhs) {
+        return createOr(aigNot(lhs), rhs);
+    }
+    AigLit createXor(AigLit lhs, AigLit rhs);
+    AigLit createIff(AigLit lhs, AigLit rhs) {
+        return aigNot(createXor(lhs, rhs));
+    }
+    AigLit createIte(AigLit cond, AigLit then, AigLit elze);
+
+    bool isInput(unsigned node) const { return node != 0 && mNodes[node].fanin0 == InputMarker; }
+    bool isAnd(unsigned node) const { return node != 0 && mNodes[node].fanin0 != InputMarker; }
+
+    AigLit getFanin0(unsigned node) const { assert(isAnd(node)); return mNodes[node].fanin0; }
+    AigLit getFanin1(unsigned node) const { assert(isAnd(node)); return mNodes[node].fanin1; }
+
+    size_t getNumNodes() const { return mNodes.size(); }
+    size_t getNumAnds() const { return mNodes.size() - mNumInputs - 1; }
+    size_t getNumInputs() const { return mNumInputs; }
+
+    /// Returns the number of AND nodes which were simplified away or found
+    /// in the structural hash table instead of being created.
+    size_t getNumRewrites() const { return mNumRewrites; }
+    size_t getNumHashHits() const { return mNumHashHits; }
+
+private:
+    AigLit simplifyAnd(AigLit lhs, AigLit rhs, bool& simplified);
+    AigLit lookupOrCreateAnd(AigLit lhs, AigLit rhs);
+
+private:
+    std::vector<Node> mNodes;
+    llvm::DenseMap<uint64_t, unsigned> mStrash;
+    size_t mNumInputs = 0;
+    size_t mNumRewrites = 0;
+    size_t mNumHashHits = 0;
+};
+
+} // end namespace gazer::bitblast
+
+#endif
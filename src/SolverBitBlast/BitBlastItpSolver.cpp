@@ -0,0 +1,519 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "BitBlastSolverImpl.h"
+
+#include "gazer/Core/ExprTypes.h"
+#include "gazer/Core/LiteralExpr.h"
+#include "gazer/Core/Solver/Model.h"
+
+#include <llvm/ADT/SmallPtrSet.h>
+#include <llvm/Support/raw_ostream.h>
+
+using namespace gazer;
+using namespace gazer::bitblast;
+
+static constexpr SatVar UndefSatVar = ~0u;
+
+namespace
+{
+
+enum ConeMask : uint8_t
+{
+    ConeA = 1,
+    ConeB = 2
+};
+
+/// Computes McMillan's partial interpolants for each derived clause.
+/// Resolving on a variable local to A yields the disjunction of the partial
+/// interpolants, resolving on any other variable yields their conjunction.
+class McMillanTracer : public SatProofTracer
+{
+public:
+    McMillanTracer(AigManager& aig, const std::vector<bool>& localToA)
+        : mAig(aig), mLocalToA(localToA)
+    {}
+
+    unsigned resolve(unsigned lhs, unsigned rhs, SatVar pivot) override
+    {
+        if (mLocalToA[pivot]) {
+            return mAig.createOr(lhs, rhs);
+        }
+
+        return mAig.createAnd(lhs, rhs);
+    }
+
+private:
+    AigManager& mAig;
+    const std::vector<bool>& mLocalToA;
+};
+
+} // end anonymous namespace
+
+/// Marks the nodes in the cone of influence of \p roots with \p mask.
+static void markCone(
+    const AigManager& aig, llvm::ArrayRef<AigLit> roots, std::vector<uint8_t>& marks, uint8_t mask)
+{
+    llvm::SmallVector<unsigned, 32> worklist;
+    for (AigLit root : roots) {
+        worklist.push_back(aigNode(root));
+    }
+
+    while (!worklist.empty()) {
+        unsigned node = worklist.pop_back_val();
+        if (node == 0 || (marks[node] & mask) != 0) {
+            continue;
+        }
+
+        marks[node] |= mask;
+        if (aig.isAnd(node)) {
+            worklist.push_back(aigNode(aig.getFanin0(node)));
+            worklist.push_back(aigNode(aig.getFanin1(node)));
+        }
+    }
+}
+
+/// Inserts the variables referenced by \p expr into \p vars.
+static void collectVariables(const ExprPtr& expr, llvm::DenseSet<Variable*>& vars)
+{
+    llvm::SmallPtrSet<Expr*, 32> visited;
+    llvm::SmallVector<Expr*, 32> worklist;
+    worklist.push_back(expr.get());
+
+    while (!worklist.empty()) {
+        Expr* current = worklist.pop_back_val();
+        if (!visited.insert(current).second) {
+            continue;
+        }
+
+        if (auto varRef = llvm::dyn_cast<VarRefExpr>(current)) {
+            vars.insert(&varRef->getVariable());
+        } else if (auto nonNullary = llvm::dyn_cast<NonNullaryExpr>(current)) {
+            for (const ExprPtr& op : nonNullary->operands()) {
+                worklist.push_back(op.get());
+            }
+        }
+    }
+}
+
+static SatLit toSatLit(const std::vector<SatVar>& satVars, AigLit lit)
+{
+    assert(satVars[aigNode(lit)] != UndefSatVar && "Node is not part of the encoded cone!");
+    return mkSatLit(satVars[aigNode(lit)], aigIsNegated(lit));
+}
+
+BitBlastItpSolver::BitBlastItpSolver(GazerContext& context)
+    : ItpSolver(context)
+{
+    this->reset();
+}
+
+void BitBlastItpSolver::reset()
+{
+    mAig = std::make_unique<AigManager>();
+    mBlaster = std::make_unique<BitBlaster>(*mAig);
+    mAssertions.clear();
+    mLemmas.clear();
+    mNumScopes = 0;
+    mSat.reset();
+    mSatVars.clear();
+    mStatus = SolverStatus::UNKNOWN;
+}
+
+void BitBlastItpSolver::addConstraint(ExprPtr expr)
+{
+    // Constraints outside of any interpolation group always belong to B.
+    this->addConstraint(0, expr);
+}
+
+void BitBlastItpSolver::addConstraint(ItpGroup group, ExprPtr expr)
+{
+    AigLit root = mBlaster->blastBool(expr);
+    mBlaster->takeLemmas(mLemmas);
+    mAssertions.push_back({expr, root, group, mNumScopes});
+}
+
+void BitBlastItpSolver::push()
+{
+    ++mNumScopes;
+}
+
+void BitBlastItpSolver::pop()
+{
+    assert(mNumScopes != 0 && "Cannot pop the root scope!");
+    --mNumScopes;
+
+    while (!mAssertions.empty() && mAssertions.back().scope > mNumScopes) {
+        mAssertions.pop_back();
+    }
+}
+
+Solver::SolverStatus BitBlastItpSolver::run()
+{
+    std::vector<AigLit> roots;
+    for (const BitBlaster::ArrayLemma& lemma : mLemmas) {
+        roots.push_back(lemma.root);
+    }
+    for (const Assertion& assertion : mAssertions) {
+        roots.push_back(assertion.root);
+    }
+
+    std::vector<uint8_t> marks(mAig->getNumNodes(), 0);
+    markCone(*mAig, roots, marks, ConeA);
+
+    mSat = std::make_unique<SatSolver>();
+    mSatVars.assign(mAig->getNumNodes(), UndefSatVar);
+    for (unsigned node = 1; node < marks.size(); ++node) {
+        if (marks[node] != 0) {
+            mSatVars[node] = mSat->newVar();
+        }
+    }
+
+    for (unsigned node = 1; node < marks.size(); ++node) {
+        if (marks[node] == 0 || !mAig->isAnd(node)) {
+            continue;
+        }
+
+        SatLit out = mkSatLit(mSatVars[node]);
+        SatLit a = toSatLit(mSatVars, mAig->getFanin0(node));
+        SatLit b = toSatLit(mSatVars, mAig->getFanin1(node));
+
+        mSat->addClause({ satLitNeg(out), a });
+        mSat->addClause({ satLitNeg(out), b });
+        mSat->addClause({ out, satLitNeg(a), satLitNeg(b) });
+    }
+
+    for (AigLit root : roots) {
+        if (root == AigFalse) {
+            mSat->addClause({});
+        } else if (root != AigTrue) {
+            mSat->addClause({ toSatLit(mSatVars, root) });
+        }
+    }
+
+    switch (mSat->solve()) {
+        case SatSolver::Sat:
+            mStatus = this->hasUnsupported() ? SolverStatus::UNKNOWN : SolverStatus::SAT;
+            break;
+        case SatSolver::Unsat:
+            mStatus = SolverStatus::UNSAT;
+            break;
+        case SatSolver::Unknown:
+            mStatus = SolverStatus::UNKNOWN;
+            break;
+    }
+
+    return mStatus;
+}
+
+std::unique_ptr<Model> BitBlastItpSolver::getModel()
+{
+    assert(mSat != nullptr && "Cannot get a model before calling run()!");
+
+    return createBitBlastModel(*mBlaster, [this](AigLit lit) {
+        if (aigIsConst(lit)) {
+            return lit == AigTrue;
+        }
+
+        unsigned node = aigNode(lit);
+        bool value = false;
+        if (node < mSatVars.size() && mSatVars[node] != UndefSatVar) {
+            value = mSat->getModelValue(mSatVars[node]) == LBool::True;
+        }
+
+        return value != aigIsNegated(lit);
+    });
+}
+
+ExprPtr BitBlastItpSolver::getInterpolant(ItpGroup group)
+{
+    assert(mStatus == SolverStatus::UNSAT && "Interpolants require an unsatisfiable formula!");
+    ++mNumInterpolants;
+
+    std::vector<AigLit> rootsA;
+    std::vector<AigLit> rootsB;
+    llvm::DenseSet<Variable*> varsA;
+    llvm::DenseSet<Variable*> varsB;
+    for (const Assertion& assertion : mAssertions) {
+        bool inA = assertion.group == group;
+        (inA ? rootsA : rootsB).push_back(assertion.root);
+        collectVariables(assertion.expr, inA ? varsA : varsB);
+    }
+
+    // A congruence lemma relating reads local to A must not be put into B,
+    // otherwise these reads (and their indices) would become shared.
+    // Lemmas mixing the reads of both sides and extensionality lemmas are
+    // put into B, interpolants depending on the A-local terms of these are
+    // rejected by aigToExpr.
+    for (const BitBlaster::ArrayLemma& lemma : mLemmas) {
+        bool overA = isReadOver(lemma.base, lemma.lhsIndex, varsA)
+            && isReadOver(lemma.base, lemma.rhsIndex, varsA);
+        bool overB = isReadOver(lemma.base, lemma.lhsIndex, varsB)
+            && isReadOver(lemma.base, lemma.rhsIndex, varsB);
+
+        (overA && !overB ? rootsA : rootsB).push_back(lemma.root);
+    }
+
+    llvm::DenseSet<Variable*> shared;
+    for (Variable* variable : varsA) {
+        if (varsB.count(variable) != 0) {
+            shared.insert(variable);
+        }
+    }
+
+    // Definitions of nodes in the cone of B are put into B, the rest of the
+    // definitions are put into A. The partition only decides which
+    // variables are local to A, it does not affect the soundness of the
+    // interpolant.
+    size_t numNodes = mAig->getNumNodes();
+    std::vector<uint8_t> marks(numNodes, 0);
+    markCone(*mAig, rootsA, marks, ConeA);
+    markCone(*mAig, rootsB, marks, ConeB);
+
+    std::vector<SatVar> satVars(numNodes, UndefSatVar);
+    std::vector<AigLit> varToAig;
+    std::vector<uint8_t> occurrences;
+    for (unsigned node = 1; node < numNodes; ++node) {
+        if (marks[node] != 0) {
+            satVars[node] = varToAig.size();
+            varToAig.push_back(node << 1);
+            occurrences.push_back(0);
+        }
+    }
+
+    auto occurs = [&](AigLit lit, uint8_t mask) {
+        if (!aigIsConst(lit)) {
+            occurrences[satVars[aigNode(lit)]] |= mask;
+        }
+    };
+
+    for (unsigned node = 1; node < numNodes; ++node) {
+        if (marks[node] != 0 && mAig->isAnd(node)) {
+            uint8_t side = (marks[node] & ConeB) != 0 ? ConeB : ConeA;
+            occurs(node << 1, side);
+            occurs(mAig->getFanin0(node), side);
+            occurs(mAig->getFanin1(node), side);
+        }
+    }
+    for (AigLit root : rootsA) { occurs(root, ConeA); }
+    for (AigLit root : rootsB) { occurs(root, ConeB); }
+
+    std::vector<bool> localToA(varToAig.size());
+    for (size_t v = 0; v < varToAig.size(); ++v) {
+        localToA[v] = occurrences[v] == ConeA;
+    }
+
+    McMillanTracer tracer(*mAig, localToA);
+    SatSolver sat;
+    sat.setProofTracer(&tracer);
+    for (size_t v = 0; v < varToAig.size(); ++v) {
+        sat.newVar();
+    }
+
+    // The partial interpolant of an A clause is the disjunction of its
+    // shared literals, while B clauses are labeled with true.
+    auto addClause = [&](llvm::ArrayRef<AigLit> lits, uint8_t side) {
+        llvm::SmallVector<SatLit, 3> clause;
+        AigLit label = side == ConeA ? AigFalse : AigTrue;
+        for (AigLit lit : lits) {
+            if (lit == AigFalse) {
+                continue;
+            }
+
+            SatLit satLit = toSatLit(satVars, lit);
+            clause.push_back(satLit);
+            if (side == ConeA && occurrences[satLitVar(satLit)] == (ConeA | ConeB)) {
+                label = mAig->createOr(label, lit);
+            }
+        }
+
+        sat.addClause(clause, label);
+    };
+
+    for (unsigned node = 1; node < numNodes; ++node) {
+        if (marks[node] == 0 || !mAig->isAnd(node)) {
+            continue;
+        }
+
+        uint8_t side = (marks[node] & ConeB) != 0 ? ConeB : ConeA;
+        AigLit out = node << 1;
+        AigLit a = mAig->getFanin0(node);
+        AigLit b = mAig->getFanin1(node);
+
+        addClause({ aigNot(out), a }, side);
+        addClause({ aigNot(out), b }, side);
+        addClause({ out, aigNot(a), aigNot(b) }, side);
+    }
+
+    for (AigLit root : rootsA) {
+        if (root != AigTrue) { addClause({ root }, ConeA); }
+    }
+    for (AigLit root : rootsB) {
+        if (root != AigTrue) { addClause({ root }, ConeB); }
+    }
+
+    if (sat.solve() != SatSolver::Unsat) {
+        // The formula was unsatisfiable, thus this may only happen if
+        // the solver gave up.
+        return nullptr;
+    }
+
+    return this->aigToExpr(sat.getFinalLabel(), shared);
+}
+
+bool BitBlastItpSolver::hasUnsupported() const
+{
+    return llvm::any_of(mAssertions, [this](const Assertion& assertion) {
+        return mBlaster->isUnsupported(assertion.expr);
+    });
+}
+
+bool BitBlastItpSolver::isReadOver(
+    unsigned base, unsigned index, const llvm::DenseSet<Variable*>& vars) const
+{
+    if (base == BitBlaster::ArrayLemma::NoBase) {
+        return false;
+    }
+
+    Variable* variable = mBlaster->getArrayBase(base).variable;
+    ExprPtr indexExpr = mBlaster->getExprForBits(index);
+    if (variable == nullptr || indexExpr == nullptr || vars.count(variable) == 0) {
+        return false;
+    }
+
+    llvm::DenseSet<Variable*> indexVars;
+    collectVariables(indexExpr, indexVars);
+
+    return llvm::all_of(indexVars, [&vars](Variable* v) { return vars.count(v) != 0; });
+}
+
+void BitBlastItpSolver::collectInputExprs(
+    llvm::DenseMap<unsigned, ExprPtr>& inputs, const llvm::DenseSet<Variable*>& shared)
+{
+    auto addBits = [&](const ExprPtr& expr, const Bits& bits) {
+        auto bvTy = llvm::dyn_cast<BvType>(&expr->getType());
+        for (size_t i = 0; i < bits.size(); ++i) {
+            if (aigIsNegated(bits[i]) || !mAig->isInput(aigNode(bits[i]))) {
+                continue;
+            }
+
+            ExprPtr bit = expr;
+            if (bvTy != nullptr) {
+                bit = EqExpr::Create(
+                    ExtractExpr::Create(expr, i, 1),
+                    BvLiteralExpr::Get(BvType::Get(mContext, 1), 1)
+                );
+            }
+
+            inputs.try_emplace(aigNode(bits[i]), bit);
+        }
+    };
+
+    // Only terms over shared variables may appear in the interpolant.
+    for (auto& [variable, id] : mBlaster->getVariables()) {
+        if (shared.count(variable) == 0) {
+            continue;
+        }
+
+        if (!variable->getType().isArrayType()) {
+            addBits(variable->getRefExpr(), mBlaster->getBits(id));
+            continue;
+        }
+
+        unsigned baseId = mBlaster->getArrayTerm(id).base;
+        for (const auto& read : mBlaster->getArrayBase(baseId).reads) {
+            if (this->isReadOver(baseId, read.index, shared)) {
+                ExprPtr index = mBlaster->getExprForBits(read.index);
+                addBits(ArrayReadExpr::Create(variable->getRefExpr(), index), mBlaster->getBits(read.value));
+            }
+        }
+    }
+}
+
+ExprPtr BitBlastItpSolver::aigToExpr(AigLit root, const llvm::DenseSet<Variable*>& shared)
+{
+    if (aigIsConst(root)) {
+        return BoolLiteralExpr::Get(mContext, root == AigTrue);
+    }
+
+    llvm::DenseMap<unsigned, ExprPtr> exprs;
+    this->collectInputExprs(exprs, shared);
+
+    auto toExpr = [&exprs](AigLit lit) -> ExprPtr {
+        ExprPtr expr = exprs.lookup(aigNode(lit));
+        return aigIsNegated(lit) ? NotExpr::Create(expr) : expr;
+    };
+
+    // Translate the cone of the root in post-order.
+    llvm::SmallVector<std::pair<unsigned, bool>, 32> stack;
+    stack.push_back({aigNode(root), false});
+
+    while (!stack.empty()) {
+        auto [node, expanded] = stack.pop_back_val();
+        if (exprs.count(node) != 0) {
+            continue;
+        }
+
+        if (mAig->isInput(node)) {
+            // The interpolant depends on an abstracted, internal or
+            // non-shared input.
+            return nullptr;
+        }
+
+        AigLit lhs = mAig->getFanin0(node);
+        AigLit rhs = mAig->getFanin1(node);
+
+        if (!expanded) {
+            stack.push_back({node, true});
+            stack.push_back({aigNode(lhs), false});
+            stack.push_back({aigNode(rhs), false});
+            continue;
+        }
+
+        exprs[node] = AndExpr::Create(toExpr(lhs), toExpr(rhs));
+    }
+
+    return toExpr(root);
+}
+
+void BitBlastItpSolver::printStats(llvm::raw_ostream& os)
+{
+    os << "(\n"
+       << "  :aig-inputs " << mAig->getNumInputs() << "\n"
+       << "  :aig-ands " << mAig->getNumAnds() << "\n"
+       << "  :interpolants " << mNumInterpolants << "\n";
+    if (mSat != nullptr) {
+        mSat->printStats(os);
+    }
+    os << ")\n";
+}
+
+void BitBlastItpSolver::dump(llvm::raw_ostream& os)
+{
+    for (const Assertion& assertion : mAssertions) {
+        os << "(assert ";
+        if (assertion.group != 0) {
+            os << "[group " << assertion.group << "] ";
+        }
+        os << *assertion.expr << ")\n";
+    }
+}
+
+std::unique_ptr<ItpSolver> BitBlastItpSolverFactory::createItpSolver(GazerContext& context)
+{
+    return std::unique_ptr<ItpSolver>(new BitBlastItpSolver(context));
+}
@@ -0,0 +1,387 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "BitBlastSolverImpl.h"
+
+#include "gazer/Core/LiteralExpr.h"
+#include "gazer/Core/Solver/Model.h"
+
+#include <llvm/Support/raw_ostream.h>
+
+using namespace gazer;
+using namespace gazer::bitblast;
+
+static constexpr SatVar UndefSatVar = ~0u;
+
+namespace
+{
+
+class BitBlastModel : public Model
+{
+    class Evaluator : public ExprEvaluatorBase
+    {
+    public:
+        explicit Evaluator(Valuation valuation)
+            : mValuation(std::move(valuation))
+        {}
+
+        Valuation& getValuation() { return mValuation; }
+
+    protected:
+        ExprRef<AtomicExpr> getVariableValue(Variable& variable) override
+        {
+            auto it = mValuation.find(&variable);
+            if (it != mValuation.end()) {
+                return it->second;
+            }
+
+            // Variables which do not appear in the formula may take any value.
+            Type& type = variable.getType();
+            if (type.isBoolType()) {
+                return BoolLiteralExpr::False(type.getContext());
+            }
+            if (auto bvTy = llvm::dyn_cast<BvType>(&type)) {
+                return BvLiteralExpr::Get(*bvTy, 0);
+            }
+
+            return UndefExpr::Get(type);
+        }
+
+    private:
+        Valuation mValuation;
+    };
+
+public:
+    explicit BitBlastModel(Valuation valuation)
+        : mEvaluator(std::move(valuation))
+    {}
+
+    ExprRef<AtomicExpr> evaluate(const ExprPtr& expr) override {
+        return mEvaluator.evaluate(expr);
+    }
+
+    void dump(llvm::raw_ostream& os) override {
+        mEvaluator.getValuation().print(os);
+    }
+
+private:
+    Evaluator mEvaluator;
+};
+
+} // end anonymous namespace
+
+BitBlastSolver::BitBlastSolver(GazerContext& context)
+    : Solver(context)
+{
+    this->reset();
+}
+
+void BitBlastSolver::reset()
+{
+    mSat = std::make_unique<SatSolver>();
+    mAig = std::make_unique<AigManager>();
+    mBlaster = std::make_unique<BitBlaster>(*mAig);
+    mSatVars.clear();
+    mScopes.clear();
+    mAssertions.clear();
+    mLemmaBuffer.clear();
+    mAssumptions.clear();
+    mUnsatCore.clear();
+}
+
+SatLit BitBlastSolver::encode(AigLit root)
+{
+    assert(!aigIsConst(root) && "Constants should be handled by the caller!");
+
+    if (mSatVars.size() < mAig->getNumNodes()) {
+        mSatVars.resize(mAig->getNumNodes(), UndefSatVar);
+    }
+
+    // Tseitin-encode the not yet encoded cone of the root, in post-order.
+    llvm::SmallVector<std::pair<unsigned, bool>, 32> stack;
+    stack.push_back({aigNode(root), false});
+
+    while (!stack.empty()) {
+        auto [node, expanded] = stack.pop_back_val();
+        if (mSatVars[node] != UndefSatVar) {
+            continue;
+        }
+
+        if (mAig->isInput(node)) {
+            mSatVars[node] = mSat->newVar();
+            continue;
+        }
+
+        AigLit lhs = mAig->getFanin0(node);
+        AigLit rhs = mAig->getFanin1(node);
+
+        if (!expanded) {
+            stack.push_back({node, true});
+            stack.push_back({aigNode(lhs), false});
+            stack.push_back({aigNode(rhs), false});
+            continue;
+        }
+
+        SatVar var = mSat->newVar();
+        mSatVars[node] = var;
+
+        SatLit out = mkSatLit(var);
+        SatLit a = mkSatLit(mSatVars[aigNode(lhs)], aigIsNegated(lhs));
+        SatLit b = mkSatLit(mSatVars[aigNode(rhs)], aigIsNegated(rhs));
+
+        mSat->addClause({ satLitNeg(out), a });
+        mSat->addClause({ satLitNeg(out), b });
+        mSat->addClause({ out, satLitNeg(a), satLitNeg(b) });
+    }
+
+    return mkSatLit(mSatVars[aigNode(root)], aigIsNegated(root));
+}
+
+void BitBlastSolver::assertLiteral(AigLit lit, bool global)
+{
+    if (lit == AigTrue) {
+        return;
+    }
+
+    llvm::SmallVector<SatLit, 2> clause;
+    if (lit != AigFalse) {
+        clause.push_back(this->encode(lit));
+    }
+
+    if (!global && !mScopes.empty()) {
+        clause.push_back(satLitNeg(mScopes.back()));
+    }
+
+    mSat->addClause(clause);
+}
+
+void BitBlastSolver::flushLemmas()
+{
+    // Array congruence lemmas are valid regardless of the current scope.
+    mBlaster->takeLemmas(mLemmaBuffer);
+    for (AigLit lemma : mLemmaBuffer) {
+        this->assertLiteral(lemma, true);
+    }
+    mLemmaBuffer.clear();
+}
+
+void BitBlastSolver::addConstraint(ExprPtr expr)
+{
+    AigLit root = mBlaster->blastBool(expr);
+    mAssertions.emplace_back(expr, mScopes.size());
+
+    this->flushLemmas();
+    this->assertLiteral(root, false);
+}
+
+void BitBlastSolver::push()
+{
+    mScopes.push_back(mkSatLit(mSat->newVar()));
+}
+
+void BitBlastSolver::pop()
+{
+    assert(!mScopes.empty() && "Cannot pop the root scope!");
+
+    // Permanently disable the constraints of this scope.
+    SatLit activation = mScopes.back();
+    mScopes.pop_back();
+    mSat->addClause({ satLitNeg(activation) });
+
+    while (!mAssertions.empty() && mAssertions.back().second > mScopes.size()) {
+        mAssertions.pop_back();
+    }
+}
+
+Solver::SolverStatus BitBlastSolver::run()
+{
+    mAssumptions.clear();
+    mUnsatCore.clear();
+    return this->solve(mScopes);
+}
+
+Solver::SolverStatus BitBlastSolver::runWithAssumptions(llvm::ArrayRef<ExprPtr> assumptions)
+{
+    mAssumptions.clear();
+    mUnsatCore.clear();
+
+    std::vector<SatLit> lits(mScopes.begin(), mScopes.end());
+    for (const ExprPtr& assumption : assumptions) {
+        assert(assumption->getType().isBoolType() && "Assumptions must be boolean!");
+        AigLit root = mBlaster->blastBool(assumption);
+        this->flushLemmas();
+
+        if (root == AigTrue) {
+            continue;
+        }
+        if (root == AigFalse) {
+            // The assumption alone is a conflict.
+            mUnsatCore.push_back(assumption);
+            return SolverStatus::UNSAT;
+        }
+
+        SatLit lit = this->encode(root);
+        mAssumptions.emplace_back(lit, assumption);
+        lits.push_back(lit);
+    }
+
+    SolverStatus status = this->solve(lits);
+    if (status == SolverStatus::UNSAT) {
+        // Scope activation literals are not part of the core.
+        for (SatLit failed : mSat->getFailedAssumptions()) {
+            for (auto& [lit, expr] : mAssumptions) {
+                if (lit == failed) {
+                    mUnsatCore.push_back(expr);
+                }
+            }
+        }
+    }
+
+    return status;
+}
+
+void BitBlastSolver::getUnsatCore(std::vector<ExprPtr>& core)
+{
+    core.insert(core.end(), mUnsatCore.begin(), mUnsatCore.end());
+}
+
+Solver::SolverStatus BitBlastSolver::solve(llvm::ArrayRef<SatLit> assumptions)
+{
+    switch (mSat->solve(assumptions)) {
+        case SatSolver::Sat:
+            // Unsupported sub-terms were replaced by unconstrained inputs,
+            // thus only unsatisfiable results are reliable.
+            return this->hasUnsupported() ? SolverStatus::UNKNOWN : SolverStatus::SAT;
+        case SatSolver::Unsat: return SolverStatus::UNSAT;
+        case SatSolver::Unknown: return SolverStatus::UNKNOWN;
+    }
+
+    llvm_unreachable("Unknown solver status encountered.");
+}
+
+bool BitBlastSolver::hasUnsupported() const
+{
+    // Popped assertions are no longer part of the query, even if their
+    // over-approximated terms are still cached by the bit-blaster.
+    auto isUnsupported = [this](const ExprPtr& expr) { return mBlaster->isUnsupported(expr); };
+
+    return llvm::any_of(mAssertions, [&](auto& assertion) { return isUnsupported(assertion.first); })
+        || llvm::any_of(mAssumptions, [&](auto& assumption) { return isUnsupported(assumption.second); });
+}
+
+bool BitBlastSolver::getBitValue(AigLit lit) const
+{
+    if (aigIsConst(lit)) {
+        return lit == AigTrue;
+    }
+
+    unsigned node = aigNode(lit);
+    bool value = false;
+    if (node < mSatVars.size() && mSatVars[node] != UndefSatVar) {
+        value = mSat->getModelValue(mSatVars[node]) == LBool::True;
+    }
+
+    return value != aigIsNegated(lit);
+}
+
+static llvm::APInt getBitsValue(const Bits& bits, llvm::function_ref<bool(AigLit)> getBitValue)
+{
+    llvm::APInt value(bits.size(), 0);
+    for (size_t i = 0; i < bits.size(); ++i) {
+        if (getBitValue(bits[i])) {
+            value.setBit(i);
+        }
+    }
+
+    return value;
+}
+
+static ExprRef<LiteralExpr> bitsToLiteral(Type& type, const llvm::APInt& value)
+{
+    if (type.isBoolType()) {
+        return BoolLiteralExpr::Get(type.getContext(), value.getBoolValue());
+    }
+
+    return BvLiteralExpr::Get(llvm::cast<BvType>(type), value);
+}
+
+std::unique_ptr<Model> gazer::bitblast::createBitBlastModel(
+    const BitBlaster& blaster, llvm::function_ref<bool(AigLit)> getBitValue)
+{
+    auto builder = Valuation::CreateBuilder();
+
+    for (auto& [variable, id] : blaster.getVariables()) {
+        Type& type = variable->getType();
+        if (auto arrTy = llvm::dyn_cast<ArrayType>(&type)) {
+            const auto& term = blaster.getArrayTerm(id);
+            const auto& base = blaster.getArrayBase(term.base);
+            if (base.indexWidth == 0 || base.elementWidth == 0) {
+                continue;
+            }
+
+            ArrayLiteralExpr::Builder arrayBuilder(*arrTy);
+            for (auto& read : base.reads) {
+                arrayBuilder.addValue(
+                    bitsToLiteral(arrTy->getIndexType(), getBitsValue(blaster.getBits(read.index), getBitValue)),
+                    bitsToLiteral(arrTy->getElementType(), getBitsValue(blaster.getBits(read.value), getBitValue))
+                );
+            }
+            arrayBuilder.setDefault(bitsToLiteral(
+                arrTy->getElementType(), llvm::APInt(base.elementWidth, 0)
+            ));
+
+            builder.put(variable, arrayBuilder.build());
+            continue;
+        }
+
+        builder.put(variable, bitsToLiteral(type, getBitsValue(blaster.getBits(id), getBitValue)));
+    }
+
+    return std::make_unique<BitBlastModel>(builder.build());
+}
+
+std::unique_ptr<Model> BitBlastSolver::getModel()
+{
+    return createBitBlastModel(*mBlaster, [this](AigLit lit) { return this->getBitValue(lit); });
+}
+
+void BitBlastSolver::printStats(llvm::raw_ostream& os)
+{
+    os << "(\n"
+       << "  :aig-inputs " << mAig->getNumInputs() << "\n"
+       << "  :aig-ands " << mAig->getNumAnds() << "\n"
+       << "  :aig-rewrites " << mAig->getNumRewrites() << "\n"
+       << "  :aig-strash-hits " << mAig->getNumHashHits() << "\n";
+    mSat->printStats(os);
+    os << ")\n";
+}
+
+void BitBlastSolver::dump(llvm::raw_ostream& os)
+{
+    for (auto& [expr, scope] : mAssertions) {
+        os << "(assert ";
+        if (scope != 0) {
+            os << "[scope " << scope << "] ";
+        }
+        os << *expr << ")\n";
+    }
+}
+
+std::unique_ptr<Solver> BitBlastSolverFactory::createSolver(GazerContext& context)
+{
+    return std::unique_ptr<Solver>(new BitBlastSolver(context));
+}
@@ -0,0 +1,384 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#ifndef GAZER_SRC_SOLVERBITBLAST_BITBLASTSOLVERIMPL_H
+#define GAZER_SRC_SOLVERBITBLAST_BITBLASTSOLVERIMPL_H
+
+#include "Aig.h"
+#include "SatSolver.h"
+
+#include "gazer/BitBlastSolver/BitBlastSolver.h"
+#include "gazer/Core/Expr/ExprWalker.h"
+
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/DenseSet.h>
+#include <llvm/ADT/STLExtras.h>
+
+#include <unordered_map>
+
+namespace gazer::bitblast
+{
+
+using Bits = std::vector<AigLit>;
+
+/// Lowers boolean and bit-vector expressions into an and-inverter graph.
+///
+/// Each visited expression is mapped to an identifier. For boolean and
+/// bit-vector expressions, the identifier points into the bit vector table,
+/// bits are stored in least significant bit first order. Array-typed
+/// expressions are mapped to array terms instead. Array reads are eliminated
+/// using read-over-write expansion, reads of base arrays are encoded as fresh
+/// inputs constrained by Ackermann congruence lemmas. Array equalities are
+/// mapped to fresh literals, which are related to the reads of both sides
+/// at every index read or written anywhere (extensionality). Lemmas are
+/// collected and must be asserted by the owner of the bit-blaster.
+///
+/// Expressions outside of the supported fragment (e.g. integers, reals or
+/// floating-point values) are over-approximated by fresh inputs. Expressions
+/// depending on these are reported through isUnsupported().
+class BitBlaster : public ExprWalker<BitBlaster, unsigned>
+{
+    friend class ExprWalker<BitBlaster, unsigned>;
+public:
+    struct ArrayTerm
+    {
+        enum Kind { Base, Const, Write, Ite };
+
+        Kind kind;
+        unsigned base = 0;      ///< Base array index or the inner array term.
+        unsigned other = 0;     ///< Else term for ite terms.
+        AigLit cond = AigFalse; ///< Condition of ite terms.
+        unsigned index = 0;     ///< Index bits of write terms.
+        unsigned value = 0;     ///< Value bits of writes and constant arrays.
+    };
+
+    struct ArrayRead
+    {
+        unsigned index;
+        unsigned value;
+    };
+
+    struct ArrayBase
+    {
+        Variable* variable;
+        unsigned indexWidth;
+        unsigned elementWidth;
+        std::vector<ArrayRead> reads;
+    };
+
+    /// An Ackermann congruence lemma between two reads of a base array.
+    /// Extensionality lemmas of array equalities have no base array.
+    struct ArrayLemma
+    {
+        static constexpr unsigned NoBase = ~0u;
+
+        AigLit root;
+        unsigned base;
+        unsigned lhsIndex;
+        unsigned rhsIndex;
+    };
+
+    struct ArrayEquality
+    {
+        AigLit lit;
+        unsigned lhs;
+        unsigned rhs;
+        unsigned indexWidth;
+        size_t numInstantiated;  ///< The number of array indices processed.
+    };
+
+public:
+    explicit BitBlaster(AigManager& aig)
+        : mAig(aig)
+    {}
+
+    /// Lowers a boolean expression into a single AIG literal.
+    AigLit blastBool(const ExprPtr& expr);
+
+    const Bits& getBits(unsigned id) const { return mBits[id]; }
+
+    /// Returns the first expression which was lowered into the bits
+    /// identified by \p id, or nullptr if the bits were created internally.
+    ExprPtr getExprForBits(unsigned id) const { return mBitsExprs.lookup(id); }
+
+    const ArrayBase& getArrayBase(unsigned id) const { return mArrayBases[id]; }
+    const ArrayTerm& getArrayTerm(unsigned id) const { return mArrayTerms[id]; }
+
+    /// Returns the bits of array reads and scalar variables, respectively
+    /// the base array identifiers of array variables.
+    const llvm::DenseMap<Variable*, unsigned>& getVariables() const { return mVariables; }
+
+    /// Moves all lemmas created since the last call into \p lemmas.
+    void takeLemmas(std::vector<AigLit>& lemmas)
+    {
+        for (const ArrayLemma& lemma : mLemmas) {
+            lemmas.push_back(lemma.root);
+        }
+        mLemmas.clear();
+    }
+
+    void takeLemmas(std::vector<ArrayLemma>& lemmas)
+    {
+        lemmas.insert(lemmas.end(), mLemmas.begin(), mLemmas.end());
+        mLemmas.clear();
+    }
+
+    /// Returns true if \p expr was over-approximated, as it depends on an
+    /// expression outside of the supported fragment.
+    bool isUnsupported(const ExprPtr& expr) const { return mUnsupported.count(expr.get()) != 0; }
+
+    /// Returns the width of a boolean or bit-vector type, zero otherwise.
+    static unsigned getWidth(Type& type);
+
+private:
+    bool shouldSkip(const ExprPtr& expr, unsigned* ret);
+    void handleResult(const ExprPtr& expr, unsigned& ret);
+
+    unsigned addBits(Bits bits);
+    unsigned addArrayTerm(ArrayTerm term);
+    unsigned createInputBits(unsigned width);
+    unsigned createBaseArray(Variable* variable, ArrayType& type);
+    unsigned unsupported(const ExprPtr& expr);
+    unsigned literalBits(const ExprRef<LiteralExpr>& expr);
+
+    const Bits& op(size_t i) const { return mBits[getOperand(i)]; }
+
+    // Array handling
+    unsigned readArray(unsigned term, unsigned index);
+    unsigned readBaseArray(unsigned base, unsigned index);
+    void addArrayIndex(unsigned index);
+    AigLit arrayEq(unsigned lhs, unsigned rhs, ArrayType& type);
+    void instantiateEqualities();
+
+    // Circuits
+    Bits add(const Bits& lhs, const Bits& rhs, AigLit carry = AigFalse);
+    Bits sub(const Bits& lhs, const Bits& rhs);
+    Bits neg(const Bits& bits);
+    Bits mul(const Bits& lhs, const Bits& rhs);
+    void udivrem(const Bits& lhs, const Bits& rhs, Bits& quot, Bits& rem);
+    Bits sdiv(const Bits& lhs, const Bits& rhs);
+    Bits srem(const Bits& lhs, const Bits& rhs);
+    Bits shift(const Bits& bits, const Bits& amount, bool left, bool arithmetic);
+    Bits ite(AigLit cond, const Bits& then, const Bits& elze);
+    Bits bitwise(const Bits& lhs, const Bits& rhs, AigLit (AigManager::*fn)(AigLit, AigLit));
+    AigLit eq(const Bits& lhs, const Bits& rhs);
+    AigLit ult(const Bits& lhs, const Bits& rhs);
+    AigLit slt(const Bits& lhs, const Bits& rhs);
+
+private:
+    // Fallback
+    unsigned visitExpr(const ExprPtr& expr) { return this->unsupported(expr); }
+
+    // Nullary
+    unsigned visitUndef(const ExprRef<UndefExpr>& expr);
+    unsigned visitVarRef(const ExprRef<VarRefExpr>& expr);
+    unsigned visitBoolLiteral(const ExprRef<BoolLiteralExpr>& expr);
+    unsigned visitBvLiteral(const ExprRef<BvLiteralExpr>& expr);
+    unsigned visitArrayLiteral(const ExprRef<ArrayLiteralExpr>& expr);
+
+    // Logic
+    unsigned visitNot(const ExprRef<NotExpr>& expr);
+    unsigned visitAnd(const ExprRef<AndExpr>& expr);
+    unsigned visitOr(const ExprRef<OrExpr>& expr);
+    unsigned visitImply(const ExprRef<ImplyExpr>& expr);
+
+    // Casts
+    unsigned visitZExt(const ExprRef<ZExtExpr>& expr);
+    unsigned visitSExt(const ExprRef<SExtExpr>& expr);
+    unsigned visitExtract(const ExprRef<ExtractExpr>& expr);
+    unsigned visitBvConcat(const ExprRef<BvConcatExpr>& expr);
+
+    // Arithmetic
+    unsigned visitAdd(const ExprRef<AddExpr>& expr);
+    unsigned visitSub(const ExprRef<SubExpr>& expr);
+    unsigned visitMul(const ExprRef<MulExpr>& expr);
+    unsigned visitBvSDiv(const ExprRef<BvSDivExpr>& expr);
+    unsigned visitBvUDiv(const ExprRef<BvUDivExpr>& expr);
+    unsigned visitBvSRem(const ExprRef<BvSRemExpr>& expr);
+    unsigned visitBvURem(const ExprRef<BvURemExpr>& expr);
+    unsigned visitShl(const ExprRef<ShlExpr>& expr);
+    unsigned visitLShr(const ExprRef<LShrExpr>& expr);
+    unsigned visitAShr(const ExprRef<AShrExpr>& expr);
+    unsigned visitBvAnd(const ExprRef<BvAndExpr>& expr);
+    unsigned visitBvOr(const ExprRef<BvOrExpr>& expr);
+    unsigned visitBvXor(const ExprRef<BvXorExpr>& expr);
+
+    // Compare
+    unsigned visitEq(const ExprRef<EqExpr>& expr);
+    unsigned visitNotEq(const ExprRef<NotEqExpr>& expr);
+    unsigned visitBvSLt(const ExprRef<BvSLtExpr>& expr);
+    unsigned visitBvSLtEq(const ExprRef<BvSLtEqExpr>& expr);
+    unsigned visitBvSGt(const ExprRef<BvSGtExpr>& expr);
+    unsigned visitBvSGtEq(const ExprRef<BvSGtEqExpr>& expr);
+    unsigned visitBvULt(const ExprRef<BvULtExpr>& expr);
+    unsigned visitBvULtEq(const ExprRef<BvULtEqExpr>& expr);
+    unsigned visitBvUGt(const ExprRef<BvUGtExpr>& expr);
+    unsigned visitBvUGtEq(const ExprRef<BvUGtEqExpr>& expr);
+
+    // Ternary
+    unsigned visitSelect(const ExprRef<SelectExpr>& expr);
+
+    // Arrays
+    unsigned visitArrayRead(const ExprRef<ArrayReadExpr>& expr);
+    unsigned visitArrayWrite(const ExprRef<ArrayWriteExpr>& expr);
+
+private:
+    AigManager& mAig;
+    std::vector<Bits> mBits;
+    std::vector<ArrayTerm> mArrayTerms;
+    std::vector<ArrayBase> mArrayBases;
+    std::unordered_map<ExprPtr, unsigned> mCache;
+    llvm::DenseMap<Variable*, unsigned> mVariables;
+    llvm::DenseMap<std::pair<unsigned, unsigned>, unsigned> mReadCache;
+    llvm::DenseMap<unsigned, ExprPtr> mBitsExprs;
+    std::vector<ArrayLemma> mLemmas;
+
+    // Extensionality
+    std::vector<ArrayEquality> mArrayEqualities;
+    std::vector<unsigned> mArrayIndices;
+    llvm::DenseSet<unsigned> mKnownArrayIndices;
+
+    /// Expressions depending on unsupported sub-expressions.
+    llvm::DenseSet<const Expr*> mUnsupported;
+    bool mVisitUnsupported = false;
+};
+
+/// A solver which bit-blasts its input into an embedded SAT solver.
+///
+/// Assertions made inside a push/pop scope are guarded by an activation
+/// literal of the scope. Popping a scope permanently disables its
+/// activation literal, while the bit-blasted definitions (and the learnt
+/// clauses over them) are kept for later queries.
+class BitBlastSolver : public Solver
+{
+public:
+    explicit BitBlastSolver(GazerContext& context);
+
+    void printStats(llvm::raw_ostream& os) override;
+    void dump(llvm::raw_ostream& os) override;
+    SolverStatus run() override;
+
+    bool supportsAssumptions() const override { return true; }
+    SolverStatus runWithAssumptions(llvm::ArrayRef<ExprPtr> assumptions) override;
+    void getUnsatCore(std::vector<ExprPtr>& core) override;
+
+    std::unique_ptr<Model> getModel() override;
+
+    void reset() override;
+
+    void push() override;
+    void pop() override;
+
+protected:
+    void addConstraint(ExprPtr expr) override;
+
+private:
+    SatLit encode(AigLit lit);
+    void assertLiteral(AigLit lit, bool global);
+    void flushLemmas();
+    SolverStatus solve(llvm::ArrayRef<SatLit> assumptions);
+    bool getBitValue(AigLit lit) const;
+    bool hasUnsupported() const;
+
+private:
+    std::unique_ptr<AigManager> mAig;
+    std::unique_ptr<BitBlaster> mBlaster;
+    std::unique_ptr<SatSolver> mSat;
+
+    /// Maps AIG nodes to SAT variables.
+    std::vector<SatVar> mSatVars;
+    std::vector<SatLit> mScopes;
+    std::vector<std::pair<ExprPtr, unsigned>> mAssertions;
+    std::vector<AigLit> mLemmaBuffer;
+
+    /// The SAT literals of the assumptions of the last check.
+    std::vector<std::pair<SatLit, ExprPtr>> mAssumptions;
+    std::vector<ExprPtr> mUnsatCore;
+};
+
+/// An interpolating solver over the bit-blasted encoding.
+///
+/// Satisfiability checks are performed on a fresh SAT instance built from
+/// the active assertions. Interpolants are computed from the resolution
+/// refutation of a second, traced SAT instance using McMillan's labeling
+/// system. Interpolation groups are formulas of the given group (A) against
+/// all other active formulas (B). Array congruence lemmas are put into A if
+/// both of their reads are over the variables of A only, and into B
+/// otherwise. The resulting and-inverter graph is translated back into an
+/// expression over the bits of the variables (and base array reads) shared
+/// by A and B. If the interpolant depends on any other input, no
+/// interpolant is returned.
+class BitBlastItpSolver : public ItpSolver
+{
+    struct Assertion
+    {
+        ExprPtr expr;
+        AigLit root;
+        ItpGroup group;
+        unsigned scope;
+    };
+
+public:
+    explicit BitBlastItpSolver(GazerContext& context);
+
+    void printStats(llvm::raw_ostream& os) override;
+    void dump(llvm::raw_ostream& os) override;
+    SolverStatus run() override;
+
+    std::unique_ptr<Model> getModel() override;
+
+    void reset() override;
+
+    void push() override;
+    void pop() override;
+
+    ExprPtr getInterpolant(ItpGroup group) override;
+
+protected:
+    void addConstraint(ExprPtr expr) override;
+    void addConstraint(ItpGroup group, ExprPtr expr) override;
+
+private:
+    bool hasUnsupported() const;
+    ExprPtr aigToExpr(AigLit lit, const llvm::DenseSet<Variable*>& shared);
+    void collectInputExprs(
+        llvm::DenseMap<unsigned, ExprPtr>& inputs, const llvm::DenseSet<Variable*>& shared);
+
+    /// Returns true if the read of \p base at \p index only mentions \p vars.
+    bool isReadOver(unsigned base, unsigned index, const llvm::DenseSet<Variable*>& vars) const;
+
+private:
+    std::unique_ptr<AigManager> mAig;
+    std::unique_ptr<BitBlaster> mBlaster;
+    std::vector<Assertion> mAssertions;
+    std::vector<BitBlaster::ArrayLemma> mLemmas;
+    unsigned mNumScopes = 0;
+
+    // State of the last satisfiability check
+    std::unique_ptr<SatSolver> mSat;
+    std::vector<SatVar> mSatVars;
+    SolverStatus mStatus = SolverStatus::UNKNOWN;
+    uint64_t mNumInterpolants = 0;
+};
+
+/// Builds a model from the values of the bit-blasted variables.
+std::unique_ptr<Model> createBitBlastModel(
+    const BitBlaster& blaster, llvm::function_ref<bool(AigLit)> getBitValue);
+
+} // end namespace gazer::bitblast
+
+#endif
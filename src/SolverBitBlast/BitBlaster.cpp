@@ -0,0 +1,770 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "BitBlastSolverImpl.h"
+
+#include "gazer/Core/ExprTypes.h"
+#include "gazer/Core/LiteralExpr.h"
+
+#include <algorithm>
+
+using namespace gazer;
+using namespace gazer::bitblast;
+
+unsigned BitBlaster::getWidth(Type& type)
+{
+    if (type.isBoolType()) {
+        return 1;
+    }
+
+    if (auto bvTy = llvm::dyn_cast<BvType>(&type)) {
+        return bvTy->getWidth();
+    }
+
+    return 0;
+}
+
+AigLit BitBlaster::blastBool(const ExprPtr& expr)
+{
+    assert(expr->getType().isBoolType());
+    AigLit root = mBits[this->walk(expr)][0];
+
+    // The expression may have introduced new array indices or equalities.
+    this->instantiateEqualities();
+
+    return root;
+}
+
+bool BitBlaster::shouldSkip(const ExprPtr& expr, unsigned* ret)
+{
+    auto it = mCache.find(expr);
+    if (it != mCache.end()) {
+        *ret = it->second;
+        return true;
+    }
+
+    return false;
+}
+
+void BitBlaster::handleResult(const ExprPtr& expr, unsigned& ret)
+{
+    // Over-approximation is inherited from the operands.
+    bool unsupported = mVisitUnsupported;
+    mVisitUnsupported = false;
+    if (auto nonNullary = llvm::dyn_cast<NonNullaryExpr>(expr)) {
+        unsupported |= llvm::any_of(nonNullary->operands(), [this](const ExprPtr& op) {
+            return mUnsupported.count(op.get()) != 0;
+        });
+    }
+
+    if (unsupported) {
+        mUnsupported.insert(expr.get());
+    }
+
+    // Each occurrence of an undef expression denotes a different value,
+    // so these cannot be cached.
+    if (expr->getKind() != Expr::Undef) {
+        mCache[expr] = ret;
+        if (!expr->getType().isArrayType()) {
+            mBitsExprs.try_emplace(ret, expr);
+        }
+    }
+}
+
+unsigned BitBlaster::addBits(Bits bits)
+{
+    mBits.emplace_back(std::move(bits));
+    return mBits.size() - 1;
+}
+
+unsigned BitBlaster::addArrayTerm(ArrayTerm term)
+{
+    mArrayTerms.push_back(term);
+    return mArrayTerms.size() - 1;
+}
+
+unsigned BitBlaster::createInputBits(unsigned width)
+{
+    Bits bits(width);
+    for (unsigned i = 0; i < width; ++i) {
+        bits[i] = mAig.createInput();
+    }
+
+    return this->addBits(std::move(bits));
+}
+
+unsigned BitBlaster::createBaseArray(Variable* variable, ArrayType& type)
+{
+    unsigned indexWidth = getWidth(type.getIndexType());
+    unsigned elementWidth = getWidth(type.getElementType());
+
+    if (indexWidth == 0 || elementWidth == 0) {
+        mVisitUnsupported = true;
+    }
+
+    mArrayBases.push_back({variable, indexWidth, elementWidth, {}});
+
+    ArrayTerm term;
+    term.kind = ArrayTerm::Base;
+    term.base = mArrayBases.size() - 1;
+
+    return this->addArrayTerm(term);
+}
+
+unsigned BitBlaster::unsupported(const ExprPtr& expr)
+{
+    mVisitUnsupported = true;
+    if (auto arrTy = llvm::dyn_cast<ArrayType>(&expr->getType())) {
+        return this->createBaseArray(nullptr, *arrTy);
+    }
+
+    return this->createInputBits(getWidth(expr->getType()));
+}
+
+// Circuits
+//===----------------------------------------------------------------------===//
+
+Bits BitBlaster::add(const Bits& lhs, const Bits& rhs, AigLit carry)
+{
+    assert(lhs.size() == rhs.size());
+    Bits result(lhs.size());
+
+    for (size_t i = 0; i < lhs.size(); ++i) {
+        AigLit x = mAig.createXor(lhs[i], rhs[i]);
+        result[i] = mAig.createXor(x, carry);
+        carry = mAig.createOr(
+            mAig.createAnd(lhs[i], rhs[i]),
+            mAig.createAnd(carry, x)
+        );
+    }
+
+    return result;
+}
+
+Bits BitBlaster::sub(const Bits& lhs, const Bits& rhs)
+{
+    Bits negated(rhs.size());
+    std::transform(rhs.begin(), rhs.end(), negated.begin(), aigNot);
+
+    return this->add(lhs, negated, AigTrue);
+}
+
+Bits BitBlaster::neg(const Bits& bits)
+{
+    return this->sub(Bits(bits.size(), AigFalse), bits);
+}
+
+Bits BitBlaster::mul(const Bits& lhs, const Bits& rhs)
+{
+    size_t width = lhs.size();
+    Bits result(width, AigFalse);
+
+    for (size_t i = 0; i < width; ++i) {
+        if (rhs[i] == AigFalse) {
+            continue;
+        }
+
+        Bits partial(width, AigFalse);
+        for (size_t j = i; j < width; ++j) {
+            partial[j] = mAig.createAnd(lhs[j - i], rhs[i]);
+        }
+
+        result = this->add(result, partial);
+    }
+
+    return result;
+}
+
+void BitBlaster::udivrem(const Bits& lhs, const Bits& rhs, Bits& quot, Bits& rem)
+{
+    // Restoring division. The partial remainder is kept on width + 1 bits,
+    // so the shifted-out bit takes part in the comparison. Division by zero
+    // yields all ones as the quotient and the dividend as the remainder,
+    // matching the semantics of SMT-LIB.
+    size_t width = lhs.size();
+    quot.assign(width, AigFalse);
+    rem.assign(width, AigFalse);
+
+    Bits divisor(rhs);
+    divisor.push_back(AigFalse);
+
+    for (size_t i = width; i-- > 0;) {
+        Bits shifted(width + 1);
+        shifted[0] = lhs[i];
+        std::copy(rem.begin(), rem.end(), shifted.begin() + 1);
+
+        Bits diff = this->sub(shifted, divisor);
+        AigLit geq = aigNot(this->ult(shifted, divisor));
+
+        quot[i] = geq;
+        for (size_t j = 0; j < width; ++j) {
+            rem[j] = mAig.createIte(geq, diff[j], shifted[j]);
+        }
+    }
+}
+
+Bits BitBlaster::sdiv(const Bits& lhs, const Bits& rhs)
+{
+    AigLit lhsNeg = lhs.back();
+    AigLit rhsNeg = rhs.back();
+
+    Bits quot, rem;
+    this->udivrem(
+        this->ite(lhsNeg, this->neg(lhs), lhs),
+        this->ite(rhsNeg, this->neg(rhs), rhs),
+        quot, rem
+    );
+
+    return this->ite(mAig.createXor(lhsNeg, rhsNeg), this->neg(quot), quot);
+}
+
+Bits BitBlaster::srem(const Bits& lhs, const Bits& rhs)
+{
+    // The sign of the remainder follows the sign of the dividend.
+    AigLit lhsNeg = lhs.back();
+    AigLit rhsNeg = rhs.back();
+
+    Bits quot, rem;
+    this->udivrem(
+        this->ite(lhsNeg, this->neg(lhs), lhs),
+        this->ite(rhsNeg, this->neg(rhs), rhs),
+        quot, rem
+    );
+
+    return this->ite(lhsNeg, this->neg(rem), rem);
+}
+
+Bits BitBlaster::shift(const Bits& bits, const Bits& amount, bool left, bool arithmetic)
+{
+    size_t width = bits.size();
+    AigLit fill = arithmetic ? bits.back() : AigFalse;
+
+    // Barrel shifter: stage k shifts by 2^k if the k-th bit of the amount is set.
+    Bits current(bits);
+    AigLit overflow = AigFalse;
+    for (size_t k = 0; k < amount.size(); ++k) {
+        if (k >= 32 || (1ull << k) >= width) {
+            overflow = mAig.createOr(overflow, amount[k]);
+            continue;
+        }
+
+        size_t dist = 1ull << k;
+        Bits next(width);
+        for (size_t i = 0; i < width; ++i) {
+            AigLit shifted;
+            if (left) {
+                shifted = i >= dist ? current[i - dist] : AigFalse;
+            } else {
+                shifted = i + dist < width ? current[i + dist] : fill;
+            }
+            next[i] = mAig.createIte(amount[k], shifted, current[i]);
+        }
+        current = std::move(next);
+    }
+
+    return this->ite(overflow, Bits(width, fill), current);
+}
+
+Bits BitBlaster::ite(AigLit cond, const Bits& then, const Bits& elze)
+{
+    assert(then.size() == elze.size());
+    Bits result(then.size());
+    for (size_t i = 0; i < then.size(); ++i) {
+        result[i] = mAig.createIte(cond, then[i], elze[i]);
+    }
+
+    return result;
+}
+
+Bits BitBlaster::bitwise(const Bits& lhs, const Bits& rhs, AigLit (AigManager::*fn)(AigLit, AigLit))
+{
+    assert(lhs.size() == rhs.size());
+    Bits result(lhs.size());
+    for (size_t i = 0; i < lhs.size(); ++i) {
+        result[i] = (mAig.*fn)(lhs[i], rhs[i]);
+    }
+
+    return result;
+}
+
+AigLit BitBlaster::eq(const Bits& lhs, const Bits& rhs)
+{
+    assert(lhs.size() == rhs.size());
+    AigLit result = AigTrue;
+    for (size_t i = 0; i < lhs.size() && result != AigFalse; ++i) {
+        result = mAig.createAnd(result, mAig.createIff(lhs[i], rhs[i]));
+    }
+
+    return result;
+}
+
+AigLit BitBlaster::ult(const Bits& lhs, const Bits& rhs)
+{
+    assert(lhs.size() == rhs.size());
+    AigLit result = AigFalse;
+    for (size_t i = 0; i < lhs.size(); ++i) {
+        // lhs < rhs on bits [0..i] if lhs[i] < rhs[i], or they are equal
+        // and lhs < rhs holds on the lower bits.
+        result = mAig.createOr(
+            mAig.createAnd(aigNot(lhs[i]), rhs[i]),
+            mAig.createAnd(mAig.createIff(lhs[i], rhs[i]), result)
+        );
+    }
+
+    return result;
+}
+
+AigLit BitBlaster::slt(const Bits& lhs, const Bits& rhs)
+{
+    // Signed comparison is unsigned comparison with flipped sign bits.
+    Bits left(lhs);
+    Bits right(rhs);
+    left.back() = aigNot(left.back());
+    right.back() = aigNot(right.back());
+
+    return this->ult(left, right);
+}
+
+// Arrays
+//===----------------------------------------------------------------------===//
+
+unsigned BitBlaster::readArray(unsigned term, unsigned index)
+{
+    auto cached = mReadCache.find({term, index});
+    if (cached != mReadCache.end()) {
+        return cached->second;
+    }
+
+    // Collect the write chain without recursion, as memory arrays may
+    // contain very long store sequences.
+    llvm::SmallVector<unsigned, 8> writes;
+    unsigned current = term;
+    while (mArrayTerms[current].kind == ArrayTerm::Write) {
+        writes.push_back(current);
+        current = mArrayTerms[current].base;
+    }
+
+    ArrayTerm inner = mArrayTerms[current];
+    unsigned result;
+    switch (inner.kind) {
+        case ArrayTerm::Base:
+            result = this->readBaseArray(inner.base, index);
+            break;
+        case ArrayTerm::Const:
+            result = inner.value;
+            break;
+        case ArrayTerm::Ite: {
+            unsigned thenVal = this->readArray(inner.base, index);
+            unsigned elseVal = this->readArray(inner.other, index);
+            result = this->addBits(this->ite(inner.cond, mBits[thenVal], mBits[elseVal]));
+            break;
+        }
+        default:
+            llvm_unreachable("Unknown array term kind!");
+    }
+
+    // Read-over-write expansion, starting from the innermost write.
+    for (auto it = writes.rbegin(), ie = writes.rend(); it != ie; ++it) {
+        const ArrayTerm& write = mArrayTerms[*it];
+        AigLit cond = this->eq(mBits[index], mBits[write.index]);
+        if (cond == AigTrue) {
+            result = write.value;
+        } else if (cond != AigFalse) {
+            result = this->addBits(this->ite(cond, mBits[write.value], mBits[result]));
+        }
+    }
+
+    mReadCache[{term, index}] = result;
+    return result;
+}
+
+unsigned BitBlaster::readBaseArray(unsigned base, unsigned index)
+{
+    unsigned elementWidth = mArrayBases[base].elementWidth;
+    const Bits indexBits = mBits[index];
+
+    for (const ArrayRead& read : mArrayBases[base].reads) {
+        if (mBits[read.index] == indexBits) {
+            return read.value;
+        }
+    }
+
+    unsigned value = this->createInputBits(elementWidth);
+
+    // Ackermann congruence: equal indices must yield equal values.
+    for (const ArrayRead& read : mArrayBases[base].reads) {
+        AigLit sameIndex = this->eq(indexBits, mBits[read.index]);
+        if (sameIndex == AigFalse) {
+            continue;
+        }
+
+        AigLit lemma = mAig.createImply(sameIndex, this->eq(mBits[value], mBits[read.value]));
+        mLemmas.push_back({lemma, base, index, read.index});
+    }
+
+    mArrayBases[base].reads.push_back({index, value});
+    return value;
+}
+
+void BitBlaster::addArrayIndex(unsigned index)
+{
+    if (mKnownArrayIndices.insert(index).second) {
+        mArrayIndices.push_back(index);
+    }
+}
+
+AigLit BitBlaster::arrayEq(unsigned lhs, unsigned rhs, ArrayType& type)
+{
+    if (lhs == rhs) {
+        return AigTrue;
+    }
+
+    unsigned indexWidth = getWidth(type.getIndexType());
+    if (indexWidth == 0 || getWidth(type.getElementType()) == 0) {
+        mVisitUnsupported = true;
+        return mAig.createInput();
+    }
+
+    AigLit lit = mAig.createInput();
+
+    // Distinct arrays differ at some index, which is read on both sides.
+    unsigned witness = this->createInputBits(indexWidth);
+    this->addArrayIndex(witness);
+    AigLit differ = aigNot(this->eq(
+        mBits[this->readArray(lhs, witness)], mBits[this->readArray(rhs, witness)]
+    ));
+    mLemmas.push_back({mAig.createOr(lit, differ), ArrayLemma::NoBase, 0, 0});
+
+    mArrayEqualities.push_back({lit, lhs, rhs, indexWidth, 0});
+    return lit;
+}
+
+void BitBlaster::instantiateEqualities()
+{
+    // Equal arrays must agree at every index which is read or written. As
+    // instantiation only reads the arrays at known indices, this terminates.
+    for (ArrayEquality& equality : mArrayEqualities) {
+        while (equality.numInstantiated < mArrayIndices.size()) {
+            unsigned index = mArrayIndices[equality.numInstantiated++];
+            if (mBits[index].size() != equality.indexWidth) {
+                continue;
+            }
+
+            unsigned lhsValue = this->readArray(equality.lhs, index);
+            unsigned rhsValue = this->readArray(equality.rhs, index);
+            AigLit same = this->eq(mBits[lhsValue], mBits[rhsValue]);
+            mLemmas.push_back({mAig.createImply(equality.lit, same), ArrayLemma::NoBase, 0, 0});
+        }
+    }
+}
+
+// Visitors
+//===----------------------------------------------------------------------===//
+
+unsigned BitBlaster::visitUndef(const ExprRef<UndefExpr>& expr)
+{
+    if (auto arrTy = llvm::dyn_cast<ArrayType>(&expr->getType())) {
+        return this->createBaseArray(nullptr, *arrTy);
+    }
+
+    unsigned width = getWidth(expr->getType());
+    if (width == 0) {
+        return this->unsupported(expr);
+    }
+
+    return this->createInputBits(width);
+}
+
+unsigned BitBlaster::visitVarRef(const ExprRef<VarRefExpr>& expr)
+{
+    Variable* variable = &expr->getVariable();
+    auto it = mVariables.find(variable);
+    if (it != mVariables.end()) {
+        return it->second;
+    }
+
+    unsigned result;
+    if (auto arrTy = llvm::dyn_cast<ArrayType>(&variable->getType())) {
+        result = this->createBaseArray(variable, *arrTy);
+    } else {
+        unsigned width = getWidth(variable->getType());
+        if (width == 0) {
+            return this->unsupported(expr);
+        }
+        result = this->createInputBits(width);
+    }
+
+    mVariables[variable] = result;
+    return result;
+}
+
+unsigned BitBlaster::visitBoolLiteral(const ExprRef<BoolLiteralExpr>& expr)
+{
+    return this->addBits({ expr->getValue() ? AigTrue : AigFalse });
+}
+
+unsigned BitBlaster::visitBvLiteral(const ExprRef<BvLiteralExpr>& expr)
+{
+    llvm::APInt value = expr->getValue();
+    Bits bits(value.getBitWidth());
+    for (unsigned i = 0; i < value.getBitWidth(); ++i) {
+        bits[i] = value[i] ? AigTrue : AigFalse;
+    }
+
+    return this->addBits(std::move(bits));
+}
+
+unsigned BitBlaster::literalBits(const ExprRef<LiteralExpr>& expr)
+{
+    // Array literal elements cannot be walked from within a visit method,
+    // so they are translated here directly.
+    if (auto boolLit = llvm::dyn_cast<BoolLiteralExpr>(expr)) {
+        return this->visitBoolLiteral(boolLit);
+    }
+
+    if (auto bvLit = llvm::dyn_cast<BvLiteralExpr>(expr)) {
+        return this->visitBvLiteral(bvLit);
+    }
+
+    return this->unsupported(expr);
+}
+
+unsigned BitBlaster::visitArrayLiteral(const ExprRef<ArrayLiteralExpr>& expr)
+{
+    ArrayType& type = expr->getType();
+    unsigned elementWidth = getWidth(type.getElementType());
+    if (getWidth(type.getIndexType()) == 0 || elementWidth == 0) {
+        return this->unsupported(expr);
+    }
+
+    unsigned result;
+    if (expr->hasDefault()) {
+        ArrayTerm term;
+        term.kind = ArrayTerm::Const;
+        term.value = this->literalBits(expr->getDefault());
+        result = this->addArrayTerm(term);
+    } else {
+        result = this->createBaseArray(nullptr, type);
+    }
+
+    for (auto& [index, value] : expr->getMap()) {
+        ArrayTerm term;
+        term.kind = ArrayTerm::Write;
+        term.base = result;
+        term.index = this->literalBits(index);
+        term.value = this->literalBits(value);
+        result = this->addArrayTerm(term);
+    }
+
+    return result;
+}
+
+unsigned BitBlaster::visitNot(const ExprRef<NotExpr>& expr)
+{
+    return this->addBits({ aigNot(op(0)[0]) });
+}
+
+unsigned BitBlaster::visitAnd(const ExprRef<AndExpr>& expr)
+{
+    AigLit result = AigTrue;
+    for (size_t i = 0; i < expr->getNumOperands(); ++i) {
+        result = mAig.createAnd(result, op(i)[0]);
+    }
+
+    return this->addBits({ result });
+}
+
+unsigned BitBlaster::visitOr(const ExprRef<OrExpr>& expr)
+{
+    AigLit result = AigFalse;
+    for (size_t i = 0; i < expr->getNumOperands(); ++i) {
+        result = mAig.createOr(result, op(i)[0]);
+    }
+
+    return this->addBits({ result });
+}
+
+unsigned BitBlaster::visitImply(const ExprRef<ImplyExpr>& expr)
+{
+    return this->addBits({ mAig.createImply(op(0)[0], op(1)[0]) });
+}
+
+unsigned BitBlaster::visitZExt(const ExprRef<ZExtExpr>& expr)
+{
+    Bits bits(op(0));
+    bits.resize(expr->getExtendedWidth(), AigFalse);
+
+    return this->addBits(std::move(bits));
+}
+
+unsigned BitBlaster::visitSExt(const ExprRef<SExtExpr>& expr)
+{
+    Bits bits(op(0));
+    bits.resize(expr->getExtendedWidth(), bits.back());
+
+    return this->addBits(std::move(bits));
+}
+
+unsigned BitBlaster::visitExtract(const ExprRef<ExtractExpr>& expr)
+{
+    const Bits& bits = op(0);
+    auto begin = bits.begin() + expr->getOffset();
+
+    return this->addBits(Bits(begin, begin + expr->getWidth()));
+}
+
+unsigned BitBlaster::visitBvConcat(const ExprRef<BvConcatExpr>& expr)
+{
+    // The left operand forms the most significant bits.
+    Bits bits(op(1));
+    bits.insert(bits.end(), op(0).begin(), op(0).end());
+
+    return this->addBits(std::move(bits));
+}
+
+#define BITBLAST_BV_OPERATION(NAME, OPERATION)                                  \
+unsigned BitBlaster::visit##NAME(const ExprRef<NAME##Expr>& expr)               \
+{                                                                               \
+    if (!expr->getType().isBvType()) {                                          \
+        return this->unsupported(expr);                                         \
+    }                                                                           \
+    const Bits& lhs = op(0);                                                    \
+    const Bits& rhs = op(1);                                                    \
+    return this->addBits(OPERATION);                                            \
+}                                                                               \
+
+BITBLAST_BV_OPERATION(Add,      this->add(lhs, rhs))
+BITBLAST_BV_OPERATION(Sub,      this->sub(lhs, rhs))
+BITBLAST_BV_OPERATION(Mul,      this->mul(lhs, rhs))
+BITBLAST_BV_OPERATION(BvSDiv,   this->sdiv(lhs, rhs))
+BITBLAST_BV_OPERATION(BvSRem,   this->srem(lhs, rhs))
+BITBLAST_BV_OPERATION(Shl,      this->shift(lhs, rhs, true, false))
+BITBLAST_BV_OPERATION(LShr,     this->shift(lhs, rhs, false, false))
+BITBLAST_BV_OPERATION(AShr,     this->shift(lhs, rhs, false, true))
+BITBLAST_BV_OPERATION(BvAnd,    this->bitwise(lhs, rhs, &AigManager::createAnd))
+BITBLAST_BV_OPERATION(BvOr,     this->bitwise(lhs, rhs, &AigManager::createOr))
+BITBLAST_BV_OPERATION(BvXor,    this->bitwise(lhs, rhs, &AigManager::createXor))
+
+#undef BITBLAST_BV_OPERATION
+
+unsigned BitBlaster::visitBvUDiv(const ExprRef<BvUDivExpr>& expr)
+{
+    Bits quot, rem;
+    this->udivrem(op(0), op(1), quot, rem);
+
+    return this->addBits(std::move(quot));
+}
+
+unsigned BitBlaster::visitBvURem(const ExprRef<BvURemExpr>& expr)
+{
+    Bits quot, rem;
+    this->udivrem(op(0), op(1), quot, rem);
+
+    return this->addBits(std::move(rem));
+}
+
+unsigned BitBlaster::visitEq(const ExprRef<EqExpr>& expr)
+{
+    Type& opTy = expr->getLeft()->getType();
+    if (auto arrTy = llvm::dyn_cast<ArrayType>(&opTy)) {
+        return this->addBits({ this->arrayEq(getOperand(0), getOperand(1), *arrTy) });
+    }
+
+    if (!opTy.isBoolType() && !opTy.isBvType()) {
+        return this->unsupported(expr);
+    }
+
+    return this->addBits({ this->eq(op(0), op(1)) });
+}
+
+unsigned BitBlaster::visitNotEq(const ExprRef<NotEqExpr>& expr)
+{
+    Type& opTy = expr->getLeft()->getType();
+    if (auto arrTy = llvm::dyn_cast<ArrayType>(&opTy)) {
+        return this->addBits({ aigNot(this->arrayEq(getOperand(0), getOperand(1), *arrTy)) });
+    }
+
+    if (!opTy.isBoolType() && !opTy.isBvType()) {
+        return this->unsupported(expr);
+    }
+
+    return this->addBits({ aigNot(this->eq(op(0), op(1))) });
+}
+
+#define BITBLAST_BV_COMPARE(NAME, OPERATION)                                    \
+unsigned BitBlaster::visit##NAME(const ExprRef<NAME##Expr>& expr)               \
+{                                                                               \
+    const Bits& lhs = op(0);                                                    \
+    const Bits& rhs = op(1);                                                    \
+    return this->addBits({ OPERATION });                                        \
+}                                                                               \
+
+BITBLAST_BV_COMPARE(BvSLt,      this->slt(lhs, rhs))
+BITBLAST_BV_COMPARE(BvSLtEq,    aigNot(this->slt(rhs, lhs)))
+BITBLAST_BV_COMPARE(BvSGt,      this->slt(rhs, lhs))
+BITBLAST_BV_COMPARE(BvSGtEq,    aigNot(this->slt(lhs, rhs)))
+BITBLAST_BV_COMPARE(BvULt,      this->ult(lhs, rhs))
+BITBLAST_BV_COMPARE(BvULtEq,    aigNot(this->ult(rhs, lhs)))
+BITBLAST_BV_COMPARE(BvUGt,      this->ult(rhs, lhs))
+BITBLAST_BV_COMPARE(BvUGtEq,    aigNot(this->ult(lhs, rhs)))
+
+#undef BITBLAST_BV_COMPARE
+
+unsigned BitBlaster::visitSelect(const ExprRef<SelectExpr>& expr)
+{
+    AigLit cond = op(0)[0];
+
+    if (expr->getType().isArrayType()) {
+        if (cond == AigTrue) {
+            return getOperand(1);
+        }
+        if (cond == AigFalse) {
+            return getOperand(2);
+        }
+
+        ArrayTerm term;
+        term.kind = ArrayTerm::Ite;
+        term.cond = cond;
+        term.base = getOperand(1);
+        term.other = getOperand(2);
+        return this->addArrayTerm(term);
+    }
+
+    if (getWidth(expr->getType()) == 0) {
+        return this->unsupported(expr);
+    }
+
+    return this->addBits(this->ite(cond, op(1), op(2)));
+}
+
+unsigned BitBlaster::visitArrayRead(const ExprRef<ArrayReadExpr>& expr)
+{
+    this->addArrayIndex(getOperand(1));
+    return this->readArray(getOperand(0), getOperand(1));
+}
+
+unsigned BitBlaster::visitArrayWrite(const ExprRef<ArrayWriteExpr>& expr)
+{
+    ArrayTerm term;
+    term.kind = ArrayTerm::Write;
+    term.base = getOperand(0);
+    term.index = getOperand(1);
+    term.value = getOperand(2);
+    this->addArrayIndex(term.index);
+
+    return this->addArrayTerm(term);
+}
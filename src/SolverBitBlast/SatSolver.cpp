@@ -0,0 +1,716 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "SatSolver.h"
+
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+
+using namespace gazer::bitblast;
+
+static constexpr double VarDecay = 0.95;
+static constexpr double ClauseDecay = 0.999;
+static constexpr double RescaleLimit = 1e100;
+static constexpr unsigned RestartBase = 100;
+
+/// Returns the i-th element of the Luby sequence (1, 1, 2, 1, 1, 2, 4, ...).
+static uint64_t luby(uint64_t i)
+{
+    uint64_t size = 1;
+    unsigned seq = 0;
+    while (size < i + 1) {
+        ++seq;
+        size = 2 * size + 1;
+    }
+
+    while (size - 1 != i) {
+        size = (size - 1) >> 1;
+        --seq;
+        i = i % size;
+    }
+
+    return 1ull << seq;
+}
+
+// Variable order heap
+//===----------------------------------------------------------------------===//
+
+void SatSolver::VarOrderHeap::insert(SatVar v)
+{
+    if (mIndices.size() <= v) {
+        mIndices.resize(v + 1, -1);
+    }
+
+    assert(!contains(v) && "Variable is already in the heap!");
+    mIndices[v] = mHeap.size();
+    mHeap.push_back(v);
+    percolateUp(mIndices[v]);
+}
+
+SatVar SatSolver::VarOrderHeap::removeMax()
+{
+    assert(!mHeap.empty());
+    SatVar top = mHeap[0];
+    mHeap[0] = mHeap.back();
+    mIndices[mHeap[0]] = 0;
+    mIndices[top] = -1;
+    mHeap.pop_back();
+
+    if (mHeap.size() > 1) {
+        percolateDown(0);
+    }
+
+    return top;
+}
+
+void SatSolver::VarOrderHeap::clear()
+{
+    for (SatVar v : mHeap) {
+        mIndices[v] = -1;
+    }
+    mHeap.clear();
+}
+
+void SatSolver::VarOrderHeap::percolateUp(int i)
+{
+    SatVar v = mHeap[i];
+    while (i != 0) {
+        int parent = (i - 1) >> 1;
+        if (!lessThan(v, mHeap[parent])) {
+            break;
+        }
+        mHeap[i] = mHeap[parent];
+        mIndices[mHeap[i]] = i;
+        i = parent;
+    }
+    mHeap[i] = v;
+    mIndices[v] = i;
+}
+
+void SatSolver::VarOrderHeap::percolateDown(int i)
+{
+    SatVar v = mHeap[i];
+    int size = mHeap.size();
+    while (2 * i + 1 < size) {
+        int child = 2 * i + 1;
+        if (child + 1 < size && lessThan(mHeap[child + 1], mHeap[child])) {
+            ++child;
+        }
+        if (!lessThan(mHeap[child], v)) {
+            break;
+        }
+        mHeap[i] = mHeap[child];
+        mIndices[mHeap[i]] = i;
+        i = child;
+    }
+    mHeap[i] = v;
+    mIndices[v] = i;
+}
+
+// Solver implementation
+//===----------------------------------------------------------------------===//
+
+SatSolver::SatSolver()
+    : mOrder(mActivity)
+{}
+
+SatVar SatSolver::newVar()
+{
+    SatVar v = mAssigns.size();
+    mAssigns.push_back(LBool::Undef);
+    mLevels.push_back(0);
+    mReasons.push_back(nullptr);
+    mPolarity.push_back(true);
+    mActivity.push_back(0.0);
+    mSeen.push_back(0);
+    mUnitLabels.push_back(0);
+    mWatches.emplace_back();
+    mWatches.emplace_back();
+    mOrder.insert(v);
+
+    return v;
+}
+
+bool SatSolver::addClause(llvm::ArrayRef<SatLit> lits, unsigned label)
+{
+    assert(decisionLevel() == 0 && "Clauses may only be added at the root level!");
+    if (!mOk) {
+        return false;
+    }
+
+    std::vector<SatLit> clause(lits.begin(), lits.end());
+    std::sort(clause.begin(), clause.end());
+
+    // Remove duplicates and false literals, drop tautologies and satisfied clauses.
+    size_t j = 0;
+    SatLit prev = UndefSatLit;
+    for (size_t i = 0; i < clause.size(); ++i) {
+        SatLit lit = clause[i];
+        assert(satLitVar(lit) < mAssigns.size() && "Unknown variable in clause!");
+        if (value(lit) == LBool::True || lit == satLitNeg(prev)) {
+            return true;
+        }
+        if (value(lit) == LBool::False) {
+            if (mTracer != nullptr) {
+                label = mTracer->resolve(label, mUnitLabels[satLitVar(lit)], satLitVar(lit));
+            }
+        } else if (lit != prev) {
+            clause[j++] = prev = lit;
+        }
+    }
+    clause.resize(j);
+
+    if (clause.empty()) {
+        mFinalLabel = label;
+        mOk = false;
+        return false;
+    }
+
+    if (clause.size() == 1) {
+        enqueue(clause[0], nullptr);
+        mUnitLabels[satLitVar(clause[0])] = label;
+        if (Clause* conflict = propagate()) {
+            if (mTracer != nullptr) {
+                mFinalLabel = resolveRootLits(conflict->label, conflict->lits);
+            }
+            mOk = false;
+        }
+        return mOk;
+    }
+
+    mClauses.emplace_back(std::make_unique<Clause>(clause, false, label));
+    attachClause(mClauses.back().get());
+
+    return true;
+}
+
+void SatSolver::attachClause(Clause* clause)
+{
+    assert(clause->lits.size() >= 2);
+    mWatches[clause->lits[0]].push_back({clause, clause->lits[1]});
+    mWatches[clause->lits[1]].push_back({clause, clause->lits[0]});
+}
+
+void SatSolver::enqueue(SatLit lit, Clause* reason)
+{
+    assert(value(lit) == LBool::Undef);
+    SatVar v = satLitVar(lit);
+    mAssigns[v] = satLitSign(lit) ? LBool::False : LBool::True;
+    mLevels[v] = decisionLevel();
+    mReasons[v] = reason;
+    mTrail.push_back(lit);
+
+    // Root-level implications are facts, remember the derivation of their
+    // unit clause for later resolution steps.
+    if (mTracer != nullptr && reason != nullptr && decisionLevel() == 0) {
+        assert(reason->lits[0] == lit);
+        mUnitLabels[v] = resolveRootLits(reason->label, reason->lits, 1);
+    }
+}
+
+unsigned SatSolver::resolveRootLits(unsigned label, llvm::ArrayRef<SatLit> lits, size_t begin)
+{
+    for (size_t i = begin; i < lits.size(); ++i) {
+        SatVar v = satLitVar(lits[i]);
+        assert(mLevels[v] == 0 && value(lits[i]) == LBool::False);
+        label = mTracer->resolve(label, mUnitLabels[v], v);
+    }
+
+    return label;
+}
+
+auto SatSolver::propagate() -> Clause*
+{
+    Clause* conflict = nullptr;
+
+    while (mQueueHead < mTrail.size()) {
+        SatLit falseLit = satLitNeg(mTrail[mQueueHead++]);
+        std::vector<Watcher>& watches = mWatches[falseLit];
+        ++mStats.Propagations;
+
+        size_t i = 0;
+        size_t j = 0;
+        while (i < watches.size()) {
+            Watcher watcher = watches[i];
+            if (value(watcher.blocker) == LBool::True) {
+                watches[j++] = watches[i++];
+                continue;
+            }
+
+            Clause& clause = *watcher.clause;
+            auto& lits = clause.lits;
+
+            // Make sure that the false literal is the second one.
+            if (lits[0] == falseLit) {
+                std::swap(lits[0], lits[1]);
+            }
+            assert(lits[1] == falseLit);
+            ++i;
+
+            SatLit first = lits[0];
+            Watcher newWatcher = { &clause, first };
+            if (first != watcher.blocker && value(first) == LBool::True) {
+                watches[j++] = newWatcher;
+                continue;
+            }
+
+            // Look for a new literal to watch.
+            bool found = false;
+            for (size_t k = 2; k < lits.size(); ++k) {
+                if (value(lits[k]) != LBool::False) {
+                    std::swap(lits[1], lits[k]);
+                    mWatches[lits[1]].push_back(newWatcher);
+                    found = true;
+                    break;
+                }
+            }
+
+            if (found) {
+                continue;
+            }
+
+            // The clause is unit or conflicting under the current assignment.
+            watches[j++] = newWatcher;
+            if (value(first) == LBool::False) {
+                conflict = &clause;
+                mQueueHead = mTrail.size();
+                while (i < watches.size()) {
+                    watches[j++] = watches[i++];
+                }
+            } else {
+                enqueue(first, &clause);
+            }
+        }
+
+        watches.resize(j);
+        if (conflict != nullptr) {
+            break;
+        }
+    }
+
+    return conflict;
+}
+
+void SatSolver::analyze(Clause* conflict, std::vector<SatLit>& learnt, unsigned& backtrackLevel, unsigned& label)
+{
+    learnt.clear();
+    learnt.push_back(UndefSatLit);
+    mRootLits.clear();
+    label = conflict->label;
+
+    int pathCount = 0;
+    SatLit lit = UndefSatLit;
+    size_t index = mTrail.size();
+
+    do {
+        assert(conflict != nullptr && "Implied literals must have a reason!");
+        if (conflict->learnt) {
+            bumpClauseActivity(conflict);
+        }
+
+        if (mTracer != nullptr && lit != UndefSatLit) {
+            label = mTracer->resolve(label, conflict->label, satLitVar(lit));
+        }
+
+        for (size_t i = (lit == UndefSatLit ? 0 : 1); i < conflict->lits.size(); ++i) {
+            SatLit q = conflict->lits[i];
+            SatVar v = satLitVar(q);
+            if (mLevels[v] == 0) {
+                // Root-level literals are resolved away with their unit
+                // clauses after the analysis, when tracing.
+                if (mTracer != nullptr) {
+                    mRootLits.push_back(q);
+                }
+            } else if (!mSeen[v]) {
+                bumpVarActivity(v);
+                mSeen[v] = 1;
+                if (mLevels[v] >= decisionLevel()) {
+                    ++pathCount;
+                } else {
+                    learnt.push_back(q);
+                }
+            }
+        }
+
+        // Select the next literal to look at.
+        do {
+            --index;
+        } while (!mSeen[satLitVar(mTrail[index])]);
+
+        lit = mTrail[index];
+        conflict = mReasons[satLitVar(lit)];
+        mSeen[satLitVar(lit)] = 0;
+        --pathCount;
+    } while (pathCount > 0);
+
+    learnt[0] = satLitNeg(lit);
+
+    // Local minimization: drop literals which are implied by other literals
+    // of the learnt clause. Removed literals are swapped to the end, so we
+    // can clear their seen flags afterwards.
+    size_t j = 1;
+    for (size_t i = 1; i < learnt.size(); ++i) {
+        if (!isRedundant(learnt[i])) {
+            std::swap(learnt[j++], learnt[i]);
+        }
+    }
+
+    if (mTracer != nullptr) {
+        label = this->traceMinimization(label, learnt, j);
+    }
+
+    for (size_t i = j; i < learnt.size(); ++i) {
+        mSeen[satLitVar(learnt[i])] = 0;
+    }
+    learnt.resize(j);
+
+    // Find the backtrack level and put a literal of that level to the second position.
+    backtrackLevel = 0;
+    if (learnt.size() > 1) {
+        size_t maxIdx = 1;
+        for (size_t i = 2; i < learnt.size(); ++i) {
+            if (mLevels[satLitVar(learnt[i])] > mLevels[satLitVar(learnt[maxIdx])]) {
+                maxIdx = i;
+            }
+        }
+        std::swap(learnt[1], learnt[maxIdx]);
+        backtrackLevel = mLevels[satLitVar(learnt[1])];
+    }
+
+    for (SatLit l : learnt) {
+        mSeen[satLitVar(l)] = 0;
+    }
+
+    if (mTracer != nullptr) {
+        std::sort(mRootLits.begin(), mRootLits.end());
+        mRootLits.erase(std::unique(mRootLits.begin(), mRootLits.end()), mRootLits.end());
+        label = resolveRootLits(label, mRootLits);
+    }
+}
+
+unsigned SatSolver::traceMinimization(unsigned label, llvm::ArrayRef<SatLit> learnt, size_t removedBegin)
+{
+    // Literals removed by the minimization are resolved with their reasons.
+    // Reasons only contain literals assigned earlier, thus resolving in
+    // reverse trail order never re-introduces an already removed literal.
+    size_t remaining = learnt.size() - removedBegin;
+    for (size_t i = removedBegin; i < learnt.size(); ++i) {
+        mSeen[satLitVar(learnt[i])] = 2;
+    }
+
+    for (size_t i = mTrail.size(); i > 0 && remaining != 0; --i) {
+        SatVar v = satLitVar(mTrail[i - 1]);
+        if (mSeen[v] != 2) {
+            continue;
+        }
+
+        const Clause* reason = mReasons[v];
+        label = mTracer->resolve(label, reason->label, v);
+        for (size_t k = 1; k < reason->lits.size(); ++k) {
+            if (mLevels[satLitVar(reason->lits[k])] == 0) {
+                mRootLits.push_back(reason->lits[k]);
+            }
+        }
+        --remaining;
+    }
+
+    return label;
+}
+
+bool SatSolver::isRedundant(SatLit lit) const
+{
+    const Clause* reason = mReasons[satLitVar(lit)];
+    if (reason == nullptr) {
+        return false;
+    }
+
+    for (size_t k = 1; k < reason->lits.size(); ++k) {
+        SatVar v = satLitVar(reason->lits[k]);
+        if (!mSeen[v] && mLevels[v] > 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void SatSolver::analyzeFinal(SatLit failed)
+{
+    // Collects the assumptions which imply the negation of the failed
+    // assumption. As every decision made so far is an assumption, these are
+    // the decision literals in the implication graph of the failed one.
+    mFailedAssumptions.clear();
+    mFailedAssumptions.push_back(failed);
+
+    if (decisionLevel() == 0) {
+        return;
+    }
+
+    mSeen[satLitVar(failed)] = 1;
+    for (size_t i = mTrail.size(); i > mTrailLim[0]; --i) {
+        SatVar v = satLitVar(mTrail[i - 1]);
+        if (!mSeen[v]) {
+            continue;
+        }
+
+        const Clause* reason = mReasons[v];
+        if (reason == nullptr) {
+            mFailedAssumptions.push_back(mTrail[i - 1]);
+        } else {
+            for (size_t k = 1; k < reason->lits.size(); ++k) {
+                if (mLevels[satLitVar(reason->lits[k])] > 0) {
+                    mSeen[satLitVar(reason->lits[k])] = 1;
+                }
+            }
+        }
+        mSeen[v] = 0;
+    }
+    mSeen[satLitVar(failed)] = 0;
+}
+
+void SatSolver::cancelUntil(unsigned level)
+{
+    if (decisionLevel() <= level) {
+        return;
+    }
+
+    for (size_t i = mTrail.size(); i > mTrailLim[level]; --i) {
+        SatVar v = satLitVar(mTrail[i - 1]);
+        mAssigns[v] = LBool::Undef;
+        mReasons[v] = nullptr;
+        mPolarity[v] = satLitSign(mTrail[i - 1]);
+        if (!mOrder.contains(v)) {
+            mOrder.insert(v);
+        }
+    }
+
+    mQueueHead = mTrailLim[level];
+    mTrail.resize(mTrailLim[level]);
+    mTrailLim.resize(level);
+}
+
+SatLit SatSolver::pickBranchLit()
+{
+    while (!mOrder.empty()) {
+        SatVar v = mOrder.removeMax();
+        if (mAssigns[v] == LBool::Undef) {
+            return mkSatLit(v, mPolarity[v]);
+        }
+    }
+
+    return UndefSatLit;
+}
+
+bool SatSolver::isLocked(const Clause* clause) const
+{
+    SatLit first = clause->lits[0];
+    return value(first) == LBool::True && mReasons[satLitVar(first)] == clause;
+}
+
+void SatSolver::reduceLearnts()
+{
+    std::sort(mLearnts.begin(), mLearnts.end(), [](auto& lhs, auto& rhs) {
+        if (lhs->lits.size() <= 2 || rhs->lits.size() <= 2) {
+            return lhs->lits.size() > 2 && rhs->lits.size() <= 2;
+        }
+        return lhs->activity < rhs->activity;
+    });
+
+    // Delete the less active half of the learnt clauses, keeping binaries
+    // and clauses which currently act as a reason.
+    double limit = mClauseInc / mLearnts.size();
+    size_t half = mLearnts.size() / 2;
+    for (size_t i = 0; i < mLearnts.size(); ++i) {
+        Clause* clause = mLearnts[i].get();
+        if (clause->lits.size() > 2 && !isLocked(clause)
+            && (i < half || clause->activity < limit)
+        ) {
+            clause->deleted = true;
+        }
+    }
+
+    for (auto& watches : mWatches) {
+        watches.erase(
+            std::remove_if(watches.begin(), watches.end(), [](const Watcher& w) {
+                return w.clause->deleted;
+            }),
+            watches.end()
+        );
+    }
+
+    size_t before = mLearnts.size();
+    mLearnts.erase(
+        std::remove_if(mLearnts.begin(), mLearnts.end(), [](auto& clause) {
+            return clause->deleted;
+        }),
+        mLearnts.end()
+    );
+    mStats.DeletedClauses += before - mLearnts.size();
+}
+
+void SatSolver::bumpVarActivity(SatVar v)
+{
+    if ((mActivity[v] += mVarInc) > RescaleLimit) {
+        for (double& act : mActivity) {
+            act *= 1e-100;
+        }
+        mVarInc *= 1e-100;
+    }
+
+    if (mOrder.contains(v)) {
+        mOrder.increased(v);
+    }
+}
+
+void SatSolver::bumpClauseActivity(Clause* clause)
+{
+    if ((clause->activity += mClauseInc) > 1e20) {
+        for (auto& learnt : mLearnts) {
+            learnt->activity *= 1e-20;
+        }
+        mClauseInc *= 1e-20;
+    }
+}
+
+void SatSolver::decayActivities()
+{
+    mVarInc *= (1 / VarDecay);
+    mClauseInc *= (1 / ClauseDecay);
+}
+
+auto SatSolver::search(int64_t conflictLimit, llvm::ArrayRef<SatLit> assumptions) -> SatResult
+{
+    int64_t conflicts = 0;
+
+    while (true) {
+        Clause* conflict = propagate();
+        if (conflict != nullptr) {
+            ++mStats.Conflicts;
+            ++conflicts;
+
+            if (decisionLevel() == 0) {
+                if (mTracer != nullptr) {
+                    mFinalLabel = resolveRootLits(conflict->label, conflict->lits);
+                }
+                mOk = false;
+                return Unsat;
+            }
+
+            unsigned backtrackLevel;
+            unsigned label;
+            analyze(conflict, mLearntClause, backtrackLevel, label);
+            cancelUntil(backtrackLevel);
+            mStats.LearntLiterals += mLearntClause.size();
+
+            if (mLearntClause.size() == 1) {
+                enqueue(mLearntClause[0], nullptr);
+                mUnitLabels[satLitVar(mLearntClause[0])] = label;
+            } else {
+                mLearnts.emplace_back(std::make_unique<Clause>(mLearntClause, true, label));
+                Clause* clause = mLearnts.back().get();
+                attachClause(clause);
+                bumpClauseActivity(clause);
+                enqueue(mLearntClause[0], clause);
+            }
+
+            decayActivities();
+            continue;
+        }
+
+        if (conflictLimit >= 0 && conflicts >= conflictLimit) {
+            cancelUntil(0);
+            return Unknown;
+        }
+
+        if (static_cast<double>(mLearnts.size()) - mTrail.size() >= mMaxLearnts) {
+            reduceLearnts();
+        }
+
+        SatLit next = UndefSatLit;
+        while (decisionLevel() < assumptions.size()) {
+            SatLit assumption = assumptions[decisionLevel()];
+            LBool val = value(assumption);
+            if (val == LBool::True) {
+                // Dummy decision level, the assumption already holds.
+                mTrailLim.push_back(mTrail.size());
+            } else if (val == LBool::False) {
+                this->analyzeFinal(assumption);
+                return Unsat;
+            } else {
+                next = assumption;
+                break;
+            }
+        }
+
+        if (next == UndefSatLit) {
+            ++mStats.Decisions;
+            next = pickBranchLit();
+            if (next == UndefSatLit) {
+                return Sat;
+            }
+        }
+
+        mTrailLim.push_back(mTrail.size());
+        enqueue(next, nullptr);
+    }
+}
+
+auto SatSolver::solve(llvm::ArrayRef<SatLit> assumptions) -> SatResult
+{
+    assert((mTracer == nullptr || assumptions.empty()) && "Assumptions are not supported while tracing!");
+    ++mStats.Solves;
+    mModel.clear();
+    mFailedAssumptions.clear();
+
+    if (!mOk) {
+        return Unsat;
+    }
+
+    mMaxLearnts = std::max(mClauses.size() / 3.0, 5000.0);
+
+    SatResult result = Unknown;
+    for (uint64_t restarts = 0; result == Unknown; ++restarts) {
+        int64_t limit = luby(restarts) * RestartBase;
+        result = search(limit, assumptions);
+        if (result == Unknown) {
+            ++mStats.Restarts;
+            mMaxLearnts *= 1.1;
+        }
+    }
+
+    if (result == Sat) {
+        mModel = mAssigns;
+    }
+
+    cancelUntil(0);
+    return result;
+}
+
+void SatSolver::printStats(llvm::raw_ostream& os) const
+{
+    os << "  :sat-vars " << getNumVars() << "\n"
+       << "  :sat-clauses " << getNumClauses() << "\n"
+       << "  :sat-learnts " << getNumLearnts() << "\n"
+       << "  :sat-solves " << mStats.Solves << "\n"
+       << "  :sat-conflicts " << mStats.Conflicts << "\n"
+       << "  :sat-decisions " << mStats.Decisions << "\n"
+       << "  :sat-propagations " << mStats.Propagations << "\n"
+       << "  :sat-restarts " << mStats.Restarts << "\n"
+       << "  :sat-learnt-literals " << mStats.LearntLiterals << "\n"
+       << "  :sat-deleted-clauses " << mStats.DeletedClauses << "\n";
+}
@@ -0,0 +1,273 @@
+//==- SatSolver.h - Embedded incremental SAT solver -------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file A small conflict-driven clause learning SAT solver, used as the
+/// decision procedure of the bit-blasting solver backend.
+///
+/// The implementation follows the design of MiniSat: two watched literals
+/// with blockers, first-UIP conflict analysis with local clause minimization,
+/// VSIDS branching with phase saving, Luby restarts and activity-based
+/// learnt clause deletion. Incrementality is supported through assumptions,
+/// clauses may be added between subsequent calls of solve().
+///
+//===----------------------------------------------------------------------===//
+#ifndef GAZER_SRC_SOLVERBITBLAST_SATSOLVER_H
+#define GAZER_SRC_SOLVERBITBLAST_SATSOLVER_H
+
+#include <llvm/ADT/ArrayRef.h>
+
+#include <memory>
+#include <vector>
+#include <cassert>
+#include <cstdint>
+
+namespace llvm {
+    class raw_ostream;
+} // end namespace llvm
+
+namespace gazer::bitblast
+{
+
+/// A literal is represented as (var << 1) | sign, where a set sign bit
+/// denotes a negated variable.
+using SatVar = unsigned;
+using SatLit = unsigned;
+
+constexpr SatLit UndefSatLit = ~0u;
+
+inline SatLit mkSatLit(SatVar var, bool negated = false) { return (var << 1) | (negated ? 1u : 0u); }
+inline SatVar satLitVar(SatLit lit) { return lit >> 1; }
+inline bool satLitSign(SatLit lit) { return (lit & 1u) != 0; }
+inline SatLit satLitNeg(SatLit lit) { return lit ^ 1u; }
+
+/// Observes the resolution steps performed by the solver.
+///
+/// When a tracer is installed, each clause carries a label. Original clauses
+/// are labeled by the client, while the label of a derived clause is computed
+/// by folding resolve() over the resolution steps of its derivation. This
+/// is sufficient to compute proof-based interpolants without storing the
+/// resolution proof itself.
+class SatProofTracer
+{
+public:
+    /// Returns the label of the resolvent of two clauses labeled \p lhs and
+    /// \p rhs on the variable \p pivot.
+    virtual unsigned resolve(unsigned lhs, unsigned rhs, SatVar pivot) = 0;
+
+    virtual ~SatProofTracer() = default;
+};
+
+/// Three-valued truth value of a variable or literal.
+enum class LBool : uint8_t
+{
+    False = 0,
+    True  = 1,
+    Undef = 2
+};
+
+class SatSolver
+{
+    struct Clause
+    {
+        std::vector<SatLit> lits;
+        bool learnt;
+        bool deleted = false;
+        double activity = 0.0;
+        unsigned label;
+
+        Clause(llvm::ArrayRef<SatLit> literals, bool isLearnt, unsigned label = 0)
+            : lits(literals.begin(), literals.end()), learnt(isLearnt), label(label)
+        {}
+    };
+
+    struct Watcher
+    {
+        Clause* clause;
+        SatLit blocker;
+    };
+
+    /// Binary max-heap of variables, ordered by their activity.
+    class VarOrderHeap
+    {
+    public:
+        explicit VarOrderHeap(const std::vector<double>& activity)
+            : mActivity(activity)
+        {}
+
+        bool empty() const { return mHeap.empty(); }
+        bool contains(SatVar v) const { return v < mIndices.size() && mIndices[v] >= 0; }
+
+        void insert(SatVar v);
+        SatVar removeMax();
+        void increased(SatVar v) { percolateUp(mIndices[v]); }
+        void clear();
+
+    private:
+        bool lessThan(SatVar a, SatVar b) const { return mActivity[a] > mActivity[b]; }
+        void percolateUp(int i);
+        void percolateDown(int i);
+
+    private:
+        const std::vector<double>& mActivity;
+        std::vector<SatVar> mHeap;
+        std::vector<int> mIndices;
+    };
+
+public:
+    enum SatResult
+    {
+        Sat,
+        Unsat,
+        Unknown
+    };
+
+    struct Statistics
+    {
+        uint64_t Conflicts = 0;
+        uint64_t Decisions = 0;
+        uint64_t Propagations = 0;
+        uint64_t Restarts = 0;
+        uint64_t LearntLiterals = 0;
+        uint64_t DeletedClauses = 0;
+        uint64_t Solves = 0;
+    };
+
+public:
+    SatSolver();
+
+    SatSolver(const SatSolver&) = delete;
+    SatSolver& operator=(const SatSolver&) = delete;
+
+    /// Creates a new variable and returns its index.
+    SatVar newVar();
+
+    /// Installs a proof tracer. Must be called before adding any clauses.
+    /// Solving with assumptions is not supported while tracing.
+    void setProofTracer(SatProofTracer* tracer)
+    {
+        assert(mClauses.empty() && mTrail.empty() && "Tracing must be enabled on an empty solver!");
+        mTracer = tracer;
+    }
+
+    /// Adds a clause to the problem. Returns false if the clause set became
+    /// trivially unsatisfiable. The label is only used when tracing.
+    bool addClause(llvm::ArrayRef<SatLit> lits, unsigned label = 0);
+
+    /// Solves the current clause set under the given assumptions.
+    SatResult solve(llvm::ArrayRef<SatLit> assumptions = {});
+
+    /// Returns the subset of the assumptions responsible for the last
+    /// unsatisfiable solve() call. The set is empty if the clause set is
+    /// unsatisfiable regardless of the assumptions.
+    llvm::ArrayRef<SatLit> getFailedAssumptions() const { return mFailedAssumptions; }
+
+    /// Returns the value of \p var in the last satisfying assignment.
+    LBool getModelValue(SatVar var) const {
+        return var < mModel.size() ? mModel[var] : LBool::Undef;
+    }
+
+    bool isOkay() const { return mOk; }
+
+    /// Returns the label of the empty clause, derived by the last
+    /// unsatisfiable solve() call while tracing.
+    unsigned getFinalLabel() const
+    {
+        assert(mTracer != nullptr && !mOk && "The empty clause was not derived!");
+        return mFinalLabel;
+    }
+
+    size_t getNumVars() const { return mAssigns.size(); }
+    size_t getNumClauses() const { return mClauses.size(); }
+    size_t getNumLearnts() const { return mLearnts.size(); }
+
+    const Statistics& getStatistics() const { return mStats; }
+    void printStats(llvm::raw_ostream& os) const;
+
+private:
+    LBool value(SatLit lit) const
+    {
+        LBool val = mAssigns[satLitVar(lit)];
+        if (val == LBool::Undef) {
+            return LBool::Undef;
+        }
+
+        return (val == LBool::True) != satLitSign(lit) ? LBool::True : LBool::False;
+    }
+
+    unsigned decisionLevel() const { return mTrailLim.size(); }
+
+    void attachClause(Clause* clause);
+    void enqueue(SatLit lit, Clause* reason);
+    unsigned resolveRootLits(unsigned label, llvm::ArrayRef<SatLit> lits, size_t begin = 0);
+    unsigned traceMinimization(unsigned label, llvm::ArrayRef<SatLit> learnt, size_t removedBegin);
+    Clause* propagate();
+    void analyze(Clause* conflict, std::vector<SatLit>& learnt, unsigned& backtrackLevel, unsigned& label);
+    bool isRedundant(SatLit lit) const;
+    void analyzeFinal(SatLit failed);
+    void cancelUntil(unsigned level);
+    SatLit pickBranchLit();
+    SatResult search(int64_t conflictLimit, llvm::ArrayRef<SatLit> assumptions);
+    void reduceLearnts();
+    bool isLocked(const Clause* clause) const;
+
+    void bumpVarActivity(SatVar v);
+    void bumpClauseActivity(Clause* clause);
+    void decayActivities();
+
+private:
+    bool mOk = true;
+
+    // Clause database
+    std::vector<std::unique_ptr<Clause>> mClauses;
+    std::vector<std::unique_ptr<Clause>> mLearnts;
+    std::vector<std::vector<Watcher>> mWatches;
+
+    // Assignment
+    std::vector<LBool> mAssigns;
+    std::vector<unsigned> mLevels;
+    std::vector<Clause*> mReasons;
+    std::vector<bool> mPolarity;
+    std::vector<SatLit> mTrail;
+    std::vector<unsigned> mTrailLim;
+    size_t mQueueHead = 0;
+
+    // Heuristics
+    std::vector<double> mActivity;
+    VarOrderHeap mOrder;
+    double mVarInc = 1.0;
+    double mClauseInc = 1.0;
+    double mMaxLearnts = 0.0;
+
+    // Conflict analysis scratch space
+    std::vector<char> mSeen;
+    std::vector<SatLit> mLearntClause;
+
+    std::vector<LBool> mModel;
+    std::vector<SatLit> mFailedAssumptions;
+    Statistics mStats;
+
+    // Proof tracing
+    SatProofTracer* mTracer = nullptr;
+    std::vector<unsigned> mUnitLabels;
+    std::vector<SatLit> mRootLits;
+    unsigned mFinalLabel = 0;
+};
+
+} // end namespace gazer::bitblast
+
+#endif
@@ -22,13 +22,23 @@
 
 #include <llvm/ADT/APFloat.h>
 #include <llvm/ADT/APSInt.h>
+#include <llvm/ADT/DenseMap.h>
 #include <llvm/Support/raw_ostream.h>
 
+#include <unordered_map>
+
 using namespace gazer;
 
 namespace
 {
 
+/// A lazily evaluated view of a Z3 model.
+///
+/// Values are only converted into literal expressions when requested and
+/// are cached afterwards: variable values are cached per variable, while
+/// other values are cached by the (hash-consed) Z3 node of the model value.
+/// Array reads are evaluated directly by Z3, therefore they do not require
+/// building the literal representation of the whole array.
 class Z3Model : public Model
 {
 public:
@@ -39,17 +49,24 @@ public:
     }
 
     ExprRef<AtomicExpr> evaluate(const ExprPtr& expr) override;
+    void evaluateAll(llvm::ArrayRef<ExprPtr> exprs, std::vector<ExprRef<AtomicExpr>>& results) override;
 
     void dump(llvm::raw_ostream& os) override {
         os << Z3_model_to_string(mZ3Context, mModel);
     }
 
     ~Z3Model() override {
+        // Release the cached handles before the model itself.
+        mValueCache.clear();
         Z3_model_dec_ref(mZ3Context, mModel);
     }
 
 private:
+    ExprRef<AtomicExpr> evalVariable(Variable& variable);
     ExprRef<AtomicExpr> evalAst(Z3AstHandle ast);
+    ExprRef<AtomicExpr> evalValue(Z3AstHandle value);
+    ExprRef<AtomicExpr> convertValue(Z3AstHandle value);
+
 private:
     ExprRef<BoolLiteralExpr> evalBoolean(Z3AstHandle ast);
     ExprRef<BvLiteralExpr> evalBv(Z3AstHandle ast, unsigned width);
@@ -57,6 +74,7 @@ private:
     ExprRef<IntLiteralExpr> evalInt(Z3AstHandle ast);
 
     ExprRef<AtomicExpr> evalConstantArray(Z3AstHandle ast, ArrayType& type);
+    ExprRef<AtomicExpr> evalFuncInterpArray(Z3AstHandle ast, ArrayType& type);
 
     FloatType::FloatPrecision getFloatPrecision(Z3Handle<Z3_sort> sort);
     Type& sortToType(Z3Handle<Z3_sort> sort);
@@ -67,6 +85,9 @@ private:
     Z3_model mModel;
     Z3DeclMapTy& mDecls;
     Z3ExprTransformer& mExprTransformer;
+
+    llvm::DenseMap<Variable*, ExprRef<AtomicExpr>> mVariableValues;
+    std::unordered_map<Z3AstHandle, ExprRef<AtomicExpr>> mValueCache;
 };
 
 } // end anonymous namespace
@@ -79,10 +100,71 @@ auto Z3Solver::getModel() -> std::unique_ptr<Model>
 
 auto Z3Model::evaluate(const ExprPtr& expr) -> ExprRef<AtomicExpr>
 {
+    if (auto varRef = llvm::dyn_cast<VarRefExpr>(expr)) {
+        return this->evalVariable(varRef->getVariable());
+    }
+
+    if (auto atomic = llvm::dyn_cast<AtomicExpr>(expr)) {
+        if (!atomic->isUndef()) {
+            return atomic;
+        }
+    }
+
     auto ast = mExprTransformer.walk(expr);
     return this->evalAst(ast);
 }
 
+void Z3Model::evaluateAll(llvm::ArrayRef<ExprPtr> exprs, std::vector<ExprRef<AtomicExpr>>& results)
+{
+    // Counterexample traces usually request the values of many variables,
+    // which are served from the variable cache or directly from the
+    // interpretation of their declarations. Other expressions are
+    // translated once and identical terms are only evaluated once.
+    std::unordered_map<ExprPtr, ExprRef<AtomicExpr>> evaluated;
+
+    results.reserve(results.size() + exprs.size());
+    for (const ExprPtr& expr : exprs) {
+        auto it = evaluated.find(expr);
+        if (it != evaluated.end()) {
+            results.push_back(it->second);
+            continue;
+        }
+
+        auto value = this->evaluate(expr);
+        evaluated.emplace(expr, value);
+        results.push_back(value);
+    }
+}
+
+auto Z3Model::evalVariable(Variable& variable) -> ExprRef<AtomicExpr>
+{
+    auto it = mVariableValues.find(&variable);
+    if (it != mVariableValues.end()) {
+        return it->second;
+    }
+
+    ExprRef<AtomicExpr> result;
+
+    // If the variable has an interpretation in the model, we can avoid
+    // the translation and evaluation of its reference expression.
+    auto decl = mDecls.get(&variable);
+    if (decl) {
+        Z3_ast interp = Z3_model_get_const_interp(mZ3Context, mModel, *decl);
+        if (interp != nullptr) {
+            result = this->evalValue(Z3AstHandle(mZ3Context, interp));
+        }
+    }
+
+    if (result == nullptr) {
+        // The variable is not present in the model (or was not part of any
+        // assertion), let the model completion decide its value.
+        result = this->evalAst(mExprTransformer.walk(variable.getRefExpr()));
+    }
+
+    mVariableValues[&variable] = result;
+    return result;
+}
+
 auto Z3Model::evalAst(Z3AstHandle ast) -> ExprRef<AtomicExpr>
 {
     Z3_ast resultAst;
@@ -90,24 +172,68 @@ auto Z3Model::evalAst(Z3AstHandle ast) -> ExprRef<AtomicExpr>
     bool success = Z3_model_eval(mZ3Context, mModel, ast, true, &resultAst);
     assert(success);
 
-    Z3AstHandle result(mZ3Context, resultAst);
-    auto sort = Z3Handle<Z3_sort>(mZ3Context, Z3_get_sort(mZ3Context, result));
+    return this->convertValue(Z3AstHandle(mZ3Context, resultAst));
+}
+
+auto Z3Model::evalValue(Z3AstHandle value) -> ExprRef<AtomicExpr>
+{
+    // Numerals, boolean constants and arrays are already values within the
+    // model, they do not need another evaluation round.
+    auto sort = Z3Handle<Z3_sort>(mZ3Context, Z3_get_sort(mZ3Context, value));
+    switch (Z3_get_sort_kind(mZ3Context, sort)) {
+        case Z3_BOOL_SORT:
+            if (Z3_get_bool_value(mZ3Context, value) != Z3_L_UNDEF) {
+                return this->convertValue(value);
+            }
+            break;
+        case Z3_INT_SORT:
+        case Z3_BV_SORT:
+            if (Z3_is_numeral_ast(mZ3Context, value)) {
+                return this->convertValue(value);
+            }
+            break;
+        case Z3_ARRAY_SORT:
+            return this->convertValue(value);
+        default:
+            break;
+    }
+
+    return this->evalAst(value);
+}
+
+auto Z3Model::convertValue(Z3AstHandle value) -> ExprRef<AtomicExpr>
+{
+    auto it = mValueCache.find(value);
+    if (it != mValueCache.end()) {
+        return it->second;
+    }
+
+    auto sort = Z3Handle<Z3_sort>(mZ3Context, Z3_get_sort(mZ3Context, value));
     Z3_sort_kind kind = Z3_get_sort_kind(mZ3Context, sort);
 
+    ExprRef<AtomicExpr> result;
     switch (kind) {
         case Z3_BOOL_SORT:
-            return this->evalBoolean(result);
+            result = this->evalBoolean(value);
+            break;
         case Z3_INT_SORT:
-            return this->evalInt(result);
+            result = this->evalInt(value);
+            break;
         case Z3_BV_SORT:
-            return this->evalBv(result, Z3_get_bv_sort_size(mZ3Context, sort));
+            result = this->evalBv(value, Z3_get_bv_sort_size(mZ3Context, sort));
+            break;
         case Z3_FLOATING_POINT_SORT:
-            return this->evalFloat(result, this->getFloatPrecision(sort));
+            result = this->evalFloat(value, this->getFloatPrecision(sort));
+            break;
         case Z3_ARRAY_SORT:
-            return this->evalConstantArray(result, llvm::cast<ArrayType>(this->sortToType(sort)));
+            result = this->evalConstantArray(value, llvm::cast<ArrayType>(this->sortToType(sort)));
+            break;
+        default:
+            llvm_unreachable("Unknown Z3 sort!");
     }
 
-    llvm_unreachable("Unknown Z3 sort!");
+    mValueCache.emplace(value, result);
+    return result;
 }
 
 auto Z3Model::evalBoolean(Z3AstHandle ast) -> ExprRef<BoolLiteralExpr> 
@@ -161,47 +287,119 @@ auto Z3Model::evalFloat(Z3AstHandle ast, FloatType::FloatPrecision prec)
 
 auto Z3Model::evalConstantArray(Z3AstHandle ast, ArrayType& type) -> ExprRef<AtomicExpr>
 {
-    auto kind = Z3_get_ast_kind(mZ3Context, ast);
-    if (kind == Z3_APP_AST) {
-        Z3_app app = Z3_to_app(mZ3Context, ast);
-        Z3Handle<Z3_func_decl> decl(mZ3Context, Z3_get_app_decl(mZ3Context, app));
+    if (Z3_get_ast_kind(mZ3Context, ast) != Z3_APP_AST) {
+        return UndefExpr::Get(type);
+    }
 
-        auto declKind = Z3_get_decl_kind(mZ3Context, decl);
-        ArrayLiteralExpr::Builder builder(type);
+    if (Z3_is_as_array(mZ3Context, ast)) {
+        return this->evalFuncInterpArray(ast, type);
+    }
 
-        while (declKind == Z3_OP_STORE) {
-            Z3AstHandle index(mZ3Context, Z3_get_app_arg(mZ3Context, app, 1));
-            Z3AstHandle value(mZ3Context, Z3_get_app_arg(mZ3Context, app, 2));
+    Z3_app app = Z3_to_app(mZ3Context, ast);
+    Z3Handle<Z3_func_decl> decl(mZ3Context, Z3_get_app_decl(mZ3Context, app));
+    auto declKind = Z3_get_decl_kind(mZ3Context, decl);
 
-            ast = Z3AstHandle(mZ3Context, Z3_get_app_arg(mZ3Context, app, 0));
-            app = Z3_to_app(mZ3Context, ast);
-            decl = Z3Handle<Z3_func_decl>(mZ3Context, Z3_get_app_decl(mZ3Context, app));
-            declKind = Z3_get_decl_kind(mZ3Context, decl);
+    // Stores are visited from the outermost one, but inner stores must not
+    // overwrite the values of the outer ones, so they are added in reverse.
+    std::vector<std::pair<ExprRef<AtomicExpr>, ExprRef<AtomicExpr>>> stores;
 
-            auto indexExpr = this->evalAst(index);
-            auto valueExpr = this->evalAst(value);
+    while (declKind == Z3_OP_STORE) {
+        Z3AstHandle index(mZ3Context, Z3_get_app_arg(mZ3Context, app, 1));
+        Z3AstHandle value(mZ3Context, Z3_get_app_arg(mZ3Context, app, 2));
 
-            if (!llvm::isa<LiteralExpr>(indexExpr) || !llvm::isa<LiteralExpr>(valueExpr)) {
-                // Something went wrong here, return an Undef expression
-                UndefExpr::Get(type);
-            }
+        ast = Z3AstHandle(mZ3Context, Z3_get_app_arg(mZ3Context, app, 0));
+        app = Z3_to_app(mZ3Context, ast);
+        decl = Z3Handle<Z3_func_decl>(mZ3Context, Z3_get_app_decl(mZ3Context, app));
+        declKind = Z3_get_decl_kind(mZ3Context, decl);
 
-            builder.addValue(llvm::cast<LiteralExpr>(indexExpr), llvm::cast<LiteralExpr>(valueExpr));
+        auto indexExpr = this->evalValue(index);
+        auto valueExpr = this->evalValue(value);
+
+        if (!llvm::isa<LiteralExpr>(indexExpr) || !llvm::isa<LiteralExpr>(valueExpr)) {
+            // Something went wrong here, return an Undef expression
+            return UndefExpr::Get(type);
+        }
+
+        stores.emplace_back(indexExpr, valueExpr);
+    }
+
+    ArrayLiteralExpr::Builder builder(type);
+    for (auto it = stores.rbegin(), ie = stores.rend(); it != ie; ++it) {
+        builder.addValue(llvm::cast<LiteralExpr>(it->first), llvm::cast<LiteralExpr>(it->second));
+    }
+
+    if (declKind == Z3_OP_CONST_ARRAY) {
+        Z3AstHandle defaultValue(mZ3Context, Z3_get_app_arg(mZ3Context, app, 0));
+        auto defaultExpr = this->evalValue(defaultValue);
+        if (auto lit = llvm::dyn_cast<LiteralExpr>(defaultExpr)) {
+            builder.setDefault(lit);
         }
-        
-        if (declKind == Z3_OP_CONST_ARRAY) {
-            Z3AstHandle defaultValue(mZ3Context, Z3_get_app_arg(mZ3Context, app, 0));
-            auto defaultExpr = this->evalAst(defaultValue);
-            if (auto lit = llvm::dyn_cast<LiteralExpr>(defaultExpr)) {
-                builder.setDefault(lit);
+    } else if (Z3_is_as_array(mZ3Context, ast)) {
+        // Stores on top of a function interpretation
+        auto base = this->evalFuncInterpArray(ast, type);
+        if (auto baseLit = llvm::dyn_cast<ArrayLiteralExpr>(base)) {
+            ArrayLiteralExpr::Builder merged(type);
+            for (auto& [index, value] : baseLit->getMap()) {
+                merged.addValue(index, value);
             }
+            for (auto it = stores.rbegin(), ie = stores.rend(); it != ie; ++it) {
+                merged.addValue(llvm::cast<LiteralExpr>(it->first), llvm::cast<LiteralExpr>(it->second));
+            }
+            if (baseLit->hasDefault()) {
+                merged.setDefault(baseLit->getDefault());
+            }
+
+            return merged.build();
         }
+    }
+
+    return builder.build();
+}
 
-        return builder.build();
+auto Z3Model::evalFuncInterpArray(Z3AstHandle ast, ArrayType& type) -> ExprRef<AtomicExpr>
+{
+    Z3Handle<Z3_func_decl> func(mZ3Context, Z3_get_as_array_func_decl(mZ3Context, ast));
+    Z3_func_interp interp = Z3_model_get_func_interp(mZ3Context, mModel, func);
+    if (interp == nullptr) {
+        return UndefExpr::Get(type);
     }
 
+    Z3_func_interp_inc_ref(mZ3Context, interp);
+
+    ArrayLiteralExpr::Builder builder(type);
+    bool valid = true;
+
+    unsigned numEntries = Z3_func_interp_get_num_entries(mZ3Context, interp);
+    for (unsigned i = 0; i < numEntries && valid; ++i) {
+        Z3_func_entry entry = Z3_func_interp_get_entry(mZ3Context, interp, i);
+        Z3_func_entry_inc_ref(mZ3Context, entry);
+
+        auto indexExpr = this->evalValue(Z3AstHandle(mZ3Context, Z3_func_entry_get_arg(mZ3Context, entry, 0)));
+        auto valueExpr = this->evalValue(Z3AstHandle(mZ3Context, Z3_func_entry_get_value(mZ3Context, entry)));
+
+        if (llvm::isa<LiteralExpr>(indexExpr) && llvm::isa<LiteralExpr>(valueExpr)) {
+            builder.addValue(llvm::cast<LiteralExpr>(indexExpr), llvm::cast<LiteralExpr>(valueExpr));
+        } else {
+            valid = false;
+        }
+
+        Z3_func_entry_dec_ref(mZ3Context, entry);
+    }
+
+    if (valid) {
+        auto defaultExpr = this->evalValue(Z3AstHandle(mZ3Context, Z3_func_interp_get_else(mZ3Context, interp)));
+        if (auto lit = llvm::dyn_cast<LiteralExpr>(defaultExpr)) {
+            builder.setDefault(lit);
+        }
+    }
+
+    Z3_func_interp_dec_ref(mZ3Context, interp);
+
+    if (!valid) {
+        return UndefExpr::Get(type);
+    }
 
-    return nullptr;
+    return builder.build();
 }
 
 auto Z3Model::getFloatPrecision(Z3Handle<Z3_sort> sort) -> FloatType::FloatPrecision
@@ -37,7 +37,7 @@ namespace
 
 // Z3Solver implementation
 //===----------------------------------------------------------------------===//
-Z3Solver::Z3Solver(GazerContext& context)
+Z3Solver::Z3Solver(GazerContext& context, Z3SolverProfile profile)
     : Solver(context), mTransformer(mZ3Context, mTmpCount, mCache, mDecls)
 {
     mConfig = Z3_mk_config();
@@ -51,15 +51,85 @@ Z3Solver::Z3Solver(GazerContext& context)
         }
     }
 
+    // Tactic-based solvers only track assumptions if unsat cores are requested.
+    if (profile == Z3SolverProfile::QF_ABV || profile == Z3SolverProfile::ArrayElim) {
+        Z3_set_param_value(mConfig, "unsat_core", "true");
+    }
+
     mZ3Context = Z3_mk_context_rc(mConfig);
-    mSolver = Z3_mk_solver(mZ3Context);
+    mSolver = this->createSolverForProfile(profile);
     Z3_solver_inc_ref(mZ3Context, mSolver);
 }
 
+Z3_solver Z3Solver::createSolverForProfile(Z3SolverProfile profile)
+{
+    // Tactics are reference counted, keep them alive until the solver is built.
+    std::vector<Z3_tactic> tactics;
+    auto track = [&tactics, this](Z3_tactic tactic) {
+        Z3_tactic_inc_ref(mZ3Context, tactic);
+        tactics.push_back(tactic);
+        return tactic;
+    };
+    auto mkTactic = [&track, this](const char* name) {
+        return track(Z3_mk_tactic(mZ3Context, name));
+    };
+    auto andThen = [&track, this](std::initializer_list<Z3_tactic> list) {
+        Z3_tactic result = *list.begin();
+        for (auto it = std::next(list.begin()); it != list.end(); ++it) {
+            result = track(Z3_tactic_and_then(mZ3Context, result, *it));
+        }
+        return result;
+    };
+
+    Z3_solver solver;
+    switch (profile) {
+        case Z3SolverProfile::Default:
+            return Z3_mk_solver(mZ3Context);
+        case Z3SolverProfile::Incremental:
+            return Z3_mk_simple_solver(mZ3Context);
+        case Z3SolverProfile::QF_ABV: {
+            // Bit-blasting is only applicable if no arrays remain after pre-processing.
+            Z3_probe isQfBv = Z3_mk_probe(mZ3Context, "is-qfbv");
+            Z3_probe_inc_ref(mZ3Context, isQfBv);
+            Z3_tactic solve = track(Z3_tactic_cond(
+                mZ3Context, isQfBv, andThen({ mkTactic("bit-blast"), mkTactic("sat") }), mkTactic("smt")
+            ));
+            Z3_probe_dec_ref(mZ3Context, isQfBv);
+
+            solver = Z3_mk_solver_from_tactic(mZ3Context, andThen({
+                mkTactic("simplify"), mkTactic("propagate-values"), mkTactic("solve-eqs"), solve
+            }));
+            break;
+        }
+        case Z3SolverProfile::ArrayElim: {
+            Z3_params params = Z3_mk_params(mZ3Context);
+            Z3_params_inc_ref(mZ3Context, params);
+            Z3_params_set_bool(mZ3Context, params, Z3_mk_string_symbol(mZ3Context, "expand_select_store"), true);
+            Z3_params_set_bool(mZ3Context, params, Z3_mk_string_symbol(mZ3Context, "expand_store_eq"), true);
+            Z3_tactic simplify = track(Z3_tactic_using_params(mZ3Context, mkTactic("simplify"), params));
+            Z3_params_dec_ref(mZ3Context, params);
+
+            solver = Z3_mk_solver_from_tactic(mZ3Context, andThen({
+                simplify, mkTactic("solve-eqs"), mkTactic("elim-uncnstr"), mkTactic("smt")
+            }));
+            break;
+        }
+        default:
+            llvm_unreachable("Unknown Z3 solver profile!");
+    }
+
+    for (Z3_tactic tactic : tactics) {
+        Z3_tactic_dec_ref(mZ3Context, tactic);
+    }
+
+    return solver;
+}
+
 Z3Solver::~Z3Solver()
 {
     mCache.clear();
     mDecls.clear();
+    mAssumptions.clear();
     mTransformer.clear();
     Z3_solver_dec_ref(mZ3Context, mSolver);
     Z3_del_context(mZ3Context);
@@ -68,8 +138,45 @@ Z3Solver::~Z3Solver()
 
 Solver::SolverStatus Z3Solver::run()
 {
-    Z3_lbool result =  Z3_solver_check(mZ3Context, mSolver);
+    mAssumptions.clear();
+    return this->getStatus(Z3_solver_check(mZ3Context, mSolver));
+}
 
+Solver::SolverStatus Z3Solver::runWithAssumptions(llvm::ArrayRef<ExprPtr> assumptions)
+{
+    mAssumptions.clear();
+
+    std::vector<Z3_ast> asts;
+    asts.reserve(assumptions.size());
+    for (const ExprPtr& assumption : assumptions) {
+        assert(assumption->getType().isBoolType() && "Assumptions must be boolean!");
+        auto ast = mTransformer.walk(assumption);
+        asts.push_back(ast.getNode());
+        mAssumptions.emplace_back(std::move(ast), assumption);
+    }
+
+    return this->getStatus(Z3_solver_check_assumptions(mZ3Context, mSolver, asts.size(), asts.data()));
+}
+
+void Z3Solver::getUnsatCore(std::vector<ExprPtr>& core)
+{
+    Z3_ast_vector unsatCore = Z3_solver_get_unsat_core(mZ3Context, mSolver);
+    Z3_ast_vector_inc_ref(mZ3Context, unsatCore);
+
+    for (unsigned i = 0, e = Z3_ast_vector_size(mZ3Context, unsatCore); i < e; ++i) {
+        Z3_ast ast = Z3_ast_vector_get(mZ3Context, unsatCore, i);
+        auto it = std::find_if(mAssumptions.begin(), mAssumptions.end(), [ast](auto& entry) {
+            return entry.first.getNode() == ast;
+        });
+        assert(it != mAssumptions.end() && "Unsat core elements must be assumptions!");
+        core.push_back(it->second);
+    }
+
+    Z3_ast_vector_dec_ref(mZ3Context, unsatCore);
+}
+
+Solver::SolverStatus Z3Solver::getStatus(Z3_lbool result)
+{
     switch (result) {
         case Z3_L_FALSE: return SolverStatus::UNSAT;
         case Z3_L_TRUE:
@@ -93,6 +200,7 @@ void Z3Solver::reset()
 {
     mCache.clear();
     mDecls.clear();
+    mAssumptions.clear();
     Z3_solver_reset(mZ3Context, mSolver);
 }
 
@@ -439,5 +547,29 @@ Z3AstHandle Z3ExprTransformer::translateLiteral(const ExprRef<LiteralExpr>& expr
 
 std::unique_ptr<Solver> Z3SolverFactory::createSolver(GazerContext& context)
 {
-    return std::unique_ptr<Solver>(new Z3Solver(context));
+    return std::unique_ptr<Solver>(new Z3Solver(context, mProfile));
+}
+
+llvm::StringRef gazer::getZ3SolverProfileName(Z3SolverProfile profile)
+{
+    switch (profile) {
+        case Z3SolverProfile::Default: return "default";
+        case Z3SolverProfile::Incremental: return "incremental";
+        case Z3SolverProfile::QF_ABV: return "qf-abv";
+        case Z3SolverProfile::ArrayElim: return "array-elim";
+    }
+
+    llvm_unreachable("Unknown Z3 solver profile!");
+}
+
+llvm::ArrayRef<Z3SolverProfile> gazer::getAllZ3SolverProfiles()
+{
+    static const Z3SolverProfile Profiles[] = {
+        Z3SolverProfile::Default,
+        Z3SolverProfile::Incremental,
+        Z3SolverProfile::QF_ABV,
+        Z3SolverProfile::ArrayElim
+    };
+
+    return Profiles;
 }
@@ -413,11 +413,15 @@ protected:
 class Z3Solver : public Solver
 {
 public:
-    explicit Z3Solver(GazerContext& context);
+    explicit Z3Solver(GazerContext& context, Z3SolverProfile profile = Z3SolverProfile::Default);
 
     void printStats(llvm::raw_ostream& os) override;
     void dump(llvm::raw_ostream& os) override;
     SolverStatus run() override;
+
+    bool supportsAssumptions() const override { return true; }
+    SolverStatus runWithAssumptions(llvm::ArrayRef<ExprPtr> assumptions) override;
+    void getUnsatCore(std::vector<ExprPtr>& core) override;
     
     std::unique_ptr<Model> getModel() override;
 
@@ -431,6 +435,10 @@ public:
 protected:
     void addConstraint(ExprPtr expr) override;
 
+private:
+    SolverStatus getStatus(Z3_lbool result);
+    Z3_solver createSolverForProfile(Z3SolverProfile profile);
+
 protected:
     Z3_config mConfig;
     Z3_context mZ3Context;
@@ -439,6 +447,7 @@ protected:
     Z3CacheMapTy mCache;
     Z3DeclMapTy mDecls;
     Z3ExprTransformer mTransformer;
+    std::vector<std::pair<Z3AstHandle, ExprPtr>> mAssumptions;
 };
 
 } // end namespace gazer
@@ -67,7 +67,7 @@ std::unique_ptr<VerificationResult> BoundedModelCheckerImpl::createFailResult()
     std::unique_ptr<Trace> trace;
     if (mSettings.trace) {
         std::vector<Location*> states;
-        std::vector<std::vector<VariableAssignment>> actions;
+        std::vector<AssignTransition*> edges;
 
         bmc::BmcCex cex{mError, *mRoot, *model, mPredecessors};
         for (auto state : cex) {
@@ -85,8 +85,25 @@ std::unique_ptr<VerificationResult> BoundedModelCheckerImpl::createFailResult()
             auto assignEdge = llvm::dyn_cast<AssignTransition>(edge);
             assert(assignEdge != nullptr && "BMC traces must contain only assign transitions!");
 
+            edges.push_back(assignEdge);
+        }
+
+        // Evaluate the assigned values of the whole path in a single batch.
+        std::vector<ExprPtr> assignedVars;
+        for (AssignTransition* edge : edges) {
+            for (const VariableAssignment& assignment : *edge) {
+                assignedVars.push_back(assignment.getVariable()->getRefExpr());
+            }
+        }
+
+        std::vector<ExprRef<AtomicExpr>> assignedValues;
+        model->evaluateAll(assignedVars, assignedValues);
+
+        std::vector<std::vector<VariableAssignment>> actions;
+        auto valueIt = assignedValues.begin();
+        for (AssignTransition* edge : edges) {
             std::vector<VariableAssignment> traceAction;
-            for (const VariableAssignment& assignment : *assignEdge) {
+            for (const VariableAssignment& assignment : *edge) {
                 Variable* variable = assignment.getVariable();
                 Variable* origVariable = mInlinedVariables.lookup(assignment.getVariable());
                 if (origVariable == nullptr) {
@@ -94,10 +111,8 @@ std::unique_ptr<VerificationResult> BoundedModelCheckerImpl::createFailResult()
                     origVariable = variable;
                 }
 
-                ExprRef<AtomicExpr> value;
-                if (auto lit = model->evaluate(assignment.getVariable()->getRefExpr())) {
-                    value = lit;
-                } else {
+                ExprRef<AtomicExpr> value = *valueIt++;
+                if (value == nullptr) {
                     value = UndefExpr::Get(variable->getType());
                 }
 
@@ -279,6 +279,11 @@ auto BoundedModelCheckerImpl::check() -> std::unique_ptr<VerificationResult>
                     return this->createFailResult();
                 }
 
+                if (status == Solver::UNKNOWN) {
+                    llvm::outs() << "  Under-approximated formula is UNKNOWN.\n";
+                    return VerificationResult::CreateUnknown();
+                }
+
                 this->pop();
             }
 
@@ -319,15 +324,38 @@ auto BoundedModelCheckerImpl::check() -> std::unique_ptr<VerificationResult>
             // Now try to over-approximate.
             llvm::outs() << "  Over-approximating.\n";
 
+            // If the solver supports unsat cores, blocked calls are tracked
+            // through a boolean variable assumed to be false. Blocked calls
+            // which are not present in the unsat core are irrelevant for the
+            // proof, thus they need not be considered in further iterations.
+            bool useCores = mSolver->supportsAssumptions();
+            std::vector<ExprPtr> assumptions;
+            std::unordered_map<ExprPtr, CallTransition*> blockedCalls;
+
             mOpenCalls.clear();
             for (auto& [call, info] : mCalls) {
+                if (info.pruned) {
+                    info.overApprox = mExprBuilder.True();
+                    if (info.getCost() <= bound) {
+                        mOpenCalls.insert(call);
+                    }
+                    continue;
+                }
+
                 if (info.getCost() > bound) {
                     LLVM_DEBUG(
                         llvm::dbgs() << "  Skipping " << *call
                         << ": inline cost is greater than bound (" <<
                         info.getCost() << " > " << bound << ").\n"
                     );
-                    info.overApprox = mExprBuilder.False();
+                    if (useCores) {
+                        info.overApprox = this->getCallTracker(info);
+                        ExprPtr blocking = mExprBuilder.Not(info.overApprox);
+                        assumptions.push_back(blocking);
+                        blockedCalls[blocking] = call;
+                    } else {
+                        info.overApprox = mExprBuilder.False();
+                    }
                     ++numUnhandledCallSites;
                     continue;
                 }
@@ -351,7 +379,7 @@ auto BoundedModelCheckerImpl::check() -> std::unique_ptr<VerificationResult>
                 mSolver->dump(llvm::errs());
             }
 
-            status = this->runSolver();
+            status = this->runSolver(assumptions);
 
             if (status == Solver::SAT) {
                 llvm::outs() << "      Over-approximated formula is SAT.\n";
@@ -361,7 +389,14 @@ auto BoundedModelCheckerImpl::check() -> std::unique_ptr<VerificationResult>
                 auto model = mSolver->getModel();
 
                 llvm::SmallVector<CallTransition*, 16> callsToInline;
-                this->findOpenCallsInCex(*model, callsToInline);
+                llvm::SmallVector<CallTransition*, 4> prunedCalls;
+                this->findOpenCallsInCex(*model, callsToInline, prunedCalls);
+
+                // Pruned calls above the bound which participate in the counterexample
+                // cannot be inlined yet, block them again.
+                for (CallTransition* call : prunedCalls) {
+                    mCalls[call].pruned = false;
+                }
 
                 llvm::outs() << "    Inlining calls...\n";
                 while (!callsToInline.empty()) {
@@ -398,6 +433,10 @@ auto BoundedModelCheckerImpl::check() -> std::unique_ptr<VerificationResult>
                 bottom = lca.second;
             } else if (status == Solver::UNSAT) {
                 llvm::outs() << "  Over-approximated formula is UNSAT.\n";
+                if (useCores && numUnhandledCallSites != 0) {
+                    numUnhandledCallSites = this->pruneIrrelevantCalls(blockedCalls);
+                }
+
                 if (numUnhandledCallSites == 0) {
                     // If we have no unhandled call sites,
                     // the program is guaranteed to be safe at this point.
@@ -429,7 +468,12 @@ auto BoundedModelCheckerImpl::check() -> std::unique_ptr<VerificationResult>
                 skipUnderApprox = true;
                 break;
             } else {
-                llvm_unreachable("Unknown solver status.");
+                // The solver gave up or could not decide the formula.
+                llvm::outs() << "  Over-approximated formula is UNKNOWN.\n";
+                mStats.NumEndLocs = mRoot->getNumLocations();
+                mStats.NumEndLocals = mRoot->getNumLocals();
+
+                return VerificationResult::CreateUnknown();
             }
         }
     }
@@ -476,22 +520,69 @@ auto BoundedModelCheckerImpl::findCommonCallAncestor(Location* fwd, Location* bw
     return { dom, pdom };
 }
 
-void BoundedModelCheckerImpl::findOpenCallsInCex(Model& model, llvm::SmallVectorImpl<CallTransition*>& callsInCex)
-{
+void BoundedModelCheckerImpl::findOpenCallsInCex(
+    Model& model,
+    llvm::SmallVectorImpl<CallTransition*>& callsInCex,
+    llvm::SmallVectorImpl<CallTransition*>& prunedCallsInCex
+) {
     auto cex = bmc::BmcCex{mError, *mRoot, model, mPredecessors};
 
     for (auto state : cex) {
         auto call = llvm::dyn_cast_or_null<CallTransition>(state.getOutgoingTransition());
-        if (call != nullptr && mOpenCalls.count(call) != 0) {
+        if (call == nullptr) {
+            continue;
+        }
+
+        if (mOpenCalls.count(call) != 0) {
             callsInCex.push_back(call);
-            if (callsInCex.size() == mOpenCalls.size()) {
-                // All possible calls were encountered, no point in iterating further.
-                break;
+        } else {
+            auto it = mCalls.find(call);
+            if (it != mCalls.end() && it->second.pruned) {
+                prunedCallsInCex.push_back(call);
             }
         }
     }
 }
 
+ExprPtr BoundedModelCheckerImpl::getCallTracker(CallInfo& info)
+{
+    if (info.tracker == nullptr) {
+        info.tracker = mSystem.getContext().createVariable(
+            "__gazer_bmc_call_" + std::to_string(mTmp++), BoolType::Get(mSystem.getContext())
+        );
+    }
+
+    return info.tracker->getRefExpr();
+}
+
+unsigned BoundedModelCheckerImpl::pruneIrrelevantCalls(
+    const std::unordered_map<ExprPtr, CallTransition*>& blockedCalls)
+{
+    std::vector<ExprPtr> core;
+    mSolver->getUnsatCore(core);
+
+    llvm::DenseSet<CallTransition*> relevant;
+    for (const ExprPtr& expr : core) {
+        auto it = blockedCalls.find(expr);
+        assert(it != blockedCalls.end() && "Unsat core elements must be blocked calls!");
+        relevant.insert(it->second);
+    }
+
+    unsigned numPruned = 0;
+    for (auto& [blocking, call] : blockedCalls) {
+        if (relevant.count(call) == 0) {
+            LLVM_DEBUG(llvm::dbgs() << "  Pruning irrelevant call " << *call << "\n");
+            mCalls[call].pruned = true;
+            ++numPruned;
+        }
+    }
+
+    mStats.NumPruned += numPruned;
+    llvm::outs() << "    Pruned " << numPruned << " irrelevant call sites.\n";
+
+    return relevant.size();
+}
+
 void BoundedModelCheckerImpl::inlineCallIntoRoot(
     CallTransition* call,
     llvm::DenseMap<Variable*, Variable*>& vmap,
@@ -674,11 +765,11 @@ void BoundedModelCheckerImpl::inlineCallIntoRoot(
     mRoot->disconnectEdge(call);
 }
 
-auto BoundedModelCheckerImpl::runSolver() -> Solver::SolverStatus
+auto BoundedModelCheckerImpl::runSolver(llvm::ArrayRef<ExprPtr> assumptions) -> Solver::SolverStatus
 {
     llvm::outs() << "    Running solver...\n";
     mTimer.start();
-    auto status = mSolver->run();
+    auto status = assumptions.empty() ? mSolver->run() : mSolver->runWithAssumptions(assumptions);
     mTimer.stop();
 
     llvm::outs() << "      Elapsed time: ";
@@ -696,6 +787,7 @@ void BoundedModelCheckerImpl::printStats(llvm::raw_ostream& os)
     llvm::format_provider<std::chrono::milliseconds>::format(mStats.SolverTime, os, "s");
     os << "\n";
     os << "Number of inlined procedures: " << mStats.NumInlined << "\n";
+    os << "Number of pruned call sites: " << mStats.NumPruned << "\n";
     os << "Number of locations on start: " << mStats.NumBeginLocs << "\n";
     os << "Number of locations on finish: " << mStats.NumEndLocs << "\n";
     os << "Number of variables on start: " << mStats.NumBeginLocals << "\n";
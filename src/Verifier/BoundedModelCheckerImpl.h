@@ -119,6 +119,14 @@ class BoundedModelCheckerImpl
         ExprPtr overApprox = nullptr;
         std::vector<Cfa*> callChain;
 
+        /// Boolean variable used to track the call in unsat cores.
+        Variable* tracker = nullptr;
+
+        /// True if the call was found irrelevant for the proof of the
+        /// over-approximated formula, thus it is over-approximated with
+        /// 'True' regardless of its inline cost.
+        bool pruned = false;
+
         unsigned getCost() const {
             return std::count(callChain.begin(), callChain.end(), callChain.back());            
         }
@@ -128,6 +136,7 @@ public:
     {
         std::chrono::milliseconds SolverTime{0};
         unsigned NumInlined = 0;
+        unsigned NumPruned = 0;
         unsigned NumBeginLocs = 0;
         unsigned NumEndLocs = 0;
         unsigned NumBeginLocals = 0;
@@ -164,7 +173,17 @@ private:
 
     std::function<size_t(Location*)> createLocNumberFunc();
 
-    void findOpenCallsInCex(Model& model, llvm::SmallVectorImpl<CallTransition*>& callsInCex);
+    void findOpenCallsInCex(
+        Model& model,
+        llvm::SmallVectorImpl<CallTransition*>& callsInCex,
+        llvm::SmallVectorImpl<CallTransition*>& prunedCallsInCex
+    );
+
+    ExprPtr getCallTracker(CallInfo& info);
+
+    /// Marks the blocked calls which are not present in the unsat core of the
+    /// last solver call as pruned. Returns the number of the remaining blocked calls.
+    unsigned pruneIrrelevantCalls(const std::unordered_map<ExprPtr, CallTransition*>& blockedCalls);
 
     std::unique_ptr<VerificationResult> createFailResult();
 
@@ -178,7 +197,7 @@ private:
         mSolver->pop();
     }
 
-    Solver::SolverStatus runSolver();
+    Solver::SolverStatus runSolver(llvm::ArrayRef<ExprPtr> assumptions = {});
 
 private:
     AutomataSystem& mSystem;
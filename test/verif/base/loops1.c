@@ -1,4 +1,6 @@
 // RUN: %bmc -bound 10 "%s" | FileCheck "%s"
+// RUN: %bmc -bound 10 -large-block-encoding "%s" | FileCheck "%s"
+// RUN: %bmc -bound 10 -solver=bitblast "%s" | FileCheck "%s"
 
 // CHECK: Verification {{(SUCCESSFUL|BOUND REACHED)}}
 extern int __VERIFIER_nondet_int(void);
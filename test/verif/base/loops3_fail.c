@@ -1,4 +1,5 @@
 // RUN: %bmc -bound 10 "%s" | FileCheck "%s"
+// RUN: %bmc -bound 10 -solver=bitblast "%s" | FileCheck "%s"
 
 // CHECK: Verification FAILED
 #include <assert.h>
@@ -1,4 +1,6 @@
 // RUN: %bmc -bound 10 "%s" | FileCheck "%s"
+// RUN: %bmc -bound 10 -cfa-threads=4 "%s" | FileCheck "%s"
+// RUN: %bmc -bound 10 -solver=bitblast "%s" | FileCheck "%s"
 
 // CHECK: Verification FAILED
 #include <assert.h>
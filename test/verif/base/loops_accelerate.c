@@ -0,0 +1,26 @@
+// RUN: %bmc -bound 1 -accelerate-loops "%s" | FileCheck "%s"
+
+// CHECK: Verification SUCCESSFUL
+#include <assert.h>
+
+extern int __VERIFIER_nondet_int(void);
+
+int main(void)
+{
+    int a[8];
+    int sum = 0;
+    int n = __VERIFIER_nondet_int();
+
+    for (int i = 0; i < 8; ++i) {
+        a[i] = 2 * i;
+    }
+
+    for (int i = 0; i < n; ++i) {
+        sum += 3;
+    }
+
+    assert(a[5] == 10);
+    assert(n <= 0 || sum == 3 * n);
+
+    return 0;
+}
@@ -1,4 +1,6 @@
 // RUN: %bmc "%s" | FileCheck "%s"
+// RUN: %bmc -inline=off -cfa-threads=4 "%s" | FileCheck "%s"
+// RUN: %bmc -solver=bitblast "%s" | FileCheck "%s"
 
 // CHECK: Verification {{(SUCCESSFUL|BOUND REACHED)}}
 
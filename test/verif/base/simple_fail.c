@@ -1,6 +1,13 @@
 // RUN: %bmc -bound 1 "%s" | FileCheck "%s"
+// RUN: %bmc -bound 1 -large-block-encoding "%s" | FileCheck "%s"
+// RUN: %bmc -bound 1 -time-pipeline-json="%t.json" "%s" | FileCheck "%s"
+// RUN: FileCheck "%s" --check-prefix=REPORT < "%t.json"
 
 // CHECK: Verification FAILED
+
+// REPORT: "name": "Clang compile and link"
+// REPORT: "name": "Module to automata transformation"
+// REPORT: "name": "Verification backend pass"
 #include <assert.h>
 
 int main(void)
@@ -0,0 +1,25 @@
+// RUN: %bmc -bound 1 "%s" | FileCheck "%s"
+// RUN: %bmc -bound 1 -no-slicing "%s" | FileCheck "%s" --check-prefix=NOSLICE
+
+// CHECK: Verification SUCCESSFUL
+// NOSLICE: Verification {{(SUCCESSFUL|BOUND REACHED)}}
+#include <assert.h>
+
+extern int __VERIFIER_nondet_int(void);
+extern void __VERIFIER_assume(int);
+
+int main(void)
+{
+    int x = __VERIFIER_nondet_int();
+    int sum[4] = { 0 };
+
+    __VERIFIER_assume(x > 0);
+
+    for (int i = 0; i < 100; ++i) {
+        sum[i % 4] += __VERIFIER_nondet_int();
+    }
+
+    assert(x != 0);
+
+    return sum[0];
+}
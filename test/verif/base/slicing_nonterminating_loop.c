@@ -0,0 +1,21 @@
+// RUN: %bmc -bound 2 "%s" | FileCheck "%s"
+
+// Loops which may not terminate must not be sliced away.
+// CHECK: Verification {{(SUCCESSFUL|BOUND REACHED)}}
+extern unsigned __VERIFIER_nondet_uint(void);
+extern void __VERIFIER_assume(int);
+extern void __VERIFIER_error(void);
+
+int main(void)
+{
+    unsigned x = __VERIFIER_nondet_uint();
+    __VERIFIER_assume(x % 2 == 1);
+
+    while (x != 0) {
+        x += 2;
+    }
+
+    __VERIFIER_error();
+
+    return 0;
+}
@@ -1,4 +1,7 @@
 // RUN: %bmc -bound 10 "%s" | FileCheck "%s"
+// RUN: %bmc -bound 10 -memory=regions -memory-word-cells "%s" | FileCheck "%s"
+// RUN: %bmc -bound 10 -memory-flatten-reads=16 "%s" | FileCheck "%s"
+// RUN: %bmc -bound 10 -solver=bitblast "%s" | FileCheck "%s"
 
 // CHECK: Verification {{(SUCCESSFUL|BOUND REACHED)}}
 int __VERIFIER_nondet_int(void);
@@ -1,4 +1,11 @@
 // RUN: %bmc -bound 10 "%s" | FileCheck "%s"
+// RUN: %bmc -bound 10 -memory=regions "%s" | FileCheck "%s"
+// RUN: %bmc -bound 10 -memory=alias-sets "%s" | FileCheck "%s"
+// RUN: %bmc -bound 10 -memory=regions -memory-word-cells "%s" | FileCheck "%s"
+// RUN: %bmc -bound 10 -memory-flatten-reads=16 "%s" | FileCheck "%s"
+// RUN: %bmc -bound 10 -memory-flatten-reads=1 "%s" | FileCheck "%s"
+// RUN: %bmc -bound 10 -memory-flatten-reads=16 -elim-vars=off "%s" | FileCheck "%s"
+// RUN: %bmc -bound 10 -solver=bitblast "%s" | FileCheck "%s"
 
 // CHECK: Verification FAILED
 int __VERIFIER_nondet_int(void);
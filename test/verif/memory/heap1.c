@@ -0,0 +1,40 @@
+// RUN: %bmc -bound 1 "%s" | FileCheck "%s"
+// RUN: %bmc -bound 1 -memory=regions "%s" | FileCheck "%s"
+// RUN: %bmc -bound 1 -memory=alias-sets "%s" | FileCheck "%s"
+// RUN: %bmc -bound 1 -memory-flatten-reads=16 "%s" | FileCheck "%s"
+// RUN: %bmc -bound 1 -memory-flatten-reads=16 -elim-vars=off "%s" | FileCheck "%s"
+
+// CHECK: Verification SUCCESSFUL
+#include <stdlib.h>
+
+int __VERIFIER_nondet_int(void);
+void __VERIFIER_error(void) __attribute__((__noreturn__));
+
+int* buffer;
+
+void init(int n)
+{
+    buffer = malloc(n * sizeof(int));
+    buffer[0] = 1;
+}
+
+int main(void)
+{
+    int n = __VERIFIER_nondet_int();
+    if (n <= 0 || n > 16) {
+        return 0;
+    }
+
+    init(n);
+
+    // Distinct allocations never overlap.
+    int* other = calloc(4, sizeof(int));
+    other[1] = 2;
+
+    if (buffer[0] != 1 || other[0] != 0) {
+        __VERIFIER_error();
+    }
+
+    free(other);
+    return 0;
+}
@@ -0,0 +1,26 @@
+// RUN: %bmc -bound 1 "%s" | FileCheck "%s"
+
+// CHECK: Verification SUCCESSFUL
+#include <stdlib.h>
+
+unsigned __VERIFIER_nondet_uint(void);
+void __VERIFIER_error(void) __attribute__((__noreturn__));
+
+int global = 1;
+
+int main(void)
+{
+    // Allocations too large for the heap must not wrap around into globals.
+    char* large = malloc(__VERIFIER_nondet_uint());
+    int* small = malloc(4 * sizeof(int));
+    if (large == NULL || small == NULL) {
+        return 0;
+    }
+
+    small[0] = 2;
+    if (global != 1) {
+        __VERIFIER_error();
+    }
+
+    return 0;
+}
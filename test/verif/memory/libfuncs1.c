@@ -0,0 +1,36 @@
+// RUN: %bmc -bound 1 "%s" | FileCheck "%s"
+// RUN: %bmc -bound 1 -memory=regions "%s" | FileCheck "%s"
+
+// CHECK: Verification SUCCESSFUL
+#include <string.h>
+
+int __VERIFIER_nondet_int(void);
+void __VERIFIER_error(void) __attribute__((__noreturn__));
+
+void make_symbolic(void* ptr);
+
+int main(void)
+{
+    char src[8];
+    char dst[8];
+    make_symbolic(src);
+    make_symbolic(dst);
+
+    memset(src, 'a', 4);
+    src[4] = '\0';
+
+    memcpy(dst, src, sizeof(src));
+    if (dst[0] != 'a' || dst[3] != 'a') {
+        __VERIFIER_error();
+    }
+
+    if (strlen(dst) != 4) {
+        __VERIFIER_error();
+    }
+
+    if (strcmp(src, dst) != 0) {
+        __VERIFIER_error();
+    }
+
+    return 0;
+}
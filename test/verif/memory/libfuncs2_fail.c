@@ -0,0 +1,29 @@
+// RUN: %bmc -bound 1 "%s" | FileCheck "%s"
+// RUN: %bmc -bound 1 -memory=regions "%s" | FileCheck "%s"
+
+// CHECK: Verification FAILED
+#include <string.h>
+
+int __VERIFIER_nondet_int(void);
+void __VERIFIER_error(void) __attribute__((__noreturn__));
+
+void make_symbolic(void* ptr);
+
+int main(void)
+{
+    int n = __VERIFIER_nondet_int();
+    char buf[8];
+    make_symbolic(buf);
+
+    if (n < 0 || n > 8) {
+        return 0;
+    }
+
+    // Only the first n bytes are overwritten.
+    memset(buf, 0, n);
+    if (buf[2] != 0) {
+        __VERIFIER_error();
+    }
+
+    return 0;
+}
@@ -0,0 +1,22 @@
+// RUN: %bmc -bound 1 -checks="memory-safety" "%s" | FileCheck "%s"
+
+// CHECK: Verification FAILED
+// CHECK: Invalid memory access
+#include <stdlib.h>
+
+int __VERIFIER_nondet_int(void);
+
+int main(void)
+{
+    int n = __VERIFIER_nondet_int();
+    if (n < 0 || n > 4) {
+        return 0;
+    }
+
+    // Writing buf[4] is out of bounds.
+    int* buf = malloc(4 * sizeof(int));
+    buf[n] = 1;
+
+    free(buf);
+    return 0;
+}
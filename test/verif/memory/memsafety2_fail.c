@@ -0,0 +1,20 @@
+// RUN: %bmc -bound 1 -checks="memory-safety" "%s" | FileCheck "%s"
+
+// CHECK: Verification FAILED
+// CHECK: Invalid memory access
+#include <stdlib.h>
+
+int __VERIFIER_nondet_int(void);
+
+int main(void)
+{
+    int* buf = malloc(4 * sizeof(int));
+    buf[0] = 1;
+
+    if (__VERIFIER_nondet_int()) {
+        free(buf);
+    }
+
+    // This is a use-after-free on one of the paths.
+    return buf[0];
+}
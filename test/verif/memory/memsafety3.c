@@ -0,0 +1,26 @@
+// RUN: %bmc -bound 1 -checks="memory-safety" "%s" | FileCheck "%s"
+
+// CHECK: Verification SUCCESSFUL
+#include <stdlib.h>
+
+int __VERIFIER_nondet_int(void);
+
+int values[8];
+
+int main(void)
+{
+    int n = __VERIFIER_nondet_int();
+    if (n < 0 || n >= 8) {
+        return 0;
+    }
+
+    values[n] = 1;
+
+    int* buf = calloc(n + 1, sizeof(int));
+    buf[n] = values[n];
+
+    int sum = buf[0];
+    free(buf);
+
+    return sum;
+}
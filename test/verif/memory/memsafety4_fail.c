@@ -0,0 +1,22 @@
+// RUN: %bmc -bound 1 -checks="memory-safety" "%s" | FileCheck "%s"
+
+// CHECK: Verification FAILED
+// CHECK: Invalid memory access
+#include <stdlib.h>
+
+int __VERIFIER_nondet_int(void);
+
+int main(void)
+{
+    int* a = malloc(4 * sizeof(int));
+    int* b = malloc(4 * sizeof(int));
+
+    // The freed object is only known at runtime.
+    int* p = __VERIFIER_nondet_int() ? a : b;
+    free(p);
+
+    a[0] = 1;
+    b[0] = 1;
+
+    return 0;
+}
@@ -0,0 +1,19 @@
+// RUN: %bmc -bound 1 -checks="memory-safety" "%s" | FileCheck "%s"
+
+// CHECK: Verification FAILED
+// CHECK: Invalid memory access
+#include <stdlib.h>
+
+int __VERIFIER_nondet_int(void);
+
+int main(void)
+{
+    int* buf = malloc(4 * sizeof(int));
+    free(buf);
+
+    if (__VERIFIER_nondet_int()) {
+        free(buf);
+    }
+
+    return 0;
+}
@@ -0,0 +1,22 @@
+// RUN: %bmc -bound 1 -checks="memory-safety" "%s" | FileCheck "%s"
+
+// CHECK: Verification FAILED
+// CHECK: Invalid memory access
+#include <stdlib.h>
+#include <string.h>
+
+int __VERIFIER_nondet_int(void);
+
+int main(void)
+{
+    char* buf = malloc(8);
+    int n = __VERIFIER_nondet_int();
+    if (n < 0) {
+        return 0;
+    }
+
+    // Overflows the buffer for n > 8.
+    memset(buf, 0, n);
+
+    return 0;
+}
@@ -0,0 +1,17 @@
+// RUN: %bmc -bound 1 -checks="memory-safety" "%s" | FileCheck "%s"
+
+// CHECK: Verification FAILED
+// CHECK: Invalid memory access
+#include <stdlib.h>
+
+int main(void)
+{
+    int* buf = malloc(4 * sizeof(int));
+    if (buf == 0) {
+        return 0;
+    }
+
+    free(buf + 1);
+
+    return 0;
+}
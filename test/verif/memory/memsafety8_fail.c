@@ -0,0 +1,17 @@
+// RUN: %bmc -bound 1 -checks="memory-safety" "%s" | FileCheck "%s"
+
+// CHECK: Verification FAILED
+// CHECK: Invalid memory access
+#include <stdlib.h>
+
+int __VERIFIER_nondet_int(void);
+
+int main(void)
+{
+    int local = __VERIFIER_nondet_int();
+    int* ptr = &local;
+
+    free(ptr);
+
+    return local;
+}
@@ -1,4 +1,6 @@
 // RUN: %bmc -bound 1 -memory=flat "%s" | FileCheck "%s"
+// RUN: %bmc -bound 1 -memory=regions "%s" | FileCheck "%s"
+// RUN: %bmc -bound 1 -memory=regions -memory-word-cells "%s" | FileCheck "%s"
 
 // CHECK: Verification {{(SUCCESSFUL|BOUND REACHED)}}
 
@@ -1,4 +1,7 @@
 // RUN: %bmc -bound 1 -memory=flat "%s" | FileCheck "%s"
+// RUN: %bmc -bound 1 -memory=regions "%s" | FileCheck "%s"
+// RUN: %bmc -bound 1 -memory=flat -no-promote-memory "%s" | FileCheck "%s"
+// RUN: %bmc -bound 1 -memory=flat -no-promote-memory -memory-flatten-reads=16 "%s" | FileCheck "%s"
 
 // CHECK: Verification FAILED
 
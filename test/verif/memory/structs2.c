@@ -1,4 +1,5 @@
 // RUN: %bmc -bound 1 -memory=flat "%s" | FileCheck "%s"
+// RUN: %bmc -bound 1 -memory=flat -no-promote-memory -memory-flatten-reads=16 "%s" | FileCheck "%s"
 
 // By default we assume that unknown external functions do not clobber memory objects.
 // CHECK: Verification {{(SUCCESSFUL|BOUND REACHED)}}
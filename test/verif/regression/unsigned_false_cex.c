@@ -4,6 +4,13 @@
 // RUN: %bmc -math-int -trace -test-harness %t3.ll "%s"
 // RUN: %check-cex "%s" "%t3.ll" "%errors" | FileCheck "%s"
 
+// The second run loads the automata system from the cache.
+// RUN: rm -rf "%t.cache"
+// RUN: %bmc -math-int -trace -cfa-cache-dir="%t.cache" -test-harness %t5.ll "%s"
+// RUN: %check-cex "%s" "%t5.ll" "%errors" | FileCheck "%s"
+// RUN: %bmc -math-int -trace -cfa-cache-dir="%t.cache" -test-harness %t6.ll "%s"
+// RUN: %check-cex "%s" "%t6.ll" "%errors" | FileCheck "%s"
+
 // CHECK: __VERIFIER_error executed
 
 // Due to an erroneous encoding of unsigned comparisons, we have produced some
@@ -11,6 +11,7 @@
 // RUN: %check-cex "%s" "%t4.bc" "%errors" | FileCheck --check-prefix=LLI "%s"
 // RUN: %check-cex "%s" "%t5.bc" "%errors" | FileCheck --check-prefix=LLI "%s"
 // RUN: %check-cex "%s" "%t6.bc" "%errors" | FileCheck --check-prefix=LLI "%s"
+// RUN: %bmc -bound 10 -trace -test-harness="%t7.bc" -cfa-threads=4 "%s" | FileCheck --check-prefix=RESULT "%s"
 
 // RESULT: Verification FAILED
 
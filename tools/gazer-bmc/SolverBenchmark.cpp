@@ -0,0 +1,214 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "SolverBenchmark.h"
+
+#include "gazer/Core/Solver/Model.h"
+#include "gazer/Support/Stopwatch.h"
+
+#include <llvm/Support/Format.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+
+using namespace gazer;
+
+namespace
+{
+
+class BenchmarkSolver : public Solver
+{
+public:
+    struct Configuration
+    {
+        std::string name;
+        std::unique_ptr<Solver> solver;
+        std::vector<std::chrono::milliseconds> times;
+    };
+
+    BenchmarkSolver(GazerContext& context, std::vector<Configuration> configs)
+        : Solver(context), mConfigs(std::move(configs))
+    {
+        assert(!mConfigs.empty() && "Benchmarking requires at least one configuration!");
+    }
+
+    SolverStatus run() override
+    {
+        return this->runAll([](Solver& solver) { return solver.run(); });
+    }
+
+    bool supportsAssumptions() const override
+    {
+        return std::all_of(mConfigs.begin(), mConfigs.end(), [](const Configuration& config) {
+            return config.solver->supportsAssumptions();
+        });
+    }
+
+    SolverStatus runWithAssumptions(llvm::ArrayRef<ExprPtr> assumptions) override
+    {
+        return this->runAll([assumptions](Solver& solver) {
+            return solver.runWithAssumptions(assumptions);
+        });
+    }
+
+    void getUnsatCore(std::vector<ExprPtr>& core) override {
+        mConfigs.front().solver->getUnsatCore(core);
+    }
+
+    std::unique_ptr<Model> getModel() override {
+        return mConfigs.front().solver->getModel();
+    }
+
+    void reset() override
+    {
+        for (auto& config : mConfigs) {
+            config.solver->reset();
+        }
+    }
+
+    void push() override
+    {
+        for (auto& config : mConfigs) {
+            config.solver->push();
+        }
+    }
+
+    void pop() override
+    {
+        for (auto& config : mConfigs) {
+            config.solver->pop();
+        }
+    }
+
+    void printStats(llvm::raw_ostream& os) override;
+
+    void dump(llvm::raw_ostream& os) override {
+        mConfigs.front().solver->dump(os);
+    }
+
+protected:
+    void addConstraint(ExprPtr expr) override
+    {
+        for (auto& config : mConfigs) {
+            config.solver->add(expr);
+        }
+    }
+
+private:
+    SolverStatus runAll(llvm::function_ref<SolverStatus(Solver&)> check);
+
+private:
+    std::vector<Configuration> mConfigs;
+    unsigned mNumQueries = 0;
+};
+
+} // end anonymous namespace
+
+static llvm::StringRef statusToString(Solver::SolverStatus status)
+{
+    switch (status) {
+        case Solver::SAT: return "sat";
+        case Solver::UNSAT: return "unsat";
+        case Solver::UNKNOWN: return "unknown";
+    }
+
+    llvm_unreachable("Unknown solver status!");
+}
+
+auto BenchmarkSolver::runAll(llvm::function_ref<SolverStatus(Solver&)> check) -> SolverStatus
+{
+    unsigned query = mNumQueries++;
+    SolverStatus result = SolverStatus::UNKNOWN;
+    bool inconsistent = false;
+
+    llvm::outs() << "      Benchmarking query " << query << "\n";
+    for (size_t i = 0; i < mConfigs.size(); ++i) {
+        auto& config = mConfigs[i];
+
+        Stopwatch<> sw;
+        sw.start();
+        SolverStatus status = check(*config.solver);
+        sw.stop();
+        config.times.push_back(sw.elapsed());
+
+        llvm::outs() << "        " << llvm::left_justify(config.name, 16);
+        sw.format(llvm::outs(), "ms");
+        llvm::outs() << " (" << statusToString(status) << ")\n";
+
+        if (i == 0) {
+            result = status;
+        } else if (status != SolverStatus::UNKNOWN && result != SolverStatus::UNKNOWN && status != result) {
+            inconsistent = true;
+        }
+    }
+
+    if (inconsistent) {
+        llvm::errs() << "WARNING: Solver configurations disagree on query " << query << ".\n";
+    }
+
+    return result;
+}
+
+void BenchmarkSolver::printStats(llvm::raw_ostream& os)
+{
+    os << "--------- Solver benchmark ---------\n";
+    os << llvm::left_justify("Query", 8);
+    for (auto& config : mConfigs) {
+        os << llvm::right_justify(config.name, 16);
+    }
+    os << "\n";
+
+    for (unsigned i = 0; i < mNumQueries; ++i) {
+        os << llvm::format("%-8u", i);
+        for (auto& config : mConfigs) {
+            os << llvm::format("%14llums", static_cast<unsigned long long>(config.times[i].count()));
+        }
+        os << "\n";
+    }
+
+    os << llvm::left_justify("Total", 8);
+    for (auto& config : mConfigs) {
+        std::chrono::milliseconds total{0};
+        for (auto& time : config.times) {
+            total += time;
+        }
+        os << llvm::format("%14llums", static_cast<unsigned long long>(total.count()));
+    }
+    os << "\n";
+    os << "------------------------------------\n";
+
+    for (auto& config : mConfigs) {
+        os << config.name << ":\n";
+        config.solver->printStats(os);
+        os << "\n";
+    }
+}
+
+void BenchmarkSolverFactory::addConfiguration(std::string name, std::unique_ptr<SolverFactory> factory)
+{
+    mFactories.emplace_back(std::move(name), std::move(factory));
+}
+
+std::unique_ptr<Solver> BenchmarkSolverFactory::createSolver(GazerContext& context)
+{
+    std::vector<BenchmarkSolver::Configuration> configs;
+    for (auto& [name, factory] : mFactories) {
+        configs.push_back({name, factory->createSolver(context), {}});
+    }
+
+    return std::make_unique<BenchmarkSolver>(context, std::move(configs));
+}
@@ -0,0 +1,50 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file This file declares a solver factory which runs every query on
+/// multiple solver configurations and reports the time taken by each.
+///
+//===----------------------------------------------------------------------===//
+#ifndef GAZER_TOOLS_GAZERBMC_SOLVERBENCHMARK_H
+#define GAZER_TOOLS_GAZERBMC_SOLVERBENCHMARK_H
+
+#include "gazer/Core/Solver/Solver.h"
+
+#include <string>
+#include <vector>
+
+namespace gazer
+{
+
+/// Creates solvers which forward every operation to one solver instance
+/// per registered configuration. Each query is timed on all of them, and the
+/// results of the first configuration are returned to the caller.
+class BenchmarkSolverFactory : public SolverFactory
+{
+public:
+    void addConfiguration(std::string name, std::unique_ptr<SolverFactory> factory);
+
+    std::unique_ptr<Solver> createSolver(GazerContext& context) override;
+
+private:
+    std::vector<std::pair<std::string, std::unique_ptr<SolverFactory>>> mFactories;
+};
+
+} // end namespace gazer
+
+#endif
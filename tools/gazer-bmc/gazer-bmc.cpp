@@ -21,8 +21,13 @@
 #include "gazer/LLVM/ClangFrontend.h"
 
 #include "gazer/Z3Solver/Z3Solver.h"
+#ifdef GAZER_ENABLE_BITBLAST_SOLVER
+#include "gazer/BitBlastSolver/BitBlastSolver.h"
+#endif
 #include "gazer/Verifier/BoundedModelChecker.h"
 
+#include "SolverBenchmark.h"
+
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Verifier.h>
 #include <llvm/Support/raw_ostream.h>
@@ -62,6 +67,36 @@ namespace
         llvm::cl::desc("Print solver statistics information"),
         cl::cat(BmcAlgorithmCategory)
     );
+
+    enum class SolverKind { Z3, BitBlast };
+
+    cl::opt<SolverKind> SolverBackend("solver", cl::desc("Solver backend used by the model checker"),
+        cl::values(
+            clEnumValN(SolverKind::Z3, "z3", "Z3 SMT solver"),
+            clEnumValN(SolverKind::BitBlast, "bitblast",
+                "Built-in bit-blasting SAT solver (bit-vector formulas only)")
+        ),
+        cl::init(SolverKind::Z3),
+        cl::cat(BmcAlgorithmCategory)
+    );
+
+    cl::opt<Z3SolverProfile> Z3Profile("z3-profile", cl::desc("Configuration profile of the Z3 solver"),
+        cl::values(
+            clEnumValN(Z3SolverProfile::Default, "default", "Z3's default solver"),
+            clEnumValN(Z3SolverProfile::Incremental, "incremental", "Incremental SMT core without pre-processing"),
+            clEnumValN(Z3SolverProfile::QF_ABV, "qf-abv",
+                "Simplification and equation solving, followed by bit-blasting for bit-vector queries"),
+            clEnumValN(Z3SolverProfile::ArrayElim, "array-elim",
+                "Rewrite reads over array writes into if-then-else terms before solving")
+        ),
+        cl::init(Z3SolverProfile::Default),
+        cl::cat(BmcAlgorithmCategory)
+    );
+
+    cl::opt<bool> BenchmarkSolverProfiles("benchmark-solver-profiles",
+        cl::desc("Run every solver query with all Z3 profiles and report the time taken by each"),
+        cl::cat(BmcAlgorithmCategory)
+    );
 }
 
 namespace gazer
@@ -74,6 +109,7 @@ namespace gazer
 } // end namespace gazer
 
 static BmcSettings initBmcSettingsFromCommandLine();
+static std::unique_ptr<SolverFactory> createSolverFactory();
 
 int main(int argc, char* argv[])
 {
@@ -98,13 +134,16 @@ int main(int argc, char* argv[])
         return 1;
     }
 
-    Z3SolverFactory solverFactory;
+    auto solverFactory = createSolverFactory();
+    if (solverFactory == nullptr) {
+        return 1;
+    }
 
     auto bmcSettings = initBmcSettingsFromCommandLine();
     bmcSettings.simplifyExpr = frontend->getSettings().simplifyExpr;
     bmcSettings.trace = frontend->getSettings().trace;
 
-    frontend->setBackendAlgorithm(new BoundedModelChecker(solverFactory, bmcSettings));
+    frontend->setBackendAlgorithm(new BoundedModelChecker(*solverFactory, bmcSettings));
     frontend->registerVerificationPipeline();
 
     frontend->run();
@@ -119,10 +158,40 @@ BmcSettings initBmcSettingsFromCommandLine()
     settings.dumpFormula = DumpFormula;
     settings.dumpSolver = DumpSolver;
     settings.dumpSolverModel = DumpSolverModel;
-    settings.printSolverStats = PrintSolverStats;
+    settings.printSolverStats = PrintSolverStats || BenchmarkSolverProfiles;
 
     settings.maxBound = MaxBound;
     settings.eagerUnroll = EagerUnroll;
 
     return settings;
 }
+
+std::unique_ptr<SolverFactory> createSolverFactory()
+{
+    if (BenchmarkSolverProfiles) {
+        // The selected profile comes first, as its results drive the model checker.
+        auto factory = std::make_unique<BenchmarkSolverFactory>();
+        factory->addConfiguration(getZ3SolverProfileName(Z3Profile), std::make_unique<Z3SolverFactory>(Z3Profile));
+        for (Z3SolverProfile profile : getAllZ3SolverProfiles()) {
+            if (profile != Z3Profile) {
+                factory->addConfiguration(getZ3SolverProfileName(profile), std::make_unique<Z3SolverFactory>(profile));
+            }
+        }
+
+        return factory;
+    }
+
+    switch (SolverBackend) {
+        case SolverKind::Z3:
+            return std::make_unique<Z3SolverFactory>(Z3Profile);
+        case SolverKind::BitBlast:
+            #ifdef GAZER_ENABLE_BITBLAST_SOLVER
+            return std::make_unique<BitBlastSolverFactory>();
+            #else
+            llvm::errs() << "The bit-blasting solver was not enabled in this build.\n";
+            return nullptr;
+            #endif
+    }
+
+    llvm_unreachable("Unknown solver backend!");
+}
@@ -0,0 +1,163 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "gazer/Automaton/CfaSerialization.h"
+#include "gazer/Core/ExprTypes.h"
+#include "gazer/Core/LiteralExpr.h"
+
+#include <llvm/Support/raw_ostream.h>
+
+#include <gtest/gtest.h>
+
+using namespace gazer;
+
+namespace
+{
+
+std::unique_ptr<AutomataSystem> createSystem(GazerContext& ctx)
+{
+    auto system = std::make_unique<AutomataSystem>(ctx);
+    auto& bv32 = BvType::Get(ctx, 32);
+    auto& fp64 = FloatType::Get(ctx, FloatType::Double);
+    auto& memTy = ArrayType::Get(bv32, BvType::Get(ctx, 8));
+
+    auto calc = system->createCfa("calc");
+    auto a = calc->createInput("a", bv32);
+    auto f = calc->createInput("f", fp64);
+    auto q = calc->createLocal("q", bv32);
+    calc->addOutput(q);
+    calc->createAssignTransition(calc->getEntry(), calc->getExit(), {
+        { q, SelectExpr::Create(
+            FLtExpr::Create(
+                FAddExpr::Create(f->getRefExpr(), FloatLiteralExpr::Get(fp64, llvm::APFloat(1.5)), llvm::APFloat::rmNearestTiesToEven),
+                FloatLiteralExpr::Get(fp64, llvm::APFloat(-0.0))
+            ),
+            ZExtExpr::Create(ExtractExpr::Create(a->getRefExpr(), 8, 16), bv32),
+            BvLiteralExpr::Get(bv32, 0xDEADBEEF)
+        )}
+    });
+
+    auto main = system->createCfa("main");
+    auto x = main->createInput("x", bv32);
+    auto mem = main->createLocal("mem", memTy);
+    auto r = main->createLocal("r", bv32);
+    auto ret = main->createLocal("RET_VAL", bv32);
+    main->addOutput(ret);
+
+    ArrayLiteralExpr::Builder builder(memTy);
+    builder.addValue(BvLiteralExpr::Get(bv32, 1), BvLiteralExpr::Get(BvType::Get(ctx, 8), 255));
+    builder.setDefault(BvLiteralExpr::Get(BvType::Get(ctx, 8), 0));
+
+    auto l1 = main->createLocation();
+    auto l2 = main->createLocation();
+    auto err = main->createErrorLocation();
+
+    main->createAssignTransition(main->getEntry(), l1, {
+        { mem, ArrayWriteExpr::Create(builder.build(), x->getRefExpr(), BvLiteralExpr::Get(BvType::Get(ctx, 8), 7)) }
+    });
+    main->createCallTransition(l1, l2, BvULtExpr::Create(x->getRefExpr(), BvLiteralExpr::Get(bv32, 10)), calc, {
+        { a, x->getRefExpr() },
+        { f, UndefExpr::Get(fp64) }
+    }, {
+        { r, q->getRefExpr() }
+    });
+    main->createAssignTransition(l2, err, EqExpr::Create(r->getRefExpr(), BvLiteralExpr::Get(bv32, 0)));
+    main->createAssignTransition(l2, main->getExit(), NotEqExpr::Create(r->getRefExpr(), BvLiteralExpr::Get(bv32, 0)), {
+        { ret, r->getRefExpr() }
+    });
+    main->addErrorCode(err, BvLiteralExpr::Get(BvType::Get(ctx, 16), 2));
+
+    system->setMainAutomaton(main);
+    return system;
+}
+
+std::string writeSystem(AutomataSystem& system)
+{
+    std::string buffer;
+    llvm::raw_string_ostream rso(buffer);
+    AutomataSystemWriter writer(rso);
+    writer.write(system);
+
+    return rso.str();
+}
+
+TEST(CfaSerializationTest, RoundTrip)
+{
+    GazerContext ctx1;
+    auto original = createSystem(ctx1);
+
+    std::string buffer;
+    llvm::raw_string_ostream rso(buffer);
+    AutomataSystemWriter writer(rso);
+    writer.write(*original);
+
+    // Clients may append their own records after the system.
+    writer.beginRecord("custom");
+    writer.writeField(writer.writeExpr(original->getMainAutomaton()->getInput(0)->getRefExpr()));
+    writer.writeField(writer.getLocationNumber(original->getMainAutomaton()->getExit()));
+    writer.writeField("some text\nwith a newline");
+    writer.endRecord();
+    rso.flush();
+
+    GazerContext ctx2;
+    AutomataSystemReader reader(ctx2, buffer);
+    auto loaded = reader.read();
+    ASSERT_NE(loaded, nullptr);
+
+    // Writing the loaded system must yield the same records.
+    EXPECT_EQ(writeSystem(*original), writeSystem(*loaded));
+    EXPECT_EQ(loaded->getMainAutomaton()->getName(), "main");
+    EXPECT_EQ(loaded->getMainAutomaton()->getInput(0)->getName(), "main/x");
+    EXPECT_EQ(loaded->getMainAutomaton()->getNumErrors(), 1u);
+    EXPECT_EQ(loaded->getAutomatonByName("calc")->getNumOutputs(), 1u);
+
+    llvm::StringRef tag;
+    uint64_t exprNum, locNum;
+    llvm::StringRef text;
+    ASSERT_TRUE(reader.nextRecord(tag));
+    EXPECT_EQ(tag, "custom");
+    ASSERT_TRUE(reader.readField(exprNum));
+    ASSERT_TRUE(reader.readField(locNum));
+    ASSERT_TRUE(reader.readField(text));
+    ASSERT_TRUE(reader.endRecord());
+
+    EXPECT_EQ(reader.getExpr(exprNum), loaded->getMainAutomaton()->getInput(0)->getRefExpr());
+    EXPECT_EQ(reader.getLocation(locNum), loaded->getMainAutomaton()->getExit());
+    EXPECT_EQ(text, "some text\nwith a newline");
+    EXPECT_FALSE(reader.nextRecord(tag));
+    EXPECT_FALSE(reader.hasError());
+}
+
+TEST(CfaSerializationTest, MalformedInput)
+{
+    GazerContext ctx1;
+    auto original = createSystem(ctx1);
+
+    std::string buffer = writeSystem(*original);
+
+    // Truncated input
+    GazerContext ctx2;
+    AutomataSystemReader truncated(ctx2, llvm::StringRef(buffer).drop_back(10));
+    EXPECT_EQ(truncated.read(), nullptr);
+
+    // Dangling references
+    GazerContext ctx3;
+    AutomataSystemReader dangling(ctx3, "cfa 0 4:main\nmain 1\nend\n");
+    EXPECT_EQ(dangling.read(), nullptr);
+}
+
+} // end anonymous namespace
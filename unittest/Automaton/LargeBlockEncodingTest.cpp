@@ -0,0 +1,125 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "gazer/Automaton/CfaTransforms.h"
+#include "gazer/Core/ExprTypes.h"
+#include "gazer/Core/LiteralExpr.h"
+
+#include <gtest/gtest.h>
+
+using namespace gazer;
+
+namespace
+{
+
+TEST(LargeBlockEncodingTest, MergeDiamond)
+{
+    GazerContext ctx;
+    AutomataSystem system(ctx);
+
+    Cfa* cfa = system.createCfa("main");
+    auto x = cfa->createLocal("x", IntType::Get(ctx));
+    auto y = cfa->createLocal("y", IntType::Get(ctx));
+    auto z = cfa->createLocal("z", IntType::Get(ctx));
+
+    auto l2 = cfa->createLocation();
+    auto l3 = cfa->createLocation();
+    auto l4 = cfa->createLocation();
+    auto l5 = cfa->createLocation();
+    auto le = cfa->createErrorLocation();
+    cfa->addErrorCode(le, IntLiteralExpr::Get(ctx, 1));
+
+    // l0 --> l2: { x := undef, y := undef }
+    cfa->createAssignTransition(cfa->getEntry(), l2, {
+        { x, UndefExpr::Get(IntType::Get(ctx)) },
+        { y, UndefExpr::Get(IntType::Get(ctx)) }
+    });
+
+    auto lteq = LtEqExpr::Create(y->getRefExpr(), IntLiteralExpr::Get(ctx, 0));
+    auto inc = AddExpr::Create(x->getRefExpr(), IntLiteralExpr::Get(ctx, 1));
+    auto dec = SubExpr::Create(x->getRefExpr(), IntLiteralExpr::Get(ctx, 1));
+
+    // l2 --> l3 [ y <= 0 ] { z := x + 1 }
+    // l2 --> l4 [ not y <= 0 ] { z := x - 1 }
+    cfa->createAssignTransition(l2, l3, lteq, {{ z, inc }});
+    cfa->createAssignTransition(l2, l4, NotExpr::Create(lteq), {{ z, dec }});
+
+    // l3 --> l5 {}
+    // l4 --> l5 {}
+    cfa->createAssignTransition(l3, l5);
+    cfa->createAssignTransition(l4, l5);
+
+    // l5 --> ERROR [ z == 0 ]
+    auto eq = EqExpr::Create(z->getRefExpr(), IntLiteralExpr::Get(ctx, 0));
+    cfa->createAssignTransition(l5, le, eq);
+    cfa->createAssignTransition(l5, cfa->getExit(), NotExpr::Create(eq));
+
+    EXPECT_EQ(3, TransformLargeBlockEncoding(cfa));
+
+    // Only the entry, exit, error and branching locations remain.
+    ASSERT_EQ(4, cfa->getNumLocations());
+    ASSERT_EQ(3, cfa->getNumTransitions());
+    ASSERT_EQ(1, cfa->getEntry()->getNumOutgoing());
+
+    auto edge = llvm::dyn_cast<AssignTransition>(*cfa->getEntry()->outgoing_begin());
+    ASSERT_NE(nullptr, edge);
+    EXPECT_EQ(l5, edge->getTarget());
+    ASSERT_EQ(3, edge->getNumAssignments());
+
+    auto zAssign = std::find_if(edge->begin(), edge->end(), [z](auto& assign) {
+        return assign.getVariable() == z;
+    });
+    ASSERT_NE(edge->end(), zAssign);
+    EXPECT_EQ(SelectExpr::Create(lteq, inc, dec), zAssign->getValue());
+}
+
+TEST(LargeBlockEncodingTest, KeepCalls)
+{
+    GazerContext ctx;
+    AutomataSystem system(ctx);
+
+    Cfa* callee = system.createCfa("callee");
+    callee->createAssignTransition(callee->getEntry(), callee->getExit());
+
+    Cfa* cfa = system.createCfa("main");
+    auto x = cfa->createLocal("x", IntType::Get(ctx));
+    auto y = cfa->createLocal("y", IntType::Get(ctx));
+
+    auto l2 = cfa->createLocation();
+    auto l3 = cfa->createLocation();
+    auto l4 = cfa->createLocation();
+
+    // l0 --> l2 { x := 1 } --> l3 { y := x + 1 } --call--> l4 --> l1
+    cfa->createAssignTransition(cfa->getEntry(), l2, {{ x, IntLiteralExpr::Get(ctx, 1) }});
+    cfa->createAssignTransition(l2, l3, {{ y, AddExpr::Create(x->getRefExpr(), IntLiteralExpr::Get(ctx, 1)) }});
+    cfa->createCallTransition(l3, l4, callee, {}, {});
+    cfa->createAssignTransition(l4, cfa->getExit());
+
+    EXPECT_EQ(1, TransformLargeBlockEncoding(cfa));
+
+    // The call transition and its endpoints must be kept.
+    ASSERT_EQ(4, cfa->getNumLocations());
+    ASSERT_EQ(3, cfa->getNumTransitions());
+    ASSERT_EQ(1, l3->getNumIncoming());
+
+    auto edge = llvm::dyn_cast<AssignTransition>(*l3->incoming_begin());
+    ASSERT_NE(nullptr, edge);
+    EXPECT_EQ(cfa->getEntry(), edge->getSource());
+    EXPECT_EQ(2, edge->getNumAssignments());
+}
+
+} // end anonymous namespace
@@ -19,9 +19,12 @@
 #include "gazer/Core/GazerContext.h"
 #include "gazer/Core/ExprTypes.h"
 #include "gazer/Core/LiteralExpr.h"
+#include "gazer/Core/Expr/ExprUtils.h"
 
 #include <gtest/gtest.h>
 
+#include <thread>
+
 using namespace gazer;
 
 TEST(Expr, CanCreateExpressions)
@@ -203,3 +206,67 @@ TEST(Expr, CanCreateTupleExpressions)
     read = TupleSelectExpr::Create(construct, 1);
     EXPECT_EQ(read->getType(), bvTy);
 }
+
+TEST(Expr, CanCreateExpressionsConcurrently)
+{
+    GazerContext context;
+    auto x = context.createVariable("X", BvType::Get(context, 32))->getRefExpr();
+
+    constexpr unsigned NumThreads = 4;
+    constexpr unsigned NumExprs = 2000;
+
+    std::vector<std::vector<ExprPtr>> results(NumThreads);
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < NumThreads; ++t) {
+        threads.emplace_back([&context, &x, &result = results[t], t]() {
+            for (unsigned i = 0; i < NumExprs; ++i) {
+                auto& bvTy = BvType::Get(context, 1 + (i % 48));
+                auto add = AddExpr::Create(x, BvLiteralExpr::Get(BvType::Get(context, 32), i));
+                result.push_back(EqExpr::Create(add, x));
+
+                // Temporaries are released while other threads may look them up.
+                EqExpr::Create(context.createVariable(
+                    "Y" + std::to_string(t) + "_" + std::to_string(i), bvTy
+                )->getRefExpr(), BvLiteralExpr::Get(bvTy, 0));
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (unsigned t = 1; t < NumThreads; ++t) {
+        for (unsigned i = 0; i < NumExprs; ++i) {
+            ASSERT_EQ(results[t][i], results[0][i]);
+        }
+    }
+}
+
+TEST(Expr, CanBoundExpressionDAGs)
+{
+    GazerContext context;
+
+    auto x = context.createVariable("X", IntType::Get(context))->getRefExpr();
+    auto y = context.createVariable("Y", IntType::Get(context))->getRefExpr();
+    auto one = IntLiteralExpr::Get(IntType::Get(context), 1);
+
+    // The tree of this expression has 2^11 - 1 nodes, while its DAG has only 11.
+    ExprPtr shared = x;
+    for (unsigned i = 0; i < 10; ++i) {
+        shared = AddExpr::Create(shared, shared);
+    }
+
+    EXPECT_TRUE(IsExprWithinBounds(shared, 11, 11));
+    EXPECT_FALSE(IsExprWithinBounds(shared, 10, 11));
+    EXPECT_FALSE(IsExprWithinBounds(shared, 11, 10));
+
+    // The depth must be computed on the longest path to shared nodes.
+    auto sum = AddExpr::Create(x, y);
+    auto deep = AddExpr::Create(AddExpr::Create(AddExpr::Create(sum, one), one), one);
+    auto root = AddExpr::Create(sum, deep);
+
+    EXPECT_TRUE(IsExprWithinBounds(root, 100, 6));
+    EXPECT_FALSE(IsExprWithinBounds(root, 100, 5));
+    EXPECT_FALSE(IsExprWithinBounds(root, 6, 100));
+}
@@ -0,0 +1,225 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "gazer/LLVM/Memory/AliasSetPartition.h"
+
+#include <llvm/Analysis/AssumptionCache.h>
+#include <llvm/Analysis/BasicAliasAnalysis.h>
+#include <llvm/Analysis/TargetLibraryInfo.h>
+#include <llvm/AsmParser/Parser.h>
+#include <llvm/Support/SourceMgr.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/InstIterator.h>
+
+#include <gtest/gtest.h>
+
+#include <unordered_map>
+
+using namespace gazer;
+using namespace gazer::memory;
+
+namespace
+{
+
+/// Basic alias analysis results for a single function.
+struct FunctionAliasAnalysis
+{
+    FunctionAliasAnalysis(llvm::Function& function, const llvm::TargetLibraryInfo& tli)
+        : assumptions(function),
+        basic(function.getParent()->getDataLayout(), function, tli, assumptions),
+        results(tli)
+    {
+        results.addAAResult(basic);
+    }
+
+    llvm::AssumptionCache assumptions;
+    llvm::BasicAAResult basic;
+    llvm::AAResults results;
+};
+
+class AliasSetPartitionTest : public ::testing::Test
+{
+protected:
+    void setUp(const char* moduleStr)
+    {
+        module = llvm::parseAssemblyString(moduleStr, error, llvmContext);
+        if (module == nullptr) {
+            error.print("AliasSetPartitionTest", llvm::errs());
+            FAIL() << "Failed to construct LLVM module!\n";
+            return;
+        }
+
+        tliImpl = std::make_unique<llvm::TargetLibraryInfoImpl>();
+        tli = std::make_unique<llvm::TargetLibraryInfo>(*tliImpl);
+
+        auto aliasAnalysis = [this](llvm::Function& function) -> llvm::AAResults& {
+            auto& result = functionAA[&function];
+            if (result == nullptr) {
+                result = std::make_unique<FunctionAliasAnalysis>(function, *tli);
+            }
+            return result->results;
+        };
+
+        partition = std::make_unique<AliasSetPartition>(
+            *module, aliasAnalysis, module->getFunction("main"));
+    }
+
+    const llvm::Value* getValue(llvm::StringRef function, llvm::StringRef name)
+    {
+        for (llvm::Instruction& inst : llvm::instructions(module->getFunction(function))) {
+            if (inst.getName() == name) {
+                return &inst;
+            }
+        }
+
+        return nullptr;
+    }
+
+    AliasSetPartition::RegionID region(const llvm::Value* value) {
+        return partition->getRegionFor(value);
+    }
+
+protected:
+    llvm::LLVMContext llvmContext;
+    llvm::SMDiagnostic error;
+    std::unique_ptr<llvm::Module> module;
+    std::unique_ptr<llvm::TargetLibraryInfoImpl> tliImpl;
+    std::unique_ptr<llvm::TargetLibraryInfo> tli;
+    std::unordered_map<llvm::Function*, std::unique_ptr<FunctionAliasAnalysis>> functionAA;
+    std::unique_ptr<AliasSetPartition> partition;
+};
+
+TEST_F(AliasSetPartitionTest, DistinctObjectsAreSeparated)
+{
+    setUp(R"ASM(
+@a = global i32 0, align 4
+@b = global i32 0, align 4
+
+define i32 @main() {
+entry:
+    %x = alloca i32, align 4
+    store i32 1, i32* @a, align 4
+    store i32 2, i32* @b, align 4
+    store i32 3, i32* %x, align 4
+    %0 = load i32, i32* @a, align 4
+    ret i32 %0
+}
+)ASM");
+
+    auto a = module->getGlobalVariable("a");
+    auto b = module->getGlobalVariable("b");
+    auto x = getValue("main", "x");
+
+    EXPECT_NE(region(a), region(b));
+    EXPECT_NE(region(a), region(x));
+    EXPECT_NE(region(b), region(x));
+    EXPECT_NE(region(a), AliasSetPartition::UnknownRegion);
+    EXPECT_EQ(partition->getNumRegions(), 4u);
+}
+
+TEST_F(AliasSetPartitionTest, ParametersFollowArguments)
+{
+    setUp(R"ASM(
+define void @set(i32* %p) {
+entry:
+    store i32 1, i32* %p, align 4
+    ret void
+}
+
+define i32 @main() {
+entry:
+    %x = alloca i32, align 4
+    %y = alloca i32, align 4
+    store i32 0, i32* %y, align 4
+    call void @set(i32* %x)
+    %0 = load i32, i32* %x, align 4
+    ret i32 %0
+}
+)ASM");
+
+    auto x = getValue("main", "x");
+    auto y = getValue("main", "y");
+
+    EXPECT_EQ(region(x), region(module->getFunction("set")->arg_begin()));
+    EXPECT_NE(region(x), region(y));
+    EXPECT_NE(region(x), AliasSetPartition::UnknownRegion);
+}
+
+TEST_F(AliasSetPartitionTest, MayAliasAccessesShareRegion)
+{
+    // The parameter may alias the global within 'set', thus the alias set
+    // containing both of them must not be split.
+    setUp(R"ASM(
+@a = global i32 0, align 4
+
+define void @set(i32* %p) {
+entry:
+    store i32 1, i32* %p, align 4
+    store i32 2, i32* @a, align 4
+    ret void
+}
+
+define i32 @main() {
+entry:
+    %x = alloca i32, align 4
+    %y = alloca i32, align 4
+    store i32 0, i32* %y, align 4
+    call void @set(i32* %x)
+    %0 = load i32, i32* %y, align 4
+    ret i32 %0
+}
+)ASM");
+
+    auto a = module->getGlobalVariable("a");
+    auto x = getValue("main", "x");
+    auto y = getValue("main", "y");
+
+    EXPECT_EQ(region(x), region(a));
+    EXPECT_NE(region(y), region(a));
+}
+
+TEST_F(AliasSetPartitionTest, EscapedObjectsAreUnknown)
+{
+    setUp(R"ASM(
+@g = global i32* null, align 8
+
+define i32 @get() {
+entry:
+    %p = load i32*, i32** @g, align 8
+    %0 = load i32, i32* %p, align 4
+    ret i32 %0
+}
+
+define i32 @main() {
+entry:
+    %x = alloca i32, align 4
+    %y = alloca i32, align 4
+    store i32 1, i32* %x, align 4
+    store i32 2, i32* %y, align 4
+    store i32* %x, i32** @g, align 8
+    %0 = call i32 @get()
+    ret i32 %0
+}
+)ASM");
+
+    EXPECT_EQ(region(getValue("main", "x")), AliasSetPartition::UnknownRegion);
+    EXPECT_EQ(region(getValue("get", "p")), AliasSetPartition::UnknownRegion);
+    EXPECT_NE(region(getValue("main", "y")), AliasSetPartition::UnknownRegion);
+}
+
+} // end anonymous namespace
@@ -0,0 +1,177 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "gazer/LLVM/Memory/MemorySSA.h"
+
+#include <llvm/AsmParser/Parser.h>
+#include <llvm/Support/SourceMgr.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Dominators.h>
+
+#include <gtest/gtest.h>
+
+using namespace gazer;
+using namespace gazer::memory;
+
+namespace
+{
+
+class MemorySSATest : public ::testing::Test
+{
+protected:
+    void setUp(const std::string& moduleStr)
+    {
+        module = llvm::parseAssemblyString(moduleStr, error, llvmContext);
+        if (module == nullptr) {
+            error.print("MemorySSATest", llvm::errs());
+            FAIL() << "Failed to construct LLVM module!\n";
+            return;
+        }
+    }
+
+    /// Builds memory SSA for @f, where each load and store accesses a single
+    /// memory object of the given type.
+    std::unique_ptr<MemorySSA> build(MemoryObjectType objectType)
+    {
+        llvm::Function* function = module->getFunction("f");
+        dt = std::make_unique<llvm::DominatorTree>(*function);
+
+        MemorySSABuilder builder(*function, module->getDataLayout(), *dt);
+        object = builder.createMemoryObject(
+            0, objectType, 4, llvm::Type::getInt32Ty(llvmContext), "a");
+        builder.createLiveOnEntryDef(object);
+
+        for (llvm::BasicBlock& bb : *function) {
+            for (llvm::Instruction& inst : bb) {
+                if (auto store = llvm::dyn_cast<llvm::StoreInst>(&inst)) {
+                    builder.createStoreDef(object, *store);
+                } else if (auto load = llvm::dyn_cast<llvm::LoadInst>(&inst)) {
+                    builder.createLoadUse(object, *load);
+                }
+            }
+        }
+
+        return builder.build();
+    }
+
+    unsigned countPhis()
+    {
+        unsigned count = 0;
+        for (MemoryObjectDef& def : object->defs()) {
+            count += def.getKind() == MemoryObjectDef::PHI;
+        }
+
+        return count;
+    }
+
+protected:
+    llvm::LLVMContext llvmContext;
+    llvm::SMDiagnostic error;
+    std::unique_ptr<llvm::Module> module;
+    std::unique_ptr<llvm::DominatorTree> dt;
+    MemoryObject* object = nullptr;
+};
+
+const char* DiamondModule = R"ASM(
+@a = global i32 0, align 4
+
+define void @f(i1 %c) {
+entry:
+  br i1 %c, label %left, label %right
+
+left:
+  store i32 1, i32* @a, align 4
+  br label %join
+
+right:
+  store i32 2, i32* @a, align 4
+  br label %join
+
+join:
+  store i32 3, i32* @a, align 4
+  %x = load i32, i32* @a, align 4
+  ret void
+}
+)ASM";
+
+TEST_F(MemorySSATest, DeadPhisArePruned)
+{
+    setUp(DiamondModule);
+    auto memorySSA = build(MemoryObjectType::Scalar);
+
+    // The join block overwrites the scalar value before reading it,
+    // thus the object is not live at the join point.
+    EXPECT_EQ(countPhis(), 0u);
+
+    llvm::BasicBlock& join = module->getFunction("f")->back();
+    auto load = llvm::cast<llvm::LoadInst>(join.front().getNextNode());
+    MemoryObjectUse* use = memorySSA->getUniqueUseFor(load, object);
+    ASSERT_TRUE(use != nullptr);
+    EXPECT_EQ(use->getReachingDef(), memorySSA->getUniqueDefinitionFor(&join.front(), object));
+}
+
+TEST_F(MemorySSATest, PartialUpdatesKeepObjectsLive)
+{
+    setUp(DiamondModule);
+    auto memorySSA = build(MemoryObjectType::Unknown);
+
+    // Stores into non-scalar objects read their previous value,
+    // thus the join block needs a phi.
+    ASSERT_EQ(countPhis(), 1u);
+
+    llvm::BasicBlock& join = module->getFunction("f")->back();
+    MemoryObjectDef* def = memorySSA->getUniqueDefinitionFor(&join.front(), object);
+    ASSERT_TRUE(def != nullptr);
+
+    auto phi = llvm::dyn_cast_or_null<PhiDef>(def->getReachingDef());
+    ASSERT_TRUE(phi != nullptr);
+    EXPECT_EQ(phi->getParentBlock(), &join);
+}
+
+TEST_F(MemorySSATest, DeepDominatorTree)
+{
+    // A long chain of blocks, each dominating the next one.
+    constexpr unsigned NumBlocks = 20000;
+
+    std::string str = "@a = global i32 0, align 4\n"
+        "define void @f() {\n"
+        "bb0:\n";
+    for (unsigned i = 1; i < NumBlocks; ++i) {
+        str += "  store i32 " + std::to_string(i) + ", i32* @a, align 4\n";
+        str += "  br label %bb" + std::to_string(i) + "\n";
+        str += "bb" + std::to_string(i) + ":\n";
+    }
+    str += "  %x = load i32, i32* @a, align 4\n"
+        "  ret void\n"
+        "}\n";
+
+    setUp(str);
+    auto memorySSA = build(MemoryObjectType::Scalar);
+
+    auto load = llvm::cast<llvm::LoadInst>(&module->getFunction("f")->back().front());
+    MemoryObjectUse* use = memorySSA->getUniqueUseFor(load, object);
+    ASSERT_TRUE(use != nullptr);
+
+    auto reachingDef = llvm::dyn_cast_or_null<StoreDef>(use->getReachingDef());
+    ASSERT_TRUE(reachingDef != nullptr);
+    EXPECT_EQ(reachingDef->getParentBlock()->getName(), "bb" + std::to_string(NumBlocks - 2));
+    EXPECT_EQ(countPhis(), 0u);
+}
+
+} // end anonymous namespace
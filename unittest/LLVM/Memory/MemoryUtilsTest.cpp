@@ -0,0 +1,147 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "gazer/LLVM/Memory/MemoryUtils.h"
+
+#include <llvm/AsmParser/Parser.h>
+#include <llvm/Support/SourceMgr.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/InstIterator.h>
+
+#include <gtest/gtest.h>
+
+using namespace gazer;
+using namespace gazer::memory;
+
+namespace
+{
+
+class MemoryUtilsTest : public ::testing::Test
+{
+protected:
+    void setUp(const char* moduleStr)
+    {
+        module = llvm::parseAssemblyString(moduleStr, error, llvmContext);
+        if (module == nullptr) {
+            error.print("MemoryUtilsTest", llvm::errs());
+            FAIL() << "Failed to construct LLVM module!\n";
+        }
+    }
+
+    bool isPromotable(llvm::StringRef name, PromotableObject& result)
+    {
+        const llvm::Value* object = module->getGlobalVariable(name);
+        if (object == nullptr) {
+            for (llvm::Instruction& inst : llvm::instructions(module->getFunction("main"))) {
+                if (inst.getName() == name) {
+                    object = &inst;
+                }
+            }
+        }
+
+        return findPromotableFields(object, module->getDataLayout(), result, 16);
+    }
+
+protected:
+    llvm::LLVMContext llvmContext;
+    llvm::SMDiagnostic error;
+    std::unique_ptr<llvm::Module> module;
+};
+
+TEST_F(MemoryUtilsTest, PromoteStructFields)
+{
+    setUp(R"ASM(
+target datalayout = "e-m:e-i64:64-f80:128-n8:16:32:64-S128"
+%struct.S = type { i32, i64, [2 x i8] }
+
+@s = global %struct.S zeroinitializer, align 8
+
+define i32 @main() {
+entry:
+    %f0 = getelementptr inbounds %struct.S, %struct.S* @s, i32 0, i32 0
+    %f1 = getelementptr inbounds %struct.S, %struct.S* @s, i32 0, i32 1
+    %f2 = getelementptr inbounds %struct.S, %struct.S* @s, i32 0, i32 2, i32 1
+    store i32 1, i32* %f0, align 4
+    store i64 2, i64* %f1, align 8
+    store i8 3, i8* %f2, align 1
+    %0 = load i32, i32* %f0, align 4
+    ret i32 %0
+}
+)ASM");
+
+    PromotableObject result;
+    ASSERT_TRUE(isPromotable("s", result));
+    ASSERT_EQ(result.fields.size(), 3u);
+    EXPECT_EQ(result.fields[0].offset, 0u);
+    EXPECT_EQ(result.fields[1].offset, 8u);
+    EXPECT_EQ(result.fields[2].offset, 17u);
+    EXPECT_EQ(result.accesses.size(), 4u);
+}
+
+TEST_F(MemoryUtilsTest, EscapingObjectsAreNotPromoted)
+{
+    setUp(R"ASM(
+@a = global i32 0, align 4
+@p = global i32* null, align 8
+
+define i32 @main() {
+entry:
+    %x = alloca i32, align 4
+    %arr = alloca [4 x i32], align 4
+    store i32* @a, i32** @p, align 8
+    store i32 0, i32* %x, align 4
+    %i = load i32, i32* %x, align 4
+    %idx = sext i32 %i to i64
+    %e = getelementptr inbounds [4 x i32], [4 x i32]* %arr, i64 0, i64 %idx
+    store i32 1, i32* %e, align 4
+    ret i32 0
+}
+)ASM");
+
+    PromotableObject result;
+
+    // Address stored into memory
+    EXPECT_FALSE(isPromotable("a", result));
+
+    // Variable index
+    EXPECT_FALSE(isPromotable("arr", result));
+
+    result = PromotableObject();
+    EXPECT_TRUE(isPromotable("x", result));
+    EXPECT_TRUE(isPromotable("p", result = PromotableObject()));
+}
+
+TEST_F(MemoryUtilsTest, OverlappingAccessesAreNotPromoted)
+{
+    setUp(R"ASM(
+@x = global i64 0, align 8
+
+define i32 @main() {
+entry:
+    %lo = bitcast i64* @x to i32*
+    store i64 1, i64* @x, align 8
+    %0 = load i32, i32* %lo, align 8
+    ret i32 %0
+}
+)ASM");
+
+    PromotableObject result;
+    EXPECT_FALSE(isPromotable("x", result));
+}
+
+} // end anonymous namespace
@@ -0,0 +1,192 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "gazer/LLVM/Memory/ModRefSummary.h"
+
+#include <llvm/AsmParser/Parser.h>
+#include <llvm/Support/SourceMgr.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Instructions.h>
+
+#include <gtest/gtest.h>
+
+using namespace gazer;
+using namespace gazer::memory;
+
+namespace
+{
+
+class ModRefSummaryTest : public ::testing::Test
+{
+protected:
+    void setUp(const char* moduleStr)
+    {
+        module = llvm::parseAssemblyString(moduleStr, error, llvmContext);
+        if (module == nullptr) {
+            error.print("ModRefSummaryTest", llvm::errs());
+            FAIL() << "Failed to construct LLVM module!\n";
+            return;
+        }
+
+        // Each global variable is a location, numbered in declaration order.
+        for (llvm::GlobalVariable& gv : module->globals()) {
+            locations[&gv] = locations.size();
+        }
+
+        summary = std::make_unique<ModRefSummary>(*module, locations.size(),
+            [this](const llvm::Instruction& inst, llvm::BitVector& mod, llvm::BitVector& ref) {
+                if (auto store = llvm::dyn_cast<llvm::StoreInst>(&inst)) {
+                    mod.set(locations.lookup(store->getPointerOperand()));
+                } else if (auto load = llvm::dyn_cast<llvm::LoadInst>(&inst)) {
+                    ref.set(locations.lookup(load->getPointerOperand()));
+                } else if (auto call = llvm::dyn_cast<llvm::CallInst>(&inst)) {
+                    if (call->getCalledFunction() == nullptr) {
+                        mod.set();
+                        ref.set();
+                    }
+                }
+            });
+    }
+
+    bool mod(llvm::StringRef function, llvm::StringRef global) {
+        return summary->mayModify(module->getFunction(function), loc(global));
+    }
+
+    bool ref(llvm::StringRef function, llvm::StringRef global) {
+        return summary->mayReference(module->getFunction(function), loc(global));
+    }
+
+    unsigned loc(llvm::StringRef global) {
+        return locations.lookup(module->getGlobalVariable(global));
+    }
+
+protected:
+    llvm::LLVMContext llvmContext;
+    llvm::SMDiagnostic error;
+    std::unique_ptr<llvm::Module> module;
+    llvm::DenseMap<const llvm::Value*, unsigned> locations;
+    std::unique_ptr<ModRefSummary> summary;
+};
+
+TEST_F(ModRefSummaryTest, CalleeEffectsArePropagated)
+{
+    setUp(R"ASM(
+@a = global i32 0, align 4
+@b = global i32 0, align 4
+@c = global i32 0, align 4
+
+define void @reads_b() {
+    %1 = load i32, i32* @b, align 4
+    ret void
+}
+
+define void @writes_a() {
+    store i32 1, i32* @a, align 4
+    call void @reads_b()
+    ret void
+}
+
+define void @pure() {
+    ret void
+}
+
+define i32 @main() {
+    call void @writes_a()
+    call void @pure()
+    %1 = load i32, i32* @c, align 4
+    ret i32 %1
+}
+)ASM");
+
+    EXPECT_FALSE(mod("reads_b", "b"));
+    EXPECT_TRUE(ref("reads_b", "b"));
+    EXPECT_FALSE(ref("reads_b", "a"));
+
+    EXPECT_TRUE(mod("writes_a", "a"));
+    EXPECT_TRUE(ref("writes_a", "b"));
+    EXPECT_FALSE(summary->mayAccess(module->getFunction("writes_a"), loc("c")));
+
+    for (llvm::StringRef global : {"a", "b", "c"}) {
+        EXPECT_FALSE(summary->mayAccess(module->getFunction("pure"), loc(global)));
+    }
+
+    EXPECT_TRUE(mod("main", "a"));
+    EXPECT_TRUE(ref("main", "b"));
+    EXPECT_TRUE(ref("main", "c"));
+    EXPECT_FALSE(mod("main", "c"));
+}
+
+TEST_F(ModRefSummaryTest, RecursiveFunctionsShareSummaries)
+{
+    setUp(R"ASM(
+@a = global i32 0, align 4
+@b = global i32 0, align 4
+
+define void @even() {
+    store i32 0, i32* @a, align 4
+    call void @odd()
+    ret void
+}
+
+define void @odd() {
+    %1 = load i32, i32* @b, align 4
+    call void @even()
+    ret void
+}
+
+define void @main() {
+    call void @odd()
+    ret void
+}
+)ASM");
+
+    for (llvm::StringRef function : {"even", "odd", "main"}) {
+        EXPECT_TRUE(mod(function, "a"));
+        EXPECT_TRUE(ref(function, "b"));
+        EXPECT_FALSE(mod(function, "b"));
+    }
+}
+
+TEST_F(ModRefSummaryTest, UnknownEffects)
+{
+    setUp(R"ASM(
+@a = global i32 0, align 4
+@fp = global void ()* null, align 8
+
+declare void @external()
+
+define void @indirect() {
+    %f = load void ()*, void ()** @fp, align 8
+    call void %f()
+    ret void
+}
+
+define void @main() {
+    call void @external()
+    ret void
+}
+)ASM");
+
+    EXPECT_TRUE(mod("indirect", "a"));
+    EXPECT_TRUE(ref("indirect", "a"));
+
+    // The effects of declarations are up to the client.
+    EXPECT_FALSE(summary->mayAccess(module->getFunction("main"), loc("a")));
+}
+
+} // end anonymous namespace
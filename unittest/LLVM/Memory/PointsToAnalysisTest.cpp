@@ -0,0 +1,328 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "gazer/LLVM/Memory/PointsToAnalysis.h"
+
+#include <llvm/AsmParser/Parser.h>
+#include <llvm/Support/SourceMgr.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/InstIterator.h>
+
+#include <gtest/gtest.h>
+
+using namespace gazer;
+using namespace gazer::memory;
+
+namespace
+{
+
+class PointsToAnalysisTest : public ::testing::Test
+{
+protected:
+    void setUp(const char* moduleStr)
+    {
+        module = llvm::parseAssemblyString(moduleStr, error, llvmContext);
+        if (module == nullptr) {
+            error.print("PointsToAnalysisTest", llvm::errs());
+            FAIL() << "Failed to construct LLVM module!\n";
+            return;
+        }
+
+        analysis = std::make_unique<PointsToAnalysis>(*module, module->getFunction("main"));
+    }
+
+    const llvm::Value* getValue(llvm::StringRef function, llvm::StringRef name)
+    {
+        for (llvm::Instruction& inst : llvm::instructions(module->getFunction(function))) {
+            if (inst.getName() == name) {
+                return &inst;
+            }
+        }
+
+        return nullptr;
+    }
+
+    PointsToAnalysis::RegionID region(const llvm::Value* value) {
+        return analysis->getRegionFor(value);
+    }
+
+protected:
+    llvm::LLVMContext llvmContext;
+    llvm::SMDiagnostic error;
+    std::unique_ptr<llvm::Module> module;
+    std::unique_ptr<PointsToAnalysis> analysis;
+};
+
+TEST_F(PointsToAnalysisTest, DistinctObjectsAreSeparated)
+{
+    setUp(R"ASM(
+@a = global i32 0, align 4
+@b = global i32 0, align 4
+
+define i32 @main() {
+entry:
+    %x = alloca i32, align 4
+    store i32 1, i32* @a, align 4
+    store i32 2, i32* @b, align 4
+    store i32 3, i32* %x, align 4
+    %0 = load i32, i32* @a, align 4
+    ret i32 %0
+}
+)ASM");
+
+    auto a = module->getGlobalVariable("a");
+    auto b = module->getGlobalVariable("b");
+    auto x = getValue("main", "x");
+
+    EXPECT_NE(region(a), region(b));
+    EXPECT_NE(region(a), region(x));
+    EXPECT_NE(region(b), region(x));
+    EXPECT_NE(region(a), PointsToAnalysis::UnknownRegion);
+    EXPECT_EQ(analysis->getNumRegions(), 4u);
+}
+
+TEST_F(PointsToAnalysisTest, PointersAreUnified)
+{
+    setUp(R"ASM(
+@a = global i32 0, align 4
+@b = global i32 0, align 4
+@c = global i32 0, align 4
+
+declare i1 @__VERIFIER_nondet_bool()
+
+define void @set(i32* %p) {
+entry:
+    store i32 1, i32* %p, align 4
+    ret void
+}
+
+define i32 @main() {
+entry:
+    %cond = call i1 @__VERIFIER_nondet_bool()
+    %ptr = select i1 %cond, i32* @a, i32* @b
+    %0 = load i32, i32* %ptr, align 4
+    call void @set(i32* @c)
+    ret i32 %0
+}
+)ASM");
+
+    auto a = module->getGlobalVariable("a");
+    auto b = module->getGlobalVariable("b");
+    auto c = module->getGlobalVariable("c");
+
+    EXPECT_EQ(region(a), region(b));
+    EXPECT_EQ(region(a), region(getValue("main", "ptr")));
+    EXPECT_NE(region(a), region(c));
+    EXPECT_EQ(region(c), region(module->getFunction("set")->arg_begin()));
+    EXPECT_NE(region(c), PointsToAnalysis::UnknownRegion);
+}
+
+TEST_F(PointsToAnalysisTest, FieldSensitivity)
+{
+    setUp(R"ASM(
+%struct.S = type { i32*, i32* }
+
+@s = global %struct.S zeroinitializer, align 8
+@a = global i32 0, align 4
+@b = global i32 0, align 4
+
+define i32 @main() {
+entry:
+    %f0 = getelementptr inbounds %struct.S, %struct.S* @s, i32 0, i32 0
+    %f1 = getelementptr inbounds %struct.S, %struct.S* @s, i32 0, i32 1
+    store i32* @a, i32** %f0, align 8
+    store i32* @b, i32** %f1, align 8
+    %p = load i32*, i32** %f0, align 8
+    %q = load i32*, i32** %f1, align 8
+    %0 = load i32, i32* %p, align 4
+    store i32 0, i32* %q, align 4
+    ret i32 %0
+}
+)ASM");
+
+    auto a = module->getGlobalVariable("a");
+    auto b = module->getGlobalVariable("b");
+    auto s = module->getGlobalVariable("s");
+
+    EXPECT_NE(region(a), region(b));
+    EXPECT_EQ(region(getValue("main", "p")), region(a));
+    EXPECT_EQ(region(getValue("main", "q")), region(b));
+    EXPECT_EQ(region(getValue("main", "f0")), region(s));
+    EXPECT_FALSE(analysis->isCollapsed(region(s)));
+}
+
+TEST_F(PointsToAnalysisTest, VariableIndicesCollapse)
+{
+    setUp(R"ASM(
+@arr = global [2 x i32*] zeroinitializer, align 8
+@a = global i32 0, align 4
+@b = global i32 0, align 4
+
+declare i64 @__VERIFIER_nondet_long()
+
+define i32 @main() {
+entry:
+    %i = call i64 @__VERIFIER_nondet_long()
+    %e0 = getelementptr inbounds [2 x i32*], [2 x i32*]* @arr, i64 0, i64 0
+    %e1 = getelementptr inbounds [2 x i32*], [2 x i32*]* @arr, i64 0, i64 1
+    store i32* @a, i32** %e0, align 8
+    store i32* @b, i32** %e1, align 8
+    %ei = getelementptr inbounds [2 x i32*], [2 x i32*]* @arr, i64 0, i64 %i
+    %p = load i32*, i32** %ei, align 8
+    %0 = load i32, i32* %p, align 4
+    ret i32 %0
+}
+)ASM");
+
+    auto a = module->getGlobalVariable("a");
+    auto b = module->getGlobalVariable("b");
+    auto arr = module->getGlobalVariable("arr");
+
+    EXPECT_TRUE(analysis->isCollapsed(region(arr)));
+    EXPECT_EQ(region(a), region(b));
+    EXPECT_EQ(region(getValue("main", "p")), region(a));
+}
+
+TEST_F(PointsToAnalysisTest, EscapingPointersAreUnknown)
+{
+    setUp(R"ASM(
+@a = global i32 0, align 4
+@b = global i32 0, align 4
+@g = global i32* @b, align 8
+
+declare void @external(i32*)
+
+define i32 @main() {
+entry:
+    call void @external(i32* @a)
+    %int = ptrtoint i32** @g to i64
+    %p = load i32*, i32** @g, align 8
+    %0 = load i32, i32* %p, align 4
+    ret i32 %0
+}
+)ASM");
+
+    auto a = module->getGlobalVariable("a");
+    auto b = module->getGlobalVariable("b");
+    auto g = module->getGlobalVariable("g");
+
+    EXPECT_EQ(region(a), PointsToAnalysis::UnknownRegion);
+    EXPECT_EQ(region(g), PointsToAnalysis::UnknownRegion);
+
+    // Everything reachable from an escaping pointer is unknown as well.
+    EXPECT_EQ(region(b), PointsToAnalysis::UnknownRegion);
+}
+
+TEST_F(PointsToAnalysisTest, PointersStoredAsIntegersAreUnknown)
+{
+    setUp(R"ASM(
+@a = global i32 0, align 4
+
+define i32 @main() {
+entry:
+    %slot = alloca i64, align 8
+    %int = ptrtoint i32* @a to i64
+    store i64 %int, i64* %slot, align 8
+    %cast = bitcast i64* %slot to i32**
+    %p = load i32*, i32** %cast, align 8
+    %0 = load i32, i32* %p, align 4
+    ret i32 %0
+}
+)ASM");
+
+    EXPECT_EQ(region(module->getGlobalVariable("a")), PointsToAnalysis::UnknownRegion);
+    EXPECT_EQ(region(getValue("main", "p")), PointsToAnalysis::UnknownRegion);
+    EXPECT_NE(region(getValue("main", "slot")), PointsToAnalysis::UnknownRegion);
+}
+
+TEST_F(PointsToAnalysisTest, HeapAllocations)
+{
+    setUp(R"ASM(
+declare noalias i8* @malloc(i64)
+
+define i32 @main() {
+entry:
+    %m1 = call i8* @malloc(i64 4)
+    %m2 = call i8* @malloc(i64 4)
+    %p1 = bitcast i8* %m1 to i32*
+    %p2 = bitcast i8* %m2 to i32*
+    store i32 1, i32* %p1, align 4
+    store i32 2, i32* %p2, align 4
+    %0 = load i32, i32* %p1, align 4
+    ret i32 %0
+}
+)ASM");
+
+    auto m1 = getValue("main", "m1");
+    auto m2 = getValue("main", "m2");
+
+    EXPECT_NE(region(m1), region(m2));
+    EXPECT_NE(region(m1), PointsToAnalysis::UnknownRegion);
+    EXPECT_EQ(region(getValue("main", "p1")), region(m1));
+    ASSERT_EQ(analysis->getRegionObjects(region(m1)).size(), 1u);
+    EXPECT_EQ(analysis->getRegionObjects(region(m1))[0], m1);
+}
+
+TEST_F(PointsToAnalysisTest, UniformAccessSizes)
+{
+    setUp(R"ASM(
+%struct.S = type { i32, i8 }
+
+@arr = global [4 x i32] zeroinitializer, align 4
+@s = global %struct.S zeroinitializer, align 4
+@buf = global [8 x i8] zeroinitializer, align 1
+@x = global i64 0, align 8
+
+declare i64 @__VERIFIER_nondet_long()
+declare void @llvm.memset.p0i8.i64(i8*, i8, i64, i1)
+
+define i32 @main() {
+entry:
+    %i = call i64 @__VERIFIER_nondet_long()
+    %e = getelementptr inbounds [4 x i32], [4 x i32]* @arr, i64 0, i64 %i
+    store i32 1, i32* %e, align 4
+    %e2 = getelementptr inbounds [4 x i32], [4 x i32]* @arr, i64 0, i64 2
+    %0 = load i32, i32* %e2, align 4
+    %f0 = getelementptr inbounds %struct.S, %struct.S* @s, i32 0, i32 0
+    %f1 = getelementptr inbounds %struct.S, %struct.S* @s, i32 0, i32 1
+    store i32 1, i32* %f0, align 4
+    store i8 1, i8* %f1, align 4
+    %b = getelementptr inbounds [8 x i8], [8 x i8]* @buf, i64 0, i64 0
+    call void @llvm.memset.p0i8.i64(i8* %b, i8 0, i64 8, i1 false)
+    %w = bitcast [8 x i8]* @buf to i32*
+    store i32 1, i32* %w, align 4
+    %x1 = bitcast i64* @x to i32*
+    %x2 = getelementptr inbounds i32, i32* %x1, i64 1
+    store i32 1, i32* %x2, align 4
+    store i64 0, i64* @x, align 8
+    ret i32 %0
+}
+)ASM");
+
+    auto arr = module->getGlobalVariable("arr");
+    auto s = module->getGlobalVariable("s");
+    auto buf = module->getGlobalVariable("buf");
+    auto x = module->getGlobalVariable("x");
+
+    EXPECT_EQ(analysis->getUniformAccessSize(region(arr)), 4u);
+    EXPECT_EQ(analysis->getUniformAccessSize(region(s)), 0u);
+    EXPECT_EQ(analysis->getUniformAccessSize(region(buf)), 0u);
+    EXPECT_EQ(analysis->getUniformAccessSize(region(x)), 0u);
+}
+
+} // end anonymous namespace
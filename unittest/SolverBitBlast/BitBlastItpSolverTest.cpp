@@ -0,0 +1,207 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "gazer/BitBlastSolver/BitBlastSolver.h"
+#include "gazer/Core/Solver/Model.h"
+#include "gazer/Core/ExprTypes.h"
+#include "gazer/Core/LiteralExpr.h"
+
+#include <gtest/gtest.h>
+
+#include <set>
+
+using namespace gazer;
+
+namespace
+{
+
+class BitBlastItpSolverTest : public ::testing::Test
+{
+protected:
+    /// Checks that \p itp is a Craig interpolant of (A, B) over \p shared.
+    void checkInterpolant(
+        const ExprPtr& itp, const ExprPtr& a, const ExprPtr& b, const std::set<Variable*>& shared)
+    {
+        ASSERT_NE(itp, nullptr);
+
+        // A => I
+        auto solver = factory.createSolver(ctx);
+        solver->add(a);
+        solver->add(NotExpr::Create(itp));
+        EXPECT_EQ(solver->run(), Solver::UNSAT);
+
+        // I & B is unsatisfiable
+        solver->reset();
+        solver->add(itp);
+        solver->add(b);
+        EXPECT_EQ(solver->run(), Solver::UNSAT);
+
+        std::vector<ExprPtr> worklist = { itp };
+        while (!worklist.empty()) {
+            ExprPtr expr = worklist.back();
+            worklist.pop_back();
+            if (auto varRef = llvm::dyn_cast<VarRefExpr>(expr)) {
+                EXPECT_EQ(shared.count(&varRef->getVariable()), 1u) << varRef->getVariable().getName();
+            } else if (auto nonNullary = llvm::dyn_cast<NonNullaryExpr>(expr)) {
+                worklist.insert(worklist.end(), nonNullary->op_begin(), nonNullary->op_end());
+            }
+        }
+    }
+
+protected:
+    GazerContext ctx;
+    BitBlastItpSolverFactory itpFactory;
+    BitBlastSolverFactory factory;
+};
+
+TEST_F(BitBlastItpSolverTest, BooleanInterpolant)
+{
+    auto a = ctx.createVariable("a", BoolType::Get(ctx));
+    auto b = ctx.createVariable("b", BoolType::Get(ctx));
+    auto c = ctx.createVariable("c", BoolType::Get(ctx));
+
+    // A: a & (a => b), B: !b & c
+    auto formulaA = AndExpr::Create(a->getRefExpr(), ImplyExpr::Create(a->getRefExpr(), b->getRefExpr()));
+    auto formulaB = AndExpr::Create(NotExpr::Create(b->getRefExpr()), c->getRefExpr());
+
+    auto solver = itpFactory.createItpSolver(ctx);
+    ItpGroup group = solver->createItpGroup();
+    solver->add(group, formulaA);
+    solver->add(formulaB);
+
+    ASSERT_EQ(solver->run(), Solver::UNSAT);
+    checkInterpolant(solver->getInterpolant(group), formulaA, formulaB, { b });
+}
+
+TEST_F(BitBlastItpSolverTest, BvInterpolant)
+{
+    auto& bv8 = BvType::Get(ctx, 8);
+    auto x = ctx.createVariable("x", bv8);
+    auto y = ctx.createVariable("y", bv8);
+    auto z = ctx.createVariable("z", bv8);
+
+    // A: y == 5 & x == y + 1, B: x == z * 2 | z <u 3
+    auto formulaA = AndExpr::Create(
+        EqExpr::Create(y->getRefExpr(), BvLiteralExpr::Get(bv8, 5)),
+        EqExpr::Create(x->getRefExpr(), AddExpr::Create(y->getRefExpr(), BvLiteralExpr::Get(bv8, 1)))
+    );
+    auto formulaB = AndExpr::Create(
+        EqExpr::Create(x->getRefExpr(), MulExpr::Create(z->getRefExpr(), BvLiteralExpr::Get(bv8, 2))),
+        BvULtExpr::Create(z->getRefExpr(), BvLiteralExpr::Get(bv8, 3))
+    );
+
+    auto solver = itpFactory.createItpSolver(ctx);
+    ItpGroup group = solver->createItpGroup();
+    solver->add(group, formulaA);
+    solver->add(formulaB);
+
+    ASSERT_EQ(solver->run(), Solver::UNSAT);
+    checkInterpolant(solver->getInterpolant(group), formulaA, formulaB, { x });
+
+    // Interpolating the other way around is possible as well.
+    solver->reset();
+    ItpGroup other = solver->createItpGroup();
+    solver->add(formulaA);
+    solver->add(other, formulaB);
+
+    ASSERT_EQ(solver->run(), Solver::UNSAT);
+    checkInterpolant(solver->getInterpolant(other), formulaB, formulaA, { x });
+}
+
+TEST_F(BitBlastItpSolverTest, ArrayInterpolant)
+{
+    auto& bv8 = BvType::Get(ctx, 8);
+    auto mem = ctx.createVariable("mem", ArrayType::Get(bv8, bv8));
+    auto p = ctx.createVariable("p", bv8);
+    auto v = ctx.createVariable("v", bv8);
+    auto w = ctx.createVariable("w", bv8);
+
+    auto read = ArrayReadExpr::Create(mem->getRefExpr(), p->getRefExpr());
+
+    // A: mem[p] == v & v == 1, B: mem[p] == w & w == 2
+    auto formulaA = AndExpr::Create(
+        EqExpr::Create(read, v->getRefExpr()),
+        EqExpr::Create(v->getRefExpr(), BvLiteralExpr::Get(bv8, 1))
+    );
+    auto formulaB = AndExpr::Create(
+        EqExpr::Create(read, w->getRefExpr()),
+        EqExpr::Create(w->getRefExpr(), BvLiteralExpr::Get(bv8, 2))
+    );
+
+    auto solver = itpFactory.createItpSolver(ctx);
+    ItpGroup group = solver->createItpGroup();
+    solver->add(group, formulaA);
+    solver->add(formulaB);
+
+    ASSERT_EQ(solver->run(), Solver::UNSAT);
+    checkInterpolant(solver->getInterpolant(group), formulaA, formulaB, { mem, p });
+}
+
+TEST_F(BitBlastItpSolverTest, ArrayInterpolantWithLocalIndex)
+{
+    auto& bv8 = BvType::Get(ctx, 8);
+    auto mem = ctx.createVariable("mem", ArrayType::Get(bv8, bv8));
+    auto p = ctx.createVariable("p", bv8);
+    auto x = ctx.createVariable("x", bv8);
+
+    // A: x == p & mem[x] == 1, B: mem[p] == 2
+    auto formulaA = AndExpr::Create(
+        EqExpr::Create(x->getRefExpr(), p->getRefExpr()),
+        EqExpr::Create(ArrayReadExpr::Create(mem->getRefExpr(), x->getRefExpr()), BvLiteralExpr::Get(bv8, 1))
+    );
+    auto formulaB = EqExpr::Create(
+        ArrayReadExpr::Create(mem->getRefExpr(), p->getRefExpr()), BvLiteralExpr::Get(bv8, 2)
+    );
+
+    auto solver = itpFactory.createItpSolver(ctx);
+    ItpGroup group = solver->createItpGroup();
+    solver->add(group, formulaA);
+    solver->add(formulaB);
+
+    ASSERT_EQ(solver->run(), Solver::UNSAT);
+    checkInterpolant(solver->getInterpolant(group), formulaA, formulaB, { mem, p });
+}
+
+TEST_F(BitBlastItpSolverTest, PushPop)
+{
+    auto& bv8 = BvType::Get(ctx, 8);
+    auto x = ctx.createVariable("x", bv8);
+    auto y = ctx.createVariable("y", bv8);
+
+    auto formulaA = BvUGtExpr::Create(x->getRefExpr(), BvLiteralExpr::Get(bv8, 10));
+
+    auto solver = itpFactory.createItpSolver(ctx);
+    ItpGroup group = solver->createItpGroup();
+    solver->add(group, formulaA);
+
+    solver->push();
+    solver->add(EqExpr::Create(y->getRefExpr(), x->getRefExpr()));
+    ASSERT_EQ(solver->run(), Solver::SAT);
+    EXPECT_EQ(solver->getModel()->evaluate(BvUGtExpr::Create(y->getRefExpr(), BvLiteralExpr::Get(bv8, 10))),
+        BoolLiteralExpr::True(ctx));
+
+    auto formulaB = BvULtExpr::Create(x->getRefExpr(), BvLiteralExpr::Get(bv8, 4));
+    solver->add(formulaB);
+    ASSERT_EQ(solver->run(), Solver::UNSAT);
+    auto formulaBWithY = AndExpr::Create(EqExpr::Create(y->getRefExpr(), x->getRefExpr()), formulaB);
+    checkInterpolant(solver->getInterpolant(group), formulaA, formulaBWithY, { x });
+    solver->pop();
+
+    EXPECT_EQ(solver->run(), Solver::SAT);
+}
+
+} // end anonymous namespace
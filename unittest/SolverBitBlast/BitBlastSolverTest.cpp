@@ -0,0 +1,304 @@
+//==-------------------------------------------------------------*- C++ -*--==//
+//
+// Copyright 2019 Contributors to the Gazer project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+#include "gazer/BitBlastSolver/BitBlastSolver.h"
+#include "gazer/Core/Solver/Model.h"
+#include "gazer/Core/ExprTypes.h"
+#include "gazer/Core/LiteralExpr.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <functional>
+
+using namespace gazer;
+
+namespace
+{
+
+class BitBlastSolverTest : public ::testing::Test
+{
+protected:
+    GazerContext ctx;
+    BitBlastSolverFactory factory;
+};
+
+TEST_F(BitBlastSolverTest, SmokeTest)
+{
+    auto solver = factory.createSolver(ctx);
+
+    auto a = ctx.createVariable("A", BoolType::Get(ctx));
+    auto b = ctx.createVariable("B", BoolType::Get(ctx));
+
+    // (A & B)
+    solver->add(AndExpr::Create(a->getRefExpr(), b->getRefExpr()));
+
+    ASSERT_EQ(solver->run(), Solver::SAT);
+    auto model = solver->getModel();
+
+    EXPECT_EQ(model->evaluate(a->getRefExpr()), BoolLiteralExpr::True(ctx));
+    EXPECT_EQ(model->evaluate(b->getRefExpr()), BoolLiteralExpr::True(ctx));
+
+    // (A & B) & (!A | !B)
+    solver->add(OrExpr::Create(NotExpr::Create(a->getRefExpr()), NotExpr::Create(b->getRefExpr())));
+    EXPECT_EQ(solver->run(), Solver::UNSAT);
+}
+
+TEST_F(BitBlastSolverTest, BvOperations)
+{
+    // Compare the result of each operation on all 3-bit operands against
+    // the expression evaluator. The evaluator cannot handle division by zero
+    // and over-shifting, so the range of the right-hand side is restricted
+    // for these operations.
+    using BinaryFn = std::function<ExprPtr(ExprPtr, ExprPtr)>;
+    struct Operation { BinaryFn fn; unsigned rhsBegin; unsigned rhsEnd; };
+    std::vector<Operation> operations = {
+        { [](auto l, auto r) { return AddExpr::Create(l, r); }, 0, 8 },
+        { [](auto l, auto r) { return SubExpr::Create(l, r); }, 0, 8 },
+        { [](auto l, auto r) { return MulExpr::Create(l, r); }, 0, 8 },
+        { [](auto l, auto r) { return BvUDivExpr::Create(l, r); }, 1, 8 },
+        { [](auto l, auto r) { return BvURemExpr::Create(l, r); }, 1, 8 },
+        { [](auto l, auto r) { return BvSDivExpr::Create(l, r); }, 1, 8 },
+        { [](auto l, auto r) { return BvSRemExpr::Create(l, r); }, 1, 8 },
+        { [](auto l, auto r) { return ShlExpr::Create(l, r); }, 0, 3 },
+        { [](auto l, auto r) { return LShrExpr::Create(l, r); }, 0, 3 },
+        { [](auto l, auto r) { return AShrExpr::Create(l, r); }, 0, 3 },
+        { [](auto l, auto r) { return BvXorExpr::Create(l, r); }, 0, 8 },
+        { [](auto l, auto r) { return BvSLtExpr::Create(l, r); }, 0, 8 },
+        { [](auto l, auto r) { return BvSGtEqExpr::Create(l, r); }, 0, 8 },
+        { [](auto l, auto r) { return BvULtEqExpr::Create(l, r); }, 0, 8 },
+        { [](auto l, auto r) { return BvUGtExpr::Create(l, r); }, 0, 8 },
+    };
+
+    auto& bv3 = BvType::Get(ctx, 3);
+    auto x = ctx.createVariable("x", bv3)->getRefExpr();
+    auto y = ctx.createVariable("y", bv3)->getRefExpr();
+
+    auto solver = factory.createSolver(ctx);
+    for (auto& [fn, rhsBegin, rhsEnd] : operations) {
+        ExprPtr expr = fn(x, y);
+        for (unsigned i = 0; i < 8; ++i) {
+            for (unsigned j = rhsBegin; j < rhsEnd; ++j) {
+                auto lhs = BvLiteralExpr::Get(bv3, i);
+                auto rhs = BvLiteralExpr::Get(bv3, j);
+
+                solver->push();
+                solver->add(EqExpr::Create(x, lhs));
+                solver->add(EqExpr::Create(y, rhs));
+                ASSERT_EQ(solver->run(), Solver::SAT);
+
+                auto model = solver->getModel();
+                auto expected = model->evaluate(fn(lhs, rhs));
+                EXPECT_EQ(model->evaluate(expr), expected) << i << " " << j;
+
+                // The result must be forced by the bit-blasted formula.
+                solver->add(NotEqExpr::Create(expr, expected));
+                EXPECT_EQ(solver->run(), Solver::UNSAT) << i << " " << j;
+                solver->pop();
+            }
+        }
+    }
+}
+
+TEST_F(BitBlastSolverTest, DivisionByZero)
+{
+    auto solver = factory.createSolver(ctx);
+    auto& bv8 = BvType::Get(ctx, 8);
+    auto x = ctx.createVariable("x", bv8)->getRefExpr();
+    auto zero = BvLiteralExpr::Get(bv8, 0);
+
+    // x / 0 == 0xFF and x % 0 == x must be valid.
+    solver->add(OrExpr::Create(
+        NotEqExpr::Create(BvUDivExpr::Create(x, zero), BvLiteralExpr::Get(bv8, 255)),
+        NotEqExpr::Create(BvURemExpr::Create(x, zero), x)
+    ));
+
+    EXPECT_EQ(solver->run(), Solver::UNSAT);
+}
+
+TEST_F(BitBlastSolverTest, PushPop)
+{
+    auto solver = factory.createSolver(ctx);
+    auto& bv8 = BvType::Get(ctx, 8);
+    auto x = ctx.createVariable("x", bv8)->getRefExpr();
+
+    solver->add(BvUGtExpr::Create(x, BvLiteralExpr::Get(bv8, 10)));
+
+    solver->push();
+    solver->add(BvULtExpr::Create(x, BvLiteralExpr::Get(bv8, 5)));
+    EXPECT_EQ(solver->run(), Solver::UNSAT);
+    solver->pop();
+
+    solver->push();
+    solver->add(BvULtExpr::Create(x, BvLiteralExpr::Get(bv8, 12)));
+    ASSERT_EQ(solver->run(), Solver::SAT);
+    EXPECT_EQ(solver->getModel()->evaluate(x), BvLiteralExpr::Get(bv8, 11));
+    solver->pop();
+
+    EXPECT_EQ(solver->run(), Solver::SAT);
+}
+
+TEST_F(BitBlastSolverTest, Arrays)
+{
+    auto solver = factory.createSolver(ctx);
+    auto& bv8 = BvType::Get(ctx, 8);
+    auto& arrTy = ArrayType::Get(bv8, bv8);
+
+    auto x = ctx.createVariable("x", bv8)->getRefExpr();
+    auto y = ctx.createVariable("y", bv8)->getRefExpr();
+    auto mem = ctx.createVariable("mem", arrTy)->getRefExpr();
+
+    // mem[x] == 1 & mem[y] == 2
+    solver->add(EqExpr::Create(ArrayReadExpr::Create(mem, x), BvLiteralExpr::Get(bv8, 1)));
+    solver->add(EqExpr::Create(ArrayReadExpr::Create(mem, y), BvLiteralExpr::Get(bv8, 2)));
+    ASSERT_EQ(solver->run(), Solver::SAT);
+
+    auto model = solver->getModel();
+    EXPECT_NE(model->evaluate(x), model->evaluate(y));
+    EXPECT_EQ(model->evaluate(ArrayReadExpr::Create(mem, x)), BvLiteralExpr::Get(bv8, 1));
+
+    // (mem[x := 3])[y] == 3 & x != y
+    solver->push();
+    auto written = ArrayWriteExpr::Create(mem, x, BvLiteralExpr::Get(bv8, 3));
+    solver->add(EqExpr::Create(ArrayReadExpr::Create(written, y), BvLiteralExpr::Get(bv8, 3)));
+    EXPECT_EQ(solver->run(), Solver::UNSAT);
+    solver->pop();
+
+    // Array literals with a default value
+    ArrayLiteralExpr::Builder builder(arrTy);
+    builder.addValue(BvLiteralExpr::Get(bv8, 1), BvLiteralExpr::Get(bv8, 5));
+    builder.setDefault(BvLiteralExpr::Get(bv8, 0));
+    auto lit = builder.build();
+
+    solver->add(EqExpr::Create(ArrayReadExpr::Create(lit, x), BvLiteralExpr::Get(bv8, 5)));
+    ASSERT_EQ(solver->run(), Solver::SAT);
+    EXPECT_EQ(solver->getModel()->evaluate(x), BvLiteralExpr::Get(bv8, 1));
+}
+
+TEST_F(BitBlastSolverTest, ArrayEquality)
+{
+    auto solver = factory.createSolver(ctx);
+    auto& bv8 = BvType::Get(ctx, 8);
+    auto& arrTy = ArrayType::Get(bv8, bv8);
+
+    auto x = ctx.createVariable("x", bv8)->getRefExpr();
+    auto y = ctx.createVariable("y", bv8)->getRefExpr();
+    auto mem = ctx.createVariable("mem", arrTy)->getRefExpr();
+    auto mem2 = ctx.createVariable("mem2", arrTy)->getRefExpr();
+
+    // mem2 == mem[x := 3] & mem2[y] != 3 is satisfiable...
+    auto written = ArrayWriteExpr::Create(mem, x, BvLiteralExpr::Get(bv8, 3));
+    solver->add(EqExpr::Create(mem2, written));
+    solver->add(NotEqExpr::Create(ArrayReadExpr::Create(mem2, y), BvLiteralExpr::Get(bv8, 3)));
+    EXPECT_EQ(solver->run(), Solver::SAT);
+
+    // ...unless x == y.
+    solver->push();
+    solver->add(EqExpr::Create(x, y));
+    EXPECT_EQ(solver->run(), Solver::UNSAT);
+    solver->pop();
+
+    // Writing back a read value does not change the array.
+    solver->push();
+    auto same = ArrayWriteExpr::Create(mem, y, ArrayReadExpr::Create(mem, y));
+    solver->add(NotEqExpr::Create(mem, same));
+    EXPECT_EQ(solver->run(), Solver::UNSAT);
+    solver->pop();
+
+    // Distinct arrays differ at some index.
+    solver->add(NotEqExpr::Create(mem, mem2));
+    solver->add(EqExpr::Create(ArrayReadExpr::Create(mem, x), BvLiteralExpr::Get(bv8, 3)));
+    EXPECT_EQ(solver->run(), Solver::SAT);
+}
+
+TEST_F(BitBlastSolverTest, UnsatCore)
+{
+    auto solver = factory.createSolver(ctx);
+    ASSERT_TRUE(solver->supportsAssumptions());
+
+    auto& bv8 = BvType::Get(ctx, 8);
+    auto x = ctx.createVariable("x", bv8)->getRefExpr();
+    auto p = ctx.createVariable("p", BoolType::Get(ctx))->getRefExpr();
+    auto q = ctx.createVariable("q", BoolType::Get(ctx))->getRefExpr();
+    auto r = ctx.createVariable("r", BoolType::Get(ctx))->getRefExpr();
+
+    // p => x > 10, q => x < 5, r => x == 7
+    solver->add(ImplyExpr::Create(p, BvUGtExpr::Create(x, BvLiteralExpr::Get(bv8, 10))));
+    solver->add(ImplyExpr::Create(q, BvULtExpr::Create(x, BvLiteralExpr::Get(bv8, 5))));
+    solver->add(ImplyExpr::Create(r, EqExpr::Create(x, BvLiteralExpr::Get(bv8, 7))));
+
+    EXPECT_EQ(solver->runWithAssumptions({p, r}), Solver::UNSAT);
+    std::vector<ExprPtr> core;
+    solver->getUnsatCore(core);
+    EXPECT_EQ(core.size(), 2u);
+
+    // The assumption q is irrelevant to the conflict.
+    EXPECT_EQ(solver->runWithAssumptions({q, p, NotExpr::Create(r)}), Solver::UNSAT);
+    core.clear();
+    solver->getUnsatCore(core);
+    EXPECT_TRUE(std::find(core.begin(), core.end(), NotExpr::Create(r)) == core.end());
+
+    // Assumptions are not retained between checks.
+    EXPECT_EQ(solver->runWithAssumptions({q}), Solver::SAT);
+    EXPECT_EQ(solver->run(), Solver::SAT);
+
+    // Assumptions combined with scopes.
+    solver->push();
+    solver->add(p);
+    EXPECT_EQ(solver->runWithAssumptions({q}), Solver::UNSAT);
+    core.clear();
+    solver->getUnsatCore(core);
+    ASSERT_EQ(core.size(), 1u);
+    EXPECT_EQ(core[0], q);
+    solver->pop();
+
+    EXPECT_EQ(solver->runWithAssumptions({q}), Solver::SAT);
+}
+
+TEST_F(BitBlastSolverTest, UnsupportedTheories)
+{
+    auto solver = factory.createSolver(ctx);
+    auto x = ctx.createVariable("x", IntType::Get(ctx))->getRefExpr();
+
+    // Integers are abstracted away, thus satisfiable results are unknown...
+    solver->add(GtExpr::Create(x, IntLiteralExpr::Get(ctx, 0)));
+    EXPECT_EQ(solver->run(), Solver::UNKNOWN);
+
+    // ...while unsatisfiable results are still reliable.
+    auto p = ctx.createVariable("p", BoolType::Get(ctx))->getRefExpr();
+    solver->push();
+    solver->add(AndExpr::Create(p, NotExpr::Create(p)));
+    EXPECT_EQ(solver->run(), Solver::UNSAT);
+    solver->pop();
+
+    // Unsupported terms only affect the scopes they were added in.
+    solver->reset();
+    solver->add(p);
+    solver->push();
+    solver->add(NotExpr::Create(GtExpr::Create(x, IntLiteralExpr::Get(ctx, 0))));
+    EXPECT_EQ(solver->run(), Solver::UNKNOWN);
+    solver->pop();
+    EXPECT_EQ(solver->run(), Solver::SAT);
+
+    // Terms cached in an earlier scope are still over-approximated.
+    solver->push();
+    solver->add(ImplyExpr::Create(p, GtExpr::Create(x, IntLiteralExpr::Get(ctx, 0))));
+    EXPECT_EQ(solver->run(), Solver::UNKNOWN);
+    solver->pop();
+}
+
+} // end anonymous namespace
@@ -45,4 +45,78 @@ TEST(Z3ModelTest, Arrays)
     ASSERT_EQ(solver->getModel()->evaluate(ArrayReadExpr::Create(write, one)), one);
 }
 
+TEST(Z3ModelTest, ArrayVariableValues)
+{
+    GazerContext ctx;
+    Z3SolverFactory factory;
+
+    auto& bv8 = BvType::Get(ctx, 8);
+    auto& arrTy = ArrayType::Get(bv8, bv8);
+    auto mem = ctx.createVariable("mem", arrTy);
+    auto x = ctx.createVariable("x", bv8);
+
+    auto one = BvLiteralExpr::Get(bv8, 1);
+    auto two = BvLiteralExpr::Get(bv8, 2);
+
+    // mem[1] == 1 & mem[2] == 2 & x == mem[1] + mem[2]
+    auto solver = factory.createSolver(ctx);
+    solver->add(EqExpr::Create(ArrayReadExpr::Create(mem->getRefExpr(), one), one));
+    solver->add(EqExpr::Create(ArrayReadExpr::Create(mem->getRefExpr(), two), two));
+    solver->add(EqExpr::Create(x->getRefExpr(), AddExpr::Create(
+        ArrayReadExpr::Create(mem->getRefExpr(), one),
+        ArrayReadExpr::Create(mem->getRefExpr(), two)
+    )));
+    ASSERT_EQ(solver->run(), Solver::SAT);
+
+    auto model = solver->getModel();
+    auto memValue = model->evaluate(mem->getRefExpr());
+    ASSERT_TRUE(llvm::isa<ArrayLiteralExpr>(memValue));
+
+    auto memLit = llvm::cast<ArrayLiteralExpr>(memValue);
+    EXPECT_EQ(memLit->getValue(one), one);
+    EXPECT_EQ(memLit->getValue(two), two);
+
+    // Repeated queries are served from the cache.
+    EXPECT_EQ(model->evaluate(mem->getRefExpr()), memValue);
+    EXPECT_EQ(model->evaluate(x->getRefExpr()), BvLiteralExpr::Get(bv8, 3));
+}
+
+TEST(Z3ModelTest, EvaluateAll)
+{
+    GazerContext ctx;
+    Z3SolverFactory factory;
+
+    auto& bv8 = BvType::Get(ctx, 8);
+    auto x = ctx.createVariable("x", bv8);
+    auto y = ctx.createVariable("y", bv8);
+    auto z = ctx.createVariable("z", bv8);
+
+    auto solver = factory.createSolver(ctx);
+    solver->add(EqExpr::Create(x->getRefExpr(), BvLiteralExpr::Get(bv8, 5)));
+    solver->add(EqExpr::Create(y->getRefExpr(), AddExpr::Create(x->getRefExpr(), BvLiteralExpr::Get(bv8, 1))));
+    ASSERT_EQ(solver->run(), Solver::SAT);
+
+    auto model = solver->getModel();
+
+    std::vector<ExprPtr> exprs = {
+        x->getRefExpr(),
+        y->getRefExpr(),
+        AddExpr::Create(x->getRefExpr(), y->getRefExpr()),
+        x->getRefExpr(),
+        z->getRefExpr()
+    };
+
+    std::vector<ExprRef<AtomicExpr>> results;
+    model->evaluateAll(exprs, results);
+
+    ASSERT_EQ(results.size(), exprs.size());
+    EXPECT_EQ(results[0], BvLiteralExpr::Get(bv8, 5));
+    EXPECT_EQ(results[1], BvLiteralExpr::Get(bv8, 6));
+    EXPECT_EQ(results[2], BvLiteralExpr::Get(bv8, 11));
+    EXPECT_EQ(results[3], results[0]);
+
+    // Variables which are not constrained are still completed to a literal.
+    EXPECT_TRUE(llvm::isa<BvLiteralExpr>(results[4]));
+}
+
 } // namespace
@@ -22,6 +22,8 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+
 using namespace gazer;
 
 TEST(SolverZ3Test, SmokeTest1)
@@ -164,4 +166,75 @@ TEST(SolverZ3Test, Tuples)
 
     status = solver->run();
     EXPECT_EQ(status, Solver::UNSAT);
-}
\ No newline at end of file
+}
+TEST(SolverZ3Test, UnsatCore)
+{
+    GazerContext ctx;
+    Z3SolverFactory factory;
+    auto solver = factory.createSolver(ctx);
+    ASSERT_TRUE(solver->supportsAssumptions());
+
+    auto x = ctx.createVariable("x", IntType::Get(ctx))->getRefExpr();
+    auto p = ctx.createVariable("p", BoolType::Get(ctx))->getRefExpr();
+    auto q = ctx.createVariable("q", BoolType::Get(ctx))->getRefExpr();
+    auto r = ctx.createVariable("r", BoolType::Get(ctx))->getRefExpr();
+
+    // p => x > 10, q => x < 5
+    solver->add(ImplyExpr::Create(p, GtExpr::Create(x, IntLiteralExpr::Get(ctx, 10))));
+    solver->add(ImplyExpr::Create(q, LtExpr::Create(x, IntLiteralExpr::Get(ctx, 5))));
+
+    auto status = solver->runWithAssumptions({p, q, NotExpr::Create(r)});
+    ASSERT_EQ(status, Solver::UNSAT);
+
+    std::vector<ExprPtr> core;
+    solver->getUnsatCore(core);
+    ASSERT_EQ(core.size(), 2u);
+    EXPECT_TRUE(std::find(core.begin(), core.end(), NotExpr::Create(r)) == core.end());
+
+    // Assumptions are not retained between checks.
+    status = solver->runWithAssumptions({q, r});
+    EXPECT_EQ(status, Solver::SAT);
+    EXPECT_EQ(solver->getModel()->evaluate(r), BoolLiteralExpr::True(ctx));
+}
+
+TEST(SolverZ3Test, Profiles)
+{
+    for (Z3SolverProfile profile : getAllZ3SolverProfiles()) {
+        GazerContext ctx;
+        Z3SolverFactory factory(profile);
+        auto solver = factory.createSolver(ctx);
+        auto name = getZ3SolverProfileName(profile);
+
+        auto& bv8 = BvType::Get(ctx, 8);
+        auto x = ctx.createVariable("x", bv8)->getRefExpr();
+        auto y = ctx.createVariable("y", bv8)->getRefExpr();
+        auto mem = ctx.createVariable("mem", ArrayType::Get(bv8, bv8))->getRefExpr();
+        auto p = ctx.createVariable("p", BoolType::Get(ctx))->getRefExpr();
+
+        // mem[x := y][x] == 3 & (p => y == 4)
+        auto written = ArrayWriteExpr::Create(mem, x, y);
+        solver->add(EqExpr::Create(ArrayReadExpr::Create(written, x), BvLiteralExpr::Get(bv8, 3)));
+        solver->add(ImplyExpr::Create(p, EqExpr::Create(y, BvLiteralExpr::Get(bv8, 4))));
+
+        ASSERT_EQ(solver->run(), Solver::SAT) << name.str();
+        EXPECT_EQ(solver->getModel()->evaluate(y), BvLiteralExpr::Get(bv8, 3)) << name.str();
+
+        ASSERT_EQ(solver->runWithAssumptions({p}), Solver::UNSAT) << name.str();
+        std::vector<ExprPtr> core;
+        solver->getUnsatCore(core);
+        EXPECT_EQ(core.size(), 1u) << name.str();
+
+        solver->push();
+        solver->add(EqExpr::Create(x, y));
+        ASSERT_EQ(solver->run(), Solver::SAT) << name.str();
+        EXPECT_EQ(solver->getModel()->evaluate(x), BvLiteralExpr::Get(bv8, 3)) << name.str();
+        solver->pop();
+
+        solver->push();
+        solver->add(p);
+        EXPECT_EQ(solver->run(), Solver::UNSAT) << name.str();
+        solver->pop();
+
+        EXPECT_EQ(solver->run(), Solver::SAT) << name.str();
+    }
+}